@@ -5,10 +5,9 @@
 
 static bool cute_png_loads(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    PY_CHECK_ARG_TYPE(0, tp_bytes);
-    int size;
-    unsigned char* data = py_tobytes(argv, &size);
-    cp_image_t image = cp_load_png_mem(data, size);
+    py_Buffer buf;
+    if(!py_getbuffer(argv, &buf, false)) return false;
+    cp_image_t image = cp_load_png_mem(buf.data, buf.size);
     if(image.pix == NULL) return ValueError("cute_png: %s", cp_error_reason);
     py_newarray2d(py_retval(), image.w, image.h);
     for(int y = 0; y < image.h; y++) {
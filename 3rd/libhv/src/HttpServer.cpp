@@ -4,12 +4,37 @@
 #include "http/server/WebSocketServer.h"
 #include "pocketpy.h"
 
+#include <condition_variable>
+#include <mutex>
+
+// an http request waiting on the event loop thread for the python dispatcher
+struct libhv_HttpPendingRequest {
+    HttpContextPtr ctx;
+    std::mutex mtx;
+    std::condition_variable cnd;
+    int status_code = 0;
+
+    libhv_HttpPendingRequest(const HttpContextPtr& ctx) : ctx(ctx) {}
+
+    int wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cnd.wait(lock, [this] { return status_code != 0; });
+        return status_code;
+    }
+
+    void complete(int code) {
+        std::lock_guard<std::mutex> lock(mtx);
+        status_code = code;
+        cnd.notify_one();
+    }
+};
+
 struct libhv_HttpServer {
     hv::HttpService http_service;
     hv::WebSocketService ws_service;
     hv::WebSocketServer server;
 
-    libhv_MQ<std::pair<HttpContextPtr, std::atomic<int>>*> mq;
+    libhv_MQ<libhv_HttpPendingRequest*> mq;
 
     struct WsMessage {
         WsMessageType type;
@@ -41,13 +66,9 @@ static bool libhv_HttpServer__init__(int argc, py_Ref argv) {
     // http
     self->http_service.AllowCORS();
     http_ctx_handler internal_handler = [self](const HttpContextPtr& ctx) {
-        std::pair<HttpContextPtr, std::atomic<int>> msg(ctx, 0);
+        libhv_HttpPendingRequest msg(ctx);
         self->mq.push(&msg);
-        int code;
-        do {
-            code = msg.second.load();
-        } while(code == 0);
-        return code;
+        return msg.wait();
     };
     self->http_service.Any("*", internal_handler);
     self->server.registerHttpService(&self->http_service);
@@ -76,12 +97,12 @@ static bool libhv_HttpServer_dispatch(int argc, py_Ref argv) {
     py_Ref callable = py_arg(1);
     if(!py_callable(callable)) return TypeError("dispatcher must be callable");
 
-    std::pair<HttpContextPtr, std::atomic<int>>* mq_msg;
+    libhv_HttpPendingRequest* mq_msg;
     if(!self->mq.pop(&mq_msg)) {
         py_newbool(py_retval(), false);
         return true;
     } else {
-        HttpContextPtr ctx = mq_msg->first;
+        HttpContextPtr ctx = mq_msg->ctx;
         libhv_HttpRequest_create(py_retval(), ctx->request);
         // call dispatcher
         if(!py_call(callable, 1, py_retval())) return false;
@@ -144,7 +165,7 @@ static bool libhv_HttpServer_dispatch(int argc, py_Ref argv) {
             }
         }
 
-        mq_msg->second.store(status_code);
+        mq_msg->complete(status_code);
     }
     py_newbool(py_retval(), true);
     return true;
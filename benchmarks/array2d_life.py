@@ -0,0 +1,60 @@
+# Conway's game of life on a 2048x2048 grid
+N = 2048
+STEPS = 10
+K = 17
+
+def make_pattern(k):
+    return [(x * 7 + k * 13 + (x * k) % 11) % 5 == 0 for x in range(N)]
+
+patterns = [make_pattern(k) for k in range(K)]
+
+def pattern_of_row(y):
+    return (y * y + 3 * y) % K
+
+try:
+    from array2d import array2d
+except ImportError:
+    array2d = None
+
+if array2d is not None:
+    rows = [array2d.fromlist([p], dtype='bool') for p in patterns]
+    grid = array2d(N, N, default=False, dtype='bool')
+    for y in range(N):
+        grid[:, y] = rows[pattern_of_row(y)]
+    for _ in range(STEPS):
+        n = grid.count_neighbors(True, 'Moore')
+        grid = (n == 3) | (grid & (n == 2))
+    count = grid.count(True)
+else:
+    # cpython has no array2d, run the same rules on rows packed into ints
+    mask = (1 << N) - 1
+    packed = []
+    for p in patterns:
+        row = 0
+        for x in range(N):
+            if p[x]:
+                row |= 1 << x
+        packed.append(row)
+    grid = [packed[pattern_of_row(y)] for y in range(N)]
+    for _ in range(STEPS):
+        new_grid = []
+        for y in range(N):
+            up = grid[y - 1] if y > 0 else 0
+            mid = grid[y]
+            down = grid[y + 1] if y + 1 < N else 0
+            # bit-sliced counter of the 8 neighbors, s2 means at least 4
+            s0 = 0
+            s1 = 0
+            s2 = 0
+            for x in [(up << 1) & mask, up, up >> 1, (mid << 1) & mask, mid >> 1, (down << 1) & mask, down, down >> 1]:
+                c0 = s0 & x
+                s0 ^= x
+                s2 |= s1 & c0
+                s1 ^= c0
+            new_grid.append(s1 & ~s2 & (s0 | mid))
+        grid = new_grid
+    count = 0
+    for row in grid:
+        count += bin(row).count('1')
+
+print(count)
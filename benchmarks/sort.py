@@ -19,4 +19,14 @@ def __qsort(a: list, L: int, R: int):
 from dis import dis
 # dis(__qsort)
 
-__qsort(a, 0, len(a)-1)
\ No newline at end of file
+__qsort(a, 0, len(a)-1)
+
+# builtin sort
+b = [random.randint(-100000, 100000) for i in range(100000)]
+c = sorted(b)
+for i in range(len(c) - 1):
+    assert c[i] <= c[i + 1]
+assert sorted(c) == c
+assert sorted(b, reverse=True) == c[::-1]
+assert sorted(b, key=lambda x: -x) == c[::-1]
+assert sorted([str(x) for x in b]) == sorted([str(x) for x in c])
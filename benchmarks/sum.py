@@ -3,4 +3,16 @@ def f(n):
         return 0
     return n + f(n-1)
 
-assert f(900) == 405450
\ No newline at end of file
+assert f(900) == 405450
+
+# builtin sum
+a = list(range(100000))
+total = 0
+for _ in range(100):
+    total += sum(a)
+    total += sum(range(100000))
+assert total == 100 * 2 * 4999950000
+
+b = [i * 0.5 for i in range(100000)]
+for _ in range(10):
+    assert sum(b) == 2499975000.0
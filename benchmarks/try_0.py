@@ -0,0 +1,27 @@
+class Entity:
+    def __init__(self, i):
+        self.hp = i % 7
+
+def update(e):
+    try:
+        return e.hp
+    except AttributeError:
+        return -1
+
+entities = [Entity(i) for i in range(1000)]
+expected = sum([i % 7 for i in range(1000)])
+
+for _ in range(1000):
+    total = 0
+    for e in entities:
+        try:
+            total += e.hp
+        except AttributeError:
+            total -= 1
+    assert total == expected
+
+for _ in range(1000):
+    total = 0
+    for e in entities:
+        total += update(e)
+    assert total == expected
@@ -40,12 +40,12 @@
     } while(0)
 
 /**
- * @brief Sorts an array of elements of the same type, using the given comparison function.
+ * @brief Sorts an array of elements of the same type with TimSort. The sort is stable.
  * @param ptr Pointer to the first element of the array.
- * @param count Number of elements in the array.
+ * @param length Number of elements in the array.
  * @param elem_size Size of each element in the array.
- * @param cmp Comparison function that takes two elements and returns an integer similar to
- * `strcmp`.
+ * @param f_lt Comparison function that returns 1 if `a < b`, 0 if not, or -1 on error.
+ * @return `false` if `f_lt` failed. The array is still a permutation of the input.
  */
 bool c11__stable_sort(void* ptr,
                       int length,
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+
+// A process-wide pool of native workers for data-parallel loops.
+// Loop bodies run on workers and must not touch python objects.
+
+#define C11_THREADPOOL_MAX_THREADS 64
+#define C11_THREADPOOL_MAX_CHUNKS 64
+
+// body of a parallel loop over [begin, end), `chunk` is in [0, C11_THREADPOOL_MAX_CHUNKS)
+typedef void (*c11_parallel_fn)(void* ctx, int chunk, int begin, int end);
+
+void c11_threadpool__initialize();
+void c11_threadpool__finalize();
+// total number of threads including the caller, 1 runs every loop on the calling thread
+void c11_threadpool__set_size(int size);
+int c11_threadpool__size();
+// run `fn` over [0, n) split into chunks of at least `grain` items and return the number of chunks
+// chunk i always covers the same range for the same `n`, `grain` and pool size
+// the loop runs on the calling thread alone if the pool is busy with another loop
+int c11_threadpool__parallel_for(int n, int grain, c11_parallel_fn fn, void* ctx);
@@ -6,20 +6,39 @@
 
 #include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #if __EMSCRIPTEN__ || __APPLE__ || __linux__
 #include <pthread.h>
 #define PK_USE_PTHREADS 1
 typedef pthread_t c11_thrd_t;
 typedef void* c11_thrd_retval_t;
+typedef pthread_mutex_t c11_mtx_t;
+typedef pthread_cond_t c11_cnd_t;
 #else
 #include <threads.h>
 #define PK_USE_PTHREADS 0
 typedef thrd_t c11_thrd_t;
 typedef int c11_thrd_retval_t;
+typedef mtx_t c11_mtx_t;
+typedef cnd_t c11_cnd_t;
 #endif
 
 bool c11_thrd_create(c11_thrd_t* thrd, c11_thrd_retval_t (*func)(void*), void* arg);
+bool c11_thrd_join(c11_thrd_t thrd);
 void c11_thrd_yield();
 
-#endif
\ No newline at end of file
+void c11_mtx_init(c11_mtx_t* self);
+void c11_mtx_destroy(c11_mtx_t* self);
+void c11_mtx_lock(c11_mtx_t* self);
+void c11_mtx_unlock(c11_mtx_t* self);
+
+void c11_cnd_init(c11_cnd_t* self);
+void c11_cnd_destroy(c11_cnd_t* self);
+void c11_cnd_wait(c11_cnd_t* self, c11_mtx_t* mtx);
+// return false if `timeout_ms` elapsed, a negative timeout waits forever
+bool c11_cnd_timedwait(c11_cnd_t* self, c11_mtx_t* mtx, int64_t timeout_ms);
+void c11_cnd_signal(c11_cnd_t* self);
+void c11_cnd_broadcast(c11_cnd_t* self);
+
+#endif
@@ -5,4 +5,5 @@
 #include "pocketpy/objects/sourcedata.h"
 #include "pocketpy/objects/codeobject.h"
 
-Error* pk_compile(SourceData_ src, CodeObject* out);
+Error* pk_compile(SourceData_ src, int optimize_level, CodeObject* out);
+void pk_optimize(CodeObject* co, int level);
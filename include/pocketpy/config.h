@@ -23,6 +23,10 @@
 #define PK_ENABLE_WATCHDOG          0                
 #endif
 
+#ifndef PK_ENABLE_OPCODE_PROFILER   // can be overridden by cmake
+#define PK_ENABLE_OPCODE_PROFILER   0
+#endif
+
 #ifndef PK_ENABLE_CUSTOM_SNAME      // can be overridden by cmake
 #define PK_ENABLE_CUSTOM_SNAME      0                
 #endif
@@ -31,6 +35,10 @@
 #define PK_ENABLE_MIMALLOC          0                
 #endif
 
+#ifndef PK_ENABLE_SIMD              // can be overridden by cmake
+#define PK_ENABLE_SIMD              1
+#endif
+
 // GC min threshold
 #ifndef PK_GC_MIN_THRESHOLD         // can be overridden by cmake
     #define PK_GC_MIN_THRESHOLD     32768
@@ -48,7 +56,26 @@
 #define PK_MAX_CO_VARNAMES          64
 #endif
 
+// This is the number of compiled code objects cached by each VM
+// for repeated `py_exec`, `py_eval`, `py_compile` calls with the same source
+#ifndef PK_COMPILE_CACHE_SIZE       // can be overridden by cmake
+#define PK_COMPILE_CACHE_SIZE       64
+#endif
+
+// This is the default optimization level of the bytecode optimizer
+// 0: disabled; 1: jump threading, dead code removal and superinstructions;
+// 2: also constant folding
+#ifndef PK_OPTIMIZE_LEVEL           // can be overridden by cmake
+#define PK_OPTIMIZE_LEVEL           2
+#endif
+
 /*************** internal settings ***************/
+// This is the maximum length of a source string that can be cached by the compile cache
+#define PK_COMPILE_CACHE_MAX_SOURCE 1024
+
+// This is the number of parsed `str.format()` templates cached by each VM
+#define PK_FORMAT_CACHE_SIZE        64
+
 // This is the maximum character length of a module path
 #define PK_MAX_MODULE_PATH_LEN      63
 
@@ -2,6 +2,7 @@
 
 #include "pocketpy/pocketpy.h"
 #include "pocketpy/common/smallmap.h"
+#include "pocketpy/common/vector.h"
 #include "pocketpy/objects/base.h"
 
 typedef struct c11_array2d_like {
@@ -18,9 +19,60 @@ typedef struct c11_array2d_like_iterator {
     int i;
 } c11_array2d_like_iterator;
 
+typedef enum c11_array2d_dtype {
+    c11_array2d_dtype_object,  // boxed `py_TValue` cells
+    c11_array2d_dtype_bool,
+    c11_array2d_dtype_int8,
+    c11_array2d_dtype_int16,
+    c11_array2d_dtype_int32,
+    c11_array2d_dtype_float32,
+    c11_array2d_dtype_float64,
+} c11_array2d_dtype;
+
+typedef union c11_array2d_scalar {
+    bool _bool;
+    int8_t _int8;
+    int16_t _int16;
+    int32_t _int32;
+    float _float32;
+    double _float64;
+} c11_array2d_scalar;
+
+typedef enum c11_array2d_op {
+    c11_array2d_op_add,
+    c11_array2d_op_sub,
+    c11_array2d_op_mul,
+    c11_array2d_op_truediv,
+    c11_array2d_op_floordiv,
+    c11_array2d_op_mod,
+    c11_array2d_op_pow,
+    c11_array2d_op_and,
+    c11_array2d_op_or,
+    c11_array2d_op_xor,
+    c11_array2d_op_lt,
+    c11_array2d_op_le,
+    c11_array2d_op_gt,
+    c11_array2d_op_ge,
+    c11_array2d_op_eq,
+    c11_array2d_op_ne,
+} c11_array2d_op;
+
+typedef enum c11_array2d_reduce {
+    c11_array2d_reduce_sum,
+    c11_array2d_reduce_min,
+    c11_array2d_reduce_max,
+} c11_array2d_reduce;
+
 typedef struct c11_array2d {
     c11_array2d_like header;
-    py_TValue* data;  // slots
+    c11_array2d_dtype dtype;
+
+    union {
+        py_TValue* data;  // slots, if `dtype` is object
+        void* buffer;     // packed cells after the userdata, otherwise
+    };
+
+    py_TValue scratch;  // boxed cell returned by `f_get` of a typed array
 } c11_array2d;
 
 typedef struct c11_array2d_view {
@@ -32,23 +84,104 @@ typedef struct c11_array2d_view {
 } c11_array2d_view;
 
 c11_array2d* c11_newarray2d(py_OutRef out, int n_cols, int n_rows);
+c11_array2d*
+    c11_newarray2d_typed(py_OutRef out, int n_cols, int n_rows, c11_array2d_dtype dtype);
+// out = buffer[index]
+void c11_array2d__box(c11_array2d_dtype dtype, const void* buffer, int index, py_OutRef out);
+// buffer[index] = value, raises if `value` does not fit `dtype`
+bool c11_array2d__unbox(c11_array2d_dtype dtype, void* buffer, int index, py_Ref value);
+// parse a dtype name, `None` is object
+bool c11_array2d_dtype__parse(py_Ref name, c11_array2d_dtype* out);
+
+/* typed kernels, see array2d_kernels.c */
+// split typed kernels across `num_threads` threads including the caller, 1 runs them serially
+// a thread takes at least `min_cells` cells, smaller arrays stay on the calling thread
+void c11_array2d__set_parallel(int num_threads, int min_cells);
+void c11_array2d__get_parallel(int* num_threads, int* min_cells);
+int c11_array2d_dtype__itemsize(c11_array2d_dtype dtype);
+const char* c11_array2d_dtype__name(c11_array2d_dtype dtype);
+bool c11_array2d_dtype__is_float(c11_array2d_dtype dtype);
+// convert `n` cells of `src` into `dst`, floats are truncated and clamped into integers
+void c11_array2d__cast(void* dst,
+                       c11_array2d_dtype dst_dtype,
+                       const void* src,
+                       c11_array2d_dtype src_dtype,
+                       int n);
+// out = a op b, where `b` is a single scalar if `b_scalar` is true
+// comparisons write bool cells, other ops write `dtype` cells
+// returns false if `op` is not supported by `dtype`
+bool c11_array2d__binary(c11_array2d_op op,
+                         c11_array2d_dtype dtype,
+                         void* out,
+                         const void* a,
+                         const void* b,
+                         bool b_scalar,
+                         int n);
+void c11_array2d__abs(c11_array2d_dtype dtype, void* out, const void* a, int n);
+// bitwise not for integers, logical not for bool
+void c11_array2d__invert(c11_array2d_dtype dtype, void* out, const void* a, int n);
+void c11_array2d__nonzero(c11_array2d_dtype dtype, bool* out, const void* a, int n);
+int c11_array2d__count(c11_array2d_dtype dtype, const void* a, const void* value, int n);
+// sum, min or max of `n > 0` cells into `out`, bools sum into int and reduce with and/or
+void c11_array2d__reduce(c11_array2d_reduce op,
+                         c11_array2d_dtype dtype,
+                         const void* a,
+                         int n,
+                         py_OutRef out);
+// out[i] = number of true `mask` cells in the Moore or von Neumann neighborhood of cell i
+void c11_array2d__count_neighbors(int32_t* out,
+                                  const bool* mask,
+                                  int n_cols,
+                                  int n_rows,
+                                  bool moore);
+void c11_array2d__convolve_i32(int32_t* out,
+                               const int32_t* src,
+                               int n_cols,
+                               int n_rows,
+                               const int64_t* kernel,
+                               int ksize,
+                               int64_t padding);
+
+// neighbor offsets of a cell
+extern const c11_vec2i c11_array2d__Moore[8];
+extern const c11_vec2i c11_array2d__von_Neumann[4];
+// visit the true `mask` cells connected to `start` and `start` itself, clearing them in `mask`
+// `queue` receives the visited cell indices in BFS order, returns how many
+int c11_array2d__flood(int* queue, bool* mask, int n_cols, int n_rows, int start, bool moore);
+// labels[i] = 1-based index of the region of cell i, 0 outside `mask`
+// regions are numbered by their first cell in scan order, `mask` is cleared, returns how many
+int c11_array2d__label(int32_t* labels, bool* mask, int n_cols, int n_rows, bool moore);
+// out[i] = steps from cell i to the nearest true `mask` cell, -1 if `mask` has none
+void c11_array2d__distance(int32_t* out, const bool* mask, int n_cols, int n_rows, bool moore);
+// A* from `start` to `end`, entering a cell costs its value and cells not above 0 are walls
+// fills the empty `path` with the cell indices of the cheapest one, false if `end` is unreachable
+bool c11_array2d__find_path(c11_vector* path,
+                            const double* costs,
+                            int n_cols,
+                            int n_rows,
+                            int start,
+                            int end,
+                            bool moore);
 
 /* chunked_array2d */
-#define SMALLMAP_T__HEADER
+#define HASHMAP_T__HEADER
 #define K c11_vec2i
 #define V py_TValue*
 #define NAME c11_chunked_array2d_chunks
-#define less(a, b) (a._i64 < b._i64)
+#define hash(a) ((uint64_t)(a)._i64 * 0x9E3779B97F4A7C15ULL >> 32)
 #define equal(a, b) (a._i64 == b._i64)
-#include "pocketpy/xmacros/smallmap.h"
-#undef SMALLMAP_T__HEADER
+#include "pocketpy/xmacros/hashmap.h"
+#undef HASHMAP_T__HEADER
+
+// recently visited chunks, most recent first
+#define C11_CHUNKED_ARRAY2D_RECENT 4
 
 typedef struct c11_chunked_array2d {
     c11_chunked_array2d_chunks chunks;
     int chunk_size;
     int chunk_size_log2;
     int chunk_size_mask;
-    c11_chunked_array2d_chunks_KV last_visited;
+    c11_chunked_array2d_chunks_KV recent[C11_CHUNKED_ARRAY2D_RECENT];
 
     py_TValue default_T;
     py_TValue context_builder;
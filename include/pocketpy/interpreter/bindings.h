@@ -8,4 +8,9 @@ bool list_iterator__next__(int argc, py_Ref argv);
 bool tuple_iterator__next__(int argc, py_Ref argv);
 bool dict_items__next__(int argc, py_Ref argv);
 bool range_iterator__next__(int argc, py_Ref argv);
-bool str_iterator__next__(int argc, py_Ref argv);
\ No newline at end of file
+bool str_iterator__next__(int argc, py_Ref argv);
+bool map__next__(int argc, py_Ref argv);
+bool filter__next__(int argc, py_Ref argv);
+bool zip__next__(int argc, py_Ref argv);
+bool enumerate__next__(int argc, py_Ref argv);
+bool deque_iterator__next__(int argc, py_Ref argv);
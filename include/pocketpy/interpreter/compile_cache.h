@@ -0,0 +1,42 @@
+#pragma once
+
+#include "pocketpy/objects/base.h"
+#include "pocketpy/common/vector.h"
+#include "pocketpy/common/str.h"
+
+typedef struct CompileCacheEntry {
+    uint64_t hash;
+    c11_string* source;
+    c11_string* filename;
+    enum py_CompileMode mode;
+    bool is_dynamic;
+    uint64_t last_used;
+    py_TValue code;  // tp_code
+} CompileCacheEntry;
+
+/* A small LRU cache of compiled code objects, keyed by (source, filename, mode, is_dynamic).
+ * Entries are found by a linear scan over their hashes, which is cheap for the expected
+ * capacities and much cheaper than compiling. */
+typedef struct CompileCache {
+    c11_vector /*T=CompileCacheEntry*/ entries;
+    int capacity;
+    uint64_t tick;
+    py_i64 hits;
+    py_i64 misses;
+} CompileCache;
+
+void CompileCache__ctor(CompileCache* self, int capacity);
+void CompileCache__dtor(CompileCache* self);
+void CompileCache__clear(CompileCache* self);
+void CompileCache__set_capacity(CompileCache* self, int capacity);
+py_Ref CompileCache__get(CompileCache* self,
+                         const char* source,
+                         const char* filename,
+                         enum py_CompileMode mode,
+                         bool is_dynamic);
+void CompileCache__put(CompileCache* self,
+                       const char* source,
+                       const char* filename,
+                       enum py_CompileMode mode,
+                       bool is_dynamic,
+                       py_Ref code);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pocketpy/objects/formatspec.h"
+#include "pocketpy/common/sstream.h"
+#include "pocketpy/common/vector.h"
+#include "pocketpy/pocketpy.h"
+
+typedef struct FormatPiece {
+    int literal_start;  // unescaped text written before the field, in `FormatTemplate.text`
+    int literal_size;
+    int index;     // positional argument, -1 if `name` is used, -2 if there is no field
+    py_Name name;  // keyword argument
+    FormatSpec spec;
+} FormatPiece;
+
+// a parsed `str.format()` string
+typedef struct FormatTemplate {
+    uint64_t hash;
+    c11_string* source;
+    c11_string* text;
+    c11_vector /*T=FormatPiece*/ pieces;
+} FormatTemplate;
+
+/* A direct-mapped cache of parsed `str.format()` strings, indexed by their hashes.
+ * A template is taken out of its slot while it is in use, so recursive calls of
+ * `str.format()` from `__str__` never see a freed template. */
+typedef struct FormatCache {
+    FormatTemplate* slots[PK_FORMAT_CACHE_SIZE];
+} FormatCache;
+
+void FormatCache__ctor(FormatCache* self);
+void FormatCache__dtor(FormatCache* self);
+
+/// Formats `val` via `spec` and writes the result into `buf`.
+bool pk_format_object(c11_sbuf* buf, py_Ref val, const FormatSpec* spec);
+/// Writes `str(val)` into `buf`, without allocating for `int`, `float` and `str`.
+bool pk_write_str(c11_sbuf* buf, py_Ref val);
+/// `fmt.format(*args, **kwargs)`, `kwargs` can be NULL.
+bool pk_str_format(c11_sv fmt, int argc, py_Ref argv, py_Ref kwargs);
@@ -17,15 +17,6 @@ typedef struct ValueStack {
 void ValueStack__ctor(ValueStack* self);
 void ValueStack__dtor(ValueStack* self);
 
-typedef struct UnwindTarget {
-    struct UnwindTarget* next;
-    int iblock;
-    int offset;
-} UnwindTarget;
-
-UnwindTarget* UnwindTarget__new(UnwindTarget* next, int iblock, int offset);
-void UnwindTarget__delete(UnwindTarget* self);
-
 typedef struct py_Frame {
     struct py_Frame* f_back;
     const CodeObject* co;
@@ -35,7 +26,6 @@ typedef struct py_Frame {
     py_Ref locals;
     bool is_locals_special;
     int ip;
-    UnwindTarget* uw_list;
 } py_Frame;
 
 typedef struct SourceLocation {
@@ -62,9 +52,8 @@ py_Ref Frame__getclosure(py_Frame* self, py_Name name);
 py_StackRef Frame__getlocal_noproxy(py_Frame* self, py_Name name);
 
 int Frame__prepare_jump_exception_handler(py_Frame* self, ValueStack*);
-
-UnwindTarget* Frame__find_unwind_target(py_Frame* self, int iblock);
-void Frame__set_unwind_target(py_Frame* self, py_TValue* sp);
+// the stack pointer when this frame starts running, excluding its locals
+py_StackRef Frame__stack_base(py_Frame* self);
 
 void Frame__gc_mark(py_Frame* self, c11_vector* p_stack);
 SourceLocation Frame__source_location(py_Frame* self);
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "pocketpy/objects/object.h"
+
+// The frozen space is a process-wide arena of deeply immutable objects shared by all VMs.
+// Objects in it are allocated outside any `ManagedHeap` and have `gc_marked` permanently set,
+// so GC of every VM skips them without traversing their children.
+
+PyObject* FrozenSpace__new(py_Type type, int slots, int udsize);
+void pk_frozen_initialize();
+void pk_frozen_finalize();
+
+// frozendict
+py_Type pk_frozendict__register();
+void pk_newfrozendict(py_OutRef out, py_Ref dict);
@@ -18,10 +18,14 @@ void pk__add_module_pickle();
 void pk__add_module_base64();
 void pk__add_module_importlib();
 void pk__add_module_unicodedata();
+void pk__add_module_heapq();
+void pk__add_module_bisect();
+void pk__add_module_functools();
 
 void pk__add_module_vmath();
 void pk__add_module_array2d();
 void pk__add_module_colorcvt();
+void pk__add_module_collections();
 
 void pk__add_module_conio();
 void pk__add_module_lz4();
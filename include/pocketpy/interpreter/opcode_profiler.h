@@ -0,0 +1,25 @@
+#pragma once
+
+#include "pocketpy/common/vector.h"
+#include "pocketpy/objects/codeobject.h"
+
+typedef struct OpcodePairRecord {
+    uint8_t first;
+    uint8_t second;
+    py_i64 hits;
+} OpcodePairRecord;
+
+typedef struct OpcodeProfiler {
+    py_i64* hits;  // OP__COUNT__ * OP__COUNT__, lazily allocated
+    int prev_op;
+    bool enabled;
+} OpcodeProfiler;
+
+void OpcodeProfiler__ctor(OpcodeProfiler* self);
+void OpcodeProfiler__dtor(OpcodeProfiler* self);
+void OpcodeProfiler__begin(OpcodeProfiler* self);
+void OpcodeProfiler__end(OpcodeProfiler* self);
+void OpcodeProfiler__reset(OpcodeProfiler* self);
+void OpcodeProfiler__record(OpcodeProfiler* self, Opcode op);
+// get all executed pairs ordered by hits descending
+void OpcodeProfiler__get_records(OpcodeProfiler* self, c11_vector /*T=OpcodePairRecord*/* out);
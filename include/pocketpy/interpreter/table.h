@@ -0,0 +1,23 @@
+#pragma once
+
+#include "pocketpy/pocketpy.h"
+#include "pocketpy/interpreter/array2d.h"
+
+// one packed buffer per column, `width` cells of `dtype` per row
+typedef struct c11_table_column {
+    py_Name name;
+    c11_array2d_dtype dtype;  // float32 for vec2 columns, object holds `py_TValue` cells
+    int width;                // 2 for vec2 columns, 1 otherwise
+    void* data;
+} c11_table_column;
+
+typedef struct c11_table {
+    c11_table_column* columns;
+    int n_columns;
+    int length;
+    int capacity;
+    py_Type row_type;
+} c11_table;
+
+// `pkpy.Table` and `pkpy.TableRow`
+void pk_Table__register(py_Ref mod);
@@ -15,11 +15,13 @@ typedef struct py_TypeInfo {
 
     bool is_python;  // is it a python class? (not derived from c object)
     bool is_final;  // can it be subclassed?
+    bool is_method_like;  // do its instances bind to `self` like functions when found on a class?
 
     bool (*getattribute)(py_Ref self, py_Name name) PY_RAISE PY_RETURN;
     bool (*setattribute)(py_Ref self, py_Name name, py_Ref val) PY_RAISE PY_RETURN;
     bool (*delattribute)(py_Ref self, py_Name name) PY_RAISE;
     bool (*getunboundmethod)(py_Ref self, py_Name name) PY_RETURN;
+    bool (*getbuffer)(py_Ref self, py_Buffer* out) PY_RAISE;
 
     py_TValue annotations;
     py_Dtor dtor;  // destructor for this type, NULL if no dtor
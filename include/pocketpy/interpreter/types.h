@@ -20,5 +20,18 @@ typedef struct {
 
 typedef c11_vector List;
 
+void Dict__dtor(Dict* self);
+void Dict__copy(Dict* self, Dict* other);
+/// Look up `key`. `*out` is NULL if not found. Returns false on error.
+bool Dict__try_get(Dict* self, py_TValue* key, DictEntry** out);
+bool Dict__set(Dict* self, py_TValue* key, py_TValue* val);
+
 void c11_chunked_array2d__mark(void* ud, c11_vector* p_stack);
 void function__gc_mark(void* ud, c11_vector* p_stack);
+void dict__gc_mark(void* ud, c11_vector* p_stack);
+void c11_deque__dtor(void* ud);
+void c11_deque__mark(void* ud, c11_vector* p_stack);
+void lru_cache__dtor(void* ud);
+void lru_cache__gc_mark(void* ud, c11_vector* p_stack);
+void c11_table__dtor(void* ud);
+void c11_table__mark(void* ud, c11_vector* p_stack);
@@ -10,6 +10,9 @@
 #include "pocketpy/interpreter/frame.h"
 #include "pocketpy/interpreter/typeinfo.h"
 #include "pocketpy/interpreter/line_profiler.h"
+#include "pocketpy/interpreter/opcode_profiler.h"
+#include "pocketpy/interpreter/compile_cache.h"
+#include "pocketpy/interpreter/format.h"
 #include <time.h>
 
 // TODO:
@@ -54,6 +57,9 @@ typedef struct VM {
 
     py_TValue last_retval;
     py_TValue curr_exception;
+    py_TValue stop_iteration;  // cached `StopIteration` without value for internal iteration
+    py_Frame* next_frame;      // frame of the innermost `py_next()`, which consumes the cached one
+    bool is_in_next;
 
     int recursion_depth;
     int max_recursion_depth;
@@ -71,6 +77,10 @@ typedef struct VM {
     TraceInfo trace_info;
     WatchdogInfo watchdog_info;
     LineProfiler line_profiler;
+    OpcodeProfiler opcode_profiler;
+    CompileCache compile_cache;
+    FormatCache format_cache;
+    int optimize_level;
     py_TValue vectorcall_buffer[PK_MAX_CO_VARNAMES];
 
     FixedMemoryPool pool_frame;
@@ -113,12 +123,15 @@ const char* pk_opname(Opcode op);
 int pk_arrayview(py_Ref self, py_TValue** p);
 bool pk_wrapper__arrayequal(py_Type type, int argc, py_Ref argv);
 bool pk_arraycontains(py_Ref self, py_Ref val);
+bool pk_list__sort(py_Ref self, py_Ref key, bool reverse);
+/// `py_less()` with native paths for int, float, str and tuples of them.
+int pk_less(py_Ref lhs, py_Ref rhs);
 
 bool pk_loadmethod(py_StackRef self, py_Name name);
 bool pk_callmagic(py_Name name, int argc, py_Ref argv);
 
-bool pk_exec(CodeObject* co, py_Ref module);
-bool pk_execdyn(CodeObject* co, py_Ref module, py_Ref globals, py_Ref locals);
+bool pk_exec(py_Ref code, py_Ref module);
+bool pk_execdyn(py_Ref code, py_Ref module, py_Ref globals, py_Ref locals);
 
 /// Assumes [a, b] are on the stack, performs a binary op.
 /// The result is stored in `self->last_retval`.
@@ -133,6 +146,8 @@ void pk_number__register();
 py_Type pk_str__register();
 py_Type pk_str_iterator__register();
 py_Type pk_bytes__register();
+py_Type pk_bytearray__register();
+py_Type pk_memoryview__register();
 py_Type pk_dict__register();
 py_Type pk_dict_items__register();
 py_Type pk_list__register();
@@ -156,6 +171,10 @@ py_Type pk_classmethod__register();
 py_Type pk_generator__register();
 py_Type pk_namedict__register();
 py_Type pk_code__register();
+py_Type pk_map__register();
+py_Type pk_filter__register();
+py_Type pk_zip__register();
+py_Type pk_enumerate__register();
 
 py_GlobalRef pk_builtins__register();
 
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "pocketpy/pocketpy.h"
+
+// `vec2_array` or `vec3_array`, `length` vectors of `dim` floats packed after the userdata
+typedef struct c11_vec_array {
+    int dim;
+    int length;
+    float* data;
+} c11_vec_array;
+
+// zero-initialized, `dim` is 2 or 3
+c11_vec_array* c11_newvec_array(py_OutRef out, int dim, int length);
@@ -8,6 +8,7 @@
 #include "pocketpy/objects/base.h"
 #include "pocketpy/objects/sourcedata.h"
 #include "pocketpy/objects/namedict.h"
+#include "pocketpy/objects/formatspec.h"
 #include "pocketpy/pocketpy.h"
 
 #define BC_NOARG 0
@@ -43,6 +44,7 @@ typedef enum Opcode {
 #define OPCODE(name) OP_##name,
 #include "pocketpy/xmacros/opcodes.h"
 #undef OPCODE
+    OP__COUNT__,
 } Opcode;
 
 typedef struct Bytecode {
@@ -59,6 +61,7 @@ typedef struct CodeBlock {
     int start;   // start index of this block in codes, inclusive
     int end;     // end index of this block in codes, exclusive
     int end2;    // ...
+    int depth;   // stack values kept below this block, e.g. iterators of outer `for` loops
 } CodeBlock;
 
 typedef struct BytecodeEx {
@@ -66,13 +69,51 @@ typedef struct BytecodeEx {
     int iblock;       // block index
 } BytecodeEx;
 
+// 2-byte runtime instruction, args larger than 255 are prefixed by `EXTENDED_ARG`
+typedef struct CodeUnit {
+    uint8_t op;
+    uint8_t arg;
+} CodeUnit;
+
+typedef struct CodeBlockRange {
+    int start;   // first unit of this range
+    int iblock;  // block index of all units until the next range
+} CodeBlockRange;
+
+typedef struct CodeExceptionEntry {
+    int start;    // first unit covered by this entry, inclusive
+    int end;      // last unit covered by this entry, exclusive
+    int handler;  // unit to jump to when an exception is raised
+    int depth;    // number of stack values above the frame base kept by the handler
+} CodeExceptionEntry;
+
+typedef struct CodeLineCursor {
+    int offset;  // read offset in the line table
+    int unit;    // unit of the last applied entry
+    int lineno;  // line number of the last applied entry
+} CodeLineCursor;
+
+// values of an f-string with their parsed specs, see `OP_BUILD_FSTRING`
+typedef struct FStringLayout {
+    int count;          // number of values on the stack
+    FormatSpec* specs;  // one for each value
+} FStringLayout;
+
 typedef struct CodeObject {
     SourceData_ src;
     c11_string* name;
 
+    // compile-time instructions, released by `CodeObject__finalize()`
     c11_vector /*T=Bytecode*/ codes;
     c11_vector /*T=CodeObjectByteCodeEx*/ codes_ex;
 
+    // runtime encoding, built by `CodeObject__finalize()`
+    c11_vector /*T=CodeUnit*/ units;
+    c11_vector /*T=uint8_t*/ linetable;         // varint (unit delta, zigzag line delta) pairs
+    c11_vector /*T=CodeBlockRange*/ block_ranges;
+    c11_vector /*T=CodeExceptionEntry*/ exc_table;  // sorted, non-overlapping
+    CodeLineCursor line_cursor;                 // speeds up sequential line lookups
+
     c11_vector /*T=py_TValue*/ consts;  // constants
     c11_vector /*T=py_Name*/ varnames;  // local variables
     c11_vector /*T=py_Name*/ names;
@@ -83,6 +124,7 @@ typedef struct CodeObject {
 
     c11_vector /*T=CodeBlock*/ blocks;
     c11_vector /*T=FuncDecl_*/ func_decls;
+    c11_vector /*T=FStringLayout*/ fstrings;
 
     int start_line;
     int end_line;
@@ -93,6 +135,14 @@ void CodeObject__dtor(CodeObject* self);
 int CodeObject__add_varname(CodeObject* self, py_Name name);
 int CodeObject__add_name(CodeObject* self, py_Name name);
 void CodeObject__gc_mark(const CodeObject* self, c11_vector* p_stack);
+// encode `codes` and `codes_ex` into `units`, `linetable` and `block_ranges`, then release them
+void CodeObject__finalize(CodeObject* self);
+// decode the instruction starting at `ip`, returns the unit index of its opcode
+int CodeObject__decode(const CodeObject* self, int ip, Bytecode* out);
+int CodeObject__lineno(const CodeObject* self, int ip);
+int CodeObject__iblock(const CodeObject* self, int ip);
+// find the innermost `try` handler covering `ip`, returns NULL if there is none
+const CodeExceptionEntry* CodeObject__exception_entry(const CodeObject* self, int ip);
 
 typedef struct FuncDeclKwArg {
     int index;        // index in co->varnames
@@ -132,6 +182,7 @@ typedef struct Function {
     FuncDecl_ decl;
     py_GlobalRef module;    // maybe NULL, weak ref
     py_Ref globals;         // maybe NULL, strong ref
+    py_TValue globals_dict;  // `globals` points here if it is a dict
     NameDict* closure;      // maybe NULL, strong ref
     PyObject* clazz;        // weak ref; for super()
     py_CFunction cfunc;     // wrapped C function; for decl-based binding
@@ -9,4 +9,5 @@ typedef struct{
     char msg[512];
 } Error;
 
-void py_BaseException__stpush(py_Frame* frame, py_Ref, SourceData_ src, int lineno, const char* func_name);
+// push a traceback entry of `frame`, or of `src` and `lineno` if `frame` is NULL
+void py_BaseException__stpush(py_Frame* frame, py_Ref, SourceData_ src, int lineno);
@@ -3,10 +3,12 @@
 #include "pocketpy/objects/sourcedata.h"
 #include "pocketpy/objects/base.h"
 
+// a traceback entry is captured as (owner, ip) and resolved only when it is formatted
 typedef struct BaseExceptionFrame {
-    SourceData_ src;
-    int lineno;
-    c11_string* name;
+    py_TValue owner;    // a function or a code object, nil if `src` and `lineno` are given
+    int ip;             // instruction pointer in the code of `owner`
+    SourceData_ src;    // strong ref, only if `owner` is nil
+    int lineno;         // only if `owner` is nil
     py_TValue locals;   // for debugger only
     py_TValue globals;  // for debugger only
 } BaseExceptionFrame;
@@ -17,3 +19,10 @@ typedef struct BaseException {
     c11_vector /*T=BaseExceptionFrame*/ stacktrace;
 } BaseException;
 
+SourceData_ BaseExceptionFrame__src(const BaseExceptionFrame* self);
+int BaseExceptionFrame__lineno(const BaseExceptionFrame* self);
+// returns NULL for module-level code
+const char* BaseExceptionFrame__name(const BaseExceptionFrame* self);
+
+void BaseException__dtor(void* ud);
+void BaseException__gc_mark(BaseException* self, c11_vector* p_stack);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "pocketpy/common/str.h"
+
+/* A parsed format specifier of f-strings and `str.format()`.
+ * Specs are parsed once, by the compiler for f-strings and by the format cache for
+ * `str.format()`, so formatting a value never re-reads the spec string. */
+typedef struct FormatSpec {
+    const char* error;  // not NULL if the spec is invalid, raised as `ValueError` on use
+    char conversion;    // 'r' or 0
+    char fill;          // ' ' by default
+    char align;         // '<', '>', '^', or 0 to align numbers right and others left
+    char type;          // 'f', 'd', 's' or 0
+    int width;          // -1 if not specified
+    int precision;      // -1 if not specified
+} FormatSpec;
+
+// parse a spec like '!r:>10', ':.2f' or '.2f', the result has `error` set if it is invalid
+void FormatSpec__parse(FormatSpec* self, c11_sv spec);
+// true if the spec is empty, i.e. formatting is the same as `str()`
+bool FormatSpec__is_plain(const FormatSpec* self);
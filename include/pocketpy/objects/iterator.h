@@ -13,3 +13,14 @@ typedef struct list_iterator {
     c11_vector* vec;
     int index;
 } list_iterator;
+
+typedef struct Range {
+    py_i64 start;
+    py_i64 stop;
+    py_i64 step;
+} Range;
+
+typedef struct RangeIterator {
+    Range range;
+    py_i64 current;
+} RangeIterator;
@@ -5,8 +5,8 @@
 
 typedef struct PyObject {
     py_Type type;  // we have a duplicated type here for convenience
-    // bool _;
     bool gc_marked;
+    bool is_frozen;  // allocated in the frozen space, `gc_marked` is always true
     int slots;  // number of slots in the object
     char flex[];
 } PyObject;
@@ -90,6 +90,20 @@ typedef struct py_Callbacks {
     void (*gc_mark)(void (*f)(py_Ref val, void* ctx), void* ctx);
 } py_Callbacks;
 
+/// A contiguous block of memory exported by an object. See `py_getbuffer`.
+typedef struct py_Buffer {
+    /// Pointer to the first item.
+    void* data;
+    /// Size of the memory in bytes.
+    int size;
+    /// Size of one item in bytes.
+    int itemsize;
+    /// Item format in `struct` module notation: `'B'`, `'?'`, `'b'`, `'h'`, `'i'`, `'f'` or `'d'`.
+    char format;
+    /// Whether the memory must not be written.
+    bool readonly;
+} py_Buffer;
+
 /// Native function signature.
 /// @param argc number of arguments.
 /// @param argv array of arguments. Use `py_arg(i)` macro to get the i-th argument.
@@ -197,6 +211,20 @@ PK_API bool py_compile(const char* source,
                        const char* filename,
                        enum py_CompileMode mode,
                        bool is_dynamic) PY_RAISE PY_RETURN;
+/// Set the capacity of the compile cache of the current VM. Use `0` to disable it.
+/// Code objects compiled by `py_exec`, `py_eval`, `py_smartexec`, `py_smarteval` and
+/// `py_compile` are cached by `(source, filename, mode, is_dynamic)` and reused on a hit.
+/// The default capacity is `PK_COMPILE_CACHE_SIZE`.
+PK_API void py_compilecache_setcapacity(int capacity);
+/// Get the hit and miss counters of the compile cache of the current VM.
+PK_API void py_compilecache_stats(py_i64* hits, py_i64* misses);
+/// Set the optimization level of the bytecode optimizer of the current VM.
+/// `0` disables it, `1` enables jump threading, dead code removal and superinstructions,
+/// `2` also enables constant folding. The default level is `PK_OPTIMIZE_LEVEL`.
+/// The compile cache is cleared if the level is changed.
+PK_API void py_setoptimizelevel(int level);
+/// Get the optimization level of the bytecode optimizer of the current VM.
+PK_API int py_getoptimizelevel();
 
 /// Python equivalent to `globals()`.
 PK_API void py_newglobals(py_OutRef);
@@ -232,6 +260,8 @@ PK_API void py_newstrv(py_OutRef, c11_sv);
 PK_API void py_newfstr(py_OutRef, const char*, ...);
 /// Create a `bytes` object with `n` UNINITIALIZED bytes.
 PK_API unsigned char* py_newbytes(py_OutRef, int n);
+/// Create a `bytearray` object with `n` zero-initialized bytes.
+PK_API unsigned char* py_newbytearray(py_OutRef, int n);
 /// Create a `None` object.
 PK_API void py_newnone(py_OutRef);
 /// Create a `NotImplemented` object.
@@ -325,6 +355,11 @@ PK_API c11_sv py_tosv(py_Ref);
 PK_API unsigned char* py_tobytes(py_Ref, int* size);
 /// Resize a `bytes` object. It can only be resized down.
 PK_API void py_bytes_resize(py_Ref, int size);
+/// Get the memory of an object that exports a buffer without copying it,
+/// e.g. `bytes`, `bytearray`, `memoryview`, typed `array2d`, `vec2_array` or `vec3_array`.
+/// The memory is valid until the object is resized or collected.
+/// Raise `TypeError` if the object has no buffer, or if `writable` is true and it is readonly.
+PK_API bool py_getbuffer(py_Ref, py_Buffer* out, bool writable) PY_RAISE;
 /// Convert a user-defined object to its userdata.
 PK_API void* py_touserdata(py_Ref);
 
@@ -378,6 +413,8 @@ PK_API void py_tphookattributes(py_Type type,
                                     PY_RAISE PY_RETURN,
                                 bool (*delattribute)(py_Ref self, py_Name name) PY_RAISE,
                                 bool (*getunboundmethod)(py_Ref self, py_Name name) PY_RETURN);
+/// Set the buffer hook for the given type. It is also used by subclasses. See `py_getbuffer`.
+PK_API void py_tphookbuffer(py_Type type, bool (*getbuffer)(py_Ref self, py_Buffer* out) PY_RAISE);
 
 /// Check if the object is an instance of the given type exactly.
 /// Raise `TypeError` if the check fails.
@@ -701,12 +738,38 @@ PK_API bool py_pickle_dumps(py_Ref val) PY_RAISE PY_RETURN;
 /// Python equivalent to `pickle.loads(val)`.
 PK_API bool py_pickle_loads(const unsigned char* data, int size) PY_RAISE PY_RETURN;
 
+/************* Frozen Objects *************/
+
+/// Create a deeply immutable copy of `val` in the frozen space, which is shared by all VMs.
+/// Supports `None`, `bool`, `int`, `float`, `str`, `bytes`, `tuple`, `list` and `dict`.
+/// `list` is frozen as `tuple` and `dict` is frozen as `frozendict`.
+/// Frozen objects are never collected by GC and live until `py_finalize()`.
+PK_API bool py_freeze(py_Ref val) PY_RAISE PY_RETURN;
+/// Check if the object lives in the frozen space.
+PK_API bool py_isfrozen(py_Ref val);
+/// Freeze `val` and publish it under `key`. It can be retrieved from any VM via `py_getfrozen`.
+PK_API bool py_setfrozen(const char* key, py_Ref val) PY_RAISE PY_RETURN;
+/// Get a published frozen object by `key`. Return `NULL` if not found.
+/// The reference stays valid until the frozen space is finalized.
+PK_API py_GlobalRef py_getfrozen(const char* key);
+
 /************* Profiler *************/
 PK_API void py_profiler_begin();
 PK_API void py_profiler_end();
 PK_API void py_profiler_reset();
 PK_API char* py_profiler_report();
 
+/// Begin counting consecutive opcode pairs executed by the current VM.
+/// `PK_ENABLE_OPCODE_PROFILER` must be defined to `1` to use this feature.
+PK_API void py_opcodeprofiler_begin();
+/// Stop counting opcode pairs.
+PK_API void py_opcodeprofiler_end();
+/// Clear all counted opcode pairs.
+PK_API void py_opcodeprofiler_reset();
+/// Dump the counted opcode pairs ordered by frequency, one `FIRST SECOND hits` per line.
+/// The result should be freed by the caller.
+PK_API char* py_opcodeprofiler_report();
+
 /************* DAP *************/
 #if PK_ENABLE_OS
 PK_API void py_debugger_waitforattach(const char* hostname, unsigned short port);
@@ -775,8 +838,11 @@ PK_API py_i64 py_Random_randint(py_Ref self, py_i64 a, py_i64 b);
 PK_API void py_newarray2d(py_OutRef out, int width, int height);
 PK_API int py_array2d_getwidth(py_Ref self);
 PK_API int py_array2d_getheight(py_Ref self);
+/// Get the cell at `(x, y)`. For an untyped array this is the cell itself.
+/// For a typed array it is a boxed copy, valid until the next access to the array.
 PK_API py_ObjectRef py_array2d_getitem(py_Ref self, int x, int y);
-PK_API void py_array2d_setitem(py_Ref self, int x, int y, py_Ref val);
+/// Set the cell at `(x, y)`. Raise if `val` does not fit the array's dtype.
+PK_API bool py_array2d_setitem(py_Ref self, int x, int y, py_Ref val) PY_RAISE;
 
 /************* vmath module *************/
 PK_API void py_newvec2(py_OutRef out, c11_vec2);
@@ -833,6 +899,8 @@ enum py_PredefinedType {
     tp_BaseException,
     tp_Exception,
     tp_bytes,
+    tp_bytearray,    // c11_vector
+    tp_memoryview,   // 1 slot (the exporting object)
     tp_namedict,
     tp_locals,
     tp_code,
@@ -873,12 +941,24 @@ enum py_PredefinedType {
     tp_vec3i,
     tp_mat3x3,
     tp_color32,
+    tp_vec2_array,
+    tp_vec3_array,
     /* array2d */
     tp_array2d_like,
     tp_array2d_like_iterator,
     tp_array2d,
     tp_array2d_view,
     tp_chunked_array2d,
+    /* frozen */
+    tp_frozendict,  // Dict
+    /* builtin iterators */
+    tp_map,        // 1 + N slots (func, *iterators)
+    tp_filter,     // 2 slots (func, iterator)
+    tp_zip,        // N slots
+    tp_enumerate,  // 1 slot
+    /* collections */
+    tp_deque,
+    tp_deque_iterator,  // 1 slot (deque)
 };
 
 #ifdef __cplusplus
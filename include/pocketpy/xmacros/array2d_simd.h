@@ -0,0 +1,304 @@
+/* Kernels of typed array2d for one instruction set, see array2d_kernels.c */
+
+/* Input: NAME, TARGET and the vector macros undefined at the end */
+#ifndef NAME
+#error "NAME is not defined"
+#endif
+
+#ifndef TARGET
+#define TARGET
+#endif
+
+/* Temporary macros */
+#define CONCAT(A, B) CONCAT_(A, B)
+#define CONCAT_(A, B) A##B
+#define METHOD(name) CONCAT(c11_array2d_simd_, CONCAT(NAME, CONCAT(__, name)))
+#define STRINGIFY(x) STRINGIFY_(x)
+#define STRINGIFY_(x) #x
+
+TARGET static void METHOD(add_u8)(uint8_t* restrict dst, const uint8_t* restrict src, int n) {
+    int i = 0;
+    for(; i + U8_LANES <= n; i += U8_LANES) {
+        U8_STORE(dst + i, U8_ADD(U8_LOAD(dst + i), U8_LOAD(src + i)));
+    }
+    for(; i < n; i++)
+        dst[i] += src[i];
+}
+
+#define DEF_BITWISE_U8(name, OP, op)                                                               \
+    TARGET static void METHOD(name)(uint8_t* restrict out,                                         \
+                                    const uint8_t* restrict a,                                     \
+                                    const uint8_t* restrict b,                                     \
+                                    int n) {                                                       \
+        int i = 0;                                                                                 \
+        for(; i + U8_LANES <= n; i += U8_LANES) {                                                  \
+            U8_STORE(out + i, OP(U8_LOAD(a + i), U8_LOAD(b + i)));                                 \
+        }                                                                                          \
+        for(; i < n; i++)                                                                          \
+            out[i] = a[i] op b[i];                                                                 \
+    }
+
+DEF_BITWISE_U8(and_u8, U8_AND, &)
+DEF_BITWISE_U8(or_u8, U8_OR, |)
+DEF_BITWISE_U8(xor_u8, U8_XOR, ^)
+
+#undef DEF_BITWISE_U8
+
+TARGET static void METHOD(widen_u8_i32)(int32_t* restrict out, const uint8_t* restrict src, int n) {
+    int i = 0;
+    for(; i + U8_WIDEN_BLOCK <= n; i += U8_WIDEN_BLOCK) {
+        U8_WIDEN_STORE(out + i, src + i);
+    }
+    for(; i < n; i++)
+        out[i] = src[i];
+}
+
+TARGET static void
+    METHOD(eq_u8)(bool* restrict out, const uint8_t* restrict a, uint8_t value, int n) {
+    VEC_U8 v = U8_SET1(value);
+    VEC_U8 one = U8_SET1(1);
+    int i = 0;
+    for(; i + U8_LANES <= n; i += U8_LANES) {
+        U8_STORE((uint8_t*)out + i, U8_AND(U8_EQ(U8_LOAD(a + i), v), one));
+    }
+    for(; i < n; i++)
+        out[i] = a[i] == value;
+}
+
+TARGET static void
+    METHOD(eq_i32)(bool* restrict out, const int32_t* restrict a, int32_t value, int n) {
+    VEC_I32 v = I32_SET1(value);
+    int i = 0;
+    for(; i + I32_EQ_BLOCK <= n; i += I32_EQ_BLOCK) {
+        I32_EQ_STORE((uint8_t*)out + i, a + i, v);
+    }
+    for(; i < n; i++)
+        out[i] = a[i] == value;
+}
+
+TARGET static int METHOD(count_u8)(const uint8_t* restrict a, uint8_t value, int n) {
+    VEC_U8 v = U8_SET1(value);
+    int count = 0;
+    int i = 0;
+    while(i + U8_LANES <= n) {
+        // each lane counts up to 255 matches before it is flushed
+        VEC_U8 acc = U8_SET1(0);
+        for(int k = 0; k < 255 && i + U8_LANES <= n; k++, i += U8_LANES) {
+            acc = U8_SUB(acc, U8_EQ(U8_LOAD(a + i), v));
+        }
+        count += U8_HSUM(acc);
+    }
+    for(; i < n; i++)
+        count += a[i] == value;
+    return count;
+}
+
+TARGET static int METHOD(count_i32)(const int32_t* restrict a, int32_t value, int n) {
+    VEC_I32 v = I32_SET1(value);
+    VEC_I32 acc = I32_SET1(0);
+    int i = 0;
+    for(; i + I32_LANES <= n; i += I32_LANES) {
+        acc = I32_SUB(acc, I32_EQ(I32_LOAD(a + i), v));
+    }
+    int32_t lanes[I32_LANES];
+    I32_STORE(lanes, acc);
+    int count = 0;
+    for(int k = 0; k < I32_LANES; k++)
+        count += lanes[k];
+    for(; i < n; i++)
+        count += a[i] == value;
+    return count;
+}
+
+TARGET static int64_t METHOD(sum_i32)(const int32_t* restrict a, int n) {
+    VEC_I64 acc = I64_ZERO();
+    int i = 0;
+    for(; i + I32_LANES <= n; i += I32_LANES) {
+        acc = I64_ADD_I32(acc, I32_LOAD(a + i));
+    }
+    int64_t lanes[I64_LANES];
+    I64_STORE(lanes, acc);
+    int64_t sum = 0;
+    for(int k = 0; k < I64_LANES; k++)
+        sum += lanes[k];
+    for(; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+#define DEF_MINMAX_I32(name, OP, op)                                                               \
+    TARGET static int32_t METHOD(name)(const int32_t* restrict a, int n) {                         \
+        int32_t res = a[0];                                                                        \
+        int i = 0;                                                                                 \
+        if(n >= I32_LANES) {                                                                       \
+            VEC_I32 acc = I32_LOAD(a);                                                             \
+            for(i = I32_LANES; i + I32_LANES <= n; i += I32_LANES) {                               \
+                acc = OP(acc, I32_LOAD(a + i));                                                    \
+            }                                                                                      \
+            int32_t lanes[I32_LANES];                                                              \
+            I32_STORE(lanes, acc);                                                                 \
+            for(int k = 0; k < I32_LANES; k++)                                                     \
+                res = op(res, lanes[k]);                                                           \
+        }                                                                                          \
+        for(; i < n; i++)                                                                          \
+            res = op(res, a[i]);                                                                   \
+        return res;                                                                                \
+    }
+
+DEF_MINMAX_I32(min_i32, I32_MIN, c11__min)
+DEF_MINMAX_I32(max_i32, I32_MAX, c11__max)
+
+#undef DEF_MINMAX_I32
+
+TARGET static double METHOD(sum_f32)(const float* restrict a, int n) {
+    VEC_F64 acc = F64_SET1(0.0);
+    int i = 0;
+    for(; i + F32_LANES <= n; i += F32_LANES) {
+        acc = F64_ADD_F32(acc, F32_LOAD(a + i));
+    }
+    double lanes[F64_LANES];
+    F64_STORE(lanes, acc);
+    double sum = 0.0;
+    for(int k = 0; k < F64_LANES; k++)
+        sum += lanes[k];
+    for(; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+TARGET static double METHOD(sum_f64)(const double* restrict a, int n) {
+    VEC_F64 acc = F64_SET1(0.0);
+    int i = 0;
+    for(; i + F64_LANES <= n; i += F64_LANES) {
+        acc = F64_ADD(acc, F64_LOAD(a + i));
+    }
+    double lanes[F64_LANES];
+    F64_STORE(lanes, acc);
+    double sum = 0.0;
+    for(int k = 0; k < F64_LANES; k++)
+        sum += lanes[k];
+    for(; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+// NaN wins over every other value
+#define DEF_MINMAX_F(name, T, W, PREFIX, OP, op)                                                   \
+    TARGET static T METHOD(name)(const T* restrict a, int n) {                                     \
+        T res = a[0];                                                                              \
+        bool nan = false;                                                                          \
+        int i = 0;                                                                                 \
+        if(n >= W) {                                                                               \
+            CONCAT(VEC_, PREFIX) acc = CONCAT(PREFIX, _LOAD)(a);                                   \
+            CONCAT(VEC_, PREFIX) unord = CONCAT(PREFIX, _SET1)(0);                                 \
+            for(i = 0; i + W <= n; i += W) {                                                       \
+                CONCAT(VEC_, PREFIX) x = CONCAT(PREFIX, _LOAD)(a + i);                             \
+                acc = OP(acc, x);                                                                  \
+                unord = CONCAT(PREFIX, _OR_UNORD)(unord, x);                                       \
+            }                                                                                      \
+            nan = CONCAT(PREFIX, _ANY)(unord);                                                     \
+            T lanes[W];                                                                            \
+            CONCAT(PREFIX, _STORE)(lanes, acc);                                                    \
+            for(int k = 0; k < W; k++)                                                             \
+                res = op(res, lanes[k]);                                                           \
+        }                                                                                          \
+        for(; i < n; i++) {                                                                        \
+            nan |= a[i] != a[i];                                                                   \
+            res = op(res, a[i]);                                                                   \
+        }                                                                                          \
+        return nan ? (T)NAN : res;                                                                 \
+    }
+
+DEF_MINMAX_F(min_f32, float, F32_LANES, F32, F32_MIN, c11__min)
+DEF_MINMAX_F(max_f32, float, F32_LANES, F32, F32_MAX, c11__max)
+DEF_MINMAX_F(min_f64, double, F64_LANES, F64, F64_MIN, c11__min)
+DEF_MINMAX_F(max_f64, double, F64_LANES, F64, F64_MAX, c11__max)
+
+#undef DEF_MINMAX_F
+
+static const c11_array2d_simd CONCAT(c11_array2d_simd_, NAME) = {
+    .name = STRINGIFY(NAME),
+    .add_u8 = METHOD(add_u8),
+    .and_u8 = METHOD(and_u8),
+    .or_u8 = METHOD(or_u8),
+    .xor_u8 = METHOD(xor_u8),
+    .widen_u8_i32 = METHOD(widen_u8_i32),
+    .eq_u8 = METHOD(eq_u8),
+    .eq_i32 = METHOD(eq_i32),
+    .count_u8 = METHOD(count_u8),
+    .count_i32 = METHOD(count_i32),
+    .sum_i32 = METHOD(sum_i32),
+    .min_i32 = METHOD(min_i32),
+    .max_i32 = METHOD(max_i32),
+    .sum_f32 = METHOD(sum_f32),
+    .min_f32 = METHOD(min_f32),
+    .max_f32 = METHOD(max_f32),
+    .sum_f64 = METHOD(sum_f64),
+    .min_f64 = METHOD(min_f64),
+    .max_f64 = METHOD(max_f64),
+};
+
+/* Undefine all macros */
+#undef METHOD
+#undef CONCAT
+#undef CONCAT_
+#undef STRINGIFY
+#undef STRINGIFY_
+
+#undef NAME
+#undef TARGET
+
+#undef VEC_U8
+#undef U8_LANES
+#undef U8_LOAD
+#undef U8_STORE
+#undef U8_SET1
+#undef U8_ADD
+#undef U8_SUB
+#undef U8_AND
+#undef U8_OR
+#undef U8_XOR
+#undef U8_EQ
+#undef U8_HSUM
+#undef U8_WIDEN_BLOCK
+#undef U8_WIDEN_STORE
+
+#undef VEC_I32
+#undef I32_LANES
+#undef I32_LOAD
+#undef I32_STORE
+#undef I32_SET1
+#undef I32_SUB
+#undef I32_EQ
+#undef I32_MIN
+#undef I32_MAX
+#undef I32_EQ_BLOCK
+#undef I32_EQ_STORE
+
+#undef VEC_I64
+#undef I64_LANES
+#undef I64_ZERO
+#undef I64_ADD_I32
+#undef I64_STORE
+
+#undef VEC_F32
+#undef F32_LANES
+#undef F32_LOAD
+#undef F32_STORE
+#undef F32_SET1
+#undef F32_MIN
+#undef F32_MAX
+#undef F32_OR_UNORD
+#undef F32_ANY
+
+#undef VEC_F64
+#undef F64_LANES
+#undef F64_LOAD
+#undef F64_STORE
+#undef F64_SET1
+#undef F64_ADD
+#undef F64_MIN
+#undef F64_MAX
+#undef F64_OR_UNORD
+#undef F64_ANY
+#undef F64_ADD_F32
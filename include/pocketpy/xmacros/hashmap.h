@@ -0,0 +1,168 @@
+#if !defined(HASHMAP_T__HEADER) && !defined(HASHMAP_T__SOURCE)
+#include "pocketpy/common/vector.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/config.h"
+#include <stdint.h>
+
+#define HASHMAP_T__HEADER
+#define HASHMAP_T__SOURCE
+/* Input */
+#define K int
+#define V float
+#define NAME c11_hashmap_d2f
+#endif
+
+/* Optional Input */
+#ifndef hash
+#define hash(a) ((uint64_t)(a))
+#endif
+
+#ifndef equal
+#define equal(a, b) ((a) == (b))
+#endif
+
+/* Temporary macros */
+#define CONCAT(A, B) CONCAT_(A, B)
+#define CONCAT_(A, B) A##B
+
+#define KV CONCAT(NAME, _KV)
+#define METHOD(name) CONCAT(NAME, CONCAT(__, name))
+
+#ifdef HASHMAP_T__HEADER
+/* Declaration */
+typedef struct {
+    K key;
+    V value;
+} KV;
+
+// entries are dense for iteration, removal moves the last entry into the hole
+// slots are linear probed indices into `entries`, -1 if empty
+typedef struct {
+    c11_vector /*T=KV*/ entries;
+    int* slots;
+    int capacity;  // power of 2
+} NAME;
+
+void METHOD(ctor)(NAME* self);
+void METHOD(dtor)(NAME* self);
+void METHOD(set)(NAME* self, K key, V value);
+V* METHOD(try_get)(const NAME* self, K key);
+V METHOD(get)(const NAME* self, K key, V default_value);
+bool METHOD(contains)(const NAME* self, K key);
+bool METHOD(del)(NAME* self, K key);
+void METHOD(clear)(NAME* self);
+
+#endif
+
+#ifdef HASHMAP_T__SOURCE
+/* Implementation */
+
+// slot of `key`, or the empty slot where it would go
+static int METHOD(find_slot)(const NAME* self, K key) {
+    int mask = self->capacity - 1;
+    int slot = (int)(hash(key) & mask);
+    while(self->slots[slot] != -1) {
+        KV* it = c11__at(KV, &self->entries, self->slots[slot]);
+        if(equal(it->key, key)) return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static void METHOD(rehash)(NAME* self, int capacity) {
+    PK_FREE(self->slots);
+    self->capacity = capacity;
+    self->slots = PK_MALLOC(sizeof(int) * capacity);
+    memset(self->slots, -1, sizeof(int) * capacity);
+    for(int i = 0; i < self->entries.length; i++) {
+        KV* it = c11__at(KV, &self->entries, i);
+        self->slots[METHOD(find_slot)(self, it->key)] = i;
+    }
+}
+
+void METHOD(ctor)(NAME* self) {
+    c11_vector__ctor(&self->entries, sizeof(KV));
+    self->slots = NULL;
+    METHOD(rehash)(self, 8);
+}
+
+void METHOD(dtor)(NAME* self) {
+    c11_vector__dtor(&self->entries);
+    PK_FREE(self->slots);
+}
+
+void METHOD(set)(NAME* self, K key, V value) {
+    int slot = METHOD(find_slot)(self, key);
+    if(self->slots[slot] != -1) {
+        c11__at(KV, &self->entries, self->slots[slot])->value = value;
+        return;
+    }
+    KV kv = {key, value};
+    c11_vector__push(KV, &self->entries, kv);
+    self->slots[slot] = self->entries.length - 1;
+    // keep the load factor below 3/4
+    if(self->entries.length * 4 > self->capacity * 3) {
+        METHOD(rehash)(self, self->capacity * 2);
+    }
+}
+
+V* METHOD(try_get)(const NAME* self, K key) {
+    int slot = METHOD(find_slot)(self, key);
+    if(self->slots[slot] == -1) return NULL;
+    return &c11__at(KV, &self->entries, self->slots[slot])->value;
+}
+
+V METHOD(get)(const NAME* self, K key, V default_value) {
+    V* p = METHOD(try_get)(self, key);
+    return p ? *p : default_value;
+}
+
+bool METHOD(contains)(const NAME* self, K key) { return METHOD(try_get)(self, key) != NULL; }
+
+bool METHOD(del)(NAME* self, K key) {
+    int slot = METHOD(find_slot)(self, key);
+    int index = self->slots[slot];
+    if(index == -1) return false;
+    // shift back the following slots of the probe run, so lookups need no tombstones
+    int mask = self->capacity - 1;
+    int hole = slot;
+    int next = (hole + 1) & mask;
+    while(self->slots[next] != -1) {
+        KV* it = c11__at(KV, &self->entries, self->slots[next]);
+        int home = (int)(hash(it->key) & mask);
+        // move it unless its home lies cyclically in (hole, next]
+        if(((next - home) & mask) >= ((next - hole) & mask)) {
+            self->slots[hole] = self->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    self->slots[hole] = -1;
+    int last = self->entries.length - 1;
+    if(index != last) {
+        KV moved = c11__getitem(KV, &self->entries, last);
+        self->slots[METHOD(find_slot)(self, moved.key)] = index;
+        c11__setitem(KV, &self->entries, index, moved);
+    }
+    c11_vector__pop(&self->entries);
+    return true;
+}
+
+void METHOD(clear)(NAME* self) {
+    c11_vector__clear(&self->entries);
+    memset(self->slots, -1, sizeof(int) * self->capacity);
+}
+
+#endif
+
+/* Undefine all macros */
+#undef KV
+#undef METHOD
+#undef CONCAT
+#undef CONCAT_
+
+#undef K
+#undef V
+#undef NAME
+#undef equal
+#undef hash
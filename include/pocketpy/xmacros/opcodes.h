@@ -2,6 +2,7 @@
 
 /**************************/
 OPCODE(NO_OP)
+OPCODE(EXTENDED_ARG)
 /**************************/
 OPCODE(POP_TOP)
 OPCODE(DUP_TOP)
@@ -116,7 +117,6 @@ OPCODE(ADD_CLASS_ANNOTATION)
 OPCODE(WITH_ENTER)
 OPCODE(WITH_EXIT)
 /**************************/
-OPCODE(TRY_ENTER)
 OPCODE(EXCEPTION_MATCH)
 OPCODE(RAISE)
 OPCODE(RAISE_ASSERT)
@@ -127,6 +127,17 @@ OPCODE(END_EXC_HANDLING)
 OPCODE(BEGIN_FINALLY)
 OPCODE(END_FINALLY)
 /**************************/
-OPCODE(FORMAT_STRING)
+OPCODE(BUILD_FSTRING)
+/**************************/
+// superinstructions, emitted by `pk_optimize()`
+OPCODE(LOAD_FAST_LOAD_FAST)
+OPCODE(LOAD_FAST_LOAD_ATTR)
+OPCODE(INC_FAST)
+OPCODE(COMPARE_LT_JUMP_IF_FALSE)
+OPCODE(COMPARE_LE_JUMP_IF_FALSE)
+OPCODE(COMPARE_EQ_JUMP_IF_FALSE)
+OPCODE(COMPARE_NE_JUMP_IF_FALSE)
+OPCODE(COMPARE_GT_JUMP_IF_FALSE)
+OPCODE(COMPARE_GE_JUMP_IF_FALSE)
 /**************************/
 #endif
@@ -2,6 +2,7 @@ from typing import Callable, Literal, overload, Iterator, Self
 from vmath import vec2i
 
 Neighborhood = Literal['Moore', 'von Neumann']
+DType = Literal['object', 'bool', 'int8', 'int16', 'int32', 'float32', 'float64']
 
 class array2d_like[T]:
     @property
@@ -43,6 +44,7 @@ class array2d_like[T]:
     def apply(self, f: Callable[[T], T]) -> None: ...
     def zip_with[R, U](self, other: array2d_like[U], f: Callable[[T, U], R]) -> array2d[R]: ...
     def copy(self) -> 'array2d[T]': ...
+    def astype(self, dtype: DType | None) -> 'array2d': ...
     def tolist(self) -> list[list[T]]: ...
 
     def __le__(self, other: T | array2d_like[T]) -> array2d[bool]: ...
@@ -93,6 +95,15 @@ class array2d_like[T]:
     def count(self, value: T) -> int:
         """Count the number of cells with the given value."""
 
+    def sum(self) -> T:
+        """Sum of all cells, starting from the first cell. Bool cells are summed as ints."""
+
+    def min(self) -> T:
+        """Smallest cell, or raise `ValueError` if the array is empty."""
+
+    def max(self) -> T:
+        """Largest cell, or raise `ValueError` if the array is empty."""
+
     def count_neighbors(self, value: T, neighborhood: Neighborhood) -> array2d[int]:
         """Count the number of neighbors with the given value for each cell."""
 
@@ -112,6 +123,29 @@ class array2d_like[T]:
         where `0` means unvisited, and non-zero means the index of the connected component.
         """
 
+    def connected_components(self, value: T, neighborhood: Neighborhood = 'von Neumann') -> tuple[array2d[int], int]:
+        """Same as `get_connected_components`, with `'von Neumann'` as the default neighborhood."""
+
+    def flood_fill(self, pos: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann') -> int:
+        """Set the cells connected to `pos` that equal `self[pos]` to `value`.
+
+        Returns the number of cells set.
+        """
+
+    def distance_transform(self, value: T, neighborhood: Neighborhood = 'von Neumann') -> array2d[int]:
+        """Number of steps from each cell to the nearest cell equal to `value`.
+
+        Steps are Manhattan distances for `'von Neumann'` and Chebyshev distances for `'Moore'`.
+        Cells are `-1` if no cell equals `value`.
+        """
+
+    def find_path(self, start: vec2i, end: vec2i, neighborhood: Neighborhood = 'von Neumann') -> list[vec2i] | None:
+        """Find the cheapest path from `start` to `end` with A*, where `self` holds the costs.
+
+        Entering a cell costs its value, and cells that are not positive are walls.
+        Returns the cells of the path including `start` and `end`, or `None` if `end` is unreachable.
+        """
+
 
 class array2d_view[T](array2d_like[T]):
     @property
@@ -123,11 +157,15 @@ class array2d[T](array2d_like[T]):
             cls,
             n_cols: int,
             n_rows: int,
-            default: T | Callable[[vec2i], T] | None = None
+            default: T | Callable[[vec2i], T] | None = None,
+            dtype: DType | None = None
             ): ...
 
+    @property
+    def dtype(self) -> DType: ...
+
     @staticmethod
-    def fromlist(data: list[list[T]]) -> array2d[T]: ...
+    def fromlist(data: list[list[T]], dtype: DType | None = None) -> array2d[T]: ...
 
 
 class chunked_array2d[T, TContext]:
@@ -166,3 +204,23 @@ class chunked_array2d[T, TContext]:
     def view_rect(self, pos: vec2i, width: int, height: int) -> array2d_view[T]: ...
     def view_chunk(self, chunk_pos: vec2i) -> array2d_view[T]: ...
     def view_chunks(self, chunk_pos: vec2i, width: int, height: int) -> array2d_view[T]: ...
+
+    def save_chunks(self, chunk_pos: vec2i, width: int = 1, height: int = 1, compress: bool = False) -> bytes:
+        """Serializes the existing chunks in the chunk rectangle, without their contexts.
+
+        Cells must be `None`, `bool`, `int`, `float` or `str`. `compress=True` requires the `lz4` module.
+        """
+    def load_chunks(self, data: bytes) -> list[vec2i]:
+        """Loads chunks saved by `save_chunks` and returns their positions.
+
+        Existing chunks are overwritten and keep their context, new chunks call `context_builder`.
+        """
+
+
+def set_parallel(num_threads: int, min_cells: int = 65536) -> None:
+    """Split native kernels of typed arrays across `num_threads` threads, including the caller.
+
+    `1` runs them on the calling thread. Each thread takes at least `min_cells` cells.
+    """
+def get_parallel() -> tuple[int, int]:
+    """Returns `(num_threads, min_cells)`."""
@@ -0,0 +1,9 @@
+from typing import Callable, Any
+
+def bisect_left[T](a: list[T], x: Any, lo: int = 0, hi: int | None = None, key: Callable[[T], Any] | None = None) -> int: ...
+def bisect_right[T](a: list[T], x: Any, lo: int = 0, hi: int | None = None, key: Callable[[T], Any] | None = None) -> int: ...
+def insort_left[T](a: list[T], x: T, lo: int = 0, hi: int | None = None, key: Callable[[T], Any] | None = None) -> None: ...
+def insort_right[T](a: list[T], x: T, lo: int = 0, hi: int | None = None, key: Callable[[T], Any] | None = None) -> None: ...
+
+bisect = bisect_right
+insort = insort_right
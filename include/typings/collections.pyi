@@ -0,0 +1,55 @@
+from typing import Iterable, Iterator, Callable, Self
+
+class deque[T]:
+    """A double-ended queue stored as a list of fixed-size blocks."""
+
+    def __new__(cls, iterable: Iterable[T] | None = None, maxlen: int | None = None) -> Self: ...
+
+    @property
+    def maxlen(self) -> int | None: ...
+
+    def append(self, x: T) -> None: ...
+    def appendleft(self, x: T) -> None: ...
+    def pop(self) -> T: ...
+    def popleft(self) -> T: ...
+    def extend(self, iterable: Iterable[T]) -> None: ...
+    def extendleft(self, iterable: Iterable[T]) -> None: ...
+    def clear(self) -> None: ...
+    def copy(self) -> 'deque[T]': ...
+    def count(self, x: T) -> int: ...
+    def index(self, x: T, start: int | None = None, stop: int | None = None) -> int: ...
+    def insert(self, i: int, x: T) -> None: ...
+    def remove(self, x: T) -> None: ...
+    def reverse(self) -> None: ...
+    def rotate(self, n: int = 1) -> None: ...
+
+    def __len__(self) -> int: ...
+    def __iter__(self) -> Iterator[T]: ...
+    def __contains__(self, x: object) -> bool: ...
+    def __getitem__(self, i: int) -> T: ...
+    def __setitem__(self, i: int, x: T) -> None: ...
+    def __delitem__(self, i: int) -> None: ...
+
+
+class defaultdict[K, V](dict[K, V]):
+    default_factory: Callable[[], V] | None
+
+    def __init__(self, default_factory: Callable[[], V] | None = None, iterable=None) -> None: ...
+    def __missing__(self, key: K) -> V: ...
+    def copy(self) -> 'defaultdict[K, V]': ...
+
+
+class Counter[T](dict[T, int]):
+    def __init__(self, iterable: Iterable[T] | dict[T, int] | None = None) -> None: ...
+    def __missing__(self, key: T) -> int:
+        """Return `0` without inserting the key."""
+    def update(self, iterable: Iterable[T] | dict[T, int]) -> None: ...
+    def subtract(self, iterable: Iterable[T] | dict[T, int]) -> None: ...
+    def most_common(self, n: int | None = None) -> list[tuple[T, int]]:
+        """Return the `n` most common elements and their counts, from the most common to the least.
+
+        Elements with equal counts are ordered by insertion order.
+        """
+    def elements(self) -> list[T]: ...
+    def total(self) -> int: ...
+    def copy(self) -> 'Counter[T]': ...
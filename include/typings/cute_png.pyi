@@ -1,5 +1,5 @@
 from array2d import array2d
 from vmath import color32
 
-def loads(data: bytes) -> array2d[color32]: ...
+def loads(data: bytes | bytearray | memoryview) -> array2d[color32]: ...
 def dumps(image: array2d[color32]) -> bytes: ...
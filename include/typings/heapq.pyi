@@ -0,0 +1,14 @@
+def heappush[T](heap: list[T], item: T) -> None:
+    """Push the value `item` onto the heap, maintaining the heap invariant."""
+
+def heappop[T](heap: list[T]) -> T:
+    """Pop and return the smallest item from the heap, maintaining the heap invariant."""
+
+def heapify[T](x: list[T]) -> None:
+    """Transform list `x` into a heap, in-place, in linear time."""
+
+def heappushpop[T](heap: list[T], item: T) -> T:
+    """Push `item` on the heap, then pop and return the smallest item from the heap."""
+
+def heapreplace[T](heap: list[T], item: T) -> T:
+    """Pop and return the smallest item from the heap, and also push the new item."""
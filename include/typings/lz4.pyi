@@ -1,11 +1,50 @@
-def compress(data: bytes) -> bytes:
+# any object exporting a buffer, e.g. a typed `array2d` or `vec2_array` as well
+_Buffer = bytes | bytearray | memoryview
+
+def compress(data: _Buffer) -> bytes:
     """Compress the given data into LZ4 block format.
     
     This function is equivalent to `lz4.block.compress` of https://pypi.org/project/lz4/.
     """
 
-def decompress(data: bytes) -> bytes:
+def decompress(data: _Buffer) -> bytes:
     """Decompress the given LZ4 block format data produced by `lz4.compress()`.
     
     This function is equivalent to `lz4.block.decompress` of https://pypi.org/project/lz4/.
     """
+
+def decompress_into(data: _Buffer, out: bytearray | memoryview) -> int:
+    """Decompress a block produced by `lz4.compress()` into the start of the writable buffer `out`, without a copy.
+
+    Return the number of bytes written. Raise `ValueError` if `out` is too small.
+    """
+
+class Compressor:
+    """Incremental compressor producing the standard LZ4 frame format, readable by the `lz4` command line tool."""
+    def __init__(self, level: int = 0, dict: _Buffer | None = None):
+        """`level` 0 is the fast default, negative levels trade ratio for speed, and 3 to 12 use high compression.
+
+        `dict` primes the compressor for small payloads that share content. The same bytes must be passed to `Decompressor`.
+        """
+    def update(self, data: _Buffer) -> bytes:
+        """Compress `data` and return the output ready so far. The first call also returns the frame header."""
+    def flush(self, end: bool = True) -> bytes:
+        """Return the buffered output. If `end` is true, close the frame, and the next `update` starts a new one."""
+
+class Decompressor:
+    """Incremental decompressor of LZ4 frames. Concatenated frames are decompressed one after another."""
+    def __init__(self, dict: _Buffer | None = None): ...
+    def update(self, data: _Buffer) -> bytes:
+        """Decompress any part of a frame and return the output ready so far. Raise `ValueError` on corrupt data."""
+    @property
+    def eof(self) -> bool:
+        """Whether the last frame is complete."""
+
+def compress_stream(src, dst, level: int = 0, dict: _Buffer | None = None) -> None:
+    """Read `src` in chunks with `src.read(n)` until it returns an empty buffer, and write a LZ4 frame with `dst.write(data)`.
+
+    Works with files opened in binary mode, so large data never needs to be in memory at once.
+    """
+
+def decompress_stream(src, dst, dict: _Buffer | None = None) -> None:
+    """Decompress LZ4 frames from `src` into `dst` in chunks. Raise `ValueError` if the last frame is incomplete."""
@@ -1,5 +1,6 @@
-from typing import Self, Literal
-from vmath import vec2, vec2i
+from typing import Self, Literal, Iterator, overload
+from vmath import vec2, vec2i, vec2_array
+from array2d import array2d
 
 class TValue[T]:
     def __new__(cls, value: T) -> Self: ...
@@ -27,6 +28,91 @@ def currentvm() -> int:
     """Return the current VM index."""
 
 
+class frozendict[K, V]:
+    """An immutable dict allocated in the frozen space."""
+    def __init__(self, d: dict[K, V]): ...
+    def __getitem__(self, key: K) -> V: ...
+    def __contains__(self, key: K) -> bool: ...
+    def __len__(self) -> int: ...
+    def get(self, key: K, default: V | None = None) -> V | None: ...
+    def keys(self): ...
+    def values(self): ...
+    def items(self): ...
+    def copy(self) -> dict[K, V]:
+        """Return a mutable copy."""
+
+def freeze(obj):
+    """Create a deeply immutable copy of `obj` in the frozen space shared by all VMs.
+
+    `list` is frozen as `tuple` and `dict` is frozen as `frozendict`.
+    """
+def isfrozen(obj) -> bool:
+    """Check if `obj` lives in the frozen space."""
+def setfrozen(key: str, obj):
+    """Freeze `obj` and publish it under `key` so that all VMs can get it via `getfrozen`."""
+def getfrozen(key: str):
+    """Get a frozen object published by `setfrozen`. Raise `KeyError` if not found."""
+
+
+class Table:
+    """Rows of entity data stored column by column.
+
+    Each column has a dtype: `'bool'`, `'int8'`, `'int16'`, `'int32'` (alias `'int'`),
+    `'float32'`, `'float64'` (alias `'float'`), `'vec2'` or `'object'`.
+    """
+    def __new__(cls, columns: dict[str, str], length: int = 0) -> Self:
+        """Create a table with `length` rows of zeros, `False` and `None`."""
+    def __len__(self) -> int: ...
+    def __iter__(self) -> Iterator[TableRow]: ...
+
+    @property
+    def columns(self) -> dict[str, str]:
+        """Map of column names to dtypes."""
+
+    @overload
+    def __getitem__(self, index: int) -> TableRow: ...
+    @overload
+    def __getitem__(self, index: str) -> array2d | vec2_array | list: ...
+    @overload
+    def __getitem__(self, index: tuple[int, str]): ...
+    @overload
+    def __setitem__(self, index: str, value) -> None: ...
+    @overload
+    def __setitem__(self, index: tuple[int, str], value) -> None: ...
+
+    def append(self, **fields) -> int:
+        """Add a row and return its index. Missing fields are zero, `False` or `None`."""
+    def resize(self, length: int) -> None: ...
+    def clear(self) -> None: ...
+    def swap_remove(self, index: int) -> None:
+        """Remove a row by moving the last row into its place."""
+
+    def column(self, name: str) -> array2d | vec2_array | list:
+        """Copy a column into an `array2d` of width 1, a `vec2_array` or a `list` of objects."""
+    def set_column(self, name: str, value) -> None:
+        """Set a whole column from another column name, an `array2d`, a `vec2_array`,
+        a `list` or `tuple` with one item per row, or a single value for all rows.
+        """
+
+    def add_(self, name: str, value) -> None:
+        """`column += value`, where `value` is anything `set_column` accepts."""
+    def sub_(self, name: str, value) -> None: ...
+    def mul_(self, name: str, value) -> None: ...
+    def truediv_(self, name: str, value) -> None:
+        """Only for float and vec2 columns."""
+    def add_scaled_(self, name: str, value, k) -> None:
+        """`column += value * k`, e.g. `t.add_scaled_('pos', 'vel', dt)`."""
+
+class TableRow:
+    """A view of row `index` of a `Table`. Columns are read and written as attributes."""
+    @property
+    def index(self) -> int: ...
+    @property
+    def table(self) -> Table: ...
+    def __getattr__(self, name: str): ...
+    def __setattr__(self, name: str, value) -> None: ...
+
+
 def watchdog_begin(timeout: int):
     """Begin the watchdog with `timeout` in milliseconds.
 
@@ -42,6 +128,23 @@ def profiler_end() -> None: ...
 def profiler_reset() -> None: ...
 def profiler_report() -> dict[str, list[list]]: ...
 
+def opcodeprofiler_begin() -> None:
+    """Begin counting executed opcode pairs. Requires `PK_ENABLE_OPCODE_PROFILER`."""
+def opcodeprofiler_end() -> None: ...
+def opcodeprofiler_reset() -> None: ...
+def opcodeprofiler_report() -> list[tuple[str, str, int]]:
+    """Return `(first, second, hits)` for all executed opcode pairs, most frequent first."""
+
+def compilecache_setcapacity(capacity: int) -> None:
+    """Set the capacity of the compile cache of the current VM. Use `0` to disable it."""
+def compilecache_stats() -> tuple[int, int]:
+    """Return `(hits, misses)` of the compile cache of the current VM."""
+
+def setoptimizelevel(level: int) -> None:
+    """Set the bytecode optimization level of the current VM (0, 1 or 2)."""
+def getoptimizelevel() -> int:
+    """Return the bytecode optimization level of the current VM."""
+
 class ComputeThread:
     def __init__(self, vm_index: Literal[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]): ...
 
@@ -49,8 +152,18 @@ class ComputeThread:
     def is_done(self) -> bool:
         """Check if the current job is done."""
 
-    def wait_for_done(self) -> None:
-        """Wait for the current job to finish."""
+    def wait_for_done(self, timeout: float | None = None) -> bool:
+        """Block until the current job finishes or `timeout` seconds elapse.
+
+        Return `True` if the job is done.
+        """
+
+    @staticmethod
+    def wait_any(threads: list[ComputeThread], timeout: float | None = None) -> ComputeThread | None:
+        """Block until any of `threads` is done or `timeout` seconds elapse.
+
+        Return the first thread that is done, or `None` on timeout.
+        """
 
     def last_error(self) -> str | None: ...
     def last_retval(self): ...
@@ -1,4 +1,5 @@
-from typing import overload, Iterator
+from typing import overload, Iterator, Self
+from array2d import array2d
 
 class _vecF[T]:
     ONE: T
@@ -124,6 +125,8 @@ class mat3x3:
 
     def transform_point(self, p: vec2) -> vec2: ...
     def transform_vector(self, v: vec2) -> vec2: ...
+    def transform_points(self, p: vec2_array) -> vec2_array: ...
+    def transform_vectors(self, v: vec2_array) -> vec2_array: ...
 
 
 class vec2i(_vecI['vec2i']):
@@ -180,6 +183,63 @@ class vec3(_vecF['vec3']):
     def __init__(self, xyz: vec3i) -> None: ...
 
 
+class _vecF_array[T]:
+    """Packed float vectors for bulk math, see `vec2_array` and `vec3_array`.
+
+    Operands are arrays of the same length, or a single vector applied to every element.
+    Methods ending with `_` update the array in place.
+    """
+    @overload
+    def __init__(self, length: int) -> None: ...
+    @overload
+    def __init__(self, data: list[T] | tuple[T, ...]) -> None: ...
+
+    def __len__(self) -> int: ...
+    def __getitem__(self, index: int) -> T: ...
+    def __setitem__(self, index: int, value: T) -> None: ...
+    def __iter__(self) -> Iterator[T]: ...
+
+    def __add__(self, other: Self | T) -> Self: ...
+    def __sub__(self, other: Self | T) -> Self: ...
+    def __mul__(self, other: Self | T | float) -> Self: ...
+    def __truediv__(self, other: Self | T | float) -> Self: ...
+
+    def add_(self, other: Self | T) -> None: ...
+    def sub_(self, other: Self | T) -> None: ...
+    def mul_(self, other: Self | T | float) -> None: ...
+    def truediv_(self, other: Self | T | float) -> None: ...
+
+    def dot(self, other: Self | T) -> array2d[float]:
+        """Dot products as a `float32` array2d of width 1, one row per vector."""
+    def length(self) -> array2d[float]: ...
+    def length_squared(self) -> array2d[float]: ...
+    def normalize(self) -> Self:
+        """Normalize every vector. Zero vectors are left as they are."""
+    def normalize_(self) -> None: ...
+    def lerp(self, other: Self | T, t: float) -> Self: ...
+
+    def copy(self) -> Self: ...
+    def tolist(self) -> list[T]: ...
+    def to_array2d(self) -> array2d[float]:
+        """A `float32` array2d with one row per vector and one column per component."""
+
+
+class vec2_array(_vecF_array[vec2]):
+    @staticmethod
+    def from_array2d(a: array2d[float]) -> vec2_array:
+        """Build from an array2d of width 2, one row per vector."""
+
+    @staticmethod
+    def smooth_damp(current: vec2_array, target: vec2_array | vec2, current_velocity: vec2_array, smooth_time: float, max_speed: float, delta_time: float) -> tuple[vec2_array, vec2_array]:
+        """`vec2.smooth_damp` over every vector."""
+
+
+class vec3_array(_vecF_array[vec3]):
+    @staticmethod
+    def from_array2d(a: array2d[float]) -> vec3_array:
+        """Build from an array2d of width 3, one row per vector."""
+
+
 # Color32
 class color32:
     def __new__(cls, r: int, g: int, b: int, a: int) -> 'color32': ...
@@ -2,33 +2,452 @@
 #include "pocketpy/config.h"
 #include <string.h>
 
-static bool _stable_sort_merge(char* a,
-                  char* a_end,
-                  char* b,
-                  char* b_end,
-                  char* r,
-                  int elem_size,
-                  int (*f_lt)(const void* a, const void* b, void* extra),
-                  void* extra) {
-    while(a < a_end && b < b_end) {
-        int res = f_lt(b, a, extra);
-        // check error
-        if(res == -1) return false;
-        if(res == 0) {  // !(b<a) -> (b>=a) -> (a<=b)
-            memcpy(r, a, elem_size);
-            a += elem_size;
+/* TimSort, see https://github.com/python/cpython/blob/main/Objects/listsort.txt
+ *
+ * If `f_lt` fails (returns -1), the sort stops immediately but the array is always left as a
+ * permutation of its original elements. */
+
+#define TIMSORT_MIN_GALLOP 7
+#define TIMSORT_MAX_RUNS 85
+
+typedef struct {
+    char* base;
+    int elem_size;
+    int (*f_lt)(const void* a, const void* b, void* extra);
+    void* extra;
+    int min_gallop;
+    // merge buffer
+    char* tmp;
+    int tmp_capacity;
+    // a single element buffer for insertion sort and reversing
+    char* pivot;
+    // pending runs
+    int run_count;
+    int run_base[TIMSORT_MAX_RUNS];
+    int run_len[TIMSORT_MAX_RUNS];
+} c11_TimSort;
+
+#define TS_AT(ts, i) ((ts)->base + (size_t)(i) * (ts)->elem_size)
+#define TS_LT(ts, a, b) ((ts)->f_lt((a), (b), (ts)->extra))
+
+static int c11_TimSort__minrun(int n) {
+    int r = 0;
+    while(n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+static void c11_TimSort__reverse(c11_TimSort* ts, char* lo, char* hi) {
+    int es = ts->elem_size;
+    hi -= es;
+    while(lo < hi) {
+        memcpy(ts->pivot, lo, es);
+        memcpy(lo, hi, es);
+        memcpy(hi, ts->pivot, es);
+        lo += es;
+        hi -= es;
+    }
+}
+
+// sort [lo, hi) given that [lo, start) is already sorted
+static bool c11_TimSort__binary_insertion(c11_TimSort* ts, int lo, int hi, int start) {
+    int es = ts->elem_size;
+    for(; start < hi; start++) {
+        memcpy(ts->pivot, TS_AT(ts, start), es);
+        int l = lo, r = start;
+        while(l < r) {
+            int m = l + ((r - l) >> 1);
+            int res = TS_LT(ts, ts->pivot, TS_AT(ts, m));
+            if(res == -1) return false;
+            if(res) {
+                r = m;
+            } else {
+                l = m + 1;
+            }
+        }
+        memmove(TS_AT(ts, l + 1), TS_AT(ts, l), (size_t)(start - l) * es);
+        memcpy(TS_AT(ts, l), ts->pivot, es);
+    }
+    return true;
+}
+
+// return the length of the run starting at `lo`, strictly descending runs are reversed in place
+static int c11_TimSort__count_run(c11_TimSort* ts, int lo, int hi) {
+    if(lo + 1 == hi) return 1;
+    int n = 2;
+    int res = TS_LT(ts, TS_AT(ts, lo + 1), TS_AT(ts, lo));
+    if(res == -1) return -1;
+    if(res) {
+        for(; lo + n < hi; n++) {
+            res = TS_LT(ts, TS_AT(ts, lo + n), TS_AT(ts, lo + n - 1));
+            if(res == -1) return -1;
+            if(!res) break;
+        }
+        c11_TimSort__reverse(ts, TS_AT(ts, lo), TS_AT(ts, lo + n));
+    } else {
+        for(; lo + n < hi; n++) {
+            res = TS_LT(ts, TS_AT(ts, lo + n), TS_AT(ts, lo + n - 1));
+            if(res == -1) return -1;
+            if(res) break;
+        }
+    }
+    return n;
+}
+
+/* Locate the leftmost position in the sorted array `a[0:n]` to insert `key`, i.e. the k such
+ * that a[k-1] < key <= a[k]. The search starts at `hint` and gallops outwards. */
+static int c11_TimSort__gallop_left(c11_TimSort* ts, const char* key, char* a, int n, int hint) {
+    int es = ts->elem_size;
+    int ofs = 1, lastofs = 0, res;
+    res = TS_LT(ts, a + (size_t)hint * es, key);
+    if(res == -1) return -1;
+    if(res) {
+        // a[hint] < key, gallop right until a[hint+lastofs] < key <= a[hint+ofs]
+        int maxofs = n - hint;
+        while(ofs < maxofs) {
+            res = TS_LT(ts, a + (size_t)(hint + ofs) * es, key);
+            if(res == -1) return -1;
+            if(!res) break;
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if(ofs <= 0) ofs = maxofs;  // overflow
+        }
+        if(ofs > maxofs) ofs = maxofs;
+        lastofs += hint;
+        ofs += hint;
+    } else {
+        // key <= a[hint], gallop left until a[hint-ofs] < key <= a[hint-lastofs]
+        int maxofs = hint + 1;
+        while(ofs < maxofs) {
+            res = TS_LT(ts, a + (size_t)(hint - ofs) * es, key);
+            if(res == -1) return -1;
+            if(res) break;
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if(ofs <= 0) ofs = maxofs;
+        }
+        if(ofs > maxofs) ofs = maxofs;
+        int k = lastofs;
+        lastofs = hint - ofs;
+        ofs = hint - k;
+    }
+    // a[lastofs] < key <= a[ofs], binary search in between
+    lastofs++;
+    while(lastofs < ofs) {
+        int m = lastofs + ((ofs - lastofs) >> 1);
+        res = TS_LT(ts, a + (size_t)m * es, key);
+        if(res == -1) return -1;
+        if(res) {
+            lastofs = m + 1;
         } else {
-            memcpy(r, b, elem_size);
-            b += elem_size;
+            ofs = m;
         }
-        r += elem_size;
     }
+    return ofs;
+}
 
-    // one of the arrays is empty
-    for(; a < a_end; a += elem_size, r += elem_size)
-        memcpy(r, a, elem_size);
-    for(; b < b_end; b += elem_size, r += elem_size)
-        memcpy(r, b, elem_size);
+// like `gallop_left` but return the rightmost position, i.e. a[k-1] <= key < a[k]
+static int c11_TimSort__gallop_right(c11_TimSort* ts, const char* key, char* a, int n, int hint) {
+    int es = ts->elem_size;
+    int ofs = 1, lastofs = 0, res;
+    res = TS_LT(ts, key, a + (size_t)hint * es);
+    if(res == -1) return -1;
+    if(res) {
+        // key < a[hint], gallop left until a[hint-ofs] <= key < a[hint-lastofs]
+        int maxofs = hint + 1;
+        while(ofs < maxofs) {
+            res = TS_LT(ts, key, a + (size_t)(hint - ofs) * es);
+            if(res == -1) return -1;
+            if(!res) break;
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if(ofs <= 0) ofs = maxofs;
+        }
+        if(ofs > maxofs) ofs = maxofs;
+        int k = lastofs;
+        lastofs = hint - ofs;
+        ofs = hint - k;
+    } else {
+        // a[hint] <= key, gallop right until a[hint+lastofs] <= key < a[hint+ofs]
+        int maxofs = n - hint;
+        while(ofs < maxofs) {
+            res = TS_LT(ts, key, a + (size_t)(hint + ofs) * es);
+            if(res == -1) return -1;
+            if(res) break;
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if(ofs <= 0) ofs = maxofs;
+        }
+        if(ofs > maxofs) ofs = maxofs;
+        lastofs += hint;
+        ofs += hint;
+    }
+    lastofs++;
+    while(lastofs < ofs) {
+        int m = lastofs + ((ofs - lastofs) >> 1);
+        res = TS_LT(ts, key, a + (size_t)m * es);
+        if(res == -1) return -1;
+        if(res) {
+            ofs = m;
+        } else {
+            lastofs = m + 1;
+        }
+    }
+    return ofs;
+}
+
+static void c11_TimSort__reserve(c11_TimSort* ts, int n) {
+    if(ts->tmp_capacity >= n) return;
+    PK_FREE(ts->tmp);
+    ts->tmp = PK_MALLOC((size_t)n * ts->elem_size);
+    ts->tmp_capacity = n;
+}
+
+// merge the adjacent runs a[0:na] and b[0:nb] in place, where na <= nb
+static bool c11_TimSort__merge_lo(c11_TimSort* ts, char* a, int na, char* b, int nb) {
+    int es = ts->elem_size;
+    int min_gallop = ts->min_gallop;
+    bool ok = true;
+    c11_TimSort__reserve(ts, na);
+    memcpy(ts->tmp, a, (size_t)na * es);
+    char* dest = a;
+    a = ts->tmp;
+
+    memcpy(dest, b, es);
+    dest += es;
+    b += es;
+    if(--nb == 0) goto __succeed;
+    if(na == 1) goto __copy_b;
+
+    while(true) {
+        int acount = 0, bcount = 0;
+        // one pair at a time until one run wins consistently
+        while(true) {
+            int res = TS_LT(ts, b, a);
+            if(res == -1) goto __fail;
+            if(res) {
+                memcpy(dest, b, es);
+                dest += es;
+                b += es;
+                bcount++;
+                acount = 0;
+                if(--nb == 0) goto __succeed;
+                if(bcount >= min_gallop) break;
+            } else {
+                memcpy(dest, a, es);
+                dest += es;
+                a += es;
+                acount++;
+                bcount = 0;
+                if(--na == 1) goto __copy_b;
+                if(acount >= min_gallop) break;
+            }
+        }
+        // galloping mode
+        min_gallop++;
+        do {
+            min_gallop -= min_gallop > 1;
+            ts->min_gallop = min_gallop;
+            int k = c11_TimSort__gallop_right(ts, b, a, na, 0);
+            if(k == -1) goto __fail;
+            acount = k;
+            if(k) {
+                memcpy(dest, a, (size_t)k * es);
+                dest += (size_t)k * es;
+                a += (size_t)k * es;
+                na -= k;
+                if(na == 1) goto __copy_b;
+                // only possible if the comparison is inconsistent
+                if(na == 0) goto __succeed;
+            }
+            memcpy(dest, b, es);
+            dest += es;
+            b += es;
+            if(--nb == 0) goto __succeed;
+
+            k = c11_TimSort__gallop_left(ts, a, b, nb, 0);
+            if(k == -1) goto __fail;
+            bcount = k;
+            if(k) {
+                memmove(dest, b, (size_t)k * es);
+                dest += (size_t)k * es;
+                b += (size_t)k * es;
+                nb -= k;
+                if(nb == 0) goto __succeed;
+            }
+            memcpy(dest, a, es);
+            dest += es;
+            a += es;
+            if(--na == 1) goto __copy_b;
+        } while(acount >= TIMSORT_MIN_GALLOP || bcount >= TIMSORT_MIN_GALLOP);
+        min_gallop++;
+        ts->min_gallop = min_gallop;
+    }
+
+__fail:
+    ok = false;
+__succeed:
+    // the holes left in the destination are exactly where the rest of run a belongs
+    if(na) memcpy(dest, a, (size_t)na * es);
+    return ok;
+__copy_b:
+    // the last element of run a belongs at the end of the merged run
+    memmove(dest, b, (size_t)nb * es);
+    memcpy(dest + (size_t)nb * es, a, es);
+    return true;
+}
+
+// merge the adjacent runs a[0:na] and b[0:nb] in place, where na >= nb
+static bool c11_TimSort__merge_hi(c11_TimSort* ts, char* a, int na, char* b, int nb) {
+    int es = ts->elem_size;
+    int min_gallop = ts->min_gallop;
+    bool ok = true;
+    c11_TimSort__reserve(ts, nb);
+    memcpy(ts->tmp, b, (size_t)nb * es);
+    char* base_a = a;
+    char* dest = b + (size_t)(nb - 1) * es;
+    a += (size_t)(na - 1) * es;
+    b = ts->tmp + (size_t)(nb - 1) * es;
+
+    memcpy(dest, a, es);
+    dest -= es;
+    a -= es;
+    if(--na == 0) goto __succeed;
+    if(nb == 1) goto __copy_a;
+
+    while(true) {
+        int acount = 0, bcount = 0;
+        while(true) {
+            int res = TS_LT(ts, b, a);
+            if(res == -1) goto __fail;
+            if(res) {
+                memcpy(dest, a, es);
+                dest -= es;
+                a -= es;
+                acount++;
+                bcount = 0;
+                if(--na == 0) goto __succeed;
+                if(acount >= min_gallop) break;
+            } else {
+                memcpy(dest, b, es);
+                dest -= es;
+                b -= es;
+                bcount++;
+                acount = 0;
+                if(--nb == 1) goto __copy_a;
+                if(bcount >= min_gallop) break;
+            }
+        }
+        min_gallop++;
+        do {
+            min_gallop -= min_gallop > 1;
+            ts->min_gallop = min_gallop;
+            int k = c11_TimSort__gallop_right(ts, b, base_a, na, na - 1);
+            if(k == -1) goto __fail;
+            k = na - k;
+            acount = k;
+            if(k) {
+                dest -= (size_t)k * es;
+                a -= (size_t)k * es;
+                memmove(dest + es, a + es, (size_t)k * es);
+                na -= k;
+                if(na == 0) goto __succeed;
+            }
+            memcpy(dest, b, es);
+            dest -= es;
+            b -= es;
+            if(--nb == 1) goto __copy_a;
+            if(nb == 0) goto __succeed;
+
+            k = c11_TimSort__gallop_left(ts, a, ts->tmp, nb, nb - 1);
+            if(k == -1) goto __fail;
+            k = nb - k;
+            bcount = k;
+            if(k) {
+                dest -= (size_t)k * es;
+                b -= (size_t)k * es;
+                memcpy(dest + es, b + es, (size_t)k * es);
+                nb -= k;
+                if(nb == 1) goto __copy_a;
+                if(nb == 0) goto __succeed;
+            }
+            memcpy(dest, a, es);
+            dest -= es;
+            a -= es;
+            if(--na == 0) goto __succeed;
+        } while(acount >= TIMSORT_MIN_GALLOP || bcount >= TIMSORT_MIN_GALLOP);
+        min_gallop++;
+        ts->min_gallop = min_gallop;
+    }
+
+__fail:
+    ok = false;
+__succeed:
+    if(nb) memcpy(dest - (size_t)(nb - 1) * es, ts->tmp, (size_t)nb * es);
+    return ok;
+__copy_a:
+    // the first element of run b belongs at the start of the merged run
+    dest -= (size_t)na * es;
+    a -= (size_t)na * es;
+    memmove(dest + es, a + es, (size_t)na * es);
+    memcpy(dest, b, es);
+    return true;
+}
+
+// merge the runs at stack index i and i+1
+static bool c11_TimSort__merge_at(c11_TimSort* ts, int i) {
+    int es = ts->elem_size;
+    char* a = TS_AT(ts, ts->run_base[i]);
+    int na = ts->run_len[i];
+    char* b = TS_AT(ts, ts->run_base[i + 1]);
+    int nb = ts->run_len[i + 1];
+
+    ts->run_len[i] = na + nb;
+    if(i == ts->run_count - 3) {
+        ts->run_base[i + 1] = ts->run_base[i + 2];
+        ts->run_len[i + 1] = ts->run_len[i + 2];
+    }
+    ts->run_count--;
+
+    // elements of a that are already in place
+    int k = c11_TimSort__gallop_right(ts, b, a, na, 0);
+    if(k == -1) return false;
+    a += (size_t)k * es;
+    na -= k;
+    if(na == 0) return true;
+    // elements of b that are already in place
+    nb = c11_TimSort__gallop_left(ts, a + (size_t)(na - 1) * es, b, nb, nb - 1);
+    if(nb == -1) return false;
+    if(nb == 0) return true;
+
+    if(na <= nb) return c11_TimSort__merge_lo(ts, a, na, b, nb);
+    return c11_TimSort__merge_hi(ts, a, na, b, nb);
+}
+
+static bool c11_TimSort__merge_collapse(c11_TimSort* ts) {
+    int* len = ts->run_len;
+    while(ts->run_count > 1) {
+        int n = ts->run_count - 2;
+        if((n > 0 && len[n - 1] <= len[n] + len[n + 1]) ||
+           (n > 1 && len[n - 2] <= len[n - 1] + len[n])) {
+            if(len[n - 1] < len[n + 1]) n--;
+        } else if(len[n] > len[n + 1]) {
+            break;
+        }
+        if(!c11_TimSort__merge_at(ts, n)) return false;
+    }
+    return true;
+}
+
+static bool c11_TimSort__merge_force_collapse(c11_TimSort* ts) {
+    int* len = ts->run_len;
+    while(ts->run_count > 1) {
+        int n = ts->run_count - 2;
+        if(n > 0 && len[n - 1] < len[n + 1]) n--;
+        if(!c11_TimSort__merge_at(ts, n)) return false;
+    }
     return true;
 }
 
@@ -37,20 +456,52 @@ bool c11__stable_sort(void* ptr_,
                       int elem_size,
                       int (*f_lt)(const void* a, const void* b, void* extra),
                       void* extra) {
-    // merge sort
-    char *ptr = ptr_, *tmp = PK_MALLOC(length * elem_size);
-    for(int seg = 1; seg < length; seg *= 2) {
-        for(char* a = ptr; a < ptr + (length - seg) * elem_size; a += 2 * seg * elem_size) {
-            char *b = a + seg * elem_size, *a_end = b, *b_end = b + seg * elem_size;
-            if(b_end > ptr + length * elem_size) b_end = ptr + length * elem_size;
-            bool ok = _stable_sort_merge(a, a_end, b, b_end, tmp, elem_size, f_lt, extra);
-            if(!ok) {
-                PK_FREE(tmp);
-                return false;
+    if(length < 2) return true;
+    c11_TimSort ts;
+    ts.base = ptr_;
+    ts.elem_size = elem_size;
+    ts.f_lt = f_lt;
+    ts.extra = extra;
+    ts.min_gallop = TIMSORT_MIN_GALLOP;
+    ts.tmp = NULL;
+    ts.tmp_capacity = 0;
+    ts.pivot = PK_MALLOC(elem_size);
+    ts.run_count = 0;
+
+    bool ok = true;
+    int minrun = c11_TimSort__minrun(length);
+    int lo = 0, remaining = length;
+    while(remaining > 0) {
+        int n = c11_TimSort__count_run(&ts, lo, lo + remaining);
+        if(n == -1) {
+            ok = false;
+            break;
+        }
+        if(n < minrun) {
+            // extend the short run with insertion sort
+            int force = remaining <= minrun ? remaining : minrun;
+            if(!c11_TimSort__binary_insertion(&ts, lo, lo + force, lo + n)) {
+                ok = false;
+                break;
             }
-            memcpy(a, tmp, b_end - a);
+            n = force;
         }
+        ts.run_base[ts.run_count] = lo;
+        ts.run_len[ts.run_count] = n;
+        ts.run_count++;
+        if(!c11_TimSort__merge_collapse(&ts)) {
+            ok = false;
+            break;
+        }
+        lo += n;
+        remaining -= n;
     }
-    PK_FREE(tmp);
-    return true;
+    if(ok) ok = c11_TimSort__merge_force_collapse(&ts);
+
+    PK_FREE(ts.tmp);
+    PK_FREE(ts.pivot);
+    return ok;
 }
+
+#undef TS_AT
+#undef TS_LT
@@ -15,11 +15,46 @@ typedef struct NameBucket {
     char data[];  // null-terminated data
 } NameBucket;
 
-static struct {
-    NameBucket* table[0x10000];
+typedef struct NameArenaChunk NameArenaChunk;
+
+typedef struct NameArenaChunk {
+    NameArenaChunk* prev;
 #if PK_ENABLE_THREADS
-    atomic_flag lock;
+    atomic_size_t used;
+#else
+    size_t used;
 #endif
+    size_t capacity;
+} NameArenaChunk;
+
+#define NAME_ARENA_CHUNK_SIZE (64 * 1024)
+// keep the payload 8-byte aligned on 32-bit targets as well
+#define NAME_ARENA_HEADER_SIZE ((sizeof(NameArenaChunk) + 7) & ~(size_t)7)
+#define NameArenaChunk__data(self) ((char*)(self) + NAME_ARENA_HEADER_SIZE)
+
+/* Lookups never take a lock: buckets are immutable after they are published, and a new bucket
+ * is published by a CAS on the head of its chain. Buckets are bump-allocated from a chain of
+ * arena chunks that live until `pk_names_finalize`. */
+#if PK_ENABLE_THREADS
+#define NAME_ATOMIC(T) _Atomic(T)
+#define name_load(p) atomic_load_explicit(p, memory_order_acquire)
+#define name_store(p, v) atomic_store_explicit(p, v, memory_order_release)
+#define name_cas(p, expected, desired)                                                             \
+    atomic_compare_exchange_strong_explicit(p,                                                     \
+                                            expected,                                              \
+                                            desired,                                               \
+                                            memory_order_acq_rel,                                  \
+                                            memory_order_acquire)
+#else
+#define NAME_ATOMIC(T) T
+#define name_load(p) (*(p))
+#define name_store(p, v) (*(p) = (v))
+#define name_cas(p, expected, desired) (*(p) = (desired), true)
+#endif
+
+static struct {
+    NAME_ATOMIC(NameBucket*) table[0x10000];
+    NAME_ATOMIC(NameArenaChunk*) arena;
 } pk_string_table;
 
 #define MAGIC_METHOD(x) py_Name x;
@@ -34,60 +69,74 @@ void pk_names_initialize() {
 
 void pk_names_finalize() {
     for(int i = 0; i < 0x10000; i++) {
-        NameBucket* p = pk_string_table.table[i];
-        while(p) {
-            NameBucket* next = p->next;
-            PK_FREE(p);
-            p = next;
-        }
-        pk_string_table.table[i] = NULL;
+        name_store(&pk_string_table.table[i], NULL);
     }
+    NameArenaChunk* chunk = name_load(&pk_string_table.arena);
+    while(chunk) {
+        NameArenaChunk* prev = chunk->prev;
+        PK_FREE(chunk);
+        chunk = prev;
+    }
+    name_store(&pk_string_table.arena, NULL);
 }
 
-py_Name py_namev(c11_sv name) {
+static void* NameArena__alloc(size_t size) {
+    size = (size + 7) & ~(size_t)7;
+    while(true) {
+        NameArenaChunk* chunk = name_load(&pk_string_table.arena);
+        if(chunk) {
 #if PK_ENABLE_THREADS
-    while(atomic_flag_test_and_set(&pk_string_table.lock)) {
-        c11_thrd_yield();
-    }
+            size_t offset = atomic_fetch_add_explicit(&chunk->used, size, memory_order_relaxed);
+#else
+            size_t offset = chunk->used;
+            chunk->used += size;
 #endif
-    uint64_t hash = c11_sv__hash(name);
-    int index = hash & 0xFFFF;
-    NameBucket* p = pk_string_table.table[index];
-    NameBucket* prev = NULL;
-    bool found = false;
-    while(p) {
-        c11_sv p_sv = {p->data, p->size};
-        if(p->hash == hash && c11__sveq(p_sv, name)) {
-            found = true;
-            break;
+            if(offset + size <= chunk->capacity) return NameArenaChunk__data(chunk) + offset;
         }
-        prev = p;
-        p = p->next;
+        // current chunk is exhausted, try to install a new one
+        size_t capacity = size > NAME_ARENA_CHUNK_SIZE ? size : NAME_ARENA_CHUNK_SIZE;
+        NameArenaChunk* new_chunk = PK_MALLOC(NAME_ARENA_HEADER_SIZE + capacity);
+        new_chunk->prev = chunk;
+        new_chunk->used = size;
+        new_chunk->capacity = capacity;
+        if(name_cas(&pk_string_table.arena, &chunk, new_chunk)) {
+            return NameArenaChunk__data(new_chunk);
+        }
+        // another thread installed a chunk first
+        PK_FREE(new_chunk);
     }
-    if(found) {
-#if PK_ENABLE_THREADS
-        atomic_flag_clear(&pk_string_table.lock);
-#endif
-        return (py_Name)p;
+}
+
+static NameBucket* NameBucket__find(NameBucket* p, NameBucket* end, uint64_t hash, c11_sv name) {
+    while(p != end) {
+        if(p->hash == hash && c11__sveq((c11_sv){p->data, p->size}, name)) return p;
+        p = p->next;
     }
+    return NULL;
+}
+
+py_Name py_namev(c11_sv name) {
+    uint64_t hash = c11_sv__hash(name);
+    NAME_ATOMIC(NameBucket*)* slot = &pk_string_table.table[hash & 0xFFFF];
+    NameBucket* head = name_load(slot);
+    NameBucket* p = NameBucket__find(head, NULL, hash, name);
+    if(p) return (py_Name)p;
 
     // generate new index
-    NameBucket* bucket = PK_MALLOC(sizeof(NameBucket) + name.size + 1);
-    bucket->next = NULL;
+    NameBucket* bucket = NameArena__alloc(sizeof(NameBucket) + name.size + 1);
     bucket->hash = hash;
     bucket->size = name.size;
     memcpy(bucket->data, name.data, name.size);
     bucket->data[name.size] = '\0';
-    if(prev == NULL) {
-        pk_string_table.table[index] = bucket;
-    } else {
-        assert(prev->next == NULL);
-        prev->next = bucket;
+    while(true) {
+        bucket->next = head;
+        NameBucket* old_head = head;
+        if(name_cas(slot, &head, bucket)) return (py_Name)bucket;
+        // the chain grew, only the newly published buckets need to be checked
+        p = NameBucket__find(head, old_head, hash, name);
+        // the bucket is leaked into the arena, which is fine since it is reclaimed at finalize
+        if(p) return (py_Name)p;
     }
-#if PK_ENABLE_THREADS
-    atomic_flag_clear(&pk_string_table.lock);
-#endif
-    return (py_Name)bucket;
 }
 
 c11_sv py_name2sv(py_Name index) {
@@ -107,4 +156,4 @@ const char* py_name2str(py_Name index) {
     return p->data;
 }
 
-#endif
\ No newline at end of file
+#endif
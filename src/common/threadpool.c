@@ -0,0 +1,168 @@
+#include "pocketpy/common/threadpool.h"
+#include "pocketpy/common/threads.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/config.h"
+
+#include <stdint.h>
+
+static int c11_threadpool__chunks(int n, int grain, int size) {
+    if(size <= 1 || grain <= 0 || n < grain * 2) return 1;
+    // a few chunks per thread balance uneven rows
+    int n_chunks = c11__min(n / grain, size * 4);
+    return c11__min(n_chunks, C11_THREADPOOL_MAX_CHUNKS);
+}
+
+#if PK_ENABLE_THREADS
+
+typedef struct c11_threadpool_job {
+    c11_parallel_fn fn;
+    void* ctx;
+    int n;
+    int n_chunks;
+    atomic_int next;  // next chunk to claim
+} c11_threadpool_job;
+
+static struct {
+    c11_mtx_t mtx;
+    c11_cnd_t wake;  // workers wait for a new job
+    c11_cnd_t idle;  // the caller waits for workers to release the job
+    c11_thrd_t workers[C11_THREADPOOL_MAX_THREADS];
+    int n_workers;
+    c11_threadpool_job* job;
+    unsigned generation;
+    int holders;  // workers holding a pointer to `job`
+    bool quit;
+    atomic_flag busy;  // a loop or a resize owns the pool
+} c11_threadpool;
+
+static void c11_threadpool__run(c11_threadpool_job* job) {
+    while(true) {
+        int k = atomic_fetch_add(&job->next, 1);
+        if(k >= job->n_chunks) return;
+        int begin = (int)((int64_t)job->n * k / job->n_chunks);
+        int end = (int)((int64_t)job->n * (k + 1) / job->n_chunks);
+        job->fn(job->ctx, k, begin, end);
+    }
+}
+
+static c11_thrd_retval_t c11_threadpool__worker(void* arg) {
+    unsigned seen = 0;
+    c11_mtx_lock(&c11_threadpool.mtx);
+    while(true) {
+        while(!c11_threadpool.quit && c11_threadpool.generation == seen) {
+            c11_cnd_wait(&c11_threadpool.wake, &c11_threadpool.mtx);
+        }
+        if(c11_threadpool.quit) break;
+        seen = c11_threadpool.generation;
+        c11_threadpool_job* job = c11_threadpool.job;
+        if(job == NULL) continue;
+        c11_threadpool.holders++;
+        c11_mtx_unlock(&c11_threadpool.mtx);
+        c11_threadpool__run(job);
+        c11_mtx_lock(&c11_threadpool.mtx);
+        if(--c11_threadpool.holders == 0) c11_cnd_signal(&c11_threadpool.idle);
+    }
+    c11_mtx_unlock(&c11_threadpool.mtx);
+    return (c11_thrd_retval_t)0;
+}
+
+static void c11_threadpool__acquire() {
+    while(atomic_flag_test_and_set(&c11_threadpool.busy)) {
+        c11_thrd_yield();
+    }
+}
+
+static void c11_threadpool__release() { atomic_flag_clear(&c11_threadpool.busy); }
+
+void c11_threadpool__initialize() {
+    c11_mtx_init(&c11_threadpool.mtx);
+    c11_cnd_init(&c11_threadpool.wake);
+    c11_cnd_init(&c11_threadpool.idle);
+    c11_threadpool.n_workers = 0;
+    c11_threadpool.job = NULL;
+    c11_threadpool.generation = 0;
+    c11_threadpool.holders = 0;
+    c11_threadpool.quit = false;
+    atomic_flag_clear(&c11_threadpool.busy);
+}
+
+void c11_threadpool__finalize() {
+    c11_threadpool__set_size(1);
+    c11_cnd_destroy(&c11_threadpool.idle);
+    c11_cnd_destroy(&c11_threadpool.wake);
+    c11_mtx_destroy(&c11_threadpool.mtx);
+}
+
+void c11_threadpool__set_size(int size) {
+    size = c11__max(1, c11__min(size, C11_THREADPOOL_MAX_THREADS));
+    c11_threadpool__acquire();
+    if(size - 1 != c11_threadpool.n_workers) {
+        // stop every worker, then start the new ones
+        c11_mtx_lock(&c11_threadpool.mtx);
+        c11_threadpool.quit = true;
+        c11_cnd_broadcast(&c11_threadpool.wake);
+        c11_mtx_unlock(&c11_threadpool.mtx);
+        for(int i = 0; i < c11_threadpool.n_workers; i++) {
+            c11_thrd_join(c11_threadpool.workers[i]);
+        }
+        c11_threadpool.n_workers = 0;
+        c11_threadpool.quit = false;
+        c11_threadpool.generation = 0;
+        for(int i = 0; i < size - 1; i++) {
+            bool ok = c11_thrd_create(&c11_threadpool.workers[i], c11_threadpool__worker, NULL);
+            if(!ok) break;
+            c11_threadpool.n_workers++;
+        }
+    }
+    c11_threadpool__release();
+}
+
+int c11_threadpool__size() { return c11_threadpool.n_workers + 1; }
+
+int c11_threadpool__parallel_for(int n, int grain, c11_parallel_fn fn, void* ctx) {
+    if(atomic_flag_test_and_set(&c11_threadpool.busy)) {
+        // nested or concurrent loops run serially
+        fn(ctx, 0, 0, n);
+        return 1;
+    }
+    int n_chunks = c11_threadpool__chunks(n, grain, c11_threadpool.n_workers + 1);
+    if(n_chunks == 1) {
+        c11_threadpool__release();
+        fn(ctx, 0, 0, n);
+        return 1;
+    }
+    c11_threadpool_job job = {.fn = fn, .ctx = ctx, .n = n, .n_chunks = n_chunks};
+    atomic_init(&job.next, 0);
+    c11_mtx_lock(&c11_threadpool.mtx);
+    c11_threadpool.job = &job;
+    c11_threadpool.generation++;
+    c11_cnd_broadcast(&c11_threadpool.wake);
+    c11_mtx_unlock(&c11_threadpool.mtx);
+    // the caller claims chunks as well
+    c11_threadpool__run(&job);
+    c11_mtx_lock(&c11_threadpool.mtx);
+    while(c11_threadpool.holders > 0) {
+        c11_cnd_wait(&c11_threadpool.idle, &c11_threadpool.mtx);
+    }
+    c11_threadpool.job = NULL;
+    c11_mtx_unlock(&c11_threadpool.mtx);
+    c11_threadpool__release();
+    return n_chunks;
+}
+
+#else
+
+void c11_threadpool__initialize() {}
+
+void c11_threadpool__finalize() {}
+
+void c11_threadpool__set_size(int size) {}
+
+int c11_threadpool__size() { return 1; }
+
+int c11_threadpool__parallel_for(int n, int grain, c11_parallel_fn fn, void* ctx) {
+    fn(ctx, 0, 0, n);
+    return 1;
+}
+
+#endif  // PK_ENABLE_THREADS
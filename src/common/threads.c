@@ -2,6 +2,20 @@
 
 #if PK_ENABLE_THREADS
 
+#include <time.h>
+
+static struct timespec c11__deadline(int64_t timeout_ms) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (timeout_ms % 1000) * 1000000;
+    if(ts.tv_nsec >= 1000000000) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
 #if PK_USE_PTHREADS
 
 bool c11_thrd_create(c11_thrd_t* thrd, c11_thrd_retval_t (*func)(void*), void* arg) {
@@ -9,8 +23,41 @@ bool c11_thrd_create(c11_thrd_t* thrd, c11_thrd_retval_t (*func)(void*), void* a
     return res == 0;
 }
 
+bool c11_thrd_join(c11_thrd_t thrd) {
+    int res = pthread_join(thrd, NULL);
+    return res == 0;
+}
+
 void c11_thrd_yield() { sched_yield(); }
 
+void c11_mtx_init(c11_mtx_t* self) { pthread_mutex_init(self, NULL); }
+
+void c11_mtx_destroy(c11_mtx_t* self) { pthread_mutex_destroy(self); }
+
+void c11_mtx_lock(c11_mtx_t* self) { pthread_mutex_lock(self); }
+
+void c11_mtx_unlock(c11_mtx_t* self) { pthread_mutex_unlock(self); }
+
+void c11_cnd_init(c11_cnd_t* self) { pthread_cond_init(self, NULL); }
+
+void c11_cnd_destroy(c11_cnd_t* self) { pthread_cond_destroy(self); }
+
+void c11_cnd_wait(c11_cnd_t* self, c11_mtx_t* mtx) { pthread_cond_wait(self, mtx); }
+
+bool c11_cnd_timedwait(c11_cnd_t* self, c11_mtx_t* mtx, int64_t timeout_ms) {
+    if(timeout_ms < 0) {
+        pthread_cond_wait(self, mtx);
+        return true;
+    }
+    // pthread_cond_timedwait() uses CLOCK_REALTIME by default, which is the same as TIME_UTC
+    struct timespec deadline = c11__deadline(timeout_ms);
+    return pthread_cond_timedwait(self, mtx, &deadline) == 0;
+}
+
+void c11_cnd_signal(c11_cnd_t* self) { pthread_cond_signal(self); }
+
+void c11_cnd_broadcast(c11_cnd_t* self) { pthread_cond_broadcast(self); }
+
 #else
 
 bool c11_thrd_create(c11_thrd_t* thrd, c11_thrd_retval_t (*func)(void*), void* arg) {
@@ -18,8 +65,40 @@ bool c11_thrd_create(c11_thrd_t* thrd, c11_thrd_retval_t (*func)(void*), void* a
     return res == thrd_success;
 }
 
+bool c11_thrd_join(c11_thrd_t thrd) {
+    int res = thrd_join(thrd, NULL);
+    return res == thrd_success;
+}
+
 void c11_thrd_yield() { thrd_yield(); }
 
+void c11_mtx_init(c11_mtx_t* self) { mtx_init(self, mtx_plain); }
+
+void c11_mtx_destroy(c11_mtx_t* self) { mtx_destroy(self); }
+
+void c11_mtx_lock(c11_mtx_t* self) { mtx_lock(self); }
+
+void c11_mtx_unlock(c11_mtx_t* self) { mtx_unlock(self); }
+
+void c11_cnd_init(c11_cnd_t* self) { cnd_init(self); }
+
+void c11_cnd_destroy(c11_cnd_t* self) { cnd_destroy(self); }
+
+void c11_cnd_wait(c11_cnd_t* self, c11_mtx_t* mtx) { cnd_wait(self, mtx); }
+
+bool c11_cnd_timedwait(c11_cnd_t* self, c11_mtx_t* mtx, int64_t timeout_ms) {
+    if(timeout_ms < 0) {
+        cnd_wait(self, mtx);
+        return true;
+    }
+    struct timespec deadline = c11__deadline(timeout_ms);
+    return cnd_timedwait(self, mtx, &deadline) == thrd_success;
+}
+
+void c11_cnd_signal(c11_cnd_t* self) { cnd_signal(self); }
+
+void c11_cnd_broadcast(c11_cnd_t* self) { cnd_broadcast(self); }
+
 #endif
 
-#endif  // PK_ENABLE_THREADS
\ No newline at end of file
+#endif  // PK_ENABLE_THREADS
@@ -63,6 +63,7 @@ typedef struct Ctx {
     int level;
     int curr_iblock;
     bool is_compiling_class;
+    int class_iblock;  // blocks before this index are outside of the class body
     c11_vector /*T=Expr_p*/ s_expr;
     c11_smallmap_n2d global_names;
     c11_smallmap_v2d co_consts_string_dedup_map;  // this stores 0-based index instead of pointer
@@ -234,17 +235,18 @@ typedef struct FStringSpecExpr {
     c11_sv spec;
 } FStringSpecExpr;
 
+// the spec is parsed by the enclosing f-string, see `FStringExpr__emit_()`
 void FStringSpecExpr__emit_(Expr* self_, Ctx* ctx) {
     FStringSpecExpr* self = (FStringSpecExpr*)self_;
     vtemit_(self->child, ctx);
-    int index = Ctx__add_const_string(ctx, self->spec);
-    Ctx__emit_(ctx, OP_FORMAT_STRING, index, self->line);
 }
 
+const static ExprVt FStringSpecExprVt = {.emit_ = FStringSpecExpr__emit_,
+                                         .dtor = UnaryExpr__dtor};
+
 FStringSpecExpr* FStringSpecExpr__new(int line, Expr* child, c11_sv spec) {
-    const static ExprVt Vt = {.emit_ = FStringSpecExpr__emit_, .dtor = UnaryExpr__dtor};
     FStringSpecExpr* self = PK_MALLOC(sizeof(FStringSpecExpr));
-    self->vt = &Vt;
+    self->vt = &FStringSpecExprVt;
     self->line = line;
     self->child = child;
     self->spec = spec;
@@ -539,9 +541,35 @@ static SequenceExpr* SequenceExpr__new(int line, const ExprVt* vt, int count, Op
     return self;
 }
 
+static void FStringExpr__emit_(Expr* self_, Ctx* ctx) {
+    SequenceExpr* self = (SequenceExpr*)self_;
+    bool has_spec = false;
+    for(int i = 0; i < self->itemCount; i++) {
+        if(self->items[i]->vt == &FStringSpecExprVt) has_spec = true;
+    }
+    if(!has_spec) {
+        SequenceExpr__emit_(self_, ctx);
+        return;
+    }
+    // parse the specs once at compile time
+    FStringLayout layout;
+    layout.count = self->itemCount;
+    layout.specs = PK_MALLOC(sizeof(FormatSpec) * self->itemCount);
+    for(int i = 0; i < self->itemCount; i++) {
+        Expr* item = self->items[i];
+        c11_sv spec = {NULL, 0};
+        if(item->vt == &FStringSpecExprVt) spec = ((FStringSpecExpr*)item)->spec;
+        FormatSpec__parse(&layout.specs[i], spec);
+        vtemit_(item, ctx);
+    }
+    int index = ctx->co->fstrings.length;
+    c11_vector__push(FStringLayout, &ctx->co->fstrings, layout);
+    Ctx__emit_(ctx, OP_BUILD_FSTRING, index, self->line);
+}
+
 SequenceExpr* FStringExpr__new(int line, int count) {
-    const static ExprVt ListExprVt = {.dtor = SequenceExpr__dtor, .emit_ = SequenceExpr__emit_};
-    return SequenceExpr__new(line, &ListExprVt, count, OP_BUILD_STRING);
+    const static ExprVt FStringExprVt = {.dtor = SequenceExpr__dtor, .emit_ = FStringExpr__emit_};
+    return SequenceExpr__new(line, &FStringExprVt, count, OP_BUILD_STRING);
 }
 
 SequenceExpr* ListExpr__new(int line, int count) {
@@ -1098,6 +1126,7 @@ static void Ctx__ctor(Ctx* self, CodeObject* co, FuncDecl* func, int level) {
     self->level = level;
     self->curr_iblock = 0;
     self->is_compiling_class = false;
+    self->class_iblock = 0;
     c11_vector__ctor(&self->s_expr, sizeof(Expr*));
     c11_smallmap_n2d__ctor(&self->global_names);
     c11_smallmap_v2d__ctor(&self->co_consts_string_dedup_map);
@@ -1148,7 +1177,13 @@ static int Ctx__prepare_loop_divert(Ctx* self, int line, bool is_break) {
 }
 
 static int Ctx__enter_block(Ctx* self, CodeBlockType type) {
-    CodeBlock block = {type, self->curr_iblock, self->co->codes.length, -1, -1};
+    CodeBlock* parent = c11__at(CodeBlock, &self->co->blocks, self->curr_iblock);
+    int depth = parent->depth;
+    // context blocks keep their object on the stack
+    if(parent->type == CodeBlockType_FOR_LOOP || parent->type == CodeBlockType_WITH) depth++;
+    // so does the class object while compiling its body
+    if(self->is_compiling_class && self->curr_iblock < self->class_iblock) depth++;
+    CodeBlock block = {type, self->curr_iblock, self->co->codes.length, -1, -1, depth};
     c11_vector__push(CodeBlock, &self->co->blocks, block);
     self->curr_iblock = self->co->blocks.length - 1;
     return self->curr_iblock;
@@ -1320,11 +1355,13 @@ typedef struct Compiler {
     int tokens_length;
 
     int i;  // current token index
+    int optimize_level;
     c11_vector /*T=CodeEmitContext*/ contexts;
 } Compiler;
 
 static void Compiler__ctor(Compiler* self, SourceData_ src, Token* tokens, int tokens_length) {
     self->src = src;
+    self->optimize_level = 0;
     self->tokens = tokens;
     self->tokens_length = tokens_length;
     self->i = 0;
@@ -1567,6 +1604,23 @@ static Error* pop_context(Compiler* self) {
 
         assert(func->type != FuncType_UNSET);
     }
+    if(func && co->codes.length >= 2) {
+        Bytecode* codes = (Bytecode*)co->codes.data;
+
+        if(codes[0].op == OP_LOAD_CONST && codes[1].op == OP_POP_TOP) {
+            // handle optional docstring
+            py_TValue* consts = co->consts.data;
+            py_TValue* c = &consts[codes[0].arg];
+            if(py_isstr(c)) {
+                func->docstring = py_tostr(c);
+                codes[0].op = OP_NO_OP;
+                codes[1].op = OP_NO_OP;
+            }
+        }
+    }
+    // run the optimizer after `func->type` is known, dead `yield` still makes a generator
+    pk_optimize(co, self->optimize_level);
+    CodeObject__finalize(co);
     Ctx__dtor(ctx());
     c11_vector__pop(&self->contexts);
     return NULL;
@@ -2431,21 +2485,6 @@ static Error* compile_function(Compiler* self, int decorators) {
     check(compile_block_body(self));
     check(pop_context(self));
 
-    if(decl->code.codes.length >= 2) {
-        Bytecode* codes = (Bytecode*)decl->code.codes.data;
-
-        if(codes[0].op == OP_LOAD_CONST && codes[1].op == OP_POP_TOP) {
-            // handle optional docstring
-            py_TValue* consts = decl->code.consts.data;
-            py_TValue* c = &consts[codes[0].arg];
-            if(py_isstr(c)) {
-                decl->docstring = py_tostr(c);
-                codes[0].op = OP_NO_OP;
-                codes[1].op = OP_NO_OP;
-            }
-        }
-    }
-
     Ctx__emit_(ctx(), OP_LOAD_FUNCTION, decl_index, def_line);
     Ctx__s_emit_decorators(ctx(), decorators);
 
@@ -2493,6 +2532,7 @@ static Error* compile_class(Compiler* self, int decorators) {
         if(it->is_compiling_class) return SyntaxError(self, "nested class is not allowed");
     }
     ctx()->is_compiling_class = true;
+    ctx()->class_iblock = ctx()->co->blocks.length;
     check(compile_block_body(self));
     ctx()->is_compiling_class = false;
 
@@ -2626,8 +2666,8 @@ static Error* compile_try_except(Compiler* self) {
     int patches[8];
     int patches_length = 0;
 
+    // no instruction is emitted on entry, handlers are found by `co->exc_table`
     Ctx__enter_block(ctx(), CodeBlockType_TRY);
-    Ctx__emit_(ctx(), OP_TRY_ENTER, BC_NOARG, prev()->line);
     check(compile_block_body(self));
 
     // https://docs.python.org/3/reference/compound_stmts.html#finally-clause
@@ -2934,7 +2974,7 @@ Error* Compiler__compile(Compiler* self, CodeObject* out) {
     return NULL;
 }
 
-Error* pk_compile(SourceData_ src, CodeObject* out) {
+Error* pk_compile(SourceData_ src, int optimize_level, CodeObject* out) {
     Token* tokens;
     int tokens_length;
     Error* err = Lexer__process(src, &tokens, &tokens_length);
@@ -2962,6 +3002,7 @@ Error* pk_compile(SourceData_ src, CodeObject* out) {
 
     Compiler compiler;
     Compiler__ctor(&compiler, src, tokens, tokens_length);
+    compiler.optimize_level = optimize_level;
     CodeObject__ctor(out, src, c11_string__sv(src->filename));
     err = Compiler__compile(&compiler, out);
     if(err) {
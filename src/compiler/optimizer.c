@@ -0,0 +1,440 @@
+#include "pocketpy/compiler/compiler.h"
+#include "pocketpy/interpreter/vm.h"
+#include <stdbool.h>
+#include <string.h>
+
+// This is the maximum length of a string that can be produced by constant folding
+#define PK_OPTIMIZER_MAX_STR_LEN 256
+// This is the maximum number of optimization rounds for a code object
+#define PK_OPTIMIZER_MAX_ROUNDS 4
+
+typedef struct Optimizer {
+    CodeObject* co;
+    Bytecode* codes;
+    BytecodeEx* codes_ex;
+    int length;
+    bool* is_target;  // jumped to by some instruction or an exception handler
+} Optimizer;
+
+static int Optimizer__jump_target(Optimizer* self, int i) {
+    return i + (int16_t)self->codes[i].arg;
+}
+
+static bool Opcode__is_unconditional_jump(Opcode op) {
+    return op == OP_JUMP_FORWARD || op == OP_LOOP_CONTINUE || op == OP_LOOP_BREAK;
+}
+
+static bool Opcode__is_terminator(Opcode op) {
+    if(Opcode__is_unconditional_jump(op)) return true;
+    return op == OP_RETURN_VALUE || op == OP_RAISE || op == OP_RAISE_ASSERT;
+}
+
+static void Optimizer__refresh(Optimizer* self) {
+    CodeObject* co = self->co;
+    self->codes = co->codes.data;
+    self->codes_ex = co->codes_ex.data;
+    self->length = co->codes.length;
+    memset(self->is_target, 0, sizeof(bool) * (self->length + 1));
+    for(int i = 0; i < self->length; i++) {
+        if(!Bytecode__is_forward_jump(&self->codes[i])) continue;
+        int target = Optimizer__jump_target(self, i);
+        if(target >= 0 && target <= self->length) self->is_target[target] = true;
+    }
+    // exception handlers are entered at the end of try blocks
+    c11__foreach(CodeBlock, &co->blocks, block) {
+        if(block->type == CodeBlockType_TRY) self->is_target[block->end] = true;
+    }
+}
+
+/* constant folding */
+static bool Optimizer__load_const(Optimizer* self, int i, py_TValue* out) {
+    Bytecode bc = self->codes[i];
+    switch(bc.op) {
+        case OP_LOAD_CONST: {
+            py_TValue* val = c11__at(py_TValue, &self->co->consts, bc.arg);
+            switch(val->type) {
+                case tp_int:
+                case tp_float:
+                case tp_str: *out = *val; return true;
+                default: return false;
+            }
+        }
+        case OP_LOAD_SMALL_INT: py_newint(out, (int16_t)bc.arg); return true;
+        case OP_LOAD_TRUE: py_newbool(out, true); return true;
+        case OP_LOAD_FALSE: py_newbool(out, false); return true;
+        case OP_LOAD_NONE: py_newnone(out); return true;
+        default: return false;
+    }
+}
+
+static void Optimizer__store_const(Optimizer* self, int i, py_Ref val) {
+    Bytecode* bc = &self->codes[i];
+    switch(val->type) {
+        case tp_int: {
+            py_i64 x = val->_i64;
+            if(INT16_MIN <= x && x <= INT16_MAX) {
+                bc->op = OP_LOAD_SMALL_INT;
+                bc->arg = (uint16_t)x;
+                return;
+            }
+            break;
+        }
+        case tp_bool: {
+            bc->op = val->_bool ? OP_LOAD_TRUE : OP_LOAD_FALSE;
+            bc->arg = BC_NOARG;
+            return;
+        }
+        case tp_NoneType: {
+            bc->op = OP_LOAD_NONE;
+            bc->arg = BC_NOARG;
+            return;
+        }
+        default: break;
+    }
+    c11_vector__push(py_TValue, &self->co->consts, *val);
+    bc->op = OP_LOAD_CONST;
+    bc->arg = self->co->consts.length - 1;
+}
+
+static bool Optimizer__is_number(py_Ref val) { return val->type == tp_int || val->type == tp_float; }
+
+static double Optimizer__to_float(py_Ref val) {
+    return val->type == tp_int ? (double)val->_i64 : val->_f64;
+}
+
+static int Optimizer__strlen(py_Ref val) { return py_tosv(val).size; }
+
+// returns true if `lhs <op> rhs` is pure and cannot raise
+static bool Optimizer__can_fold_binary(Opcode op, py_Ref lhs, py_Ref rhs) {
+    bool num_num = Optimizer__is_number(lhs) && Optimizer__is_number(rhs);
+    bool int_int = lhs->type == tp_int && rhs->type == tp_int;
+    bool str_str = lhs->type == tp_str && rhs->type == tp_str;
+    switch(op) {
+        case OP_BINARY_ADD:
+            if(str_str) {
+                return Optimizer__strlen(lhs) + Optimizer__strlen(rhs) <= PK_OPTIMIZER_MAX_STR_LEN;
+            }
+            return num_num;
+        case OP_BINARY_SUB: return num_num;
+        case OP_BINARY_MUL: {
+            if(lhs->type == tp_str && rhs->type == tp_int) {
+                py_i64 n = rhs->_i64;
+                int size = Optimizer__strlen(lhs);
+                return n >= 0 && (size == 0 || n <= PK_OPTIMIZER_MAX_STR_LEN / size);
+            }
+            return num_num;
+        }
+        case OP_BINARY_TRUEDIV: return num_num && Optimizer__to_float(rhs) != 0;
+        case OP_BINARY_FLOORDIV:
+        case OP_BINARY_MOD:
+            if(int_int) return rhs->_i64 != 0 && rhs->_i64 != -1;
+            return num_num && Optimizer__to_float(rhs) != 0;
+        case OP_BINARY_POW:
+            if(int_int) return rhs->_i64 >= 0;
+            return num_num && Optimizer__to_float(lhs) > 0;
+        case OP_BINARY_LSHIFT:
+        case OP_BINARY_RSHIFT: return int_int && rhs->_i64 >= 0 && rhs->_i64 < 64;
+        case OP_BINARY_AND:
+        case OP_BINARY_OR:
+        case OP_BINARY_XOR: return int_int;
+        case OP_COMPARE_LT:
+        case OP_COMPARE_LE:
+        case OP_COMPARE_GT:
+        case OP_COMPARE_GE:
+        case OP_COMPARE_EQ:
+        case OP_COMPARE_NE: return num_num || str_str;
+        default: return false;
+    }
+}
+
+static bool Optimizer__eval_binary(Opcode op, py_Ref lhs, py_Ref rhs, py_TValue* out) {
+    py_Name name, rname;
+    switch(op) {
+        case OP_BINARY_ADD: name = __add__, rname = __radd__; break;
+        case OP_BINARY_SUB: name = __sub__, rname = __rsub__; break;
+        case OP_BINARY_MUL: name = __mul__, rname = __rmul__; break;
+        case OP_BINARY_TRUEDIV: name = __truediv__, rname = __rtruediv__; break;
+        case OP_BINARY_FLOORDIV: name = __floordiv__, rname = __rfloordiv__; break;
+        case OP_BINARY_MOD: name = __mod__, rname = __rmod__; break;
+        case OP_BINARY_POW: name = __pow__, rname = __rpow__; break;
+        case OP_BINARY_LSHIFT: name = __lshift__, rname = 0; break;
+        case OP_BINARY_RSHIFT: name = __rshift__, rname = 0; break;
+        case OP_BINARY_AND: name = __and__, rname = 0; break;
+        case OP_BINARY_OR: name = __or__, rname = 0; break;
+        case OP_BINARY_XOR: name = __xor__, rname = 0; break;
+        case OP_COMPARE_LT: name = __lt__, rname = __gt__; break;
+        case OP_COMPARE_LE: name = __le__, rname = __ge__; break;
+        case OP_COMPARE_EQ: name = __eq__, rname = __eq__; break;
+        case OP_COMPARE_NE: name = __ne__, rname = __ne__; break;
+        case OP_COMPARE_GT: name = __gt__, rname = __lt__; break;
+        case OP_COMPARE_GE: name = __ge__, rname = __le__; break;
+        default: return false;
+    }
+    py_StackRef p0 = py_peek(0);
+    if(!py_binaryop(lhs, rhs, name, rname)) {
+        py_clearexc(p0);
+        return false;
+    }
+    *out = *py_retval();
+    if(out->type == tp_str && Optimizer__strlen(out) > PK_OPTIMIZER_MAX_STR_LEN) return false;
+    return Optimizer__is_number(out) || out->type == tp_bool || out->type == tp_str;
+}
+
+static int Optimizer__truthiness(py_Ref val) {
+    if(val->type == tp_str) return Optimizer__strlen(val) != 0;
+    return py_bool(val);  // builtin constants never raise
+}
+
+static bool Optimizer__fold_constants(Optimizer* self) {
+    // never fold while an exception is being raised or handled
+    if(py_checkexc(false)) return false;
+    bool changed = false;
+    py_TValue a, b, res;
+    for(int i = 0; i < self->length; i++) {
+        if(self->co->consts.length >= 65530) break;
+        if(!Optimizer__load_const(self, i, &a)) continue;
+        // [a] UNARY_*
+        if(i + 1 < self->length && !self->is_target[i + 1]) {
+            Opcode op = self->codes[i + 1].op;
+            if(op == OP_UNARY_NOT) {
+                py_newbool(&res, !Optimizer__truthiness(&a));
+            } else if(op == OP_UNARY_NEGATIVE && Optimizer__is_number(&a) &&
+                      !(a.type == tp_int && a._i64 == INT64_MIN)) {
+                if(a.type == tp_int) {
+                    py_newint(&res, -a._i64);
+                } else {
+                    py_newfloat(&res, -a._f64);
+                }
+            } else {
+                goto __BINARY;
+            }
+            self->codes[i].op = OP_NO_OP;
+            Optimizer__store_const(self, i + 1, &res);
+            changed = true;
+            continue;
+        }
+    __BINARY:
+        // [a] [b] BINARY_*
+        if(i + 2 >= self->length || self->is_target[i + 1] || self->is_target[i + 2]) continue;
+        if(!Optimizer__load_const(self, i + 1, &b)) continue;
+        Opcode op = self->codes[i + 2].op;
+        if(!Optimizer__can_fold_binary(op, &a, &b)) continue;
+        if(!Optimizer__eval_binary(op, &a, &b, &res)) continue;
+        self->codes[i].op = OP_NO_OP;
+        self->codes[i + 1].op = OP_NO_OP;
+        Optimizer__store_const(self, i + 2, &res);
+        changed = true;
+    }
+    return changed;
+}
+
+/* control flow */
+static bool Optimizer__fold_const_jumps(Optimizer* self) {
+    bool changed = false;
+    py_TValue a;
+    for(int i = 0; i + 1 < self->length; i++) {
+        Bytecode* bc = &self->codes[i + 1];
+        if(bc->op != OP_POP_JUMP_IF_FALSE && bc->op != OP_POP_JUMP_IF_TRUE) continue;
+        if(self->is_target[i + 1]) continue;
+        if(!Optimizer__load_const(self, i, &a)) continue;
+        bool truthy = Optimizer__truthiness(&a);
+        bool taken = bc->op == OP_POP_JUMP_IF_TRUE ? truthy : !truthy;
+        self->codes[i].op = OP_NO_OP;
+        bc->op = taken ? OP_JUMP_FORWARD : OP_NO_OP;
+        changed = true;
+    }
+    return changed;
+}
+
+static bool Optimizer__thread_jumps(Optimizer* self) {
+    bool changed = false;
+    for(int i = 0; i < self->length; i++) {
+        Bytecode* bc = &self->codes[i];
+        if(!Bytecode__is_forward_jump(bc)) continue;
+        int target = Optimizer__jump_target(self, i);
+        // follow the chain of unconditional jumps
+        for(int hops = 0; hops < 16; hops++) {
+            if(target >= self->length) break;
+            if(!Opcode__is_unconditional_jump(self->codes[target].op)) break;
+            int next = Optimizer__jump_target(self, target);
+            if(next == target) break;
+            target = next;
+        }
+        int offset = target - i;
+        if(offset != (int16_t)bc->arg && offset == (int16_t)offset) {
+            Bytecode__set_signed_arg(bc, offset);
+            changed = true;
+        }
+        // jump to the next instruction
+        if(offset == 1 && Opcode__is_unconditional_jump(bc->op)) {
+            bc->op = OP_NO_OP;
+            bc->arg = BC_NOARG;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+static bool Optimizer__remove_unreachable(Optimizer* self) {
+    bool* reachable = PK_MALLOC(sizeof(bool) * self->length);
+    int* worklist = PK_MALLOC(sizeof(int) * self->length);
+    memset(reachable, 0, sizeof(bool) * self->length);
+    int top = 0;
+    worklist[top++] = 0;
+    reachable[0] = true;
+    c11__foreach(CodeBlock, &self->co->blocks, block) {
+        if(block->type != CodeBlockType_TRY || block->end >= self->length) continue;
+        if(!reachable[block->end]) {
+            reachable[block->end] = true;
+            worklist[top++] = block->end;
+        }
+    }
+    while(top > 0) {
+        int i = worklist[--top];
+        Bytecode* bc = &self->codes[i];
+        int succ[2];
+        int n = 0;
+        if(!Opcode__is_terminator(bc->op)) succ[n++] = i + 1;
+        if(Bytecode__is_forward_jump(bc)) succ[n++] = Optimizer__jump_target(self, i);
+        for(int k = 0; k < n; k++) {
+            int j = succ[k];
+            if(j < 0 || j >= self->length || reachable[j]) continue;
+            reachable[j] = true;
+            worklist[top++] = j;
+        }
+    }
+    bool changed = false;
+    for(int i = 0; i < self->length; i++) {
+        if(reachable[i] || self->codes[i].op == OP_NO_OP) continue;
+        self->codes[i].op = OP_NO_OP;
+        self->codes[i].arg = BC_NOARG;
+        changed = true;
+    }
+    PK_FREE(worklist);
+    PK_FREE(reachable);
+    return changed;
+}
+
+/* superinstructions */
+static bool Optimizer__can_fuse(Optimizer* self, int i, int n) {
+    if(i + n > self->length) return false;
+    for(int k = 1; k < n; k++) {
+        if(self->is_target[i + k]) return false;
+    }
+    return true;
+}
+
+static void Optimizer__fuse(Optimizer* self, int i, int n, Opcode op, uint16_t arg) {
+    self->codes[i].op = op;
+    self->codes[i].arg = arg;
+    for(int k = 1; k < n; k++) {
+        self->codes[i + k].op = OP_NO_OP;
+        self->codes[i + k].arg = BC_NOARG;
+    }
+}
+
+static void Optimizer__emit_superinstructions(Optimizer* self) {
+    for(int i = 0; i < self->length; i++) {
+        Bytecode* bc = &self->codes[i];
+        switch(bc->op) {
+            case OP_LOAD_FAST: {
+                // LOAD_FAST x; LOAD_SMALL_INT k; BINARY_ADD; STORE_FAST x -> INC_FAST
+                if(Optimizer__can_fuse(self, i, 4) && bc[1].op == OP_LOAD_SMALL_INT &&
+                   bc[2].op == OP_BINARY_ADD && bc[3].op == OP_STORE_FAST &&
+                   bc[3].arg == bc->arg) {
+                    int delta = (int16_t)bc[1].arg;
+                    if(bc->arg < 256 && delta >= INT8_MIN && delta <= INT8_MAX) {
+                        uint16_t arg = bc->arg | ((uint8_t)(int8_t)delta << 8);
+                        Optimizer__fuse(self, i, 4, OP_INC_FAST, arg);
+                        i += 3;
+                        break;
+                    }
+                }
+                if(!Optimizer__can_fuse(self, i, 2) || bc->arg >= 256 || bc[1].arg >= 256) break;
+                if(bc[1].op == OP_LOAD_FAST) {
+                    Optimizer__fuse(self, i, 2, OP_LOAD_FAST_LOAD_FAST, bc->arg | bc[1].arg << 8);
+                    i += 1;
+                } else if(bc[1].op == OP_LOAD_ATTR) {
+                    Optimizer__fuse(self, i, 2, OP_LOAD_FAST_LOAD_ATTR, bc->arg | bc[1].arg << 8);
+                    i += 1;
+                }
+                break;
+            }
+            case OP_COMPARE_LT:
+            case OP_COMPARE_LE:
+            case OP_COMPARE_EQ:
+            case OP_COMPARE_NE:
+            case OP_COMPARE_GT:
+            case OP_COMPARE_GE: {
+                if(!Optimizer__can_fuse(self, i, 2) || bc[1].op != OP_POP_JUMP_IF_FALSE) break;
+                int target = Optimizer__jump_target(self, i + 1);
+                Opcode op = bc->op - OP_COMPARE_LT + OP_COMPARE_LT_JUMP_IF_FALSE;
+                Optimizer__fuse(self, i, 2, op, BC_NOARG);
+                Bytecode__set_signed_arg(bc, target - i);
+                i += 1;
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+// remove all `NO_OP`s and remap jumps, line numbers and blocks
+static void Optimizer__compact(Optimizer* self) {
+    int* map = PK_MALLOC(sizeof(int) * (self->length + 1));
+    int new_length = 0;
+    for(int i = 0; i < self->length; i++) {
+        map[i] = new_length;
+        if(self->codes[i].op != OP_NO_OP) new_length++;
+    }
+    map[self->length] = new_length;
+    if(new_length == self->length) {
+        PK_FREE(map);
+        return;
+    }
+    for(int i = 0; i < self->length; i++) {
+        Bytecode bc = self->codes[i];
+        if(bc.op == OP_NO_OP) continue;
+        int j = map[i];
+        if(Bytecode__is_forward_jump(&bc)) {
+            int target = Optimizer__jump_target(self, i);
+            Bytecode__set_signed_arg(&bc, map[target] - j);
+        }
+        self->codes[j] = bc;
+        self->codes_ex[j] = self->codes_ex[i];
+    }
+    c11__foreach(CodeBlock, &self->co->blocks, block) {
+        block->start = map[block->start];
+        if(block->end != -1) block->end = map[block->end];
+        if(block->end2 != -1) block->end2 = map[block->end2];
+    }
+    self->co->codes.length = new_length;
+    self->co->codes_ex.length = new_length;
+    PK_FREE(map);
+}
+
+void pk_optimize(CodeObject* co, int level) {
+    if(level <= 0 || co->codes.length == 0) return;
+    Optimizer self;
+    self.co = co;
+    self.is_target = PK_MALLOC(sizeof(bool) * (co->codes.length + 1));
+    for(int round = 0; round < PK_OPTIMIZER_MAX_ROUNDS; round++) {
+        bool changed = false;
+        Optimizer__refresh(&self);
+        if(level >= 2) changed |= Optimizer__fold_constants(&self);
+        changed |= Optimizer__fold_const_jumps(&self);
+        changed |= Optimizer__thread_jumps(&self);
+        Optimizer__refresh(&self);
+        changed |= Optimizer__remove_unreachable(&self);
+        Optimizer__compact(&self);
+        if(!changed) break;
+    }
+    // superinstructions hide the original patterns, so they are emitted last
+    Optimizer__refresh(&self);
+    Optimizer__emit_superinstructions(&self);
+    Optimizer__compact(&self);
+    PK_FREE(self.is_target);
+}
+
+#undef PK_OPTIMIZER_MAX_STR_LEN
+#undef PK_OPTIMIZER_MAX_ROUNDS
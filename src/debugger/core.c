@@ -261,10 +261,11 @@ void c11_debugger_exception_frames(c11_sbuf* buffer) {
     int idx = 0;
     c11__foreach(BaseExceptionFrame, debugger.exception_stacktrace, it) {
         if(idx > 0) c11_sbuf__write_char(buffer, ',');
-        int line = it->lineno;
-        const char* filename = it->src->filename->data;
+        int line = BaseExceptionFrame__lineno(it);
+        const char* filename = BaseExceptionFrame__src(it)->filename->data;
         const char* basename = get_basename(filename);
-        const char* modname = it->name == NULL ? basename : it->name->data;
+        const char* name = BaseExceptionFrame__name(it);
+        const char* modname = name == NULL ? basename : name;
         pk_sprintf(
             buffer,
             "{\"id\": %d, \"name\": %Q, \"line\": %d, \"column\": 1, \"source\": {\"name\": %Q, \"path\": %Q}}",
@@ -11,8 +11,6 @@
 #include <assert.h>
 #include <time.h>
 
-static bool stack_format_object(VM* self, c11_sv spec);
-
 #define CHECK_RETURN_FROM_EXCEPT_OR_FINALLY()                                                      \
     if(self->is_curr_exc_handled) py_clearexc(NULL)
 
@@ -34,7 +32,7 @@ static bool stack_format_object(VM* self, c11_sv spec);
 
 #define RESET_CO_CACHE()                                                                           \
     do {                                                                                           \
-        co_codes = frame->co->codes.data;                                                          \
+        co_codes = frame->co->units.data;                                                          \
         co_names = frame->co->names.data;                                                          \
     } while(0)
 
@@ -88,7 +86,7 @@ static bool unpack_dict_to_buffer(py_Ref key, py_Ref val, void* ctx) {
 
 FrameResult VM__run_top_frame(VM* self) {
     py_Frame* frame = self->top_frame;
-    Bytecode* co_codes;
+    CodeUnit* co_codes;
     py_Name* co_names;
     Bytecode byte;
 
@@ -103,7 +101,8 @@ __NEXT_FRAME:
     frame->ip++;
 
 __NEXT_STEP:
-    byte = co_codes[frame->ip];
+    byte.op = co_codes[frame->ip].op;
+    byte.arg = co_codes[frame->ip].arg;
 
     if(self->trace_info.func) {
         bool is_virtual = byte.op == OP_RETURN_VALUE && byte.arg == BC_RETURN_VIRTUAL;
@@ -119,6 +118,10 @@ __NEXT_STEP:
         }
     }
 
+#if PK_ENABLE_OPCODE_PROFILER
+    if(self->opcode_profiler.enabled) OpcodeProfiler__record(&self->opcode_profiler, byte.op);
+#endif
+
 #if PK_ENABLE_WATCHDOG
     if(self->watchdog_info.max_reset_time > 0) {
         clock_t now = clock();
@@ -130,12 +133,19 @@ __NEXT_STEP:
     }
 #endif
 
+__NEXT_OP:
 #ifndef NDEBUG
     pk_print_stack(self, frame, byte);
 #endif
 
     switch((Opcode)byte.op) {
         case OP_NO_OP: DISPATCH();
+        case OP_EXTENDED_ARG: {
+            frame->ip++;
+            byte.op = co_codes[frame->ip].op;
+            byte.arg = (byte.arg << 8) | co_codes[frame->ip].arg;
+            goto __NEXT_OP;
+        }
         /*****************************************/
         case OP_POP_TOP: POP(); DISPATCH();
         case OP_DUP_TOP: PUSH(TOP()); DISPATCH();
@@ -602,8 +612,10 @@ __NEXT_STEP:
             c11_sbuf ss;
             c11_sbuf__ctor(&ss);
             for(int i = 0; i < byte.arg; i++) {
-                if(!py_str(begin + i)) goto __ERROR;
-                c11_sbuf__write_sv(&ss, py_tosv(&self->last_retval));
+                if(!pk_write_str(&ss, begin + i)) {
+                    c11_sbuf__dtor(&ss);
+                    goto __ERROR;
+                }
             }
             SP() = begin;
             c11_sbuf__py_submit(&ss, SP()++);
@@ -1135,10 +1147,6 @@ __NEXT_STEP:
             DISPATCH();
         }
         ///////////
-        case OP_TRY_ENTER: {
-            Frame__set_unwind_target(frame, SP());
-            DISPATCH();
-        }
         case OP_EXCEPTION_MATCH: {
             if(!py_checktype(TOP(), tp_type)) goto __ERROR;
             bool ok = py_isinstance(&self->curr_exception, py_totype(TOP()));
@@ -1212,23 +1220,105 @@ __NEXT_STEP:
             DISPATCH();
         }
         //////////////////
-        case OP_FORMAT_STRING: {
-            py_Ref spec = c11__at(py_TValue, &frame->co->consts, byte.arg);
-            bool ok = stack_format_object(self, py_tosv(spec));
-            if(!ok) goto __ERROR;
+        case OP_BUILD_FSTRING: {
+            FStringLayout* layout = c11__at(FStringLayout, &frame->co->fstrings, byte.arg);
+            py_TValue* begin = SP() - layout->count;
+            c11_sbuf ss;
+            c11_sbuf__ctor(&ss);
+            for(int i = 0; i < layout->count; i++) {
+                if(!pk_format_object(&ss, begin + i, &layout->specs[i])) {
+                    c11_sbuf__dtor(&ss);
+                    goto __ERROR;
+                }
+            }
+            SP() = begin;
+            c11_sbuf__py_submit(&ss, SP()++);
+            DISPATCH();
+        }
+        /*****************************************/
+        case OP_LOAD_FAST_LOAD_FAST: {
+            assert(!frame->is_locals_special);
+            int index = byte.arg & 0xFF;
+            py_Ref a = &frame->locals[index];
+            if(!py_isnil(a)) {
+                index = byte.arg >> 8;
+                py_Ref b = &frame->locals[index];
+                if(!py_isnil(b)) {
+                    PUSH(a);
+                    PUSH(b);
+                    DISPATCH();
+                }
+            }
+            py_Name name = c11__getitem(py_Name, &frame->co->varnames, index);
+            UnboundLocalError(name);
+            goto __ERROR;
+        }
+        case OP_LOAD_FAST_LOAD_ATTR: {
+            assert(!frame->is_locals_special);
+            py_Ref val = &frame->locals[byte.arg & 0xFF];
+            if(py_isnil(val)) {
+                py_Name name = c11__getitem(py_Name, &frame->co->varnames, byte.arg & 0xFF);
+                UnboundLocalError(name);
+                goto __ERROR;
+            }
+            if(!py_getattr(val, co_names[byte.arg >> 8])) goto __ERROR;
+            PUSH(py_retval());
             DISPATCH();
         }
+        case OP_INC_FAST: {
+            // x = x + delta
+            assert(!frame->is_locals_special);
+            py_Ref val = &frame->locals[byte.arg & 0xFF];
+            int8_t delta = (int8_t)(byte.arg >> 8);
+            switch(val->type) {
+                case tp_int: val->_i64 += delta; DISPATCH();
+                case tp_float: val->_f64 += delta; DISPATCH();
+                default: {
+                    if(py_isnil(val)) {
+                        py_Name name = c11__getitem(py_Name, &frame->co->varnames, byte.arg & 0xFF);
+                        UnboundLocalError(name);
+                        goto __ERROR;
+                    }
+                    PUSH(val);
+                    py_newint(SP()++, delta);
+                    if(!pk_stack_binaryop(self, __add__, __radd__)) goto __ERROR;
+                    STACK_SHRINK(2);
+                    *val = self->last_retval;
+                    DISPATCH();
+                }
+            }
+        }
+#define CASE_COMPARE_JUMP(label, op, rop, cmp)                                                     \
+    case label: {                                                                                  \
+        if(SECOND()->type == tp_int && TOP()->type == tp_int) {                                    \
+            bool res = SECOND()->_i64 cmp TOP()->_i64;                                             \
+            STACK_SHRINK(2);                                                                       \
+            if(!res) DISPATCH_JUMP((int16_t)byte.arg);                                             \
+            DISPATCH();                                                                            \
+        }                                                                                          \
+        if(!pk_stack_binaryop(self, op, rop)) goto __ERROR;                                        \
+        POP();                                                                                     \
+        *TOP() = self->last_retval;                                                                \
+        int res = py_bool(TOP());                                                                  \
+        if(res < 0) goto __ERROR;                                                                  \
+        POP();                                                                                     \
+        if(!res) DISPATCH_JUMP((int16_t)byte.arg);                                                 \
+        DISPATCH();                                                                                \
+    }
+            CASE_COMPARE_JUMP(OP_COMPARE_LT_JUMP_IF_FALSE, __lt__, __gt__, <)
+            CASE_COMPARE_JUMP(OP_COMPARE_LE_JUMP_IF_FALSE, __le__, __ge__, <=)
+            CASE_COMPARE_JUMP(OP_COMPARE_EQ_JUMP_IF_FALSE, __eq__, __eq__, ==)
+            CASE_COMPARE_JUMP(OP_COMPARE_NE_JUMP_IF_FALSE, __ne__, __ne__, !=)
+            CASE_COMPARE_JUMP(OP_COMPARE_GT_JUMP_IF_FALSE, __gt__, __lt__, >)
+            CASE_COMPARE_JUMP(OP_COMPARE_GE_JUMP_IF_FALSE, __ge__, __le__, >=)
+#undef CASE_COMPARE_JUMP
         default: c11__unreachable();
     }
 
     c11__unreachable();
 
 __ERROR:
-    py_BaseException__stpush(frame,
-                             &self->curr_exception,
-                             frame->co->src,
-                             Frame__lineno(frame),
-                             !frame->is_locals_special ? frame->co->name->data : NULL);
+    py_BaseException__stpush(frame, &self->curr_exception, NULL, 0);
 __ERROR_RE_RAISE:
     do {
     } while(0);
@@ -1369,153 +1459,6 @@ bool py_gt(py_Ref lhs, py_Ref rhs) { return py_binaryop(lhs, rhs, __gt__, __lt__
 
 bool py_ge(py_Ref lhs, py_Ref rhs) { return py_binaryop(lhs, rhs, __ge__, __le__); }
 
-static bool stack_format_object(VM* self, c11_sv spec) {
-    // format TOS via `spec` inplace
-    // spec: '!r:.2f', '.2f'
-    py_StackRef val = TOP();
-    if(spec.size == 0) return py_str(val);
-
-    if(spec.data[0] == '!') {
-        if(c11_sv__startswith(spec, (c11_sv){"!r", 2})) {
-            spec.data += 2;
-            spec.size -= 2;
-            if(!py_repr(val)) return false;
-            py_assign(val, py_retval());
-            if(spec.size == 0) return true;
-        } else {
-            return ValueError("invalid conversion specifier (only !r is supported)");
-        }
-    }
-
-    assert(spec.size > 0);
-
-    if(spec.data[0] == ':') {
-        spec.data++;
-        spec.size--;
-    }
-
-    char type;
-    switch(spec.data[spec.size - 1]) {
-        case 'f':
-        case 'd':
-        case 's':
-            type = spec.data[spec.size - 1];
-            spec.size--;  // remove last char
-            break;
-        default: type = ' '; break;
-    }
-
-    char pad_c = ' ';
-    if(strchr("0-=*#@!~", spec.data[0])) {
-        pad_c = spec.data[0];
-        spec = c11_sv__slice(spec, 1);
-    }
-
-    char align;
-    if(spec.data[0] == '^') {
-        align = '^';
-        spec = c11_sv__slice(spec, 1);
-    } else if(spec.data[0] == '>') {
-        align = '>';
-        spec = c11_sv__slice(spec, 1);
-    } else if(spec.data[0] == '<') {
-        align = '<';
-        spec = c11_sv__slice(spec, 1);
-    } else {
-        align = (py_isint(val) || py_isfloat(val)) ? '>' : '<';
-    }
-
-    int dot = c11_sv__index(spec, '.');
-    py_i64 width, precision;
-
-    if(dot >= 0) {
-        if(dot == 0) {
-            // {.2f}
-            width = -1;
-        } else {
-            // {10.2f}
-            IntParsingResult res = c11__parse_uint(c11_sv__slice2(spec, 0, dot), &width, 10);
-            if(res != IntParsing_SUCCESS) return ValueError("invalid format specifier");
-        }
-        IntParsingResult res = c11__parse_uint(c11_sv__slice(spec, dot + 1), &precision, 10);
-        if(res != IntParsing_SUCCESS) return ValueError("invalid format specifier");
-    } else {
-        // {10s}
-        IntParsingResult res = c11__parse_uint(spec, &width, 10);
-        if(res != IntParsing_SUCCESS) return ValueError("invalid format specifier");
-        precision = -1;
-    }
-
-    if(type != 'f' && dot >= 0) {
-        return ValueError("precision not allowed in the format specifier");
-    }
-
-    c11_sbuf buf;
-    c11_sbuf__ctor(&buf);
-
-    if(type == 'f') {
-        py_f64 x;
-        if(!py_castfloat(val, &x)) {
-            c11_sbuf__dtor(&buf);
-            return false;
-        }
-        if(precision < 0) precision = 6;
-        c11_sbuf__write_f64(&buf, x, precision);
-    } else if(type == 'd') {
-        if(!py_checkint(val)) {
-            c11_sbuf__dtor(&buf);
-            return false;
-        }
-        c11_sbuf__write_i64(&buf, py_toint(val));
-    } else if(type == 's') {
-        if(!py_checkstr(val)) {
-            c11_sbuf__dtor(&buf);
-            return false;
-        }
-        c11_sbuf__write_sv(&buf, py_tosv(val));
-    } else {
-        if(!py_str(val)) {
-            c11_sbuf__dtor(&buf);
-            return false;
-        }
-        c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
-    }
-
-    c11_string* body = c11_sbuf__submit(&buf);
-    int length = c11_sv__u8_length(c11_string__sv(body));
-    c11_sbuf__ctor(&buf);  // reinit sbuf
-
-    if(width != -1 && width > length) {
-        switch(align) {
-            case '>': {
-                c11_sbuf__write_pad(&buf, width - length, pad_c);
-                c11_sbuf__write_sv(&buf, c11_string__sv(body));
-                break;
-            }
-            case '<': {
-                c11_sbuf__write_sv(&buf, c11_string__sv(body));
-                c11_sbuf__write_pad(&buf, width - length, pad_c);
-                break;
-            }
-            case '^': {
-                int pad_left = (width - length) / 2;
-                int pad_right = (width - length) - pad_left;
-                c11_sbuf__write_pad(&buf, pad_left, pad_c);
-                c11_sbuf__write_sv(&buf, c11_string__sv(body));
-                c11_sbuf__write_pad(&buf, pad_right, pad_c);
-                break;
-            }
-            default: c11__unreachable();
-        }
-    } else {
-        c11_sbuf__write_sv(&buf, c11_string__sv(body));
-    }
-
-    c11_string__delete(body);
-    // inplace update
-    c11_sbuf__py_submit(&buf, val);
-    return true;
-}
 
 #undef CHECK_RETURN_FROM_EXCEPT_OR_FINALLY
 #undef DISPATCH
@@ -0,0 +1,100 @@
+#include "pocketpy/interpreter/compile_cache.h"
+#include <string.h>
+
+static uint64_t CompileCache__hash(c11_sv source, c11_sv filename) {
+    return c11_sv__hash(source) * 31 + c11_sv__hash(filename);
+}
+
+static void CompileCacheEntry__dtor(CompileCacheEntry* self) {
+    c11_string__delete(self->source);
+    c11_string__delete(self->filename);
+}
+
+void CompileCache__ctor(CompileCache* self, int capacity) {
+    c11_vector__ctor(&self->entries, sizeof(CompileCacheEntry));
+    self->capacity = capacity;
+    self->tick = 0;
+    self->hits = 0;
+    self->misses = 0;
+}
+
+void CompileCache__dtor(CompileCache* self) {
+    CompileCache__clear(self);
+    c11_vector__dtor(&self->entries);
+}
+
+void CompileCache__clear(CompileCache* self) {
+    c11__foreach(CompileCacheEntry, &self->entries, entry) CompileCacheEntry__dtor(entry);
+    c11_vector__clear(&self->entries);
+}
+
+static int CompileCache__lru_index(CompileCache* self) {
+    int index = 0;
+    for(int i = 1; i < self->entries.length; i++) {
+        CompileCacheEntry* entry = c11__at(CompileCacheEntry, &self->entries, i);
+        if(entry->last_used < c11__at(CompileCacheEntry, &self->entries, index)->last_used) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+void CompileCache__set_capacity(CompileCache* self, int capacity) {
+    if(capacity < 0) capacity = 0;
+    self->capacity = capacity;
+    while(self->entries.length > capacity) {
+        int index = CompileCache__lru_index(self);
+        CompileCacheEntry__dtor(c11__at(CompileCacheEntry, &self->entries, index));
+        c11_vector__erase(CompileCacheEntry, &self->entries, index);
+    }
+}
+
+static bool CompileCache__cacheable(CompileCache* self, const char* source) {
+    // large sources are usually modules that are only executed once
+    return self->capacity > 0 && strlen(source) <= PK_COMPILE_CACHE_MAX_SOURCE;
+}
+
+py_Ref CompileCache__get(CompileCache* self,
+                         const char* source,
+                         const char* filename,
+                         enum py_CompileMode mode,
+                         bool is_dynamic) {
+    if(!CompileCache__cacheable(self, source)) return NULL;
+    c11_sv source_sv = {source, strlen(source)};
+    c11_sv filename_sv = {filename, strlen(filename)};
+    uint64_t hash = CompileCache__hash(source_sv, filename_sv);
+    c11__foreach(CompileCacheEntry, &self->entries, entry) {
+        if(entry->hash != hash || entry->mode != mode || entry->is_dynamic != is_dynamic) continue;
+        if(!c11__sveq(c11_string__sv(entry->source), source_sv)) continue;
+        if(!c11__sveq(c11_string__sv(entry->filename), filename_sv)) continue;
+        entry->last_used = ++self->tick;
+        self->hits++;
+        return &entry->code;
+    }
+    self->misses++;
+    return NULL;
+}
+
+void CompileCache__put(CompileCache* self,
+                       const char* source,
+                       const char* filename,
+                       enum py_CompileMode mode,
+                       bool is_dynamic,
+                       py_Ref code) {
+    if(!CompileCache__cacheable(self, source)) return;
+    CompileCacheEntry* entry;
+    if(self->entries.length < self->capacity) {
+        entry = c11_vector__emplace(&self->entries);
+    } else {
+        // evict the least recently used entry
+        entry = c11__at(CompileCacheEntry, &self->entries, CompileCache__lru_index(self));
+        CompileCacheEntry__dtor(entry);
+    }
+    entry->source = c11_string__new(source);
+    entry->filename = c11_string__new(filename);
+    entry->hash = CompileCache__hash(c11_string__sv(entry->source), c11_string__sv(entry->filename));
+    entry->mode = mode;
+    entry->is_dynamic = is_dynamic;
+    entry->last_used = ++self->tick;
+    entry->code = *code;
+}
@@ -0,0 +1,270 @@
+#include "pocketpy/interpreter/format.h"
+#include "pocketpy/interpreter/vm.h"
+
+#include <string.h>
+
+bool pk_write_str(c11_sbuf* buf, py_Ref val) {
+    switch(val->type) {
+        case tp_int: c11_sbuf__write_i64(buf, py_toint(val)); return true;
+        case tp_float: c11_sbuf__write_f64(buf, py_tofloat(val), -1); return true;
+        case tp_str: c11_sbuf__write_sv(buf, py_tosv(val)); return true;
+        default:
+            if(!py_str(val)) return false;
+            c11_sbuf__write_sv(buf, py_tosv(py_retval()));
+            return true;
+    }
+}
+
+bool pk_format_object(c11_sbuf* buf, py_Ref val, const FormatSpec* spec) {
+    if(spec->error) return ValueError("%s", spec->error);
+    if(spec->conversion == 'r') {
+        if(!py_repr(val)) return false;
+        val = py_retval();
+    }
+    char align = spec->align;
+    if(align == 0) align = (py_isint(val) || py_isfloat(val)) ? '>' : '<';
+
+    // write the body, then pad it in place
+    int start = buf->data.length;
+    switch(spec->type) {
+        case 'f': {
+            py_f64 x;
+            if(!py_castfloat(val, &x)) return false;
+            c11_sbuf__write_f64(buf, x, spec->precision < 0 ? 6 : spec->precision);
+            break;
+        }
+        case 'd': {
+            if(!py_checkint(val)) return false;
+            c11_sbuf__write_i64(buf, py_toint(val));
+            break;
+        }
+        case 's': {
+            if(!py_checkstr(val)) return false;
+            c11_sbuf__write_sv(buf, py_tosv(val));
+            break;
+        }
+        default: {
+            if(!pk_write_str(buf, val)) return false;
+            break;
+        }
+    }
+
+    if(spec->width <= 0) return true;
+    c11_sv body = {(const char*)buf->data.data + start, buf->data.length - start};
+    int length = c11_sv__u8_length(body);
+    if(spec->width <= length) return true;
+    int pad = spec->width - length;
+    int pad_left;
+    switch(align) {
+        case '>': pad_left = pad; break;
+        case '<': pad_left = 0; break;
+        case '^': pad_left = pad / 2; break;
+        default: c11__unreachable();
+    }
+    if(pad_left > 0) {
+        c11_sbuf__write_pad(buf, pad_left, spec->fill);
+        char* p = (char*)buf->data.data + start;
+        memmove(p + pad_left, p, body.size);
+        memset(p, spec->fill, pad_left);
+    }
+    c11_sbuf__write_pad(buf, pad - pad_left, spec->fill);
+    return true;
+}
+
+/****************** str.format() ******************/
+static void FormatTemplate__delete(FormatTemplate* self) {
+    c11_string__delete(self->source);
+    c11_string__delete(self->text);
+    c11_vector__dtor(&self->pieces);
+    PK_FREE(self);
+}
+
+static bool FormatTemplate__is_digits(c11_sv sv) {
+    for(int i = 0; i < sv.size; i++) {
+        if(sv.data[i] < '0' || sv.data[i] > '9') return false;
+    }
+    return sv.size > 0;
+}
+
+// length of the text written into `buf`, excluding the reserved string header
+static int FormatTemplate__text_size(c11_sbuf* buf) {
+    return buf->data.length - (int)sizeof(c11_string);
+}
+
+// parse `fmt` into a new template, NULL on error
+static FormatTemplate* FormatTemplate__new(c11_sv fmt, uint64_t hash) {
+    c11_sbuf text;
+    c11_sbuf__ctor(&text);
+    c11_vector pieces;
+    c11_vector__ctor(&pieces, sizeof(FormatPiece));
+    int literal_start = 0;
+    int next_index = 0;
+    char mode = 0;  // 'a' for automatic numbering, 'm' for manual numbering
+    const char* error = NULL;
+
+    int i = 0;
+    while(i < fmt.size) {
+        char c = fmt.data[i];
+        char next = i + 1 < fmt.size ? fmt.data[i + 1] : '\0';
+        if(c == '}') {
+            if(next != '}') {
+                error = "Single '}' encountered in format string";
+                break;
+            }
+            c11_sbuf__write_char(&text, '}');
+            i += 2;
+            continue;
+        }
+        if(c != '{') {
+            c11_sbuf__write_char(&text, c);
+            i++;
+            continue;
+        }
+        if(next == '{') {
+            c11_sbuf__write_char(&text, '{');
+            i += 2;
+            continue;
+        }
+        // {field!r:spec}
+        int end = i + 1;
+        while(end < fmt.size && fmt.data[end] != '}') {
+            if(fmt.data[end] == '{') {
+                error = "Unexpected '{' in field name";
+                break;
+            }
+            end++;
+        }
+        if(error) break;
+        if(end == fmt.size) {
+            error = "Expected '}' before end of string";
+            break;
+        }
+        c11_sv field = c11_sv__slice2(fmt, i + 1, end);
+        int name_size = 0;
+        while(name_size < field.size && field.data[name_size] != '!' &&
+              field.data[name_size] != ':') {
+            name_size++;
+        }
+        c11_sv name = c11_sv__slice2(field, 0, name_size);
+
+        FormatPiece piece;
+        piece.literal_start = literal_start;
+        piece.literal_size = FormatTemplate__text_size(&text) - literal_start;
+        piece.index = -1;
+        piece.name = NULL;
+        if(name.size == 0) {
+            if(mode == 'm') {
+                error = "Cannot switch from manual field numbering to automatic field "
+                        "specification";
+                break;
+            }
+            mode = 'a';
+            piece.index = next_index++;
+        } else if(FormatTemplate__is_digits(name)) {
+            if(mode == 'a') {
+                error = "Cannot switch from automatic field specification to manual field "
+                        "numbering";
+                break;
+            }
+            mode = 'm';
+            int64_t index;
+            if(c11__parse_uint(name, &index, 10) != IntParsing_SUCCESS || index > 0xffff) {
+                error = "Too many decimal digits in format string";
+                break;
+            }
+            piece.index = (int)index;
+        } else {
+            piece.name = py_namev(name);
+        }
+        FormatSpec__parse(&piece.spec, c11_sv__slice(field, name_size));
+        if(piece.spec.error) {
+            error = piece.spec.error;
+            break;
+        }
+        c11_vector__push(FormatPiece, &pieces, piece);
+        literal_start = FormatTemplate__text_size(&text);
+        i = end + 1;
+    }
+
+    if(error) {
+        c11_sbuf__dtor(&text);
+        c11_vector__dtor(&pieces);
+        ValueError("%s", error);
+        return NULL;
+    }
+
+    if(FormatTemplate__text_size(&text) > literal_start) {
+        FormatPiece piece;
+        memset(&piece, 0, sizeof(FormatPiece));
+        piece.literal_start = literal_start;
+        piece.literal_size = FormatTemplate__text_size(&text) - literal_start;
+        piece.index = -2;
+        c11_vector__push(FormatPiece, &pieces, piece);
+    }
+
+    FormatTemplate* self = PK_MALLOC(sizeof(FormatTemplate));
+    self->hash = hash;
+    self->source = c11_string__new2(fmt.data, fmt.size);
+    self->text = c11_sbuf__submit(&text);
+    self->pieces = pieces;
+    return self;
+}
+
+void FormatCache__ctor(FormatCache* self) { memset(self->slots, 0, sizeof(self->slots)); }
+
+void FormatCache__dtor(FormatCache* self) {
+    for(int i = 0; i < PK_FORMAT_CACHE_SIZE; i++) {
+        if(self->slots[i]) FormatTemplate__delete(self->slots[i]);
+        self->slots[i] = NULL;
+    }
+}
+
+static bool pk_str_format__run(FormatTemplate* t, int argc, py_Ref argv, py_Ref kwargs) {
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11__foreach(FormatPiece, &t->pieces, piece) {
+        c11_sbuf__write_cstrn(&buf, t->text->data + piece->literal_start, piece->literal_size);
+        if(piece->index == -2) continue;
+        py_TValue val;
+        if(piece->index >= 0) {
+            if(piece->index >= argc) {
+                c11_sbuf__dtor(&buf);
+                return IndexError("Replacement index %d out of range for positional args tuple",
+                                  piece->index);
+            }
+            val = argv[piece->index];
+        } else {
+            // the value is kept alive by `kwargs`
+            int res = kwargs ? py_dict_getitem(kwargs, py_name2ref(piece->name)) : 0;
+            if(res != 1) {
+                c11_sbuf__dtor(&buf);
+                return res == -1 ? false : KeyError(py_name2ref(piece->name));
+            }
+            val = *py_retval();
+        }
+        if(!pk_format_object(&buf, &val, &piece->spec)) {
+            c11_sbuf__dtor(&buf);
+            return false;
+        }
+    }
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+bool pk_str_format(c11_sv fmt, int argc, py_Ref argv, py_Ref kwargs) {
+    FormatCache* cache = &pk_current_vm->format_cache;
+    uint64_t hash = c11_sv__hash(fmt);
+    FormatTemplate** slot = &cache->slots[hash % PK_FORMAT_CACHE_SIZE];
+    FormatTemplate* t = *slot;
+    if(t && t->hash == hash && c11__sveq(c11_string__sv(t->source), fmt)) {
+        *slot = NULL;  // take it out while in use
+    } else {
+        t = FormatTemplate__new(fmt, hash);
+        if(!t) return false;
+    }
+    bool ok = pk_str_format__run(t, argc, argv, kwargs);
+    // a recursive call may have filled the slot
+    if(*slot) FormatTemplate__delete(*slot);
+    *slot = t;
+    return ok;
+}
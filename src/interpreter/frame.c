@@ -38,16 +38,6 @@ NameDict* FastLocals__to_namedict(py_TValue* locals, const CodeObject* co) {
     return dict;
 }
 
-UnwindTarget* UnwindTarget__new(UnwindTarget* next, int iblock, int offset) {
-    UnwindTarget* self = PK_MALLOC(sizeof(UnwindTarget));
-    self->next = next;
-    self->iblock = iblock;
-    self->offset = offset;
-    return self;
-}
-
-void UnwindTarget__delete(UnwindTarget* self) { PK_FREE(self); }
-
 py_Frame* Frame__new(const CodeObject* co,
                      py_StackRef p0,
                      py_GlobalRef module,
@@ -68,51 +58,26 @@ py_Frame* Frame__new(const CodeObject* co,
     self->locals = locals;
     self->is_locals_special = is_locals_special;
     self->ip = -1;
-    self->uw_list = NULL;
     return self;
 }
 
 void Frame__delete(py_Frame* self) {
-    while(self->uw_list) {
-        UnwindTarget* p = self->uw_list;
-        self->uw_list = p->next;
-        UnwindTarget__delete(p);
-    }
     FixedMemoryPool__dealloc(&pk_current_vm->pool_frame, self);
 }
 
 int Frame__prepare_jump_exception_handler(py_Frame* self, ValueStack* _s) {
-    // try to find a parent try block
-    int iblock = Frame__iblock(self);
-    while(iblock >= 0) {
-        CodeBlock* block = c11__at(CodeBlock, &self->co->blocks, iblock);
-        if(block->type == CodeBlockType_TRY) break;
-        iblock = block->parent;
-    }
-    if(iblock < 0) return -1;
-    UnwindTarget* uw = Frame__find_unwind_target(self, iblock);
-    _s->sp = (self->p0 + uw->offset);  // unwind the stack
-    return c11__at(CodeBlock, &self->co->blocks, iblock)->end;
+    if(self->ip < 0) return -1;
+    const CodeExceptionEntry* entry = CodeObject__exception_entry(self->co, self->ip);
+    if(entry == NULL) return -1;
+    _s->sp = Frame__stack_base(self) + entry->depth;  // unwind the stack
+    return entry->handler;
 }
 
-UnwindTarget* Frame__find_unwind_target(py_Frame* self, int iblock) {
-    UnwindTarget* uw;
-    for(uw = self->uw_list; uw; uw = uw->next) {
-        if(uw->iblock == iblock) return uw;
-    }
-    return NULL;
-}
-
-void Frame__set_unwind_target(py_Frame* self, py_TValue* sp) {
-    int iblock = Frame__iblock(self);
-    assert(iblock >= 0);
-    UnwindTarget* existing = Frame__find_unwind_target(self, iblock);
-    if(existing) {
-        existing->offset = sp - self->p0;
-    } else {
-        UnwindTarget* prev = self->uw_list;
-        self->uw_list = UnwindTarget__new(prev, iblock, sp - self->p0);
-    }
+py_StackRef Frame__stack_base(py_Frame* self) {
+    // [callable, <self>, args..., local_vars...]
+    //                    ^locals             ^base
+    if(self->is_locals_special) return self->p0;
+    return self->locals + self->co->nlocals;
 }
 
 void Frame__gc_mark(py_Frame* self, c11_vector* p_stack) {
@@ -123,10 +88,7 @@ void Frame__gc_mark(py_Frame* self, c11_vector* p_stack) {
 
 int Frame__lineno(const py_Frame* self) {
     int ip = self->ip;
-    if(ip >= 0) {
-        BytecodeEx* ex = c11__at(BytecodeEx, &self->co->codes_ex, ip);
-        return ex->lineno;
-    }
+    if(ip >= 0) return CodeObject__lineno(self->co, ip);
     if(!self->is_locals_special) return self->co->start_line;
     return 0;
 }
@@ -134,7 +96,7 @@ int Frame__lineno(const py_Frame* self) {
 int Frame__iblock(const py_Frame* self) {
     int ip = self->ip;
     if(ip < 0) return -1;
-    return c11__getitem(BytecodeEx, &self->co->codes_ex, ip).iblock;
+    return CodeObject__iblock(self->co, ip);
 }
 
 int Frame__getglobal(py_Frame* self, py_Name name) {
@@ -0,0 +1,222 @@
+#include "pocketpy/interpreter/frozen.h"
+#include "pocketpy/common/threads.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/types.h"
+#include "pocketpy/objects/base.h"
+#include "pocketpy/pocketpy.h"
+#include <assert.h>
+
+typedef struct FrozenChunk FrozenChunk;
+
+typedef struct FrozenChunk {
+    FrozenChunk* prev;
+    size_t used;
+    size_t capacity;
+} FrozenChunk;
+
+typedef struct FrozenEntry {
+    char* key;
+    py_TValue val;
+} FrozenEntry;
+
+#define FROZEN_CHUNK_SIZE (1024 * 1024)
+#define FROZEN_CHUNK_HEADER_SIZE ((sizeof(FrozenChunk) + 7) & ~(size_t)7)
+#define FrozenChunk__data(self) ((char*)(self) + FROZEN_CHUNK_HEADER_SIZE)
+
+static struct {
+    FrozenChunk* chunks;
+    c11_vector /* PyObject* */ objects_with_dtor;
+    c11_vector /* FrozenEntry* */ entries;  // entries never move, see `py_getfrozen`
+#if PK_ENABLE_THREADS
+    atomic_flag lock;
+#endif
+} pk_frozen_space;
+
+static void FrozenSpace__lock() {
+#if PK_ENABLE_THREADS
+    while(atomic_flag_test_and_set(&pk_frozen_space.lock)) {
+        c11_thrd_yield();
+    }
+#endif
+}
+
+static void FrozenSpace__unlock() {
+#if PK_ENABLE_THREADS
+    atomic_flag_clear(&pk_frozen_space.lock);
+#endif
+}
+
+void pk_frozen_initialize() {
+    pk_frozen_space.chunks = NULL;
+    c11_vector__ctor(&pk_frozen_space.objects_with_dtor, sizeof(PyObject*));
+    c11_vector__ctor(&pk_frozen_space.entries, sizeof(FrozenEntry*));
+}
+
+void pk_frozen_finalize() {
+    c11__foreach(PyObject*, &pk_frozen_space.objects_with_dtor, p_obj) {
+        PyObject__dtor(*p_obj);
+    }
+    c11_vector__dtor(&pk_frozen_space.objects_with_dtor);
+    c11__foreach(FrozenEntry*, &pk_frozen_space.entries, p_entry) {
+        PK_FREE((*p_entry)->key);
+        PK_FREE(*p_entry);
+    }
+    c11_vector__dtor(&pk_frozen_space.entries);
+    FrozenChunk* chunk = pk_frozen_space.chunks;
+    while(chunk) {
+        FrozenChunk* prev = chunk->prev;
+        PK_FREE(chunk);
+        chunk = prev;
+    }
+    pk_frozen_space.chunks = NULL;
+}
+
+PyObject* FrozenSpace__new(py_Type type, int slots, int udsize) {
+    assert(slots >= 0);
+    size_t size = sizeof(PyObject) + PK_OBJ_SLOTS_SIZE(slots) + udsize;
+    size = (size + 7) & ~(size_t)7;
+    FrozenSpace__lock();
+    FrozenChunk* chunk = pk_frozen_space.chunks;
+    if(chunk == NULL || chunk->used + size > chunk->capacity) {
+        size_t capacity = size > FROZEN_CHUNK_SIZE ? size : FROZEN_CHUNK_SIZE;
+        chunk = PK_MALLOC(FROZEN_CHUNK_HEADER_SIZE + capacity);
+        chunk->prev = pk_frozen_space.chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        pk_frozen_space.chunks = chunk;
+    }
+    PyObject* obj = (PyObject*)(FrozenChunk__data(chunk) + chunk->used);
+    chunk->used += size;
+    if(type == tp_frozendict) {
+        c11_vector__push(PyObject*, &pk_frozen_space.objects_with_dtor, obj);
+    }
+    FrozenSpace__unlock();
+
+    obj->type = type;
+    obj->gc_marked = true;
+    obj->is_frozen = true;
+    obj->slots = slots;
+    memset(obj->flex, 0, slots * sizeof(py_TValue));
+    return obj;
+}
+
+static void pk_frozen__submit(py_OutRef out, PyObject* obj) {
+    out->type = obj->type;
+    out->is_ptr = true;
+    out->_obj = obj;
+}
+
+static bool pk_frozen__copy(py_Ref val, py_OutRef out, int depth) {
+    if(depth > 1000) {
+        return py_exception(tp_RecursionError, "maximum recursion depth exceeded while freezing");
+    }
+    if(py_isfrozen(val)) {
+        *out = *val;
+        return true;
+    }
+    switch(val->type) {
+        case tp_NoneType:
+        case tp_bool:
+        case tp_int:
+        case tp_float: *out = *val; return true;
+        case tp_str: {
+            if(!val->is_ptr) {
+                *out = *val;
+                return true;
+            }
+            c11_string* src = PyObject__userdata(val->_obj);
+            PyObject* obj = FrozenSpace__new(tp_str, 0, sizeof(c11_string) + src->size + 1);
+            c11_string__ctor2(PyObject__userdata(obj), src->data, src->size);
+            pk_frozen__submit(out, obj);
+            return true;
+        }
+        case tp_bytes: {
+            int size;
+            unsigned char* data = py_tobytes(val, &size);
+            PyObject* obj = FrozenSpace__new(tp_bytes, 0, sizeof(c11_bytes) + size);
+            c11_bytes* ud = PyObject__userdata(obj);
+            ud->size = size;
+            memcpy(ud->data, data, size);
+            pk_frozen__submit(out, obj);
+            return true;
+        }
+        case tp_list:
+        case tp_tuple: {
+            py_TValue* p;
+            int length = pk_arrayview(val, &p);
+            PyObject* obj = FrozenSpace__new(tp_tuple, length, 0);
+            py_TValue* slots = PyObject__slots(obj);
+            for(int i = 0; i < length; i++) {
+                if(!pk_frozen__copy(&p[i], &slots[i], depth + 1)) return false;
+            }
+            pk_frozen__submit(out, obj);
+            return true;
+        }
+        case tp_dict: {
+            // keys and values are frozen into a temporary dict first,
+            // only native `__hash__` and `__eq__` can be invoked here
+            Dict* src = py_touserdata(val);
+            py_Ref tmp = py_pushtmp();
+            py_newdict(tmp);
+            c11__foreach(DictEntry, &src->entries, entry) {
+                if(py_isnil(&entry->key)) continue;
+                py_TValue key, value;
+                bool ok = pk_frozen__copy(&entry->key, &key, depth + 1) &&
+                          pk_frozen__copy(&entry->val, &value, depth + 1) &&
+                          py_dict_setitem(tmp, &key, &value);
+                if(!ok) {
+                    py_pop();
+                    return false;
+                }
+            }
+            pk_newfrozendict(out, tmp);
+            py_pop();
+            return true;
+        }
+        default: return TypeError("cannot freeze '%t' object", val->type);
+    }
+}
+
+bool py_freeze(py_Ref val) {
+    py_TValue out;
+    if(!pk_frozen__copy(val, &out, 0)) return false;
+    py_assign(py_retval(), &out);
+    return true;
+}
+
+bool py_isfrozen(py_Ref val) { return val->is_ptr && val->_obj->is_frozen; }
+
+bool py_setfrozen(const char* key, py_Ref val) {
+    py_TValue out;
+    if(!pk_frozen__copy(val, &out, 0)) return false;
+    FrozenSpace__lock();
+    c11__foreach(FrozenEntry*, &pk_frozen_space.entries, p_entry) {
+        if(strcmp((*p_entry)->key, key) == 0) {
+            FrozenSpace__unlock();
+            // we do not allow override since other VMs may hold references to the old value
+            return ValueError("frozen key '%s' already exists", key);
+        }
+    }
+    FrozenEntry* entry = PK_MALLOC(sizeof(FrozenEntry));
+    entry->key = c11_strdup(key);
+    entry->val = out;
+    c11_vector__push(FrozenEntry*, &pk_frozen_space.entries, entry);
+    FrozenSpace__unlock();
+    py_assign(py_retval(), &out);
+    return true;
+}
+
+py_GlobalRef py_getfrozen(const char* key) {
+    py_GlobalRef res = NULL;
+    FrozenSpace__lock();
+    // the entry is allocated on its own, so `res` stays valid after the vector grows
+    c11__foreach(FrozenEntry*, &pk_frozen_space.entries, p_entry) {
+        if(strcmp((*p_entry)->key, key) == 0) {
+            res = &(*p_entry)->val;
+            break;
+        }
+    }
+    FrozenSpace__unlock();
+    return res;
+}
@@ -71,6 +71,7 @@ bool generator__next__(int argc, py_Ref argv) {
     } else {
         assert(res == RES_RETURN);
         ud->state = 2;
+        if(py_isnone(py_retval())) return StopIteration();
         // raise StopIteration(<retval>)
         bool ok = py_tpcall(tp_StopIteration, 1, py_retval());
         if(!ok) return false;
@@ -95,6 +95,7 @@ PyObject* ManagedHeap__gcnew(ManagedHeap* self, py_Type type, int slots, int uds
     }
     obj->type = type;
     obj->gc_marked = false;
+    obj->is_frozen = false;
     obj->slots = slots;
 
     // initialize slots or dict
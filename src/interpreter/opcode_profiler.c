@@ -0,0 +1,81 @@
+#include "pocketpy/interpreter/opcode_profiler.h"
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/common/algorithm.h"
+#include "pocketpy/common/sstream.h"
+#include <string.h>
+
+void OpcodeProfiler__ctor(OpcodeProfiler* self) {
+    self->hits = NULL;
+    self->prev_op = -1;
+    self->enabled = false;
+}
+
+void OpcodeProfiler__dtor(OpcodeProfiler* self) { PK_FREE(self->hits); }
+
+void OpcodeProfiler__begin(OpcodeProfiler* self) {
+    if(self->hits == NULL) {
+        int size = sizeof(py_i64) * OP__COUNT__ * OP__COUNT__;
+        self->hits = PK_MALLOC(size);
+        memset(self->hits, 0, size);
+    }
+    self->prev_op = -1;
+    self->enabled = true;
+}
+
+void OpcodeProfiler__end(OpcodeProfiler* self) { self->enabled = false; }
+
+void OpcodeProfiler__reset(OpcodeProfiler* self) {
+    if(self->hits) memset(self->hits, 0, sizeof(py_i64) * OP__COUNT__ * OP__COUNT__);
+    self->prev_op = -1;
+}
+
+void OpcodeProfiler__record(OpcodeProfiler* self, Opcode op) {
+    if(self->prev_op >= 0) self->hits[self->prev_op * OP__COUNT__ + op]++;
+    self->prev_op = op;
+}
+
+static int OpcodePairRecord__gt(const void* a, const void* b, void* extra) {
+    return ((const OpcodePairRecord*)a)->hits > ((const OpcodePairRecord*)b)->hits;
+}
+
+void OpcodeProfiler__get_records(OpcodeProfiler* self, c11_vector* out) {
+    c11_vector__clear(out);
+    if(self->hits == NULL) return;
+    for(int i = 0; i < OP__COUNT__; i++) {
+        for(int j = 0; j < OP__COUNT__; j++) {
+            py_i64 hits = self->hits[i * OP__COUNT__ + j];
+            if(hits == 0) continue;
+            OpcodePairRecord record = {(uint8_t)i, (uint8_t)j, hits};
+            c11_vector__push(OpcodePairRecord, out, record);
+        }
+    }
+    c11__stable_sort(out->data,
+                     out->length,
+                     sizeof(OpcodePairRecord),
+                     OpcodePairRecord__gt,
+                     NULL);
+}
+
+#if PK_ENABLE_OPCODE_PROFILER
+void py_opcodeprofiler_begin() { OpcodeProfiler__begin(&pk_current_vm->opcode_profiler); }
+
+void py_opcodeprofiler_end() { OpcodeProfiler__end(&pk_current_vm->opcode_profiler); }
+
+void py_opcodeprofiler_reset() { OpcodeProfiler__reset(&pk_current_vm->opcode_profiler); }
+
+char* py_opcodeprofiler_report() {
+    c11_vector records;
+    c11_vector__ctor(&records, sizeof(OpcodePairRecord));
+    OpcodeProfiler__get_records(&pk_current_vm->opcode_profiler, &records);
+    c11_sbuf ss;
+    c11_sbuf__ctor(&ss);
+    c11__foreach(OpcodePairRecord, &records, it) {
+        pk_sprintf(&ss, "%s %s %i\n", pk_opname(it->first), pk_opname(it->second), it->hits);
+    }
+    c11_vector__dtor(&records);
+    c11_string* res = c11_sbuf__submit(&ss);
+    char* dup = c11_strdup(res->data);
+    c11_string__delete(res);
+    return dup;
+}
+#endif
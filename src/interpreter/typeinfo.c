@@ -80,11 +80,13 @@ static void py_TypeInfo__common_init(py_Name name,
     if(!dtor && base) dtor = base_ti->dtor;
     self->is_python = is_python;
     self->is_final = is_final;
+    self->is_method_like = false;
 
     self->getattribute = NULL;
     self->setattribute = NULL;
     self->delattribute = NULL;
     self->getunboundmethod = NULL;
+    self->getbuffer = NULL;
 
     self->annotations = *py_NIL();
     self->dtor = dtor;
@@ -175,3 +177,9 @@ void py_tphookattributes(py_Type type,
     ti->delattribute = delattribute;
     ti->getunboundmethod = getunboundmethod;
 }
+
+void py_tphookbuffer(py_Type type, bool (*getbuffer)(py_Ref self, py_Buffer* out)) {
+    assert(type);
+    py_TypeInfo* ti = pk_typeinfo(type);
+    ti->getbuffer = getbuffer;
+}
@@ -2,6 +2,7 @@
 #include "pocketpy/common/memorypool.h"
 #include "pocketpy/common/utils.h"
 #include "pocketpy/interpreter/generator.h"
+#include "pocketpy/interpreter/frozen.h"
 #include "pocketpy/interpreter/modules.h"
 #include "pocketpy/interpreter/typeinfo.h"
 #include "pocketpy/objects/base.h"
@@ -94,6 +95,9 @@ void VM__ctor(VM* self) {
 
     self->last_retval = *py_NIL();
     self->curr_exception = *py_NIL();
+    self->stop_iteration = *py_NIL();
+    self->next_frame = NULL;
+    self->is_in_next = false;
 
     self->recursion_depth = 0;
     self->max_recursion_depth = 1000;
@@ -106,6 +110,10 @@ void VM__ctor(VM* self) {
     memset(&self->trace_info, 0, sizeof(TraceInfo));
     memset(&self->watchdog_info, 0, sizeof(WatchdogInfo));
     LineProfiler__ctor(&self->line_profiler);
+    OpcodeProfiler__ctor(&self->opcode_profiler);
+    CompileCache__ctor(&self->compile_cache, PK_COMPILE_CACHE_SIZE);
+    FormatCache__ctor(&self->format_cache);
+    self->optimize_level = PK_OPTIMIZE_LEVEL;
 
     FixedMemoryPool__ctor(&self->pool_frame, sizeof(py_Frame), 32);
 
@@ -154,6 +162,8 @@ void VM__ctor(VM* self) {
     validate(tp_BaseException, pk_BaseException__register());
     validate(tp_Exception, pk_Exception__register());
     validate(tp_bytes, pk_bytes__register());
+    validate(tp_bytearray, pk_bytearray__register());
+    validate(tp_memoryview, pk_memoryview__register());
     validate(tp_namedict, pk_namedict__register());
     validate(tp_locals, pk_newtype("locals", tp_object, NULL, NULL, false, true));
     validate(tp_code, pk_code__register());
@@ -222,6 +232,8 @@ void VM__ctor(VM* self) {
         tp_slice,
         tp_range,
         tp_bytes,
+        tp_bytearray,
+        tp_memoryview,
         tp_dict,
         tp_property,
         tp_staticmethod,
@@ -240,6 +252,18 @@ void VM__ctor(VM* self) {
 
     pk__add_module_vmath();
     pk__add_module_array2d();
+    pk_frozendict__register();
+
+    // builtin iterators
+    if(tp_map != pk_map__register()) abort();
+    if(tp_filter != pk_filter__register()) abort();
+    if(tp_zip != pk_zip__register()) abort();
+    if(tp_enumerate != pk_enumerate__register()) abort();
+    for(py_Type t = tp_map; t <= tp_enumerate; t++) {
+        py_TypeInfo* ti = pk_typeinfo(t);
+        py_setdict(self->builtins, ti->name, &ti->self);
+    }
+    pk__add_module_collections();
     pk__add_module_colorcvt();
 
     // add modules
@@ -260,6 +284,9 @@ void VM__ctor(VM* self) {
     pk__add_module_base64();
     pk__add_module_importlib();
     pk__add_module_unicodedata();
+    pk__add_module_heapq();
+    pk__add_module_bisect();
+    pk__add_module_functools();
 
     pk__add_module_conio();
     pk__add_module_lz4();       // optional
@@ -285,6 +312,9 @@ void VM__dtor(VM* self) {
     // reset traceinfo
     py_sys_settrace(NULL, true);
     LineProfiler__dtor(&self->line_profiler);
+    OpcodeProfiler__dtor(&self->opcode_profiler);
+    CompileCache__dtor(&self->compile_cache);
+    FormatCache__dtor(&self->format_cache);
     // destroy all objects
     ManagedHeap__dtor(&self->heap);
     // clear frames
@@ -595,6 +625,13 @@ FrameResult VM__vectorcall(VM* self, uint16_t argc, uint16_t kwargc, bool opcall
     }
 
     // handle `__call__` overload
+    if(!py_isnil(p0 + 1)) {
+        // a callable object bound as a method, its `self` becomes the first argument
+        memmove(p0 + 2, p0 + 1, (self->stack.sp - (p0 + 1)) * sizeof(py_TValue));
+        self->stack.sp++;
+        py_newnil(p0 + 1);
+        argc++;
+    }
     if(pk_loadmethod(p0, __call__)) {
         // [__call__, self, args..., kwargs...]
         return VM__vectorcall(self, argc, kwargc, opcall);
@@ -652,6 +689,10 @@ void ManagedHeap__mark(ManagedHeap* self) {
         if(kv->key == NULL) continue;
         pk__mark_value(&kv->value);
     }
+    // mark compile cache
+    c11__foreach(CompileCacheEntry, &vm->compile_cache.entries, entry) {
+        pk__mark_value(&entry->code);
+    }
     // mark types
     int types_length = vm->types.length;
     // 0-th type is placeholder
@@ -667,6 +708,7 @@ void ManagedHeap__mark(ManagedHeap* self) {
     // mark vm's registers
     pk__mark_value(&vm->last_retval);
     pk__mark_value(&vm->curr_exception);
+    pk__mark_value(&vm->stop_iteration);
     for(int i = 0; i < c11__count_array(vm->reg); i++) {
         pk__mark_value(&vm->reg[i]);
     }
@@ -703,13 +745,7 @@ void ManagedHeap__mark(ManagedHeap* self) {
                 break;
             }
             case tp_dict: {
-                Dict* self = ud;
-                for(int i = 0; i < self->entries.length; i++) {
-                    DictEntry* entry = c11__at(DictEntry, &self->entries, i);
-                    if(py_isnil(&entry->key)) continue;
-                    pk__mark_value(&entry->key);
-                    pk__mark_value(&entry->val);
-                }
+                dict__gc_mark(ud, p_stack);
                 break;
             }
             case tp_generator: {
@@ -721,16 +757,6 @@ void ManagedHeap__mark(ManagedHeap* self) {
                 function__gc_mark(ud, p_stack);
                 break;
             }
-            case tp_BaseException: {
-                BaseException* self = ud;
-                pk__mark_value(&self->args);
-                pk__mark_value(&self->inner_exc);
-                c11__foreach(BaseExceptionFrame, &self->stacktrace, frame) {
-                    pk__mark_value(&frame->locals);
-                    pk__mark_value(&frame->globals);
-                }
-                break;
-            }
             case tp_code: {
                 CodeObject* self = ud;
                 CodeObject__gc_mark(self, p_stack);
@@ -740,6 +766,26 @@ void ManagedHeap__mark(ManagedHeap* self) {
                 c11_chunked_array2d__mark(ud, p_stack);
                 break;
             }
+            case tp_deque: {
+                c11_deque__mark(ud, p_stack);
+                break;
+            }
+            default: {
+                // subclasses of native types inherit their destructors
+                py_Dtor dtor = c11__getitem(TypePointer, &vm->types, obj->type).dtor;
+                if(dtor == (py_Dtor)Dict__dtor) {
+                    dict__gc_mark(ud, p_stack);
+                } else if(dtor == BaseException__dtor) {
+                    BaseException__gc_mark(ud, p_stack);
+                } else if(dtor == c11_deque__dtor) {
+                    c11_deque__mark(ud, p_stack);
+                } else if(dtor == lru_cache__dtor) {
+                    lru_cache__gc_mark(ud, p_stack);
+                } else if(dtor == c11_table__dtor) {
+                    c11_table__mark(ud, p_stack);
+                }
+                break;
+            }
         }
     }
 }
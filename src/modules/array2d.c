@@ -1,8 +1,13 @@
 #include "pocketpy/interpreter/array2d.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/common/threadpool.h"
 #include "pocketpy/pocketpy.h"
 #include <limits.h>
 
+#ifdef PK_BUILD_MODULE_LZ4
+#include "lz4/lib/lz4.h"
+#endif
+
 static bool c11_array2d_like_is_valid(c11_array2d_like* self, int col, int row) {
     return col >= 0 && col < self->n_cols && row >= 0 && row < self->n_rows;
 }
@@ -16,6 +21,66 @@ static bool c11_array2d__set(c11_array2d* self, int col, int row, py_Ref value)
     return true;
 }
 
+void c11_array2d__box(c11_array2d_dtype dtype, const void* buffer, int index, py_OutRef out) {
+    switch(dtype) {
+        case c11_array2d_dtype_bool: py_newbool(out, ((const bool*)buffer)[index]); return;
+        case c11_array2d_dtype_int8: py_newint(out, ((const int8_t*)buffer)[index]); return;
+        case c11_array2d_dtype_int16: py_newint(out, ((const int16_t*)buffer)[index]); return;
+        case c11_array2d_dtype_int32: py_newint(out, ((const int32_t*)buffer)[index]); return;
+        case c11_array2d_dtype_float32: py_newfloat(out, ((const float*)buffer)[index]); return;
+        case c11_array2d_dtype_float64: py_newfloat(out, ((const double*)buffer)[index]); return;
+        default: c11__unreachable();
+    }
+}
+
+static bool c11_array2d__check_range(c11_array2d_dtype dtype, py_i64 val, py_i64 lo, py_i64 hi) {
+    if(val >= lo && val <= hi) return true;
+    return ValueError("%i is out of range for '%s'", val, c11_array2d_dtype__name(dtype));
+}
+
+bool c11_array2d__unbox(c11_array2d_dtype dtype, void* buffer, int index, py_Ref value) {
+    switch(dtype) {
+        case c11_array2d_dtype_bool: {
+            if(!py_checkbool(value)) return false;
+            ((bool*)buffer)[index] = py_tobool(value);
+            return true;
+        }
+        case c11_array2d_dtype_int8: {
+            if(!py_checkint(value)) return false;
+            py_i64 val = py_toint(value);
+            if(!c11_array2d__check_range(dtype, val, INT8_MIN, INT8_MAX)) return false;
+            ((int8_t*)buffer)[index] = (int8_t)val;
+            return true;
+        }
+        case c11_array2d_dtype_int16: {
+            if(!py_checkint(value)) return false;
+            py_i64 val = py_toint(value);
+            if(!c11_array2d__check_range(dtype, val, INT16_MIN, INT16_MAX)) return false;
+            ((int16_t*)buffer)[index] = (int16_t)val;
+            return true;
+        }
+        case c11_array2d_dtype_int32: {
+            if(!py_checkint(value)) return false;
+            py_i64 val = py_toint(value);
+            if(!c11_array2d__check_range(dtype, val, INT32_MIN, INT32_MAX)) return false;
+            ((int32_t*)buffer)[index] = (int32_t)val;
+            return true;
+        }
+        case c11_array2d_dtype_float32: return py_castfloat32(value, (float*)buffer + index);
+        case c11_array2d_dtype_float64: return py_castfloat(value, (double*)buffer + index);
+        default: c11__unreachable();
+    }
+}
+
+static py_Ref c11_array2d__get_typed(c11_array2d* self, int col, int row) {
+    c11_array2d__box(self->dtype, self->buffer, row * self->header.n_cols + col, &self->scratch);
+    return &self->scratch;
+}
+
+static bool c11_array2d__set_typed(c11_array2d* self, int col, int row, py_Ref value) {
+    return c11_array2d__unbox(self->dtype, self->buffer, row * self->header.n_cols + col, value);
+}
+
 c11_array2d* c11_newarray2d(py_OutRef out, int n_cols, int n_rows) {
     int numel = n_cols * n_rows;
     c11_array2d* ud = py_newobject(out, tp_array2d, numel, sizeof(c11_array2d));
@@ -24,10 +89,53 @@ c11_array2d* c11_newarray2d(py_OutRef out, int n_cols, int n_rows) {
     ud->header.numel = numel;
     ud->header.f_get = (py_Ref(*)(c11_array2d_like*, int, int))c11_array2d__get;
     ud->header.f_set = (bool (*)(c11_array2d_like*, int, int, py_Ref))c11_array2d__set;
+    ud->dtype = c11_array2d_dtype_object;
     ud->data = py_getslot(out, 0);
     return ud;
 }
 
+c11_array2d*
+    c11_newarray2d_typed(py_OutRef out, int n_cols, int n_rows, c11_array2d_dtype dtype) {
+    if(dtype == c11_array2d_dtype_object) return c11_newarray2d(out, n_cols, n_rows);
+    int numel = n_cols * n_rows;
+    int size = numel * c11_array2d_dtype__itemsize(dtype);
+    // cells are packed right after the userdata, zero-initialized
+    c11_array2d* ud = py_newobject(out, tp_array2d, 0, sizeof(c11_array2d) + size);
+    ud->header.n_cols = n_cols;
+    ud->header.n_rows = n_rows;
+    ud->header.numel = numel;
+    ud->header.f_get = (py_Ref(*)(c11_array2d_like*, int, int))c11_array2d__get_typed;
+    ud->header.f_set = (bool (*)(c11_array2d_like*, int, int, py_Ref))c11_array2d__set_typed;
+    ud->dtype = dtype;
+    ud->buffer = ud + 1;
+    memset(ud->buffer, 0, size);
+    py_newnil(&ud->scratch);
+    return ud;
+}
+
+// `self` if it is an array2d with packed cells, otherwise NULL
+static c11_array2d* c11_array2d__typed(py_Ref self) {
+    if(!py_istype(self, tp_array2d)) return NULL;
+    c11_array2d* ud = py_touserdata(self);
+    return ud->dtype == c11_array2d_dtype_object ? NULL : ud;
+}
+
+bool c11_array2d_dtype__parse(py_Ref name, c11_array2d_dtype* out) {
+    if(py_isnone(name)) {
+        *out = c11_array2d_dtype_object;
+        return true;
+    }
+    if(!py_checkstr(name)) return false;
+    const char* s = py_tostr(name);
+    for(int i = c11_array2d_dtype_object; i <= c11_array2d_dtype_float64; i++) {
+        if(strcmp(s, c11_array2d_dtype__name(i)) == 0) {
+            *out = i;
+            return true;
+        }
+    }
+    return ValueError("unknown dtype: '%s'", s);
+}
+
 /* array2d_like bindings */
 static bool array2d_like_n_cols(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
@@ -108,8 +216,8 @@ static bool array2d_like_index(int argc, py_Ref argv) {
     py_Ref value = py_arg(1);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref item = self->f_get(self, i, j);
-            int code = py_equal(item, value);
+            py_TValue item = *self->f_get(self, i, j);
+            int code = py_equal(&item, value);
             if(code == -1) return false;
             if(code == 1) {
                 py_newvec2i(py_retval(),
@@ -143,6 +251,11 @@ static bool array2d_like_render(int argc, py_Ref argv) {
 static bool array2d_like_all(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed && typed->dtype == c11_array2d_dtype_bool) {
+        py_newbool(py_retval(), memchr(typed->buffer, 0, self->numel) == NULL);
+        return true;
+    }
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
             py_Ref item = self->f_get(self, i, j);
@@ -160,6 +273,11 @@ static bool array2d_like_all(int argc, py_Ref argv) {
 static bool array2d_like_any(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed && typed->dtype == c11_array2d_dtype_bool) {
+        py_newbool(py_retval(), memchr(typed->buffer, 1, self->numel) != NULL);
+        return true;
+    }
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
             py_Ref item = self->f_get(self, i, j);
@@ -174,21 +292,54 @@ static bool array2d_like_any(int argc, py_Ref argv) {
     return true;
 }
 
+// map(self, f) with `f` being `abs`, `float` or `bool`, false if not applicable
+static bool array2d__map_typed(c11_array2d* self, py_Ref f) {
+    c11_array2d_dtype dtype = self->dtype;
+    int n_cols = self->header.n_cols;
+    int n_rows = self->header.n_rows;
+    int n = self->header.numel;
+    c11_array2d* res;
+    if(py_istype(f, tp_type)) {
+        py_Type type = py_totype(f);
+        if(type == tp_float && dtype != c11_array2d_dtype_bool) {
+            res = c11_newarray2d_typed(py_retval(), n_cols, n_rows, c11_array2d_dtype_float64);
+            c11_array2d__cast(res->buffer, res->dtype, self->buffer, dtype, n);
+            return true;
+        }
+        if(type == tp_bool) {
+            res = c11_newarray2d_typed(py_retval(), n_cols, n_rows, c11_array2d_dtype_bool);
+            c11_array2d__nonzero(dtype, res->buffer, self->buffer, n);
+            return true;
+        }
+        return false;
+    }
+    py_Ref abs = py_getdict(pk_current_vm->builtins, py_name("abs"));
+    if(abs && py_isidentical(f, abs) && dtype != c11_array2d_dtype_bool) {
+        res = c11_newarray2d_typed(py_retval(), n_cols, n_rows, dtype);
+        c11_array2d__abs(dtype, res->buffer, self->buffer, n);
+        return true;
+    }
+    return false;
+}
+
 static bool array2d_like_map(int argc, py_Ref argv) {
     // def map(self, f: Callable[[T], Any]) -> 'array2d': ...
     PY_CHECK_ARGC(2);
     c11_array2d_like* self = py_touserdata(argv);
     py_Ref f = py_arg(1);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed && array2d__map_typed(typed, f)) return true;
     c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
+    py_Ref item = py_pushtmp();
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref item = self->f_get(self, i, j);
+            *item = *self->f_get(self, i, j);
             if(!py_call(f, 1, item)) return false;
             res->data[j * self->n_cols + i] = *py_retval();
         }
     }
-    py_assign(py_retval(), py_peek(-1));
-    py_pop();
+    py_assign(py_retval(), py_peek(-2));
+    py_shrink(2);
     return true;
 }
 
@@ -197,14 +348,16 @@ static bool array2d_like_apply(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     c11_array2d_like* self = py_touserdata(argv);
     py_Ref f = py_arg(1);
+    py_Ref item = py_pushtmp();
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref item = self->f_get(self, i, j);
+            *item = *self->f_get(self, i, j);
             if(!py_call(f, 1, item)) return false;
             bool ok = self->f_set(self, i, j, py_retval());
             if(!ok) return false;
         }
     }
+    py_pop();
     py_newnone(py_retval());
     return true;
 }
@@ -221,8 +374,126 @@ static bool _array2d_like_check_same_shape(c11_array2d_like* self, c11_array2d_l
     return _check_same_shape(self->n_cols, self->n_rows, other->n_cols, other->n_rows);
 }
 
-static bool _array2d_like_broadcasted_zip_with(int argc, py_Ref argv, py_Name op, py_Name rop) {
+static c11_array2d_dtype c11_array2d_dtype__promote(c11_array2d_dtype a, c11_array2d_dtype b) {
+    if(a == c11_array2d_dtype_bool || b == c11_array2d_dtype_bool) {
+        return a == b ? a : c11_array2d_dtype_object;
+    }
+    return c11__max(a, b);
+}
+
+// the dtype to broadcast `value` with cells of `dtype`, object if there is none
+static c11_array2d_dtype c11_array2d_dtype__promote_scalar(c11_array2d_dtype dtype, py_Ref value) {
+    switch(value->type) {
+        case tp_bool: return dtype == c11_array2d_dtype_bool ? dtype : c11_array2d_dtype_object;
+        case tp_float: {
+            if(dtype == c11_array2d_dtype_bool) return c11_array2d_dtype_object;
+            return c11_array2d_dtype__is_float(dtype) ? dtype : c11_array2d_dtype_float64;
+        }
+        case tp_int: {
+            if(dtype == c11_array2d_dtype_bool) return c11_array2d_dtype_object;
+            if(c11_array2d_dtype__is_float(dtype)) return dtype;
+            // the smallest integer dtype that holds both
+            py_i64 val = py_toint(value);
+            if(val >= INT8_MIN && val <= INT8_MAX) return dtype;
+            if(val >= INT16_MIN && val <= INT16_MAX) {
+                return c11__max(dtype, c11_array2d_dtype_int16);
+            }
+            if(val >= INT32_MIN && val <= INT32_MAX) return c11_array2d_dtype_int32;
+            return c11_array2d_dtype_object;
+        }
+        default: return c11_array2d_dtype_object;
+    }
+}
+
+// `buffer` as `n` cells of `dtype`, converted into `tmp` if needed
+static const void* c11_array2d__as_dtype(const void* buffer,
+                                         c11_array2d_dtype from,
+                                         c11_array2d_dtype dtype,
+                                         int n,
+                                         void** tmp) {
+    if(from == dtype) return buffer;
+    *tmp = PK_MALLOC(n * c11_array2d_dtype__itemsize(dtype));
+    c11_array2d__cast(*tmp, dtype, buffer, from, n);
+    return *tmp;
+}
+
+// self op other with native loops over packed cells
+// returns 1 on success, 0 on error, -1 if no kernel applies
+static int array2d__binary_typed(c11_array2d* self, py_Ref other, c11_array2d_op op) {
+    c11_array2d* rhs = NULL;
+    c11_array2d_dtype dtype;
+    if(py_istype(other, tp_array2d)) {
+        rhs = py_touserdata(other);
+        if(rhs->dtype == c11_array2d_dtype_object) return -1;
+        dtype = c11_array2d_dtype__promote(self->dtype, rhs->dtype);
+    } else {
+        dtype = c11_array2d_dtype__promote_scalar(self->dtype, other);
+    }
+    if(dtype == c11_array2d_dtype_object) return -1;
+    if(op == c11_array2d_op_truediv && !c11_array2d_dtype__is_float(dtype)) {
+        // `bool / bool` is undefined for scalars as well
+        if(dtype == c11_array2d_dtype_bool) return -1;
+        dtype = c11_array2d_dtype_float64;
+    }
+    // probe with no cells
+    if(!c11_array2d__binary(op, dtype, NULL, NULL, NULL, false, 0)) return -1;
+    if(rhs && !_array2d_like_check_same_shape(&self->header, &rhs->header)) return 0;
+
+    int n = self->header.numel;
+    void* tmp_a = NULL;
+    void* tmp_b = NULL;
+    const void* a = c11_array2d__as_dtype(self->buffer, self->dtype, dtype, n, &tmp_a);
+    const void* b;
+    c11_array2d_scalar scalar;
+    if(rhs) {
+        b = c11_array2d__as_dtype(rhs->buffer, rhs->dtype, dtype, n, &tmp_b);
+    } else {
+        bool ok = c11_array2d__unbox(dtype, &scalar, 0, other);
+        assert(ok);
+        (void)ok;
+        b = &scalar;
+    }
+
+    if(op == c11_array2d_op_truediv || op == c11_array2d_op_floordiv ||
+       op == c11_array2d_op_mod) {
+        c11_array2d_scalar zero;
+        memset(&zero, 0, sizeof(zero));
+        if(c11_array2d__count(dtype, b, &zero, rhs ? n : 1) > 0) {
+            PK_FREE(tmp_a);
+            PK_FREE(tmp_b);
+            bool is_float = c11_array2d_dtype__is_float(dtype);
+            if(op == c11_array2d_op_mod) {
+                ZeroDivisionError(is_float ? "float modulo by zero" : "integer modulo by zero");
+            } else {
+                ZeroDivisionError(is_float ? "float division by zero"
+                                           : "integer division by zero");
+            }
+            return 0;
+        }
+    }
+
+    bool is_compare = op >= c11_array2d_op_lt;
+    c11_array2d* res = c11_newarray2d_typed(py_retval(),
+                                            self->header.n_cols,
+                                            self->header.n_rows,
+                                            is_compare ? c11_array2d_dtype_bool : dtype);
+    c11_array2d__binary(op, dtype, res->buffer, a, b, rhs == NULL, n);
+    PK_FREE(tmp_a);
+    PK_FREE(tmp_b);
+    return 1;
+}
+
+static bool _array2d_like_broadcasted_zip_with(int argc,
+                                               py_Ref argv,
+                                               py_Name op,
+                                               py_Name rop,
+                                               c11_array2d_op kernel_op) {
     PY_CHECK_ARGC(2);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        int res = array2d__binary_typed(typed, py_arg(1), kernel_op);
+        if(res != -1) return res;
+    }
     c11_array2d_like* self = py_touserdata(argv);
     c11_array2d_like* other;
     if(py_isinstance(py_arg(1), tp_array2d_like)) {
@@ -234,14 +505,15 @@ static bool _array2d_like_broadcasted_zip_with(int argc, py_Ref argv, py_Name op
     c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref lhs = self->f_get(self, i, j);
+            // copy it out, `other` may share the scratch cell of a typed array
+            py_TValue lhs = *self->f_get(self, i, j);
             py_Ref rhs;
             if(other != NULL) {
                 rhs = other->f_get(other, i, j);
             } else {
                 rhs = py_arg(1);  // broadcast
             }
-            if(!py_binaryop(lhs, rhs, op, rop)) return false;
+            if(!py_binaryop(&lhs, rhs, op, rop)) return false;
             c11_array2d__set(res, i, j, py_retval());
         }
     }
@@ -273,35 +545,42 @@ static bool array2d_like_zip_with(int argc, py_Ref argv) {
     return true;
 }
 
-#define DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(name, op, rop)                                            \
+#define DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(name, op, rop, kop)                                       \
     static bool array2d_like##name(int argc, py_Ref argv) {                                        \
-        return _array2d_like_broadcasted_zip_with(argc, argv, op, rop);                            \
+        return _array2d_like_broadcasted_zip_with(argc, argv, op, rop, c11_array2d_op_##kop);      \
     }
 
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__le__, __le__, __ge__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__lt__, __lt__, __gt__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__ge__, __ge__, __le__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__gt__, __gt__, __lt__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__eq__, __eq__, __eq__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__ne__, __ne__, __ne__)
-
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__add__, __add__, __radd__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__sub__, __sub__, __rsub__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__mul__, __mul__, __rmul__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__truediv__, __truediv__, __rtruediv__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__floordiv__, __floordiv__, __rfloordiv__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__mod__, __mod__, __rmod__)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__pow__, __pow__, __rpow__)
-
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__and__, __and__, 0)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__or__, __or__, 0)
-DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__xor__, __xor__, 0)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__le__, __le__, __ge__, le)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__lt__, __lt__, __gt__, lt)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__ge__, __ge__, __le__, ge)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__gt__, __gt__, __lt__, gt)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__eq__, __eq__, __eq__, eq)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__ne__, __ne__, __ne__, ne)
+
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__add__, __add__, __radd__, add)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__sub__, __sub__, __rsub__, sub)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__mul__, __mul__, __rmul__, mul)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__truediv__, __truediv__, __rtruediv__, truediv)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__floordiv__, __floordiv__, __rfloordiv__, floordiv)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__mod__, __mod__, __rmod__, mod)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__pow__, __pow__, __rpow__, pow)
+
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__and__, __and__, 0, and)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__or__, __or__, 0, or)
+DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__xor__, __xor__, 0, xor)
 
 #undef DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH
 
 static bool array2d_like__invert__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed && !c11_array2d_dtype__is_float(typed->dtype)) {
+        c11_array2d* res =
+            c11_newarray2d_typed(py_retval(), self->n_cols, self->n_rows, typed->dtype);
+        c11_array2d__invert(typed->dtype, res->buffer, typed->buffer, self->numel);
+        return true;
+    }
     c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -319,6 +598,13 @@ static bool array2d_like_copy(int argc, py_Ref argv) {
     // def copy(self) -> 'array2d': ...
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        c11_array2d* res =
+            c11_newarray2d_typed(py_retval(), self->n_cols, self->n_rows, typed->dtype);
+        memcpy(res->buffer, typed->buffer, self->numel * c11_array2d_dtype__itemsize(typed->dtype));
+        return true;
+    }
     c11_array2d* res = c11_newarray2d(py_retval(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -329,6 +615,30 @@ static bool array2d_like_copy(int argc, py_Ref argv) {
     return true;
 }
 
+static bool array2d_like_astype(int argc, py_Ref argv) {
+    // def astype(self, dtype: DType) -> 'array2d': ...
+    PY_CHECK_ARGC(2);
+    c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d_dtype dtype;
+    if(!c11_array2d_dtype__parse(py_arg(1), &dtype)) return false;
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed && dtype != c11_array2d_dtype_object) {
+        c11_array2d* res = c11_newarray2d_typed(py_retval(), self->n_cols, self->n_rows, dtype);
+        c11_array2d__cast(res->buffer, dtype, typed->buffer, typed->dtype, self->numel);
+        return true;
+    }
+    c11_array2d* res = c11_newarray2d_typed(py_pushtmp(), self->n_cols, self->n_rows, dtype);
+    for(int j = 0; j < self->n_rows; j++) {
+        for(int i = 0; i < self->n_cols; i++) {
+            py_Ref item = self->f_get(self, i, j);
+            if(!res->header.f_set(&res->header, i, j, item)) return false;
+        }
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
 static bool array2d_like_tolist(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
@@ -465,10 +775,10 @@ static bool array2d_like__getitem__(int argc, py_Ref argv) {
         py_newlist(py_retval());
         for(int j = 0; j < self->n_rows; j++) {
             for(int i = 0; i < self->n_cols; i++) {
-                py_Ref item = self->f_get(self, i, j);
+                py_TValue item = *self->f_get(self, i, j);
                 py_Ref cond = mask->f_get(mask, i, j);
                 if(!py_checkbool(cond)) return false;
-                if(py_tobool(cond)) py_list_append(py_retval(), item);
+                if(py_tobool(cond)) py_list_append(py_retval(), &item);
             }
         }
         return true;
@@ -584,10 +894,43 @@ static bool array2d_like__setitem__(int argc, py_Ref argv) {
     return TypeError("expected tuple[int, int] or tuple[slice, slice]");
 }
 
+// scalar = value, false if no cell of `dtype` can be equal to `value`
+static bool c11_array2d__exact_scalar(c11_array2d_dtype dtype,
+                                      py_Ref value,
+                                      c11_array2d_scalar* scalar) {
+    switch(value->type) {
+        case tp_bool: {
+            if(dtype != c11_array2d_dtype_bool) return false;
+            scalar->_bool = py_tobool(value);
+            return true;
+        }
+        case tp_int:
+        case tp_float: {
+            if(dtype == c11_array2d_dtype_bool) return false;
+            double x = value->type == tp_int ? (double)py_toint(value) : py_tofloat(value);
+            c11_array2d__cast(scalar, dtype, &x, c11_array2d_dtype_float64, 1);
+            double y;
+            c11_array2d__cast(&y, c11_array2d_dtype_float64, scalar, dtype, 1);
+            return x == y;
+        }
+        default: return false;
+    }
+}
+
 // count(self, value: T) -> int
 static bool array2d_like_count(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        c11_array2d_scalar scalar;
+        int count = 0;
+        if(c11_array2d__exact_scalar(typed->dtype, py_arg(1), &scalar)) {
+            count = c11_array2d__count(typed->dtype, typed->buffer, &scalar, self->numel);
+        }
+        py_newint(py_retval(), count);
+        return true;
+    }
     int count = 0;
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -600,6 +943,74 @@ static bool array2d_like_count(int argc, py_Ref argv) {
     return true;
 }
 
+// sum(self) -> T
+static bool array2d_like_sum(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_array2d_like* self = py_touserdata(argv);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(self->numel == 0) {
+        if(typed && c11_array2d_dtype__is_float(typed->dtype)) {
+            py_newfloat(py_retval(), 0.0);
+        } else {
+            py_newint(py_retval(), 0);
+        }
+        return true;
+    }
+    if(typed) {
+        c11_array2d__reduce(c11_array2d_reduce_sum,
+                            typed->dtype,
+                            typed->buffer,
+                            self->numel,
+                            py_retval());
+        return true;
+    }
+    // start from the first cell, so cells need not support `0 + cell`
+    py_Ref acc = py_pushtmp();
+    py_assign(acc, self->f_get(self, 0, 0));
+    for(int idx = 1; idx < self->numel; idx++) {
+        py_TValue item = *self->f_get(self, idx % self->n_cols, idx / self->n_cols);
+        if(!py_binaryop(acc, &item, __add__, __radd__)) return false;
+        py_assign(acc, py_retval());
+    }
+    py_assign(py_retval(), acc);
+    py_pop();
+    return true;
+}
+
+static bool array2d_like__minmax(int argc, py_Ref argv, c11_array2d_reduce op) {
+    PY_CHECK_ARGC(1);
+    c11_array2d_like* self = py_touserdata(argv);
+    bool is_min = op == c11_array2d_reduce_min;
+    if(self->numel == 0) return ValueError("%s() arg is an empty array2d", is_min ? "min" : "max");
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        c11_array2d__reduce(op, typed->dtype, typed->buffer, self->numel, py_retval());
+        return true;
+    }
+    // the first of equal cells wins
+    py_Ref res = py_pushtmp();
+    py_assign(res, self->f_get(self, 0, 0));
+    for(int idx = 1; idx < self->numel; idx++) {
+        py_TValue item = *self->f_get(self, idx % self->n_cols, idx / self->n_cols);
+        int code = is_min ? py_less(&item, res) : py_less(res, &item);
+        if(code == -1) return false;
+        if(code) *res = item;
+    }
+    py_assign(py_retval(), res);
+    py_pop();
+    return true;
+}
+
+// min(self) -> T
+static bool array2d_like_min(int argc, py_Ref argv) {
+    return array2d_like__minmax(argc, argv, c11_array2d_reduce_min);
+}
+
+// max(self) -> T
+static bool array2d_like_max(int argc, py_Ref argv) {
+    return array2d_like__minmax(argc, argv, c11_array2d_reduce_max);
+}
+
 // get_bounding_rect(self, value: T) -> tuple[int, int, int, int]
 static bool array2d_like_get_bounding_rect(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
@@ -611,8 +1022,8 @@ static bool array2d_like_get_bounding_rect(int argc, py_Ref argv) {
     int bottom = 0;
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref item = self->f_get(self, i, j);
-            int res = py_equal(item, value);
+            py_TValue item = *self->f_get(self, i, j);
+            int res = py_equal(&item, value);
             if(res == -1) return false;
             if(res == 1) {
                 left = c11__min(left, i);
@@ -636,43 +1047,97 @@ static bool array2d_like_get_bounding_rect(int argc, py_Ref argv) {
     return true;
 }
 
+static bool c11_array2d__parse_neighborhood(py_Ref arg, bool* moore) {
+    if(!py_checkstr(arg)) return false;
+    const char* neighborhood = py_tostr(arg);
+    if(strcmp(neighborhood, "Moore") == 0) {
+        *moore = true;
+    } else if(strcmp(neighborhood, "von Neumann") == 0) {
+        *moore = false;
+    } else {
+        return ValueError("neighborhood must be 'Moore' or 'von Neumann'");
+    }
+    return true;
+}
+
+// mask[i] = cell i == value, NULL on error
+static bool* array2d_like__mask(py_Ref self, py_Ref value) {
+    c11_array2d_like* ud = py_touserdata(self);
+    bool* mask = PK_MALLOC(sizeof(bool) * ud->numel);
+    c11_array2d* typed = c11_array2d__typed(self);
+    if(typed) {
+        c11_array2d_scalar scalar;
+        if(c11_array2d__exact_scalar(typed->dtype, value, &scalar)) {
+            c11_array2d__binary(c11_array2d_op_eq,
+                                typed->dtype,
+                                mask,
+                                typed->buffer,
+                                &scalar,
+                                true,
+                                ud->numel);
+        } else {
+            memset(mask, 0, sizeof(bool) * ud->numel);
+        }
+        return mask;
+    }
+    for(int idx = 0; idx < ud->numel; idx++) {
+        int code = py_equal(ud->f_get(ud, idx % ud->n_cols, idx / ud->n_cols), value);
+        if(code == -1) {
+            PK_FREE(mask);
+            return NULL;
+        }
+        mask[idx] = code;
+    }
+    return mask;
+}
+
+// int32 cells for a typed `self`, boxed ints otherwise
+static void array2d_like__newint32(py_Ref self, const int32_t* cells, py_OutRef out) {
+    c11_array2d_like* ud = py_touserdata(self);
+    if(c11_array2d__typed(self)) {
+        c11_array2d* res =
+            c11_newarray2d_typed(out, ud->n_cols, ud->n_rows, c11_array2d_dtype_int32);
+        memcpy(res->buffer, cells, sizeof(int32_t) * ud->numel);
+    } else {
+        c11_array2d* res = c11_newarray2d(out, ud->n_cols, ud->n_rows);
+        for(int idx = 0; idx < ud->numel; idx++) {
+            py_newint(&res->data[idx], cells[idx]);
+        }
+    }
+}
+
 // count_neighbors(self, value: T, neighborhood: Neighborhood) -> array2d[int]
 static bool array2d_like_count_neighbors(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
     c11_array2d_like* self = py_touserdata(argv);
-    c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     py_Ref value = py_arg(1);
-    const char* neighborhood = py_tostr(py_arg(2));
-
-    const static c11_vec2i Moore[] = {
-        {{-1, -1}},
-        {{0, -1}},
-        {{1, -1}},
-        {{-1, 0}},
-        {{1, 0}},
-        {{-1, 1}},
-        {{0, 1}},
-        {{1, 1}},
-    };
-
-    const static c11_vec2i von_Neumann[] = {
-        {{0, -1}},
-        {{-1, 0}},
-        {{1, 0}},
-        {{0, 1}},
-    };
-
-    const c11_vec2i* offsets;
-    int n_offsets;
-    if(strcmp(neighborhood, "Moore") == 0) {
-        offsets = Moore;
-        n_offsets = c11__count_array(Moore);
-    } else if(strcmp(neighborhood, "von Neumann") == 0) {
-        offsets = von_Neumann;
-        n_offsets = c11__count_array(von_Neumann);
-    } else {
-        return ValueError("neighborhood must be 'Moore' or 'von Neumann'");
+    bool moore = false;
+    if(!c11_array2d__parse_neighborhood(py_arg(2), &moore)) return false;
+    const c11_vec2i* offsets = moore ? c11_array2d__Moore : c11_array2d__von_Neumann;
+    int n_offsets = moore ? 8 : 4;
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        // mask the matching cells, then sum shifted rows of the mask
+        // a bool array counting True is its own mask
+        const bool* mask = typed->buffer;
+        bool* tmp = NULL;
+        if(typed->dtype != c11_array2d_dtype_bool || !py_isbool(value) || !py_tobool(value)) {
+            tmp = array2d_like__mask(argv, value);
+            mask = tmp;
+        }
+        c11_array2d* res = c11_newarray2d_typed(py_retval(),
+                                                self->n_cols,
+                                                self->n_rows,
+                                                c11_array2d_dtype_int32);
+        c11_array2d__count_neighbors(res->buffer,
+                                     mask,
+                                     self->n_cols,
+                                     self->n_rows,
+                                     moore);
+        PK_FREE(tmp);
+        return true;
     }
+    c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
             py_i64 count = 0;
@@ -694,6 +1159,41 @@ static bool array2d_like_count_neighbors(int argc, py_Ref argv) {
     return true;
 }
 
+// convolve over packed int cells, they accumulate into int32
+static bool array2d__convolve_typed(c11_array2d* self, c11_array2d_like* kernel, int padding) {
+    int ksize = kernel->n_cols;
+    int n = self->header.numel;
+    // the kernel is small, unbox it once into int64 weights
+    int64_t* weights = PK_MALLOC(sizeof(int64_t) * ksize * ksize);
+    for(int jj = 0; jj < ksize; jj++) {
+        for(int ii = 0; ii < ksize; ii++) {
+            py_Ref kitem = kernel->f_get(kernel, ii, jj);
+            if(!py_checkint(kitem)) {
+                PK_FREE(weights);
+                return false;
+            }
+            weights[jj * ksize + ii] = py_toint(kitem);
+        }
+    }
+    void* tmp = NULL;
+    const void* src =
+        c11_array2d__as_dtype(self->buffer, self->dtype, c11_array2d_dtype_int32, n, &tmp);
+    c11_array2d* res = c11_newarray2d_typed(py_retval(),
+                                            self->header.n_cols,
+                                            self->header.n_rows,
+                                            c11_array2d_dtype_int32);
+    c11_array2d__convolve_i32(res->buffer,
+                              src,
+                              self->header.n_cols,
+                              self->header.n_rows,
+                              weights,
+                              ksize,
+                              padding);
+    PK_FREE(tmp);
+    PK_FREE(weights);
+    return true;
+}
+
 // convolve(self: array2d_like[int], kernel: array2d_like[int], padding: int) -> array2d[int]
 static bool array2d_like_convolve(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
@@ -706,6 +1206,12 @@ static bool array2d_like_convolve(int argc, py_Ref argv) {
     int ksize = kernel->n_cols;
     if(ksize % 2 == 0) return ValueError("kernel size must be odd");
     int ksize_half = ksize / 2;
+    c11_array2d* typed = c11_array2d__typed(argv);
+    // float cells take the object path, which rejects them like an object array does
+    if(typed && typed->dtype != c11_array2d_dtype_bool &&
+       !c11_array2d_dtype__is_float(typed->dtype)) {
+        return array2d__convolve_typed(typed, kernel, padding);
+    }
     c11_array2d* res = c11_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -736,6 +1242,134 @@ static bool array2d_like_convolve(int argc, py_Ref argv) {
     return true;
 }
 
+static bool array2d_like__check_pos(c11_array2d_like* self, py_Ref arg, int* index) {
+    if(!py_checktype(arg, tp_vec2i)) return false;
+    c11_vec2i pos = py_tovec2i(arg);
+    if(!c11_array2d_like_is_valid(self, pos.x, pos.y)) {
+        return _array2d_like_IndexError(self, pos.x, pos.y);
+    }
+    *index = pos.y * self->n_cols + pos.x;
+    return true;
+}
+
+// flood_fill(self, pos: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann') -> int
+static bool array2d_like_flood_fill(int argc, py_Ref argv) {
+    c11_array2d_like* self = py_touserdata(argv);
+    py_Ref value = py_arg(2);
+    int start = 0;
+    bool moore = false;
+    if(!array2d_like__check_pos(self, py_arg(1), &start)) return false;
+    if(!c11_array2d__parse_neighborhood(py_arg(3), &moore)) return false;
+    c11_array2d* typed = c11_array2d__typed(argv);
+    c11_array2d_scalar scalar;
+    // unbox first, so a value that does not fit changes nothing
+    if(typed && !c11_array2d__unbox(typed->dtype, &scalar, 0, value)) return false;
+    py_TValue target = *self->f_get(self, start % self->n_cols, start / self->n_cols);
+    bool* mask = array2d_like__mask(argv, &target);
+    if(mask == NULL) return false;
+    int* queue = PK_MALLOC(sizeof(int) * self->numel);
+    int n = c11_array2d__flood(queue, mask, self->n_cols, self->n_rows, start, moore);
+    bool ok = true;
+    if(typed) {
+        int itemsize = c11_array2d_dtype__itemsize(typed->dtype);
+        for(int k = 0; k < n; k++) {
+            memcpy((char*)typed->buffer + (size_t)queue[k] * itemsize, &scalar, itemsize);
+        }
+    } else if(py_istype(argv, tp_array2d)) {
+        c11_array2d* ud = py_touserdata(argv);
+        for(int k = 0; k < n; k++) {
+            ud->data[queue[k]] = *value;
+        }
+    } else {
+        for(int k = 0; k < n && ok; k++) {
+            ok = self->f_set(self, queue[k] % self->n_cols, queue[k] / self->n_cols, value);
+        }
+    }
+    PK_FREE(queue);
+    PK_FREE(mask);
+    if(!ok) return false;
+    py_newint(py_retval(), n);
+    return true;
+}
+
+// connected_components(self, value: T, neighborhood: Neighborhood = 'von Neumann')
+static bool array2d_like_connected_components(int argc, py_Ref argv) {
+    c11_array2d_like* self = py_touserdata(argv);
+    bool moore = false;
+    if(!c11_array2d__parse_neighborhood(py_arg(2), &moore)) return false;
+    bool* mask = array2d_like__mask(argv, py_arg(1));
+    if(mask == NULL) return false;
+    int32_t* labels = PK_MALLOC(sizeof(int32_t) * self->numel);
+    int count = c11_array2d__label(labels, mask, self->n_cols, self->n_rows, moore);
+    py_TValue* data = py_newtuple(py_pushtmp(), 2);
+    array2d_like__newint32(argv, labels, &data[0]);
+    py_newint(&data[1], count);
+    PK_FREE(labels);
+    PK_FREE(mask);
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+// distance_transform(self, value: T, neighborhood: Neighborhood = 'von Neumann') -> array2d[int]
+static bool array2d_like_distance_transform(int argc, py_Ref argv) {
+    c11_array2d_like* self = py_touserdata(argv);
+    bool moore = false;
+    if(!c11_array2d__parse_neighborhood(py_arg(2), &moore)) return false;
+    bool* mask = array2d_like__mask(argv, py_arg(1));
+    if(mask == NULL) return false;
+    int32_t* dist = PK_MALLOC(sizeof(int32_t) * self->numel);
+    c11_array2d__distance(dist, mask, self->n_cols, self->n_rows, moore);
+    array2d_like__newint32(argv, dist, py_retval());
+    PK_FREE(dist);
+    PK_FREE(mask);
+    return true;
+}
+
+// find_path(self, start: vec2i, end: vec2i, neighborhood: Neighborhood = 'von Neumann')
+static bool array2d_like_find_path(int argc, py_Ref argv) {
+    c11_array2d_like* self = py_touserdata(argv);
+    int start = 0, end = 0;
+    bool moore = false;
+    if(!array2d_like__check_pos(self, py_arg(1), &start)) return false;
+    if(!array2d_like__check_pos(self, py_arg(2), &end)) return false;
+    if(!c11_array2d__parse_neighborhood(py_arg(3), &moore)) return false;
+    double* costs = PK_MALLOC(sizeof(double) * self->numel);
+    c11_array2d* typed = c11_array2d__typed(argv);
+    if(typed) {
+        c11_array2d__cast(costs,
+                          c11_array2d_dtype_float64,
+                          typed->buffer,
+                          typed->dtype,
+                          self->numel);
+    } else {
+        for(int idx = 0; idx < self->numel; idx++) {
+            py_Ref item = self->f_get(self, idx % self->n_cols, idx / self->n_cols);
+            if(py_isbool(item)) {
+                costs[idx] = py_tobool(item);
+            } else if(!py_castfloat(item, &costs[idx])) {
+                PK_FREE(costs);
+                return false;
+            }
+        }
+    }
+    c11_vector path;
+    c11_vector__ctor(&path, sizeof(int));
+    if(c11_array2d__find_path(&path, costs, self->n_cols, self->n_rows, start, end, moore)) {
+        py_newlistn(py_retval(), path.length);
+        for(int k = 0; k < path.length; k++) {
+            int idx = c11__getitem(int, &path, k);
+            py_newvec2i(py_list_getitem(py_retval(), k),
+                        (c11_vec2i){{idx % self->n_cols, idx / self->n_cols}});
+        }
+    } else {
+        py_newnone(py_retval());
+    }
+    c11_vector__dtor(&path);
+    PK_FREE(costs);
+    return true;
+}
+
 #undef HANDLE_SLICE
 
 static void register_array2d_like(py_Ref mod) {
@@ -762,6 +1396,7 @@ static void register_array2d_like(py_Ref mod) {
     py_bindmethod(type, "apply", array2d_like_apply);
     py_bindmethod(type, "zip_with", array2d_like_zip_with);
     py_bindmethod(type, "copy", array2d_like_copy);
+    py_bindmethod(type, "astype", array2d_like_astype);
     py_bindmethod(type, "tolist", array2d_like_tolist);
 
     py_bindmagic(type, __le__, array2d_like__le__);
@@ -791,16 +1426,28 @@ static void register_array2d_like(py_Ref mod) {
     py_bindmagic(type, __setitem__, array2d_like__setitem__);
 
     py_bindmethod(type, "count", array2d_like_count);
+    py_bindmethod(type, "sum", array2d_like_sum);
+    py_bindmethod(type, "min", array2d_like_min);
+    py_bindmethod(type, "max", array2d_like_max);
     py_bindmethod(type, "get_bounding_rect", array2d_like_get_bounding_rect);
     py_bindmethod(type, "count_neighbors", array2d_like_count_neighbors);
     py_bindmethod(type, "convolve", array2d_like_convolve);
 
-    const char* scc =
-        "\ndef get_connected_components(self, value: T, neighborhood: Neighborhood) -> tuple[array2d[int], int]:\n    from collections import deque\n    from vmath import vec2i\n\n    DIRS = [vec2i.LEFT, vec2i.RIGHT, vec2i.UP, vec2i.DOWN]\n    assert neighborhood in ['Moore', 'von Neumann']\n\n    if neighborhood == 'Moore':\n        DIRS.extend([\n            vec2i.LEFT+vec2i.UP,\n            vec2i.RIGHT+vec2i.UP,\n            vec2i.LEFT+vec2i.DOWN,\n            vec2i.RIGHT+vec2i.DOWN\n            ])\n\n    visited = array2d[int](self.width, self.height, default=0)\n    queue = deque()\n    count = 0\n    for y in range(self.height):\n        for x in range(self.width):\n            if visited[x, y] or self[x, y] != value:\n                continue\n            count += 1\n            queue.append((x, y))\n            visited[x, y] = count\n            while queue:\n                cx, cy = queue.popleft()\n                for dx, dy in DIRS:\n                    nx, ny = cx+dx, cy+dy\n                    if self.is_valid(nx, ny) and not visited[nx, ny] and self[nx, ny] == value:\n                        queue.append((nx, ny))\n                        visited[nx, ny] = count\n    return visited, count\n\narray2d_like.get_connected_components = get_connected_components\ndel get_connected_components\n";
-    if(!py_exec(scc, "array2d.py", EXEC_MODE, mod)) {
-        py_printexc();
-        c11__abort("failed to execute array2d.py");
-    }
+    py_bind(py_tpobject(type),
+            "flood_fill(self, pos, value, neighborhood='von Neumann')",
+            array2d_like_flood_fill);
+    py_bind(py_tpobject(type),
+            "connected_components(self, value, neighborhood='von Neumann')",
+            array2d_like_connected_components);
+    py_bind(py_tpobject(type),
+            "get_connected_components(self, value, neighborhood)",
+            array2d_like_connected_components);
+    py_bind(py_tpobject(type),
+            "distance_transform(self, value, neighborhood='von Neumann')",
+            array2d_like_distance_transform);
+    py_bind(py_tpobject(type),
+            "find_path(self, start, end, neighborhood='von Neumann')",
+            array2d_like_find_path);
 }
 
 bool array2d_like_iterator__next__(int argc, py_Ref argv) {
@@ -829,7 +1476,7 @@ static void register_array2d_like_iterator(py_Ref mod) {
 }
 
 static bool array2d__new__(int argc, py_Ref argv) {
-    // __new__(cls, n_cols: int, n_rows: int, default: Callable[[vec2i], T] = None)
+    // __new__(cls, n_cols: int, n_rows: int, default: Callable[[vec2i], T] = None, dtype=None)
     py_Ref default_ = py_arg(3);
     PY_CHECK_ARG_TYPE(0, tp_type);
     PY_CHECK_ARG_TYPE(1, tp_int);
@@ -837,7 +1484,9 @@ static bool array2d__new__(int argc, py_Ref argv) {
     int n_cols = argv[1]._i64;
     int n_rows = argv[2]._i64;
     if(n_cols <= 0 || n_rows <= 0) return ValueError("array2d() expected positive dimensions");
-    c11_array2d* ud = c11_newarray2d(py_pushtmp(), n_cols, n_rows);
+    c11_array2d_dtype dtype;
+    if(!c11_array2d_dtype__parse(py_arg(4), &dtype)) return false;
+    c11_array2d* ud = c11_newarray2d_typed(py_pushtmp(), n_cols, n_rows, dtype);
     // setup initial values
     if(py_callable(default_)) {
         for(int j = 0; j < n_rows; j++) {
@@ -848,23 +1497,35 @@ static bool array2d__new__(int argc, py_Ref argv) {
                                 {i, j}
                 });
                 if(!py_call(default_, 1, &tmp)) return false;
-                ud->data[j * n_cols + i] = *py_retval();
+                if(!ud->header.f_set(&ud->header, i, j, py_retval())) return false;
             }
         }
-    } else {
+    } else if(dtype == c11_array2d_dtype_object) {
         for(int i = 0; i < ud->header.numel; i++) {
             ud->data[i] = *default_;
         }
+    } else if(!py_isnone(default_)) {
+        // typed cells start as zeros, otherwise fill them by doubling the filled prefix
+        if(!c11_array2d__unbox(dtype, ud->buffer, 0, default_)) return false;
+        int total = ud->header.numel * c11_array2d_dtype__itemsize(dtype);
+        int filled = c11_array2d_dtype__itemsize(dtype);
+        while(filled < total) {
+            int size = c11__min(filled, total - filled);
+            memcpy((char*)ud->buffer + filled, ud->buffer, size);
+            filled += size;
+        }
     }
     py_assign(py_retval(), py_peek(-1));
     py_pop();
     return true;
 }
 
-// fromlist(data: list[list[T]]) -> array2d[T]
+// fromlist(data: list[list[T]], dtype=None) -> array2d[T]
 static bool array2d_fromlist_STATIC(int argc, py_Ref argv) {
-    PY_CHECK_ARGC(1);
+    PY_CHECK_ARGC(2);
     if(!py_checktype(argv, tp_list)) return false;
+    c11_array2d_dtype dtype;
+    if(!c11_array2d_dtype__parse(py_arg(1), &dtype)) return false;
     int n_rows = py_list_len(argv);
     if(n_rows == 0) return ValueError("fromlist() expected a non-empty list");
     int n_cols = -1;
@@ -879,13 +1540,37 @@ static bool array2d_fromlist_STATIC(int argc, py_Ref argv) {
             return ValueError("fromlist() expected a list of lists with the same length");
         }
     }
-    c11_array2d* res = c11_newarray2d(py_retval(), n_cols, n_rows);
+    c11_array2d* res = c11_newarray2d_typed(py_pushtmp(), n_cols, n_rows, dtype);
     for(int j = 0; j < n_rows; j++) {
         py_Ref row_j = py_list_getitem(argv, j);
         for(int i = 0; i < n_cols; i++) {
-            c11_array2d__set(res, i, j, py_list_getitem(row_j, i));
+            if(!res->header.f_set(&res->header, i, j, py_list_getitem(row_j, i))) return false;
         }
     }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+static bool array2d_dtype(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_array2d* self = py_touserdata(argv);
+    py_newstr(py_retval(), c11_array2d_dtype__name(self->dtype));
+    return true;
+}
+
+// typed cells are exported row by row, object cells have no buffer
+static bool array2d__getbuffer(py_Ref self, py_Buffer* out) {
+    c11_array2d* ud = py_touserdata(self);
+    static const char formats[] = {'\0', '?', 'b', 'h', 'i', 'f', 'd'};
+    if(ud->dtype == c11_array2d_dtype_object) {
+        return TypeError("array2d of objects has no buffer, pass a dtype to create it");
+    }
+    out->data = ud->buffer;
+    out->itemsize = c11_array2d_dtype__itemsize(ud->dtype);
+    out->size = ud->header.numel * out->itemsize;
+    out->format = formats[ud->dtype];
+    out->readonly = false;
     return true;
 }
 
@@ -893,9 +1578,19 @@ static void register_array2d(py_Ref mod) {
     py_Type type = py_newtype("array2d", tp_array2d_like, mod, NULL);
     assert(type == tp_array2d);
     py_bind(py_tpobject(type),
-            "__new__(cls, n_cols: int, n_rows: int, default=None)",
+            "__new__(cls, n_cols: int, n_rows: int, default=None, dtype=None)",
             array2d__new__);
-    py_bindstaticmethod(type, "fromlist", array2d_fromlist_STATIC);
+    py_bindproperty(type, "dtype", array2d_dtype, NULL);
+    py_tphookbuffer(type, array2d__getbuffer);
+
+    // bind it with a signature, then wrap it as a static method
+    py_bind(py_tpobject(type), "fromlist(data, dtype=None)", array2d_fromlist_STATIC);
+    py_TValue fromlist = *py_getdict(py_tpobject(type), py_name("fromlist"));
+    if(!py_tpcall(tp_staticmethod, 1, &fromlist)) {
+        py_printexc();
+        c11__abort("failed to create array2d.fromlist");
+    }
+    py_setdict(py_tpobject(type), py_name("fromlist"), py_retval());
 }
 
 static bool array2d_view_origin(int argc, py_Ref argv) {
@@ -912,14 +1607,32 @@ static void register_array2d_view(py_Ref mod) {
 }
 
 /* chunked_array2d */
-#define SMALLMAP_T__SOURCE
+#define HASHMAP_T__SOURCE
 #define K c11_vec2i
 #define V py_TValue*
 #define NAME c11_chunked_array2d_chunks
-#define less(a, b) (a._i64 < b._i64)
+#define hash(a) ((uint64_t)(a)._i64 * 0x9E3779B97F4A7C15ULL >> 32)
 #define equal(a, b) (a._i64 == b._i64)
-#include "pocketpy/xmacros/smallmap.h"
-#undef SMALLMAP_T__SOURCE
+#include "pocketpy/xmacros/hashmap.h"
+#undef HASHMAP_T__SOURCE
+
+static void c11_chunked_array2d__forget(c11_chunked_array2d* self) {
+    memset(self->recent, 0, sizeof(self->recent));
+}
+
+// move `pos` to the front of the recent chunks
+static void c11_chunked_array2d__visit(c11_chunked_array2d* self, c11_vec2i pos, py_TValue* data) {
+    int i = 0;
+    while(i < C11_CHUNKED_ARRAY2D_RECENT - 1 && self->recent[i].value != NULL &&
+          self->recent[i].key._i64 != pos._i64) {
+        i++;
+    }
+    for(; i > 0; i--) {
+        self->recent[i] = self->recent[i - 1];
+    }
+    self->recent[0].key = pos;
+    self->recent[0].value = data;
+}
 
 static py_TValue* c11_chunked_array2d__new_chunk(c11_chunked_array2d* self, c11_vec2i pos) {
 #ifndef NDEBUG
@@ -941,8 +1654,7 @@ static py_TValue* c11_chunked_array2d__new_chunk(c11_chunked_array2d* self, c11_
     }
     memset(&data[1], 0, sizeof(py_TValue) * (chunk_numel - 1));
     c11_chunked_array2d_chunks__set(&self->chunks, pos, data);
-    self->last_visited.key = pos;
-    self->last_visited.value = data;
+    c11_chunked_array2d__visit(self, pos, data);
     return data;
 }
 
@@ -980,16 +1692,18 @@ static py_TValue* c11_chunked_array2d__parse_col_row(c11_chunked_array2d* self,
                                                      c11_vec2i* restrict chunk_pos,
                                                      c11_vec2i* restrict local_pos) {
     c11_chunked_array2d__world_to_chunk(self, col, row, chunk_pos, local_pos);
-    py_TValue* data;
-    if(self->last_visited.value != NULL && chunk_pos->_i64 == self->last_visited.key._i64) {
-        data = self->last_visited.value;
-    } else {
-        data = c11_chunked_array2d_chunks__get(&self->chunks, *chunk_pos, NULL);
+    if(self->recent[0].value != NULL && chunk_pos->_i64 == self->recent[0].key._i64) {
+        return self->recent[0].value;
     }
-    if(data != NULL) {
-        self->last_visited.key = *chunk_pos;
-        self->last_visited.value = data;
+    py_TValue* data = NULL;
+    for(int i = 1; i < C11_CHUNKED_ARRAY2D_RECENT; i++) {
+        if(self->recent[i].value != NULL && chunk_pos->_i64 == self->recent[i].key._i64) {
+            data = self->recent[i].value;
+            break;
+        }
     }
+    if(data == NULL) data = c11_chunked_array2d_chunks__get(&self->chunks, *chunk_pos, NULL);
+    if(data != NULL) c11_chunked_array2d__visit(self, *chunk_pos, data);
     return data;
 }
 
@@ -1045,7 +1759,7 @@ static bool chunked_array2d__new__(int argc, py_Ref argv) {
         default: return ValueError("invalid chunk_size: %d, not power of 2", chunk_size);
     }
     self->chunk_size_mask = chunk_size - 1;
-    memset(&self->last_visited, 0, sizeof(c11_chunked_array2d_chunks_KV));
+    c11_chunked_array2d__forget(self);
     return true;
 }
 
@@ -1104,10 +1818,10 @@ static bool chunked_array2d__delitem__(int argc, py_Ref argv) {
 static bool chunked_array2d__iter__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    py_Ref data = py_newtuple(py_pushtmp(), self->chunks.length);
-    for(int i = 0; i < self->chunks.length; i++) {
+    py_Ref data = py_newtuple(py_pushtmp(), self->chunks.entries.length);
+    for(int i = 0; i < self->chunks.entries.length; i++) {
         c11_chunked_array2d_chunks_KV* kv =
-            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks, i);
+            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks.entries, i);
         py_Ref p = py_newtuple(&data[i], 2);
         py_newvec2i(&p[0], kv->key);  // pos
         p[1] = kv->value[0];          // context
@@ -1121,16 +1835,18 @@ static bool chunked_array2d__iter__(int argc, py_Ref argv) {
 static bool chunked_array2d__len__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    py_newint(py_retval(), self->chunks.length);
+    py_newint(py_retval(), self->chunks.entries.length);
     return true;
 }
 
 static bool chunked_array2d_clear(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    c11__foreach(c11_chunked_array2d_chunks_KV, &self->chunks, p_kv) PK_FREE(p_kv->value);
+    c11__foreach(c11_chunked_array2d_chunks_KV, &self->chunks.entries, p_kv) {
+        PK_FREE(p_kv->value);
+    }
     c11_chunked_array2d_chunks__clear(&self->chunks);
-    self->last_visited.value = NULL;
+    c11_chunked_array2d__forget(self);
     py_newnone(py_retval());
     return true;
 }
@@ -1142,23 +1858,17 @@ static bool chunked_array2d_copy(int argc, py_Ref argv) {
         py_newobject(py_retval(), tp_chunked_array2d, 0, sizeof(c11_chunked_array2d));
     // copy basic data
     memcpy(res, self, sizeof(c11_chunked_array2d));
-    // invalidate last_visited cache
-    self->last_visited.value = NULL;
+    // the recent chunks of `self` are not owned by `res`
+    c11_chunked_array2d__forget(res);
     // copy chunks
-    memset(&res->chunks, 0, sizeof(c11_chunked_array2d_chunks));
     c11_chunked_array2d_chunks__ctor(&res->chunks);
-    c11_vector__reserve(&res->chunks, self->chunks.capacity);
-    for(int i = 0; i < self->chunks.length; i++) {
+    for(int i = 0; i < self->chunks.entries.length; i++) {
         c11_chunked_array2d_chunks_KV* kv =
-            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks, i);
+            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks.entries, i);
         int chunk_numel = self->chunk_size * self->chunk_size + 1;
         py_TValue* data = PK_MALLOC(sizeof(py_TValue) * chunk_numel);
         memcpy(data, kv->value, sizeof(py_TValue) * chunk_numel);
-        // construct new KV
-        c11_chunked_array2d_chunks_KV new_kv;
-        new_kv.key = kv->key;
-        new_kv.value = data;
-        c11_vector__push(c11_chunked_array2d_chunks_KV, &res->chunks, new_kv);
+        c11_chunked_array2d_chunks__set(&res->chunks, kv->key, data);
     }
     return true;
 }
@@ -1197,7 +1907,7 @@ static bool chunked_array2d_remove_chunk(int argc, py_Ref argv) {
         PK_FREE(data);
         bool ok = c11_chunked_array2d_chunks__del(&self->chunks, pos);
         assert(ok);
-        self->last_visited.value = NULL;
+        c11_chunked_array2d__forget(self);
         py_newbool(py_retval(), ok);
     } else {
         py_newbool(py_retval(), false);
@@ -1220,7 +1930,7 @@ static bool chunked_array2d_move_chunk(int argc, py_Ref argv) {
     }
     c11_chunked_array2d_chunks__del(&self->chunks, src);
     c11_chunked_array2d_chunks__set(&self->chunks, dst, src_data);
-    self->last_visited.value = NULL;
+    c11_chunked_array2d__forget(self);
     py_newbool(py_retval(), true);
     return true;
 }
@@ -1240,7 +1950,9 @@ static bool chunked_array2d_get_context(int argc, py_Ref argv) {
 }
 
 void c11_chunked_array2d__dtor(c11_chunked_array2d* self) {
-    c11__foreach(c11_chunked_array2d_chunks_KV, &self->chunks, p_kv) PK_FREE(p_kv->value);
+    c11__foreach(c11_chunked_array2d_chunks_KV, &self->chunks.entries, p_kv) {
+        PK_FREE(p_kv->value);
+    }
     c11_chunked_array2d_chunks__dtor(&self->chunks);
 }
 
@@ -1249,8 +1961,9 @@ void c11_chunked_array2d__mark(void* ud, c11_vector* p_stack) {
     pk__mark_value(&self->default_T);
     pk__mark_value(&self->context_builder);
     int chunk_numel = self->chunk_size * self->chunk_size + 1;
-    for(int i = 0; i < self->chunks.length; i++) {
-        py_TValue* data = c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks, i).value;
+    for(int i = 0; i < self->chunks.entries.length; i++) {
+        py_TValue* data =
+            c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks.entries, i).value;
         for(int j = 0; j < chunk_numel; j++) {
             pk__mark_value(data + j);
         }
@@ -1260,13 +1973,14 @@ void c11_chunked_array2d__mark(void* ud, c11_vector* p_stack) {
 static bool chunked_array2d_view(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(&argv[0]);
-    if(self->chunks.length == 0) { return ValueError("chunked_array2d is empty"); }
+    if(self->chunks.entries.length == 0) { return ValueError("chunked_array2d is empty"); }
     int min_chunk_x = INT_MAX;
     int min_chunk_y = INT_MAX;
     int max_chunk_x = INT_MIN;
     int max_chunk_y = INT_MIN;
-    for(int i = 0; i < self->chunks.length; i++) {
-        c11_vec2i chunk_pos = c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks, i).key;
+    for(int i = 0; i < self->chunks.entries.length; i++) {
+        c11_vec2i chunk_pos =
+            c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks.entries, i).key;
         min_chunk_x = c11__min(min_chunk_x, chunk_pos.x);
         min_chunk_y = c11__min(min_chunk_y, chunk_pos.y);
         max_chunk_x = c11__max(max_chunk_x, chunk_pos.x);
@@ -1321,6 +2035,290 @@ static bool chunked_array2d_view_chunks(int argc, py_Ref argv) {
     return _chunked_array2d_view(py_retval(), argv, self, start_col, start_row, width, height);
 }
 
+/* chunk streaming */
+// header: "PKCA", u8 version, u8 flags, u16 chunk_size, i32 count
+// then `count` records of i32 x, i32 y and runs of u8 tag, varint length, payload
+// covering the chunk row by row
+// with `CHUNK_IO_LZ4`, the records are i32 size followed by a LZ4 block
+#define CHUNK_IO_VERSION 1
+#define CHUNK_IO_LZ4 1
+#define CHUNK_IO_HEADER_SIZE 12
+
+enum {
+    CHUNK_IO_NIL,  // unset cell, reads as `default`
+    CHUNK_IO_NONE,
+    CHUNK_IO_FALSE,
+    CHUNK_IO_TRUE,
+    CHUNK_IO_INT,    // zigzag varint
+    CHUNK_IO_FLOAT,  // 8 bytes
+    CHUNK_IO_STR,    // varint size, utf-8 bytes
+};
+
+typedef struct chunk_io_reader {
+    const unsigned char* p;
+    const unsigned char* end;
+} chunk_io_reader;
+
+static void chunk_io__write(c11_vector* buf, const void* p, int size) {
+    c11_vector__extend(char, buf, p, size);
+}
+
+static void chunk_io__write_varint(c11_vector* buf, uint64_t val) {
+    while(val >= 0x80) {
+        c11_vector__push(char, buf, (char)(val | 0x80));
+        val >>= 7;
+    }
+    c11_vector__push(char, buf, (char)val);
+}
+
+static bool chunk_io__read(chunk_io_reader* r, void* p, int size) {
+    if(r->end - r->p < size) return false;
+    memcpy(p, r->p, size);
+    r->p += size;
+    return true;
+}
+
+static bool chunk_io__read_varint(chunk_io_reader* r, uint64_t* val) {
+    *val = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(r->p == r->end) return false;
+        unsigned char byte = *r->p++;
+        *val |= (uint64_t)(byte & 0x7f) << shift;
+        if(byte < 0x80) return true;
+    }
+    return false;
+}
+
+static int chunk_io__tag(py_Ref value) {
+    switch(value->type) {
+        case tp_nil: return CHUNK_IO_NIL;
+        case tp_NoneType: return CHUNK_IO_NONE;
+        case tp_bool: return py_tobool(value) ? CHUNK_IO_TRUE : CHUNK_IO_FALSE;
+        case tp_int: return CHUNK_IO_INT;
+        case tp_float: return CHUNK_IO_FLOAT;
+        case tp_str: return CHUNK_IO_STR;
+        default: return -1;
+    }
+}
+
+static bool chunk_io__same(py_Ref a, py_Ref b, int tag) {
+    if(chunk_io__tag(b) != tag) return false;
+    switch(tag) {
+        case CHUNK_IO_INT:
+        case CHUNK_IO_FLOAT: return a->_i64 == b->_i64;
+        case CHUNK_IO_STR: {
+            if(a->_obj == b->_obj) return true;
+            int a_size, b_size;
+            const char* a_data = py_tostrn(a, &a_size);
+            const char* b_data = py_tostrn(b, &b_size);
+            return a_size == b_size && memcmp(a_data, b_data, a_size) == 0;
+        }
+        default: return true;
+    }
+}
+
+static bool chunk_io__save(c11_vector* buf, c11_vec2i pos, py_TValue* cells, int numel) {
+    chunk_io__write(buf, &pos.x, 4);
+    chunk_io__write(buf, &pos.y, 4);
+    int i = 0;
+    while(i < numel) {
+        py_Ref value = &cells[i];
+        int tag = chunk_io__tag(value);
+        if(tag < 0) return TypeError("cannot save '%t' cells", value->type);
+        int run = 1;
+        while(i + run < numel && chunk_io__same(value, &cells[i + run], tag)) {
+            run++;
+        }
+        c11_vector__push(char, buf, (char)tag);
+        chunk_io__write_varint(buf, run);
+        switch(tag) {
+            case CHUNK_IO_INT: {
+                uint64_t val = (uint64_t)value->_i64;
+                chunk_io__write_varint(buf, (val << 1) ^ (uint64_t)(value->_i64 >> 63));
+                break;
+            }
+            case CHUNK_IO_FLOAT: chunk_io__write(buf, &value->_f64, 8); break;
+            case CHUNK_IO_STR: {
+                int size;
+                const char* data = py_tostrn(value, &size);
+                chunk_io__write_varint(buf, size);
+                chunk_io__write(buf, data, size);
+                break;
+            }
+            default: break;
+        }
+        i += run;
+    }
+    return true;
+}
+
+static bool chunk_io__load(chunk_io_reader* r, py_TValue* cells, int numel) {
+    int i = 0;
+    while(i < numel) {
+        unsigned char tag;
+        uint64_t run;
+        if(!chunk_io__read(r, &tag, 1)) return false;
+        if(!chunk_io__read_varint(r, &run)) return false;
+        if(run == 0 || run > (uint64_t)(numel - i)) return false;
+        py_TValue value;
+        switch(tag) {
+            case CHUNK_IO_NIL: value = *py_NIL(); break;
+            case CHUNK_IO_NONE: py_newnone(&value); break;
+            case CHUNK_IO_FALSE: py_newbool(&value, false); break;
+            case CHUNK_IO_TRUE: py_newbool(&value, true); break;
+            case CHUNK_IO_INT: {
+                uint64_t val;
+                if(!chunk_io__read_varint(r, &val)) return false;
+                py_newint(&value, (py_i64)(val >> 1) ^ -(py_i64)(val & 1));
+                break;
+            }
+            case CHUNK_IO_FLOAT: {
+                double val;
+                if(!chunk_io__read(r, &val, 8)) return false;
+                py_newfloat(&value, val);
+                break;
+            }
+            case CHUNK_IO_STR: {
+                uint64_t size;
+                if(!chunk_io__read_varint(r, &size)) return false;
+                if(size > (uint64_t)(r->end - r->p)) return false;
+                // the new string is reachable from the chunk before anything else allocates
+                py_newstrv(&cells[i], (c11_sv){(const char*)r->p, (int)size});
+                r->p += size;
+                value = cells[i];
+                break;
+            }
+            default: return false;
+        }
+        for(int j = 0; j < (int)run; j++) {
+            cells[i + j] = value;
+        }
+        i += (int)run;
+    }
+    return true;
+}
+
+// save_chunks(chunk_pos, width=1, height=1, compress=False)
+static bool chunked_array2d_save_chunks(int argc, py_Ref argv) {
+    PY_CHECK_ARG_TYPE(1, tp_vec2i);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_int);
+    PY_CHECK_ARG_TYPE(4, tp_bool);
+    c11_chunked_array2d* self = py_touserdata(&argv[0]);
+    c11_vec2i chunk_pos = py_tovec2i(&argv[1]);
+    py_i64 width = py_toint(&argv[2]);
+    py_i64 height = py_toint(&argv[3]);
+    bool compress = py_tobool(&argv[4]);
+    if(width < 0 || height < 0) return ValueError("width and height must be non-negative");
+#ifndef PK_BUILD_MODULE_LZ4
+    if(compress) return ValueError("compress=True requires the lz4 module");
+#endif
+    int numel = self->chunk_size * self->chunk_size;
+    int count = 0;
+    c11_vector buf;
+    c11_vector__ctor(&buf, sizeof(char));
+    for(py_i64 j = 0; j < height; j++) {
+        for(py_i64 i = 0; i < width; i++) {
+            c11_vec2i pos = {{(int)(chunk_pos.x + i), (int)(chunk_pos.y + j)}};
+            py_TValue* data = c11_chunked_array2d_chunks__get(&self->chunks, pos, NULL);
+            if(data == NULL) continue;
+            if(!chunk_io__save(&buf, pos, &data[1], numel)) {
+                c11_vector__dtor(&buf);
+                return false;
+            }
+            count++;
+        }
+    }
+    unsigned char header[CHUNK_IO_HEADER_SIZE] = {'P', 'K', 'C', 'A', CHUNK_IO_VERSION};
+    uint16_t chunk_size = (uint16_t)self->chunk_size;
+    header[5] = compress ? CHUNK_IO_LZ4 : 0;
+    memcpy(header + 6, &chunk_size, 2);
+    memcpy(header + 8, &count, 4);
+    if(!compress) {
+        unsigned char* p = py_newbytes(py_retval(), CHUNK_IO_HEADER_SIZE + buf.length);
+        memcpy(p, header, CHUNK_IO_HEADER_SIZE);
+        if(buf.length > 0) memcpy(p + CHUNK_IO_HEADER_SIZE, buf.data, buf.length);
+        c11_vector__dtor(&buf);
+        return true;
+    }
+#ifdef PK_BUILD_MODULE_LZ4
+    int capacity = LZ4_compressBound(buf.length);
+    unsigned char* p = py_newbytes(py_retval(), CHUNK_IO_HEADER_SIZE + 4 + capacity);
+    memcpy(p, header, CHUNK_IO_HEADER_SIZE);
+    memcpy(p + CHUNK_IO_HEADER_SIZE, &buf.length, 4);
+    char* dst = (char*)p + CHUNK_IO_HEADER_SIZE + 4;
+    int size = LZ4_compress_default(buf.data, dst, buf.length, capacity);
+    c11_vector__dtor(&buf);
+    if(size <= 0) return ValueError("LZ4 compression failed");
+    py_bytes_resize(py_retval(), CHUNK_IO_HEADER_SIZE + 4 + size);
+#endif
+    return true;
+}
+
+static bool chunked_array2d_load_chunks(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_bytes);
+    c11_chunked_array2d* self = py_touserdata(&argv[0]);
+    int size;
+    const unsigned char* p = py_tobytes(&argv[1], &size);
+    if(size < CHUNK_IO_HEADER_SIZE || memcmp(p, "PKCA", 4) != 0) {
+        return ValueError("invalid chunk data");
+    }
+    if(p[4] != CHUNK_IO_VERSION) return ValueError("unsupported chunk data version: %d", p[4]);
+    uint16_t chunk_size;
+    int count;
+    memcpy(&chunk_size, p + 6, 2);
+    memcpy(&count, p + 8, 4);
+    if(chunk_size != self->chunk_size) {
+        return ValueError("chunk_size mismatch: %d != %d", (int)chunk_size, self->chunk_size);
+    }
+    chunk_io_reader r = {p + CHUNK_IO_HEADER_SIZE, p + size};
+    void* records = NULL;
+    if(p[5] & CHUNK_IO_LZ4) {
+#ifdef PK_BUILD_MODULE_LZ4
+        int raw_size;
+        if(!chunk_io__read(&r, &raw_size, 4) || raw_size < 0) {
+            return ValueError("invalid chunk data");
+        }
+        records = PK_MALLOC(raw_size);
+        int src_size = (int)(r.end - r.p);
+        if(LZ4_decompress_safe((const char*)r.p, records, src_size, raw_size) != raw_size) {
+            PK_FREE(records);
+            return ValueError("LZ4 decompression failed");
+        }
+        r.p = records;
+        r.end = r.p + raw_size;
+#else
+        return ValueError("compressed chunk data requires the lz4 module");
+#endif
+    }
+    // loaded positions, `py_retval()` is clobbered by `context_builder`
+    py_Ref res = py_pushtmp();
+    py_newlist(res);
+    int numel = self->chunk_size * self->chunk_size;
+    bool ok = count >= 0;
+    for(int k = 0; ok && k < count; k++) {
+        c11_vec2i pos;
+        ok = chunk_io__read(&r, &pos.x, 4) && chunk_io__read(&r, &pos.y, 4);
+        if(!ok) break;
+        py_TValue* data = c11_chunked_array2d_chunks__get(&self->chunks, pos, NULL);
+        if(data == NULL) {
+            data = c11_chunked_array2d__new_chunk(self, pos);
+            if(data == NULL) {
+                PK_FREE(records);
+                return false;
+            }
+        }
+        ok = chunk_io__load(&r, &data[1], numel);
+        py_newvec2i(py_list_emplace(res), pos);
+    }
+    PK_FREE(records);
+    if(!ok || r.p != r.end) return ValueError("invalid chunk data");
+    py_assign(py_retval(), res);
+    py_pop();
+    return true;
+}
+
 static void register_chunked_array2d(py_Ref mod) {
     py_Type type =
         py_newtype("chunked_array2d", tp_object, mod, (py_Dtor)c11_chunked_array2d__dtor);
@@ -1352,11 +2350,44 @@ static void register_chunked_array2d(py_Ref mod) {
     py_bindmethod(type, "view_rect", chunked_array2d_view_rect);
     py_bindmethod(type, "view_chunk", chunked_array2d_view_chunk);
     py_bindmethod(type, "view_chunks", chunked_array2d_view_chunks);
+
+    py_bind(py_tpobject(type),
+            "save_chunks(self, chunk_pos, width=1, height=1, compress=False)",
+            chunked_array2d_save_chunks);
+    py_bindmethod(type, "load_chunks", chunked_array2d_load_chunks);
+}
+
+// set_parallel(num_threads, min_cells=65536)
+static bool array2d_set_parallel(int argc, py_Ref argv) {
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    py_i64 num_threads = py_toint(py_arg(0));
+    py_i64 min_cells = py_toint(py_arg(1));
+    if(num_threads < 1) return ValueError("num_threads must be positive");
+    if(min_cells < 1) return ValueError("min_cells must be positive");
+    num_threads = c11__min(num_threads, C11_THREADPOOL_MAX_THREADS);
+    min_cells = c11__min(min_cells, INT32_MAX);
+    c11_array2d__set_parallel((int)num_threads, (int)min_cells);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool array2d_get_parallel(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    int num_threads, min_cells;
+    c11_array2d__get_parallel(&num_threads, &min_cells);
+    py_TValue* data = py_newtuple(py_retval(), 2);
+    py_newint(&data[0], num_threads);
+    py_newint(&data[1], min_cells);
+    return true;
 }
 
 void pk__add_module_array2d() {
     py_GlobalRef mod = py_newmodule("array2d");
 
+    py_bind(mod, "set_parallel(num_threads, min_cells=65536)", array2d_set_parallel);
+    py_bindfunc(mod, "get_parallel", array2d_get_parallel);
+
     register_array2d_like(mod);
     register_array2d_like_iterator(mod);
     register_array2d(mod);
@@ -1381,11 +2412,11 @@ int py_array2d_getheight(py_Ref self) {
 py_ObjectRef py_array2d_getitem(py_Ref self, int x, int y) {
     assert(self->type == tp_array2d);
     c11_array2d* ud = py_touserdata(self);
-    return c11_array2d__get(ud, x, y);
+    return ud->header.f_get(&ud->header, x, y);
 }
 
-void py_array2d_setitem(py_Ref self, int x, int y, py_Ref value) {
+bool py_array2d_setitem(py_Ref self, int x, int y, py_Ref value) {
     assert(self->type == tp_array2d);
     c11_array2d* ud = py_touserdata(self);
-    c11_array2d__set(ud, x, y, value);
+    return ud->header.f_set(&ud->header, x, y, value);
 }
\ No newline at end of file
@@ -0,0 +1,1630 @@
+#include "pocketpy/interpreter/array2d.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/common/threadpool.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// X(name, T, U), where `U` is the type used for wrapping arithmetic
+#define C11_ARRAY2D_INT_DTYPES(X)                                                                  \
+    X(int8, int8_t, uint8_t)                                                                       \
+    X(int16, int16_t, uint16_t)                                                                    \
+    X(int32, int32_t, uint32_t)
+
+#define C11_ARRAY2D_FLOAT_DTYPES(X)                                                                \
+    X(float32, float, float)                                                                       \
+    X(float64, double, double)
+
+#define C11_ARRAY2D_NUMERIC_DTYPES(X) C11_ARRAY2D_INT_DTYPES(X) C11_ARRAY2D_FLOAT_DTYPES(X)
+
+int c11_array2d_dtype__itemsize(c11_array2d_dtype dtype) {
+    switch(dtype) {
+        case c11_array2d_dtype_object: return sizeof(py_TValue);
+        case c11_array2d_dtype_bool: return sizeof(bool);
+        case c11_array2d_dtype_int8: return sizeof(int8_t);
+        case c11_array2d_dtype_int16: return sizeof(int16_t);
+        case c11_array2d_dtype_int32: return sizeof(int32_t);
+        case c11_array2d_dtype_float32: return sizeof(float);
+        case c11_array2d_dtype_float64: return sizeof(double);
+        default: c11__unreachable();
+    }
+}
+
+const char* c11_array2d_dtype__name(c11_array2d_dtype dtype) {
+    switch(dtype) {
+        case c11_array2d_dtype_object: return "object";
+        case c11_array2d_dtype_bool: return "bool";
+        case c11_array2d_dtype_int8: return "int8";
+        case c11_array2d_dtype_int16: return "int16";
+        case c11_array2d_dtype_int32: return "int32";
+        case c11_array2d_dtype_float32: return "float32";
+        case c11_array2d_dtype_float64: return "float64";
+        default: c11__unreachable();
+    }
+}
+
+bool c11_array2d_dtype__is_float(c11_array2d_dtype dtype) {
+    return dtype == c11_array2d_dtype_float32 || dtype == c11_array2d_dtype_float64;
+}
+
+/* simd */
+// kernels that dominate cellular automata and reductions, one table per instruction set
+typedef struct c11_array2d_simd {
+    const char* name;
+    void (*add_u8)(uint8_t* dst, const uint8_t* src, int n);
+    void (*and_u8)(uint8_t* out, const uint8_t* a, const uint8_t* b, int n);
+    void (*or_u8)(uint8_t* out, const uint8_t* a, const uint8_t* b, int n);
+    void (*xor_u8)(uint8_t* out, const uint8_t* a, const uint8_t* b, int n);
+    void (*widen_u8_i32)(int32_t* out, const uint8_t* src, int n);
+    void (*eq_u8)(bool* out, const uint8_t* a, uint8_t value, int n);
+    void (*eq_i32)(bool* out, const int32_t* a, int32_t value, int n);
+    int (*count_u8)(const uint8_t* a, uint8_t value, int n);
+    int (*count_i32)(const int32_t* a, int32_t value, int n);
+    int64_t (*sum_i32)(const int32_t* a, int n);
+    int32_t (*min_i32)(const int32_t* a, int n);
+    int32_t (*max_i32)(const int32_t* a, int n);
+    double (*sum_f32)(const float* a, int n);
+    float (*min_f32)(const float* a, int n);
+    float (*max_f32)(const float* a, int n);
+    double (*sum_f64)(const double* a, int n);
+    double (*min_f64)(const double* a, int n);
+    double (*max_f64)(const double* a, int n);
+} c11_array2d_simd;
+
+_Static_assert(sizeof(bool) == 1, "bool cells are used as byte masks");
+
+#if PK_ENABLE_SIMD && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))
+#define C11_ARRAY2D_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// avx2 is compiled per function and selected at runtime
+#define C11_ARRAY2D_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if PK_ENABLE_SIMD && defined(__aarch64__) && defined(__ARM_NEON)
+#define C11_ARRAY2D_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* scalar, one lane per vector */
+#define NAME scalar
+#define VEC_U8 uint8_t
+#define U8_LANES 1
+#define U8_LOAD(p) (*(p))
+#define U8_STORE(p, v) (*(p) = (v))
+#define U8_SET1(x) ((uint8_t)(x))
+#define U8_ADD(a, b) ((uint8_t)((a) + (b)))
+#define U8_SUB(a, b) ((uint8_t)((a) - (b)))
+#define U8_AND(a, b) ((a) & (b))
+#define U8_OR(a, b) ((a) | (b))
+#define U8_XOR(a, b) ((a) ^ (b))
+#define U8_EQ(a, b) ((uint8_t)((a) == (b) ? 0xFF : 0))
+#define U8_HSUM(v) (v)
+#define U8_WIDEN_BLOCK 1
+#define U8_WIDEN_STORE(out, src) (*(out) = *(src))
+#define VEC_I32 int32_t
+#define I32_LANES 1
+#define I32_LOAD(p) (*(p))
+#define I32_STORE(p, v) (*(p) = (v))
+#define I32_SET1(x) ((int32_t)(x))
+#define I32_SUB(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+#define I32_EQ(a, b) ((a) == (b) ? -1 : 0)
+#define I32_MIN(a, b) c11__min(a, b)
+#define I32_MAX(a, b) c11__max(a, b)
+#define I32_EQ_BLOCK 1
+#define I32_EQ_STORE(out, a, v) (*(out) = *(a) == (v))
+#define VEC_I64 int64_t
+#define I64_LANES 1
+#define I64_ZERO() ((int64_t)0)
+#define I64_ADD_I32(acc, v) ((acc) + (v))
+#define I64_STORE(p, v) (*(p) = (v))
+#define VEC_F32 float
+#define F32_LANES 1
+#define F32_LOAD(p) (*(p))
+#define F32_STORE(p, v) (*(p) = (v))
+#define F32_SET1(x) ((float)(x))
+#define F32_MIN(a, b) c11__min(a, b)
+#define F32_MAX(a, b) c11__max(a, b)
+#define F32_OR_UNORD(m, x) ((m) + ((x) != (x)))
+#define F32_ANY(m) ((m) != 0)
+#define VEC_F64 double
+#define F64_LANES 1
+#define F64_LOAD(p) (*(p))
+#define F64_STORE(p, v) (*(p) = (v))
+#define F64_SET1(x) ((double)(x))
+#define F64_ADD(a, b) ((a) + (b))
+#define F64_MIN(a, b) c11__min(a, b)
+#define F64_MAX(a, b) c11__max(a, b)
+#define F64_OR_UNORD(m, x) ((m) + ((x) != (x)))
+#define F64_ANY(m) ((m) != 0)
+#define F64_ADD_F32(acc, v) ((acc) + (double)(v))
+#include "pocketpy/xmacros/array2d_simd.h"
+
+#if C11_ARRAY2D_SSE2
+static inline int c11_array2d_sse2__hsum_u8(__m128i v) {
+    __m128i s = _mm_sad_epu8(v, _mm_setzero_si128());
+    return _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+}
+
+static inline void c11_array2d_sse2__widen_u8(int32_t* out, const uint8_t* src) {
+    __m128i z = _mm_setzero_si128();
+    __m128i v = _mm_loadu_si128((const __m128i*)src);
+    __m128i lo = _mm_unpacklo_epi8(v, z);
+    __m128i hi = _mm_unpackhi_epi8(v, z);
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi16(lo, z));
+    _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(lo, z));
+    _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi16(hi, z));
+    _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(hi, z));
+}
+
+static inline void c11_array2d_sse2__eq_i32(uint8_t* out, const int32_t* a, __m128i v) {
+    __m128i m0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)a), v);
+    __m128i m1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + 4)), v);
+    __m128i m2 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + 8)), v);
+    __m128i m3 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + 12)), v);
+    __m128i m = _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+    _mm_storeu_si128((__m128i*)out, _mm_and_si128(m, _mm_set1_epi8(1)));
+}
+
+// sse2 has no min_epi32 and max_epi32
+static inline __m128i c11_array2d_sse2__min_i32(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+static inline __m128i c11_array2d_sse2__max_i32(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+static inline __m128i c11_array2d_sse2__add_i64_i32(__m128i acc, __m128i v) {
+    __m128i sign = _mm_srai_epi32(v, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+#define NAME sse2
+#define VEC_U8 __m128i
+#define U8_LANES 16
+#define U8_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define U8_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define U8_SET1(x) _mm_set1_epi8((char)(x))
+#define U8_ADD(a, b) _mm_add_epi8(a, b)
+#define U8_SUB(a, b) _mm_sub_epi8(a, b)
+#define U8_AND(a, b) _mm_and_si128(a, b)
+#define U8_OR(a, b) _mm_or_si128(a, b)
+#define U8_XOR(a, b) _mm_xor_si128(a, b)
+#define U8_EQ(a, b) _mm_cmpeq_epi8(a, b)
+#define U8_HSUM(v) c11_array2d_sse2__hsum_u8(v)
+#define U8_WIDEN_BLOCK 16
+#define U8_WIDEN_STORE(out, src) c11_array2d_sse2__widen_u8(out, src)
+#define VEC_I32 __m128i
+#define I32_LANES 4
+#define I32_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define I32_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define I32_SET1(x) _mm_set1_epi32(x)
+#define I32_SUB(a, b) _mm_sub_epi32(a, b)
+#define I32_EQ(a, b) _mm_cmpeq_epi32(a, b)
+#define I32_MIN(a, b) c11_array2d_sse2__min_i32(a, b)
+#define I32_MAX(a, b) c11_array2d_sse2__max_i32(a, b)
+#define I32_EQ_BLOCK 16
+#define I32_EQ_STORE(out, a, v) c11_array2d_sse2__eq_i32(out, a, v)
+#define VEC_I64 __m128i
+#define I64_LANES 2
+#define I64_ZERO() _mm_setzero_si128()
+#define I64_ADD_I32(acc, v) c11_array2d_sse2__add_i64_i32(acc, v)
+#define I64_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define VEC_F32 __m128
+#define F32_LANES 4
+#define F32_LOAD(p) _mm_loadu_ps(p)
+#define F32_STORE(p, v) _mm_storeu_ps(p, v)
+#define F32_SET1(x) _mm_set1_ps(x)
+#define F32_MIN(a, b) _mm_min_ps(a, b)
+#define F32_MAX(a, b) _mm_max_ps(a, b)
+#define F32_OR_UNORD(m, x) _mm_or_ps(m, _mm_cmpunord_ps(x, x))
+#define F32_ANY(m) (_mm_movemask_ps(m) != 0)
+#define VEC_F64 __m128d
+#define F64_LANES 2
+#define F64_LOAD(p) _mm_loadu_pd(p)
+#define F64_STORE(p, v) _mm_storeu_pd(p, v)
+#define F64_SET1(x) _mm_set1_pd(x)
+#define F64_ADD(a, b) _mm_add_pd(a, b)
+#define F64_MIN(a, b) _mm_min_pd(a, b)
+#define F64_MAX(a, b) _mm_max_pd(a, b)
+#define F64_OR_UNORD(m, x) _mm_or_pd(m, _mm_cmpunord_pd(x, x))
+#define F64_ANY(m) (_mm_movemask_pd(m) != 0)
+#define F64_ADD_F32(acc, v)                                                                        \
+    _mm_add_pd(_mm_add_pd(acc, _mm_cvtps_pd(v)), _mm_cvtps_pd(_mm_movehl_ps(v, v)))
+#include "pocketpy/xmacros/array2d_simd.h"
+#endif
+
+#if C11_ARRAY2D_AVX2
+#define C11_ARRAY2D_AVX2_TARGET __attribute__((target("avx2")))
+
+C11_ARRAY2D_AVX2_TARGET static inline int c11_array2d_avx2__hsum_u8(__m256i v) {
+    __m256i s = _mm256_sad_epu8(v, _mm256_setzero_si256());
+    __m128i t = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    return _mm_cvtsi128_si32(t) + _mm_extract_epi16(t, 4);
+}
+
+C11_ARRAY2D_AVX2_TARGET static inline void
+    c11_array2d_avx2__eq_i32(uint8_t* out, const int32_t* a, __m256i v) {
+    __m256i m0 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)a), v);
+    __m256i m1 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + 8)), v);
+    __m256i m2 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + 16)), v);
+    __m256i m3 = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + 24)), v);
+    __m256i m = _mm256_packs_epi16(_mm256_packs_epi32(m0, m1), _mm256_packs_epi32(m2, m3));
+    // packs work within 128-bit lanes, put the 4-byte groups back in order
+    m = _mm256_permutevar8x32_epi32(m, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256((__m256i*)out, _mm256_and_si256(m, _mm256_set1_epi8(1)));
+}
+
+C11_ARRAY2D_AVX2_TARGET static inline __m256i c11_array2d_avx2__add_i64_i32(__m256i acc,
+                                                                            __m256i v) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+C11_ARRAY2D_AVX2_TARGET static inline __m256d c11_array2d_avx2__add_f64_f32(__m256d acc,
+                                                                            __m256 v) {
+    acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    return _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+}
+
+#define NAME avx2
+#define TARGET C11_ARRAY2D_AVX2_TARGET
+#define VEC_U8 __m256i
+#define U8_LANES 32
+#define U8_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define U8_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define U8_SET1(x) _mm256_set1_epi8((char)(x))
+#define U8_ADD(a, b) _mm256_add_epi8(a, b)
+#define U8_SUB(a, b) _mm256_sub_epi8(a, b)
+#define U8_AND(a, b) _mm256_and_si256(a, b)
+#define U8_OR(a, b) _mm256_or_si256(a, b)
+#define U8_XOR(a, b) _mm256_xor_si256(a, b)
+#define U8_EQ(a, b) _mm256_cmpeq_epi8(a, b)
+#define U8_HSUM(v) c11_array2d_avx2__hsum_u8(v)
+#define U8_WIDEN_BLOCK 8
+#define U8_WIDEN_STORE(out, src)                                                                   \
+    _mm256_storeu_si256((__m256i*)(out),                                                           \
+                        _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src))))
+#define VEC_I32 __m256i
+#define I32_LANES 8
+#define I32_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define I32_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define I32_SET1(x) _mm256_set1_epi32(x)
+#define I32_SUB(a, b) _mm256_sub_epi32(a, b)
+#define I32_EQ(a, b) _mm256_cmpeq_epi32(a, b)
+#define I32_MIN(a, b) _mm256_min_epi32(a, b)
+#define I32_MAX(a, b) _mm256_max_epi32(a, b)
+#define I32_EQ_BLOCK 32
+#define I32_EQ_STORE(out, a, v) c11_array2d_avx2__eq_i32(out, a, v)
+#define VEC_I64 __m256i
+#define I64_LANES 4
+#define I64_ZERO() _mm256_setzero_si256()
+#define I64_ADD_I32(acc, v) c11_array2d_avx2__add_i64_i32(acc, v)
+#define I64_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define VEC_F32 __m256
+#define F32_LANES 8
+#define F32_LOAD(p) _mm256_loadu_ps(p)
+#define F32_STORE(p, v) _mm256_storeu_ps(p, v)
+#define F32_SET1(x) _mm256_set1_ps(x)
+#define F32_MIN(a, b) _mm256_min_ps(a, b)
+#define F32_MAX(a, b) _mm256_max_ps(a, b)
+#define F32_OR_UNORD(m, x) _mm256_or_ps(m, _mm256_cmp_ps(x, x, _CMP_UNORD_Q))
+#define F32_ANY(m) (_mm256_movemask_ps(m) != 0)
+#define VEC_F64 __m256d
+#define F64_LANES 4
+#define F64_LOAD(p) _mm256_loadu_pd(p)
+#define F64_STORE(p, v) _mm256_storeu_pd(p, v)
+#define F64_SET1(x) _mm256_set1_pd(x)
+#define F64_ADD(a, b) _mm256_add_pd(a, b)
+#define F64_MIN(a, b) _mm256_min_pd(a, b)
+#define F64_MAX(a, b) _mm256_max_pd(a, b)
+#define F64_OR_UNORD(m, x) _mm256_or_pd(m, _mm256_cmp_pd(x, x, _CMP_UNORD_Q))
+#define F64_ANY(m) (_mm256_movemask_pd(m) != 0)
+#define F64_ADD_F32(acc, v) c11_array2d_avx2__add_f64_f32(acc, v)
+#include "pocketpy/xmacros/array2d_simd.h"
+
+#undef C11_ARRAY2D_AVX2_TARGET
+#endif
+
+#if C11_ARRAY2D_NEON
+static inline void c11_array2d_neon__widen_u8(int32_t* out, const uint8_t* src) {
+    uint8x16_t v = vld1q_u8(src);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    uint16x8_t hi = vmovl_high_u8(v);
+    vst1q_s32(out, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))));
+    vst1q_s32(out + 4, vreinterpretq_s32_u32(vmovl_high_u16(lo)));
+    vst1q_s32(out + 8, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))));
+    vst1q_s32(out + 12, vreinterpretq_s32_u32(vmovl_high_u16(hi)));
+}
+
+static inline void c11_array2d_neon__eq_i32(uint8_t* out, const int32_t* a, int32x4_t v) {
+    uint32x4_t m0 = vceqq_s32(vld1q_s32(a), v);
+    uint32x4_t m1 = vceqq_s32(vld1q_s32(a + 4), v);
+    uint32x4_t m2 = vceqq_s32(vld1q_s32(a + 8), v);
+    uint32x4_t m3 = vceqq_s32(vld1q_s32(a + 12), v);
+    uint16x8_t n0 = vcombine_u16(vmovn_u32(m0), vmovn_u32(m1));
+    uint16x8_t n1 = vcombine_u16(vmovn_u32(m2), vmovn_u32(m3));
+    uint8x16_t m = vcombine_u8(vmovn_u16(n0), vmovn_u16(n1));
+    vst1q_u8(out, vandq_u8(m, vdupq_n_u8(1)));
+}
+
+static inline float32x4_t c11_array2d_neon__or_unord_f32(float32x4_t m, float32x4_t x) {
+    uint32x4_t unord = vmvnq_u32(vceqq_f32(x, x));
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(m), unord));
+}
+
+static inline float64x2_t c11_array2d_neon__or_unord_f64(float64x2_t m, float64x2_t x) {
+    uint32x4_t unord = vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(x, x)));
+    return vreinterpretq_f64_u32(vorrq_u32(vreinterpretq_u32_f64(m), unord));
+}
+
+#define NAME neon
+#define VEC_U8 uint8x16_t
+#define U8_LANES 16
+#define U8_LOAD(p) vld1q_u8(p)
+#define U8_STORE(p, v) vst1q_u8(p, v)
+#define U8_SET1(x) vdupq_n_u8(x)
+#define U8_ADD(a, b) vaddq_u8(a, b)
+#define U8_SUB(a, b) vsubq_u8(a, b)
+#define U8_AND(a, b) vandq_u8(a, b)
+#define U8_OR(a, b) vorrq_u8(a, b)
+#define U8_XOR(a, b) veorq_u8(a, b)
+#define U8_EQ(a, b) vceqq_u8(a, b)
+#define U8_HSUM(v) vaddlvq_u8(v)
+#define U8_WIDEN_BLOCK 16
+#define U8_WIDEN_STORE(out, src) c11_array2d_neon__widen_u8(out, src)
+#define VEC_I32 int32x4_t
+#define I32_LANES 4
+#define I32_LOAD(p) vld1q_s32(p)
+#define I32_STORE(p, v) vst1q_s32(p, v)
+#define I32_SET1(x) vdupq_n_s32(x)
+#define I32_SUB(a, b) vsubq_s32(a, b)
+#define I32_EQ(a, b) vreinterpretq_s32_u32(vceqq_s32(a, b))
+#define I32_MIN(a, b) vminq_s32(a, b)
+#define I32_MAX(a, b) vmaxq_s32(a, b)
+#define I32_EQ_BLOCK 16
+#define I32_EQ_STORE(out, a, v) c11_array2d_neon__eq_i32(out, a, v)
+#define VEC_I64 int64x2_t
+#define I64_LANES 2
+#define I64_ZERO() vdupq_n_s64(0)
+#define I64_ADD_I32(acc, v) vpadalq_s32(acc, v)
+#define I64_STORE(p, v) vst1q_s64(p, v)
+#define VEC_F32 float32x4_t
+#define F32_LANES 4
+#define F32_LOAD(p) vld1q_f32(p)
+#define F32_STORE(p, v) vst1q_f32(p, v)
+#define F32_SET1(x) vdupq_n_f32(x)
+#define F32_MIN(a, b) vminq_f32(a, b)
+#define F32_MAX(a, b) vmaxq_f32(a, b)
+#define F32_OR_UNORD(m, x) c11_array2d_neon__or_unord_f32(m, x)
+#define F32_ANY(m) (vmaxvq_u32(vreinterpretq_u32_f32(m)) != 0)
+#define VEC_F64 float64x2_t
+#define F64_LANES 2
+#define F64_LOAD(p) vld1q_f64(p)
+#define F64_STORE(p, v) vst1q_f64(p, v)
+#define F64_SET1(x) vdupq_n_f64(x)
+#define F64_ADD(a, b) vaddq_f64(a, b)
+#define F64_MIN(a, b) vminq_f64(a, b)
+#define F64_MAX(a, b) vmaxq_f64(a, b)
+#define F64_OR_UNORD(m, x) c11_array2d_neon__or_unord_f64(m, x)
+#define F64_ANY(m) (vmaxvq_u32(vreinterpretq_u32_f64(m)) != 0)
+#define F64_ADD_F32(acc, v)                                                                        \
+    vaddq_f64(vaddq_f64(acc, vcvt_f64_f32(vget_low_f32(v))), vcvt_high_f64_f32(v))
+#include "pocketpy/xmacros/array2d_simd.h"
+#endif
+
+static const c11_array2d_simd* c11_array2d__select_simd(void) {
+#if C11_ARRAY2D_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return &c11_array2d_simd_avx2;
+#endif
+#if C11_ARRAY2D_SSE2
+    return &c11_array2d_simd_sse2;
+#elif C11_ARRAY2D_NEON
+    return &c11_array2d_simd_neon;
+#else
+    return &c11_array2d_simd_scalar;
+#endif
+}
+
+static const c11_array2d_simd* c11_array2d__simd(void) {
+    static const c11_array2d_simd* impl;
+    // every thread that races here selects the same table
+    if(impl == NULL) impl = c11_array2d__select_simd();
+    return impl;
+}
+
+// floats are reduced in order when the results must not depend on the instruction set
+static const c11_array2d_simd* c11_array2d__simd_fp(void) {
+#if PK_ENABLE_DETERMINISM
+    return &c11_array2d_simd_scalar;
+#else
+    return c11_array2d__simd();
+#endif
+}
+
+/* parallel */
+// the least number of cells handed to one thread
+static int c11_array2d__min_cells = 65536;
+
+void c11_array2d__set_parallel(int num_threads, int min_cells) {
+    c11_threadpool__set_size(num_threads);
+    c11_array2d__min_cells = c11__max(1, min_cells);
+}
+
+void c11_array2d__get_parallel(int* num_threads, int* min_cells) {
+    *num_threads = c11_threadpool__size();
+    *min_cells = c11_array2d__min_cells;
+}
+
+static int c11_array2d__row_grain(int n_cols) {
+    return c11__max(1, c11_array2d__min_cells / c11__max(1, n_cols));
+}
+
+// an elementwise kernel over cells [begin, end), pointers advance by their cell size in bytes
+typedef struct c11_array2d_map {
+    void (*fn)(struct c11_array2d_map* self, void* out, const void* a, const void* b, int n);
+    void* out;
+    const void* a;
+    const void* b;
+    int out_size;
+    int a_size;
+    int b_size;  // 0 for a broadcasted scalar
+    c11_array2d_dtype dtype;
+    c11_array2d_dtype out_dtype;
+    c11_array2d_op op;
+} c11_array2d_map;
+
+static void c11_array2d__map_chunk(void* ctx, int chunk, int begin, int end) {
+    c11_array2d_map* self = ctx;
+    self->fn(self,
+             (char*)self->out + (size_t)begin * self->out_size,
+             (const char*)self->a + (size_t)begin * self->a_size,
+             (const char*)self->b + (size_t)begin * self->b_size,
+             end - begin);
+}
+
+static void c11_array2d__map(c11_array2d_map* self, int n) {
+    c11_threadpool__parallel_for(n, c11_array2d__min_cells, c11_array2d__map_chunk, self);
+}
+
+// result of one chunk of a reduction, integers and bools use `i` and floats use `f`
+typedef struct c11_array2d_partial {
+    int64_t i;
+    double f;
+} c11_array2d_partial;
+
+typedef struct c11_array2d_fold {
+    c11_array2d_partial (*fn)(struct c11_array2d_fold* self, const void* a, int n);
+    const void* a;
+    const void* value;
+    int a_size;
+    c11_array2d_dtype dtype;
+    c11_array2d_reduce op;
+    c11_array2d_partial partials[C11_THREADPOOL_MAX_CHUNKS];
+} c11_array2d_fold;
+
+static void c11_array2d__fold_chunk(void* ctx, int chunk, int begin, int end) {
+    c11_array2d_fold* self = ctx;
+    const void* a = (const char*)self->a + (size_t)begin * self->a_size;
+    self->partials[chunk] = self->fn(self, a, end - begin);
+}
+
+// partials are combined in chunk order, so the result never depends on the scheduling
+static int c11_array2d__fold(c11_array2d_fold* self, int n) {
+    return c11_threadpool__parallel_for(n, c11_array2d__min_cells, c11_array2d__fold_chunk, self);
+}
+
+/* cast */
+// NaN becomes 0, out of range values saturate
+#define CLAMP(T, x, lo, hi)                                                                        \
+    ((x) != (x) ? 0 : (x) <= (lo) ? (T)(lo) : (x) >= (hi) ? (T)(hi) : (T)(x))
+
+// a bool source is always in range
+#define CAST_FROM_BOOL(T, x, lo, hi) ((T)(x))
+
+#define DEF_CAST_FROM(name, T, U) DEF_CAST_FROM_CLAMPED(name, T, CLAMP)
+#define DEF_CAST_FROM_CLAMPED(name, T, CLAMP_FN)                                                   \
+    static void c11_array2d__cast_from_##name(void* dst_,                                          \
+                                              c11_array2d_dtype dst_dtype,                         \
+                                              const T* restrict src,                               \
+                                              int n) {                                             \
+        switch(dst_dtype) {                                                                        \
+            case c11_array2d_dtype_bool: {                                                         \
+                bool* restrict dst = dst_;                                                         \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = src[i] != 0;                                                          \
+                return;                                                                            \
+            }                                                                                      \
+            case c11_array2d_dtype_int8: {                                                         \
+                int8_t* restrict dst = dst_;                                                       \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = CLAMP_FN(int8_t, src[i], INT8_MIN, INT8_MAX);                         \
+                return;                                                                            \
+            }                                                                                      \
+            case c11_array2d_dtype_int16: {                                                        \
+                int16_t* restrict dst = dst_;                                                      \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = CLAMP_FN(int16_t, src[i], INT16_MIN, INT16_MAX);                      \
+                return;                                                                            \
+            }                                                                                      \
+            case c11_array2d_dtype_int32: {                                                        \
+                int32_t* restrict dst = dst_;                                                      \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = CLAMP_FN(int32_t, src[i], INT32_MIN, INT32_MAX);                      \
+                return;                                                                            \
+            }                                                                                      \
+            case c11_array2d_dtype_float32: {                                                      \
+                float* restrict dst = dst_;                                                        \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = (float)src[i];                                                        \
+                return;                                                                            \
+            }                                                                                      \
+            case c11_array2d_dtype_float64: {                                                      \
+                double* restrict dst = dst_;                                                       \
+                for(int i = 0; i < n; i++)                                                         \
+                    dst[i] = (double)src[i];                                                       \
+                return;                                                                            \
+            }                                                                                      \
+            default: c11__unreachable();                                                           \
+        }                                                                                          \
+    }
+
+DEF_CAST_FROM_CLAMPED(bool, bool, CAST_FROM_BOOL)
+C11_ARRAY2D_NUMERIC_DTYPES(DEF_CAST_FROM)
+
+#undef DEF_CAST_FROM
+#undef DEF_CAST_FROM_CLAMPED
+#undef CAST_FROM_BOOL
+#undef CLAMP
+
+static void c11_array2d__cast_serial(void* dst,
+                                     c11_array2d_dtype dst_dtype,
+                                     const void* src,
+                                     c11_array2d_dtype src_dtype,
+                                     int n) {
+    switch(src_dtype) {
+        case c11_array2d_dtype_bool: c11_array2d__cast_from_bool(dst, dst_dtype, src, n); return;
+        case c11_array2d_dtype_int8: c11_array2d__cast_from_int8(dst, dst_dtype, src, n); return;
+        case c11_array2d_dtype_int16: c11_array2d__cast_from_int16(dst, dst_dtype, src, n); return;
+        case c11_array2d_dtype_int32: c11_array2d__cast_from_int32(dst, dst_dtype, src, n); return;
+        case c11_array2d_dtype_float32:
+            c11_array2d__cast_from_float32(dst, dst_dtype, src, n);
+            return;
+        case c11_array2d_dtype_float64:
+            c11_array2d__cast_from_float64(dst, dst_dtype, src, n);
+            return;
+        default: c11__unreachable();
+    }
+}
+
+static void c11_array2d__cast_map(c11_array2d_map* self,
+                                  void* out,
+                                  const void* a,
+                                  const void* b,
+                                  int n) {
+    c11_array2d__cast_serial(out, self->out_dtype, a, self->dtype, n);
+}
+
+void c11_array2d__cast(void* dst,
+                       c11_array2d_dtype dst_dtype,
+                       const void* src,
+                       c11_array2d_dtype src_dtype,
+                       int n) {
+    c11_array2d_map map = {
+        .fn = c11_array2d__cast_map,
+        .out = dst,
+        .a = src,
+        .out_size = c11_array2d_dtype__itemsize(dst_dtype),
+        .a_size = c11_array2d_dtype__itemsize(src_dtype),
+        .dtype = src_dtype,
+        .out_dtype = dst_dtype,
+    };
+    c11_array2d__map(&map, n);
+}
+
+/* binary */
+static int64_t c11__floordiv_i64(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    if(a % b != 0 && (a < 0) != (b < 0)) q--;
+    return q;
+}
+
+static int64_t c11__mod_i64(int64_t a, int64_t b) {
+    int64_t r = a % b;
+    if(r != 0 && (r < 0) != (b < 0)) r += b;
+    return r;
+}
+
+// one loop for an array operand and one for a broadcasted scalar
+#define DEF_BINARY_LOOP(name, T, R, expr)                                                          \
+    static void name(R* restrict out, const T* restrict a, const T* restrict b, int n) {           \
+        for(int i = 0; i < n; i++) {                                                               \
+            T x = a[i];                                                                            \
+            T y = b[i];                                                                            \
+            out[i] = (expr);                                                                       \
+        }                                                                                          \
+    }                                                                                              \
+    static void name##_scalar(R* restrict out, const T* restrict a, T y, int n) {                  \
+        for(int i = 0; i < n; i++) {                                                               \
+            T x = a[i];                                                                            \
+            out[i] = (expr);                                                                       \
+        }                                                                                          \
+    }
+
+#define CASE_BINARY(op, name, T)                                                                   \
+    case c11_array2d_op_##op:                                                                      \
+        if(b_scalar) {                                                                             \
+            name##_##op##_scalar(out, a, *(const T*)b, n);                                         \
+        } else {                                                                                   \
+            name##_##op(out, a, b, n);                                                             \
+        }                                                                                          \
+        return true;
+
+#define DEF_COMPARE_LOOPS(name, T)                                                                 \
+    DEF_BINARY_LOOP(name##_lt, T, bool, x < y)                                                     \
+    DEF_BINARY_LOOP(name##_le, T, bool, x <= y)                                                    \
+    DEF_BINARY_LOOP(name##_gt, T, bool, x > y)                                                     \
+    DEF_BINARY_LOOP(name##_ge, T, bool, x >= y)                                                    \
+    DEF_BINARY_LOOP(name##_eq, T, bool, x == y)                                                    \
+    DEF_BINARY_LOOP(name##_ne, T, bool, x != y)
+
+#define DEF_INT_BINARY(name, T, U)                                                                 \
+    DEF_BINARY_LOOP(name##_add, T, T, (T)((U)x + (U)y))                                            \
+    DEF_BINARY_LOOP(name##_sub, T, T, (T)((U)x - (U)y))                                            \
+    DEF_BINARY_LOOP(name##_mul, T, T, (T)((U)x * (U)y))                                            \
+    DEF_BINARY_LOOP(name##_floordiv, T, T, (T)c11__floordiv_i64(x, y))                             \
+    DEF_BINARY_LOOP(name##_mod, T, T, (T)c11__mod_i64(x, y))                                       \
+    DEF_BINARY_LOOP(name##_and, T, T, x & y)                                                       \
+    DEF_BINARY_LOOP(name##_or, T, T, x | y)                                                        \
+    DEF_BINARY_LOOP(name##_xor, T, T, x ^ y)                                                       \
+    DEF_COMPARE_LOOPS(name, T)                                                                     \
+    static bool c11_array2d__binary_##name(c11_array2d_op op,                                      \
+                                           void* out,                                              \
+                                           const void* a,                                          \
+                                           const void* b,                                          \
+                                           bool b_scalar,                                          \
+                                           int n) {                                                \
+        switch(op) {                                                                               \
+            CASE_BINARY(add, name, T)                                                              \
+            CASE_BINARY(sub, name, T)                                                              \
+            CASE_BINARY(mul, name, T)                                                              \
+            CASE_BINARY(floordiv, name, T)                                                         \
+            CASE_BINARY(mod, name, T)                                                              \
+            CASE_BINARY(and, name, T)                                                              \
+            CASE_BINARY(or, name, T)                                                               \
+            CASE_BINARY(xor, name, T)                                                              \
+            CASE_BINARY(lt, name, T)                                                               \
+            CASE_BINARY(le, name, T)                                                               \
+            CASE_BINARY(gt, name, T)                                                               \
+            CASE_BINARY(ge, name, T)                                                               \
+            CASE_BINARY(eq, name, T)                                                               \
+            CASE_BINARY(ne, name, T)                                                               \
+            default: return false;                                                                 \
+        }                                                                                          \
+    }
+
+// no floordiv, `//` is only defined between ints and the object path raises for floats
+#define DEF_FLOAT_BINARY(name, T, U)                                                               \
+    DEF_BINARY_LOOP(name##_add, T, T, x + y)                                                       \
+    DEF_BINARY_LOOP(name##_sub, T, T, x - y)                                                       \
+    DEF_BINARY_LOOP(name##_mul, T, T, x * y)                                                       \
+    DEF_BINARY_LOOP(name##_truediv, T, T, x / y)                                                   \
+    DEF_BINARY_LOOP(name##_mod, T, T, (T)fmod(x, y))                                               \
+    DEF_COMPARE_LOOPS(name, T)                                                                     \
+    static bool c11_array2d__binary_##name(c11_array2d_op op,                                      \
+                                           void* out,                                              \
+                                           const void* a,                                          \
+                                           const void* b,                                          \
+                                           bool b_scalar,                                          \
+                                           int n) {                                                \
+        switch(op) {                                                                               \
+            CASE_BINARY(add, name, T)                                                              \
+            CASE_BINARY(sub, name, T)                                                              \
+            CASE_BINARY(mul, name, T)                                                              \
+            CASE_BINARY(truediv, name, T)                                                          \
+            CASE_BINARY(mod, name, T)                                                              \
+            CASE_BINARY(lt, name, T)                                                               \
+            CASE_BINARY(le, name, T)                                                               \
+            CASE_BINARY(gt, name, T)                                                               \
+            CASE_BINARY(ge, name, T)                                                               \
+            CASE_BINARY(eq, name, T)                                                               \
+            CASE_BINARY(ne, name, T)                                                               \
+            default: return false;                                                                 \
+        }                                                                                          \
+    }
+
+C11_ARRAY2D_INT_DTYPES(DEF_INT_BINARY)
+C11_ARRAY2D_FLOAT_DTYPES(DEF_FLOAT_BINARY)
+
+#undef DEF_INT_BINARY
+#undef DEF_FLOAT_BINARY
+
+DEF_BINARY_LOOP(bool_and, bool, bool, x & y)
+DEF_BINARY_LOOP(bool_or, bool, bool, x | y)
+DEF_BINARY_LOOP(bool_xor, bool, bool, x ^ y)
+DEF_BINARY_LOOP(bool_eq, bool, bool, x == y)
+DEF_BINARY_LOOP(bool_ne, bool, bool, x != y)
+
+static bool c11_array2d__binary_bool(c11_array2d_op op,
+                                     void* out,
+                                     const void* a,
+                                     const void* b,
+                                     bool b_scalar,
+                                     int n) {
+    switch(op) {
+        CASE_BINARY(and, bool, bool)
+        CASE_BINARY(or, bool, bool)
+        CASE_BINARY(xor, bool, bool)
+        CASE_BINARY(eq, bool, bool)
+        CASE_BINARY(ne, bool, bool)
+        default: return false;
+    }
+}
+
+#undef DEF_COMPARE_LOOPS
+#undef CASE_BINARY
+#undef DEF_BINARY_LOOP
+
+static bool c11_array2d__binary_serial(c11_array2d_op op,
+                                       c11_array2d_dtype dtype,
+                                       void* out,
+                                       const void* a,
+                                       const void* b,
+                                       bool b_scalar,
+                                       int n) {
+    const c11_array2d_simd* simd = c11_array2d__simd();
+    // bool and int8 cells share the byte kernels
+    bool is_byte = dtype == c11_array2d_dtype_bool || dtype == c11_array2d_dtype_int8;
+    if(is_byte && op == c11_array2d_op_eq && b_scalar) {
+        simd->eq_u8(out, a, *(const uint8_t*)b, n);
+        return true;
+    }
+    if(dtype == c11_array2d_dtype_int32 && op == c11_array2d_op_eq && b_scalar) {
+        simd->eq_i32(out, a, *(const int32_t*)b, n);
+        return true;
+    }
+    if(is_byte && !b_scalar) {
+        switch(op) {
+            case c11_array2d_op_and: simd->and_u8(out, a, b, n); return true;
+            case c11_array2d_op_or: simd->or_u8(out, a, b, n); return true;
+            case c11_array2d_op_xor: simd->xor_u8(out, a, b, n); return true;
+            default: break;
+        }
+    }
+    switch(dtype) {
+        case c11_array2d_dtype_bool: return c11_array2d__binary_bool(op, out, a, b, b_scalar, n);
+        case c11_array2d_dtype_int8: return c11_array2d__binary_int8(op, out, a, b, b_scalar, n);
+        case c11_array2d_dtype_int16: return c11_array2d__binary_int16(op, out, a, b, b_scalar, n);
+        case c11_array2d_dtype_int32: return c11_array2d__binary_int32(op, out, a, b, b_scalar, n);
+        case c11_array2d_dtype_float32:
+            return c11_array2d__binary_float32(op, out, a, b, b_scalar, n);
+        case c11_array2d_dtype_float64:
+            return c11_array2d__binary_float64(op, out, a, b, b_scalar, n);
+        default: return false;
+    }
+}
+
+static void c11_array2d__binary_map(c11_array2d_map* self,
+                                    void* out,
+                                    const void* a,
+                                    const void* b,
+                                    int n) {
+    c11_array2d__binary_serial(self->op, self->dtype, out, a, b, self->b_size == 0, n);
+}
+
+bool c11_array2d__binary(c11_array2d_op op,
+                         c11_array2d_dtype dtype,
+                         void* out,
+                         const void* a,
+                         const void* b,
+                         bool b_scalar,
+                         int n) {
+    // no cells only tells whether `op` is supported
+    if(!c11_array2d__binary_serial(op, dtype, out, a, b, b_scalar, 0)) return false;
+    int itemsize = c11_array2d_dtype__itemsize(dtype);
+    bool compare = op >= c11_array2d_op_lt && op <= c11_array2d_op_ne;
+    c11_array2d_map map = {
+        .fn = c11_array2d__binary_map,
+        .out = out,
+        .a = a,
+        .b = b,
+        .out_size = compare ? (int)sizeof(bool) : itemsize,
+        .a_size = itemsize,
+        .b_size = b_scalar ? 0 : itemsize,
+        .dtype = dtype,
+        .op = op,
+    };
+    c11_array2d__map(&map, n);
+    return true;
+}
+
+/* unary */
+#define DEF_ABS(name, T, U)                                                                        \
+    static void c11_array2d__abs_##name(T* restrict out, const T* restrict a, int n) {             \
+        for(int i = 0; i < n; i++)                                                                 \
+            out[i] = a[i] < 0 ? (T)(0 - (U)a[i]) : a[i];                                           \
+    }
+
+C11_ARRAY2D_NUMERIC_DTYPES(DEF_ABS)
+
+#undef DEF_ABS
+
+#define DEF_NONZERO(name, T, U)                                                                    \
+    static void c11_array2d__nonzero_##name(bool* restrict out, const T* restrict a, int n) {      \
+        for(int i = 0; i < n; i++)                                                                 \
+            out[i] = a[i] != 0;                                                                    \
+    }
+
+DEF_NONZERO(bool, bool, bool)
+C11_ARRAY2D_NUMERIC_DTYPES(DEF_NONZERO)
+
+#undef DEF_NONZERO
+
+// bool, int8 and int32 are counted by the simd kernels
+#define DEF_COUNT(name, T, U)                                                                      \
+    static int c11_array2d__count_##name(const T* restrict a, T value, int n) {                    \
+        int count = 0;                                                                             \
+        for(int i = 0; i < n; i++)                                                                 \
+            count += a[i] == value;                                                                \
+        return count;                                                                              \
+    }
+
+DEF_COUNT(int16, int16_t, uint16_t)
+C11_ARRAY2D_FLOAT_DTYPES(DEF_COUNT)
+
+#undef DEF_COUNT
+
+#define DEF_INVERT(name, T, U)                                                                     \
+    static void c11_array2d__invert_##name(T* restrict out, const T* restrict a, int n) {          \
+        for(int i = 0; i < n; i++)                                                                 \
+            out[i] = ~a[i];                                                                        \
+    }
+
+C11_ARRAY2D_INT_DTYPES(DEF_INVERT)
+
+#undef DEF_INVERT
+
+static void c11_array2d__invert_bool(bool* restrict out, const bool* restrict a, int n) {
+    for(int i = 0; i < n; i++)
+        out[i] = !a[i];
+}
+
+static void c11_array2d__abs_map(c11_array2d_map* self,
+                                 void* out,
+                                 const void* a,
+                                 const void* b,
+                                 int n) {
+    switch(self->dtype) {
+#define CASE_DTYPE(name, T, U)                                                                     \
+    case c11_array2d_dtype_##name: c11_array2d__abs_##name(out, a, n); return;
+        C11_ARRAY2D_NUMERIC_DTYPES(CASE_DTYPE)
+#undef CASE_DTYPE
+        default: c11__unreachable();
+    }
+}
+
+static void c11_array2d__invert_map(c11_array2d_map* self,
+                                    void* out,
+                                    const void* a,
+                                    const void* b,
+                                    int n) {
+    switch(self->dtype) {
+#define CASE_DTYPE(name, T, U)                                                                     \
+    case c11_array2d_dtype_##name: c11_array2d__invert_##name(out, a, n); return;
+        CASE_DTYPE(bool, bool, bool)
+        C11_ARRAY2D_INT_DTYPES(CASE_DTYPE)
+#undef CASE_DTYPE
+        default: c11__unreachable();
+    }
+}
+
+static void c11_array2d__nonzero_map(c11_array2d_map* self,
+                                     void* out,
+                                     const void* a,
+                                     const void* b,
+                                     int n) {
+    switch(self->dtype) {
+#define CASE_DTYPE(name, T, U)                                                                     \
+    case c11_array2d_dtype_##name: c11_array2d__nonzero_##name(out, a, n); return;
+        CASE_DTYPE(bool, bool, bool)
+        C11_ARRAY2D_NUMERIC_DTYPES(CASE_DTYPE)
+#undef CASE_DTYPE
+        default: c11__unreachable();
+    }
+}
+
+static void c11_array2d__unary(void (*fn)(c11_array2d_map*, void*, const void*, const void*, int),
+                               c11_array2d_dtype dtype,
+                               void* out,
+                               int out_size,
+                               const void* a,
+                               int n) {
+    c11_array2d_map map = {
+        .fn = fn,
+        .out = out,
+        .a = a,
+        .out_size = out_size,
+        .a_size = c11_array2d_dtype__itemsize(dtype),
+        .dtype = dtype,
+    };
+    c11_array2d__map(&map, n);
+}
+
+void c11_array2d__abs(c11_array2d_dtype dtype, void* out, const void* a, int n) {
+    c11_array2d__unary(c11_array2d__abs_map, dtype, out, c11_array2d_dtype__itemsize(dtype), a, n);
+}
+
+void c11_array2d__invert(c11_array2d_dtype dtype, void* out, const void* a, int n) {
+    int itemsize = c11_array2d_dtype__itemsize(dtype);
+    c11_array2d__unary(c11_array2d__invert_map, dtype, out, itemsize, a, n);
+}
+
+void c11_array2d__nonzero(c11_array2d_dtype dtype, bool* out, const void* a, int n) {
+    c11_array2d__unary(c11_array2d__nonzero_map, dtype, out, sizeof(bool), a, n);
+}
+
+static c11_array2d_partial c11_array2d__count_fold(c11_array2d_fold* self, const void* a, int n) {
+    c11_array2d_partial res = {0};
+    switch(self->dtype) {
+        case c11_array2d_dtype_bool:
+        case c11_array2d_dtype_int8:
+            res.i = c11_array2d__simd()->count_u8(a, *(const uint8_t*)self->value, n);
+            return res;
+        case c11_array2d_dtype_int32:
+            res.i = c11_array2d__simd()->count_i32(a, *(const int32_t*)self->value, n);
+            return res;
+#define CASE_DTYPE(name, T, U)                                                                     \
+    case c11_array2d_dtype_##name:                                                                 \
+        res.i = c11_array2d__count_##name(a, *(const T*)self->value, n);                           \
+        return res;
+        CASE_DTYPE(int16, int16_t, uint16_t)
+        C11_ARRAY2D_FLOAT_DTYPES(CASE_DTYPE)
+#undef CASE_DTYPE
+        default: c11__unreachable();
+    }
+}
+
+int c11_array2d__count(c11_array2d_dtype dtype, const void* a, const void* value, int n) {
+    c11_array2d_fold fold = {
+        .fn = c11_array2d__count_fold,
+        .a = a,
+        .value = value,
+        .a_size = c11_array2d_dtype__itemsize(dtype),
+        .dtype = dtype,
+    };
+    int n_chunks = c11_array2d__fold(&fold, n);
+    int64_t count = 0;
+    for(int k = 0; k < n_chunks; k++)
+        count += fold.partials[k].i;
+    return (int)count;
+}
+
+/* reduce */
+#define DEF_REDUCE(name, T, U)                                                                     \
+    static int64_t c11_array2d__reduce_##name(c11_array2d_reduce op, const T* restrict a, int n) { \
+        if(op == c11_array2d_reduce_sum) {                                                         \
+            int64_t sum = 0;                                                                       \
+            for(int i = 0; i < n; i++)                                                             \
+                sum += a[i];                                                                       \
+            return sum;                                                                            \
+        }                                                                                          \
+        T res = a[0];                                                                              \
+        if(op == c11_array2d_reduce_min) {                                                         \
+            for(int i = 1; i < n; i++)                                                             \
+                res = c11__min(res, a[i]);                                                         \
+        } else {                                                                                   \
+            for(int i = 1; i < n; i++)                                                             \
+                res = c11__max(res, a[i]);                                                         \
+        }                                                                                          \
+        return res;                                                                                \
+    }
+
+DEF_REDUCE(int8, int8_t, uint8_t)
+DEF_REDUCE(int16, int16_t, uint16_t)
+
+#undef DEF_REDUCE
+
+// bools reduce as 0 and 1
+static c11_array2d_partial c11_array2d__reduce_fold(c11_array2d_fold* self, const void* a, int n) {
+    const c11_array2d_simd* simd = c11_array2d__simd();
+    const c11_array2d_simd* simd_fp = c11_array2d__simd_fp();
+    c11_array2d_reduce op = self->op;
+    c11_array2d_partial res = {0};
+    switch(self->dtype) {
+        case c11_array2d_dtype_bool:
+            switch(op) {
+                case c11_array2d_reduce_sum: res.i = simd->count_u8(a, 1, n); return res;
+                case c11_array2d_reduce_min: res.i = memchr(a, 0, n) == NULL; return res;
+                case c11_array2d_reduce_max: res.i = memchr(a, 1, n) != NULL; return res;
+                default: c11__unreachable();
+            }
+        case c11_array2d_dtype_int8: res.i = c11_array2d__reduce_int8(op, a, n); return res;
+        case c11_array2d_dtype_int16: res.i = c11_array2d__reduce_int16(op, a, n); return res;
+        case c11_array2d_dtype_int32:
+            switch(op) {
+                case c11_array2d_reduce_sum: res.i = simd->sum_i32(a, n); return res;
+                case c11_array2d_reduce_min: res.i = simd->min_i32(a, n); return res;
+                case c11_array2d_reduce_max: res.i = simd->max_i32(a, n); return res;
+                default: c11__unreachable();
+            }
+        case c11_array2d_dtype_float32:
+            switch(op) {
+                case c11_array2d_reduce_sum: res.f = simd_fp->sum_f32(a, n); return res;
+                case c11_array2d_reduce_min: res.f = simd_fp->min_f32(a, n); return res;
+                case c11_array2d_reduce_max: res.f = simd_fp->max_f32(a, n); return res;
+                default: c11__unreachable();
+            }
+        case c11_array2d_dtype_float64:
+            switch(op) {
+                case c11_array2d_reduce_sum: res.f = simd_fp->sum_f64(a, n); return res;
+                case c11_array2d_reduce_min: res.f = simd_fp->min_f64(a, n); return res;
+                case c11_array2d_reduce_max: res.f = simd_fp->max_f64(a, n); return res;
+                default: c11__unreachable();
+            }
+        default: c11__unreachable();
+    }
+}
+
+void c11_array2d__reduce(c11_array2d_reduce op,
+                         c11_array2d_dtype dtype,
+                         const void* a,
+                         int n,
+                         py_OutRef out) {
+    c11_array2d_fold fold = {
+        .fn = c11_array2d__reduce_fold,
+        .a = a,
+        .a_size = c11_array2d_dtype__itemsize(dtype),
+        .dtype = dtype,
+        .op = op,
+    };
+    bool is_float = c11_array2d_dtype__is_float(dtype);
+    int n_chunks;
+    if(is_float && op == c11_array2d_reduce_sum) {
+        // rounding depends on how cells are grouped, so float sums stay on one thread
+        fold.partials[0] = c11_array2d__reduce_fold(&fold, a, n);
+        n_chunks = 1;
+    } else {
+        n_chunks = c11_array2d__fold(&fold, n);
+    }
+    c11_array2d_partial res = fold.partials[0];
+    for(int k = 1; k < n_chunks; k++) {
+        c11_array2d_partial x = fold.partials[k];
+        switch(op) {
+            case c11_array2d_reduce_sum: res.i += x.i; break;
+            case c11_array2d_reduce_min:
+                res.i = c11__min(res.i, x.i);
+                // NaN wins over every other value
+                res.f = (res.f != res.f || x.f != x.f) ? NAN : c11__min(res.f, x.f);
+                break;
+            case c11_array2d_reduce_max:
+                res.i = c11__max(res.i, x.i);
+                res.f = (res.f != res.f || x.f != x.f) ? NAN : c11__max(res.f, x.f);
+                break;
+            default: c11__unreachable();
+        }
+    }
+    if(is_float) {
+        py_newfloat(out, res.f);
+    } else if(dtype == c11_array2d_dtype_bool && op != c11_array2d_reduce_sum) {
+        py_newbool(out, res.i != 0);
+    } else {
+        py_newint(out, res.i);
+    }
+}
+
+/* neighborhood */
+// horizontal = left + right neighbors of one row, triple = horizontal + the cells themselves
+static void c11_array2d__neighbor_row(const c11_array2d_simd* simd,
+                                      uint8_t* horizontal,
+                                      uint8_t* triple,
+                                      const uint8_t* cells,
+                                      int n_cols) {
+    memset(horizontal, 0, n_cols);
+    simd->add_u8(horizontal + 1, cells, n_cols - 1);
+    simd->add_u8(horizontal, cells + 1, n_cols - 1);
+    if(triple == NULL) return;
+    memcpy(triple, horizontal, n_cols);
+    simd->add_u8(triple, cells, n_cols);
+}
+
+typedef struct c11_array2d_neighbors {
+    int32_t* out;
+    const uint8_t* cells;
+    int n_cols;
+    int n_rows;
+    bool moore;
+} c11_array2d_neighbors;
+
+static void c11_array2d__count_neighbors_chunk(void* ctx, int chunk, int begin, int end) {
+    c11_array2d_neighbors* self = ctx;
+    const c11_array2d_simd* simd = c11_array2d__simd();
+    const uint8_t* cells = self->cells;
+    int n_cols = self->n_cols;
+    int n_rows = self->n_rows;
+    bool moore = self->moore;
+    // at most 8 neighbors, so counts are summed in byte rows that stay in cache
+    // rows j - 1, j and j + 1 live in a ring of 3
+    uint8_t* buffer = PK_MALLOC(n_cols * 7);
+    uint8_t* horizontal[3] = {buffer, buffer + n_cols, buffer + n_cols * 2};
+    uint8_t* triples[3] = {buffer + n_cols * 3, buffer + n_cols * 4, buffer + n_cols * 5};
+    uint8_t* acc = buffer + n_cols * 6;
+    for(int j = c11__max(0, begin - 1); j <= begin && j < n_rows; j++) {
+        c11_array2d__neighbor_row(simd,
+                                  horizontal[j % 3],
+                                  moore ? triples[j % 3] : NULL,
+                                  cells + j * n_cols,
+                                  n_cols);
+    }
+    for(int j = begin; j < end; j++) {
+        if(j + 1 < n_rows) {
+            c11_array2d__neighbor_row(simd,
+                                      horizontal[(j + 1) % 3],
+                                      moore ? triples[(j + 1) % 3] : NULL,
+                                      cells + (j + 1) * n_cols,
+                                      n_cols);
+        }
+        // von Neumann adds the cells above and below, Moore adds the triples around them
+        memcpy(acc, horizontal[j % 3], n_cols);
+        if(j > 0) {
+            const uint8_t* above = moore ? triples[(j + 2) % 3] : cells + (j - 1) * n_cols;
+            simd->add_u8(acc, above, n_cols);
+        }
+        if(j + 1 < n_rows) {
+            const uint8_t* below = moore ? triples[(j + 1) % 3] : cells + (j + 1) * n_cols;
+            simd->add_u8(acc, below, n_cols);
+        }
+        simd->widen_u8_i32(self->out + j * n_cols, acc, n_cols);
+    }
+    PK_FREE(buffer);
+}
+
+void c11_array2d__count_neighbors(int32_t* out,
+                                  const bool* mask,
+                                  int n_cols,
+                                  int n_rows,
+                                  bool moore) {
+    c11_array2d_neighbors ctx = {out, (const uint8_t*)mask, n_cols, n_rows, moore};
+    c11_threadpool__parallel_for(n_rows,
+                                 c11_array2d__row_grain(n_cols),
+                                 c11_array2d__count_neighbors_chunk,
+                                 &ctx);
+}
+
+/* convolve */
+static void c11_array2d__madd_i32(int64_t* restrict dst,
+                                  const int32_t* restrict src,
+                                  int64_t w,
+                                  int n) {
+    for(int i = 0; i < n; i++)
+        dst[i] += w * src[i];
+}
+
+static void c11_array2d__madd_i64(int64_t* restrict dst,
+                                  const int64_t* restrict src,
+                                  int64_t w,
+                                  int n) {
+    for(int i = 0; i < n; i++)
+        dst[i] += w * src[i];
+}
+
+// kernel = col * row, false if it is not an outer product or has too few taps to gain from it
+#define DEF_SEPARATE(name, ACC, VALID, DIVIDES)                                                    \
+    static bool c11_array2d__separate_##name(const ACC* k, int ksize, ACC* col, ACC* row) {        \
+        int pivot = -1;                                                                            \
+        int nnz = 0;                                                                               \
+        for(int idx = 0; idx < ksize * ksize; idx++) {                                             \
+            if(!VALID(k[idx])) return false;                                                       \
+            if(k[idx] == 0) continue;                                                              \
+            if(pivot == -1) pivot = idx;                                                           \
+            nnz++;                                                                                 \
+        }                                                                                          \
+        /* two passes take 2 * ksize taps */                                                       \
+        if(nnz <= 2 * ksize) return false;                                                         \
+        int p = pivot / ksize;                                                                     \
+        int q = pivot % ksize;                                                                     \
+        for(int i = 0; i < ksize; i++)                                                             \
+            row[i] = k[p * ksize + i];                                                             \
+        for(int j = 0; j < ksize; j++) {                                                           \
+            ACC x = k[j * ksize + q];                                                              \
+            if(!DIVIDES(x, k[pivot])) return false;                                                \
+            col[j] = x / k[pivot];                                                                 \
+            for(int i = 0; i < ksize; i++) {                                                       \
+                if(k[j * ksize + i] != col[j] * row[i]) return false;                              \
+            }                                                                                      \
+        }                                                                                          \
+        return true;                                                                               \
+    }
+
+// small weights keep the products exact
+#define VALID_I64(x) ((x) >= INT32_MIN && (x) <= INT32_MAX)
+#define DIVIDES_I64(x, y) ((x) % (y) == 0)
+
+DEF_SEPARATE(i32, int64_t, VALID_I64, DIVIDES_I64)
+
+#undef VALID_I64
+#undef DIVIDES_I64
+#undef DEF_SEPARATE
+
+// accumulate w * src[y][x + dx] for one row, the border takes `w_padding` with no bounds checks
+// inside, separable kernels run a horizontal pass and a vertical pass
+// every pass splits rows across threads and adds the taps of a cell in the same order
+#define DEF_CONVOLVE(name, T, ACC, MADD_SRC, MADD_ACC)                                             \
+    static void c11_array2d__shift_madd_##name(ACC* restrict dst,                                  \
+                                               const T* restrict row,                              \
+                                               int n_cols,                                         \
+                                               int dx,                                             \
+                                               ACC w,                                              \
+                                               ACC w_padding) {                                    \
+        int i_begin = c11__min(n_cols, c11__max(0, -dx));                                          \
+        int i_end = c11__max(i_begin, c11__min(n_cols, n_cols - dx));                              \
+        for(int i = 0; i < i_begin; i++)                                                           \
+            dst[i] += w_padding;                                                                   \
+        MADD_SRC(dst + i_begin, row + i_begin + dx, w, i_end - i_begin);                           \
+        for(int i = i_end; i < n_cols; i++)                                                        \
+            dst[i] += w_padding;                                                                   \
+    }                                                                                              \
+    typedef struct c11_array2d_convolve_##name {                                                   \
+        T* out;                                                                                    \
+        const T* src;                                                                              \
+        int n_cols;                                                                                \
+        int n_rows;                                                                                \
+        const ACC* kernel;                                                                         \
+        int ksize;                                                                                 \
+        ACC padding;                                                                               \
+        ACC* acc;                                                                                  \
+        ACC* tmp;                                                                                  \
+        const ACC* col;                                                                            \
+        const ACC* row;                                                                            \
+    } c11_array2d_convolve_##name;                                                                 \
+    static void c11_array2d__convolve_rows_##name(c11_array2d_convolve_##name* self,               \
+                                                  int begin,                                       \
+                                                  int end) {                                       \
+        int n_cols = self->n_cols;                                                                 \
+        for(int j = begin; j < end; j++) {                                                         \
+            for(int i = 0; i < n_cols; i++)                                                        \
+                self->out[j * n_cols + i] = (T)self->acc[j * n_cols + i];                          \
+        }                                                                                          \
+    }                                                                                              \
+    static void c11_array2d__convolve_h_##name(void* ctx, int chunk, int begin, int end) {         \
+        c11_array2d_convolve_##name* self = ctx;                                                   \
+        int n_cols = self->n_cols;                                                                 \
+        int half = self->ksize / 2;                                                                \
+        ACC* tmp = self->tmp + begin * n_cols;                                                     \
+        memset(tmp, 0, sizeof(ACC) * (end - begin) * n_cols);                                      \
+        for(int ii = 0; ii < self->ksize; ii++) {                                                  \
+            ACC w = self->row[ii];                                                                 \
+            if(w == 0) continue;                                                                   \
+            for(int j = begin; j < end; j++) {                                                     \
+                c11_array2d__shift_madd_##name(self->tmp + j * n_cols,                             \
+                                               self->src + j * n_cols,                             \
+                                               n_cols,                                             \
+                                               ii - half,                                          \
+                                               w,                                                  \
+                                               w * self->padding);                                 \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+    static void c11_array2d__convolve_v_##name(void* ctx, int chunk, int begin, int end) {         \
+        c11_array2d_convolve_##name* self = ctx;                                                   \
+        int n_cols = self->n_cols;                                                                 \
+        int half = self->ksize / 2;                                                                \
+        memset(self->acc + begin * n_cols, 0, sizeof(ACC) * (end - begin) * n_cols);               \
+        ACC row_sum = 0;                                                                           \
+        for(int ii = 0; ii < self->ksize; ii++)                                                    \
+            row_sum += self->row[ii];                                                              \
+        for(int jj = 0; jj < self->ksize; jj++) {                                                  \
+            ACC w = self->col[jj];                                                                 \
+            if(w == 0) continue;                                                                   \
+            /* rows above and below `src` are all padding */                                       \
+            ACC w_padding = w * (row_sum * self->padding);                                         \
+            for(int j = begin; j < end; j++) {                                                     \
+                ACC* restrict dst = self->acc + j * n_cols;                                        \
+                int y = j + jj - half;                                                             \
+                if(y < 0 || y >= self->n_rows) {                                                   \
+                    for(int i = 0; i < n_cols; i++)                                                \
+                        dst[i] += w_padding;                                                       \
+                } else {                                                                           \
+                    MADD_ACC(dst, self->tmp + y * n_cols, w, n_cols);                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        c11_array2d__convolve_rows_##name(self, begin, end);                                       \
+    }                                                                                              \
+    static void c11_array2d__convolve_taps_##name(void* ctx, int chunk, int begin, int end) {      \
+        c11_array2d_convolve_##name* self = ctx;                                                   \
+        int n_cols = self->n_cols;                                                                 \
+        int ksize = self->ksize;                                                                   \
+        int half = ksize / 2;                                                                      \
+        memset(self->acc + begin * n_cols, 0, sizeof(ACC) * (end - begin) * n_cols);               \
+        /* accumulate one shifted copy of `src` per kernel tap */                                  \
+        for(int jj = 0; jj < ksize; jj++) {                                                        \
+            for(int ii = 0; ii < ksize; ii++) {                                                    \
+                ACC w = self->kernel[jj * ksize + ii];                                             \
+                if(w == 0) continue;                                                               \
+                ACC w_padding = w * self->padding;                                                 \
+                for(int j = begin; j < end; j++) {                                                 \
+                    ACC* restrict dst = self->acc + j * n_cols;                                    \
+                    int y = j + jj - half;                                                         \
+                    if(y < 0 || y >= self->n_rows) {                                               \
+                        for(int i = 0; i < n_cols; i++)                                            \
+                            dst[i] += w_padding;                                                   \
+                    } else {                                                                       \
+                        c11_array2d__shift_madd_##name(dst,                                        \
+                                                       self->src + y * n_cols,                     \
+                                                       n_cols,                                     \
+                                                       ii - half,                                  \
+                                                       w,                                          \
+                                                       w_padding);                                 \
+                    }                                                                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        c11_array2d__convolve_rows_##name(self, begin, end);                                       \
+    }                                                                                              \
+    void c11_array2d__convolve_##name(T* out,                                                      \
+                                      const T* src,                                                \
+                                      int n_cols,                                                  \
+                                      int n_rows,                                                  \
+                                      const ACC* kernel,                                           \
+                                      int ksize,                                                   \
+                                      ACC padding) {                                               \
+        int numel = n_cols * n_rows;                                                               \
+        int grain = c11_array2d__row_grain(n_cols);                                                \
+        ACC* col = PK_MALLOC(sizeof(ACC) * ksize * 2);                                             \
+        ACC* row = col + ksize;                                                                    \
+        c11_array2d_convolve_##name ctx = {                                                        \
+            .out = out,                                                                            \
+            .src = src,                                                                            \
+            .n_cols = n_cols,                                                                      \
+            .n_rows = n_rows,                                                                      \
+            .kernel = kernel,                                                                      \
+            .ksize = ksize,                                                                        \
+            .padding = padding,                                                                    \
+            .acc = PK_MALLOC(sizeof(ACC) * numel),                                                 \
+            .col = col,                                                                            \
+            .row = row,                                                                            \
+        };                                                                                         \
+        if(c11_array2d__separate_##name(kernel, ksize, col, row)) {                                \
+            ctx.tmp = PK_MALLOC(sizeof(ACC) * numel);                                              \
+            c11_threadpool__parallel_for(n_rows, grain, c11_array2d__convolve_h_##name, &ctx);     \
+            c11_threadpool__parallel_for(n_rows, grain, c11_array2d__convolve_v_##name, &ctx);     \
+            PK_FREE(ctx.tmp);                                                                      \
+        } else {                                                                                   \
+            c11_threadpool__parallel_for(n_rows, grain, c11_array2d__convolve_taps_##name, &ctx);  \
+        }                                                                                          \
+        PK_FREE(col);                                                                              \
+        PK_FREE(ctx.acc);                                                                          \
+    }
+
+DEF_CONVOLVE(i32, int32_t, int64_t, c11_array2d__madd_i32, c11_array2d__madd_i64)
+
+#undef DEF_CONVOLVE
+
+/* regions */
+const c11_vec2i c11_array2d__Moore[8] = {
+    {{-1, -1}},
+    {{0, -1}},
+    {{1, -1}},
+    {{-1, 0}},
+    {{1, 0}},
+    {{-1, 1}},
+    {{0, 1}},
+    {{1, 1}},
+};
+
+const c11_vec2i c11_array2d__von_Neumann[4] = {
+    {{0, -1}},
+    {{-1, 0}},
+    {{1, 0}},
+    {{0, 1}},
+};
+
+int c11_array2d__flood(int* queue, bool* mask, int n_cols, int n_rows, int start, bool moore) {
+    const c11_vec2i* offsets = moore ? c11_array2d__Moore : c11_array2d__von_Neumann;
+    int n_offsets = moore ? 8 : 4;
+    int head = 0;
+    int tail = 0;
+    mask[start] = false;
+    queue[tail++] = start;
+    while(head < tail) {
+        int index = queue[head++];
+        int x = index % n_cols;
+        int y = index / n_cols;
+        for(int k = 0; k < n_offsets; k++) {
+            int nx = x + offsets[k].x;
+            int ny = y + offsets[k].y;
+            if(nx < 0 || nx >= n_cols || ny < 0 || ny >= n_rows) continue;
+            int next = ny * n_cols + nx;
+            if(!mask[next]) continue;
+            mask[next] = false;
+            queue[tail++] = next;
+        }
+    }
+    return tail;
+}
+
+int c11_array2d__label(int32_t* labels, bool* mask, int n_cols, int n_rows, bool moore) {
+    int numel = n_cols * n_rows;
+    int* queue = PK_MALLOC(sizeof(int) * numel);
+    memset(labels, 0, sizeof(int32_t) * numel);
+    int count = 0;
+    for(int i = 0; i < numel; i++) {
+        if(!mask[i]) continue;
+        count++;
+        int n = c11_array2d__flood(queue, mask, n_cols, n_rows, i, moore);
+        for(int k = 0; k < n; k++)
+            labels[queue[k]] = count;
+    }
+    PK_FREE(queue);
+    return count;
+}
+
+void c11_array2d__distance(int32_t* out, const bool* mask, int n_cols, int n_rows, bool moore) {
+    // a forward and a backward raster pass are exact for unit steps in either neighborhood
+    const int32_t inf = INT32_MAX / 2;
+    for(int j = 0; j < n_rows; j++) {
+        int32_t* row = out + j * n_cols;
+        const int32_t* above = row - n_cols;
+        for(int i = 0; i < n_cols; i++) {
+            int32_t d = mask[j * n_cols + i] ? 0 : inf;
+            if(i > 0) d = c11__min(d, row[i - 1] + 1);
+            if(j > 0) {
+                d = c11__min(d, above[i] + 1);
+                if(moore && i > 0) d = c11__min(d, above[i - 1] + 1);
+                if(moore && i + 1 < n_cols) d = c11__min(d, above[i + 1] + 1);
+            }
+            row[i] = d;
+        }
+    }
+    for(int j = n_rows - 1; j >= 0; j--) {
+        int32_t* row = out + j * n_cols;
+        const int32_t* below = row + n_cols;
+        for(int i = n_cols - 1; i >= 0; i--) {
+            int32_t d = row[i];
+            if(i + 1 < n_cols) d = c11__min(d, row[i + 1] + 1);
+            if(j + 1 < n_rows) {
+                d = c11__min(d, below[i] + 1);
+                if(moore && i > 0) d = c11__min(d, below[i - 1] + 1);
+                if(moore && i + 1 < n_cols) d = c11__min(d, below[i + 1] + 1);
+            }
+            row[i] = d;
+        }
+    }
+    for(int i = 0; i < n_cols * n_rows; i++) {
+        if(out[i] >= inf) out[i] = -1;
+    }
+}
+
+typedef struct c11_array2d_node {
+    double f;
+    int seq;  // equal `f` pop in push order
+    int index;
+} c11_array2d_node;
+
+static bool c11_array2d_node__less(const c11_array2d_node* a, const c11_array2d_node* b) {
+    return a->f < b->f || (a->f == b->f && a->seq < b->seq);
+}
+
+static void c11_array2d__heap_push(c11_vector* heap, c11_array2d_node node) {
+    c11_vector__push(c11_array2d_node, heap, node);
+    c11_array2d_node* data = heap->data;
+    int i = heap->length - 1;
+    while(i > 0) {
+        int parent = (i - 1) / 2;
+        if(!c11_array2d_node__less(&node, &data[parent])) break;
+        data[i] = data[parent];
+        i = parent;
+    }
+    data[i] = node;
+}
+
+static c11_array2d_node c11_array2d__heap_pop(c11_vector* heap) {
+    c11_array2d_node* data = heap->data;
+    c11_array2d_node top = data[0];
+    c11_array2d_node last = data[c11_vector__pop(heap)];
+    int n = heap->length;
+    int i = 0;
+    while(true) {
+        int child = i * 2 + 1;
+        if(child >= n) break;
+        if(child + 1 < n && c11_array2d_node__less(&data[child + 1], &data[child])) child++;
+        if(!c11_array2d_node__less(&data[child], &last)) break;
+        data[i] = data[child];
+        i = child;
+    }
+    if(n > 0) data[i] = last;
+    return top;
+}
+
+static bool c11_array2d__passable(double cost) { return cost > 0 && isfinite(cost); }
+
+bool c11_array2d__find_path(c11_vector* path,
+                            const double* costs,
+                            int n_cols,
+                            int n_rows,
+                            int start,
+                            int end,
+                            bool moore) {
+    if(start == end) {
+        c11_vector__push(int, path, start);
+        return true;
+    }
+    if(!c11_array2d__passable(costs[end])) return false;
+    const c11_vec2i* offsets = moore ? c11_array2d__Moore : c11_array2d__von_Neumann;
+    int n_offsets = moore ? 8 : 4;
+    int numel = n_cols * n_rows;
+    // every step costs at least `min_cost`, so it times the step count never overestimates
+    double min_cost = INFINITY;
+    for(int i = 0; i < numel; i++) {
+        if(c11_array2d__passable(costs[i])) min_cost = c11__min(min_cost, costs[i]);
+    }
+    int end_x = end % n_cols;
+    int end_y = end / n_cols;
+    double* g = PK_MALLOC(sizeof(double) * numel);
+    int* parents = PK_MALLOC(sizeof(int) * numel);
+    bool* closed = PK_MALLOC(sizeof(bool) * numel);
+    for(int i = 0; i < numel; i++)
+        g[i] = INFINITY;
+    memset(closed, 0, sizeof(bool) * numel);
+    c11_vector heap;
+    c11_vector__ctor(&heap, sizeof(c11_array2d_node));
+    int seq = 0;
+    g[start] = 0;
+    parents[start] = -1;
+    c11_array2d__heap_push(&heap, (c11_array2d_node){0, seq++, start});
+    bool found = false;
+    while(heap.length > 0) {
+        c11_array2d_node node = c11_array2d__heap_pop(&heap);
+        int index = node.index;
+        if(closed[index]) continue;
+        closed[index] = true;
+        if(index == end) {
+            found = true;
+            break;
+        }
+        int x = index % n_cols;
+        int y = index / n_cols;
+        for(int k = 0; k < n_offsets; k++) {
+            int nx = x + offsets[k].x;
+            int ny = y + offsets[k].y;
+            if(nx < 0 || nx >= n_cols || ny < 0 || ny >= n_rows) continue;
+            int next = ny * n_cols + nx;
+            if(closed[next] || !c11_array2d__passable(costs[next])) continue;
+            double next_g = g[index] + costs[next];
+            if(next_g >= g[next]) continue;
+            g[next] = next_g;
+            parents[next] = index;
+            int dx = abs(end_x - nx);
+            int dy = abs(end_y - ny);
+            double h = min_cost * (moore ? c11__max(dx, dy) : dx + dy);
+            c11_array2d__heap_push(&heap, (c11_array2d_node){next_g + h, seq++, next});
+        }
+    }
+    if(found) {
+        for(int i = end; i != -1; i = parents[i]) {
+            c11_vector__push(int, path, i);
+        }
+        c11__reverse(int, path);
+    }
+    c11_vector__dtor(&heap);
+    PK_FREE(closed);
+    PK_FREE(parents);
+    PK_FREE(g);
+    return found;
+}
+
+#undef C11_ARRAY2D_INT_DTYPES
+#undef C11_ARRAY2D_FLOAT_DTYPES
+#undef C11_ARRAY2D_NUMERIC_DTYPES
+#undef C11_ARRAY2D_SSE2
+#undef C11_ARRAY2D_AVX2
+#undef C11_ARRAY2D_NEON
@@ -167,11 +167,10 @@ base64_decode(const char *in, unsigned int inlen, unsigned char *out)
 
 static bool base64_b64encode(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    PY_CHECK_ARG_TYPE(0, tp_bytes);
-    int src_size;
-    unsigned char* src_data = py_tobytes(argv, &src_size);
-    unsigned char* dst_data = py_newbytes(py_retval(), src_size * 4 / 3 + 4);
-    int size = base64_encode(src_data, src_size, (char*)dst_data);
+    py_Buffer src;
+    if(!py_getbuffer(argv, &src, false)) return false;
+    unsigned char* dst_data = py_newbytes(py_retval(), src.size * 4 / 3 + 4);
+    int size = base64_encode(src.data, src.size, (char*)dst_data);
     py_bytes_resize(py_retval(), size);
     return true;
 }
@@ -184,10 +183,11 @@ static bool base64_b64decode(int argc, py_Ref argv) {
         c11_sv sv = py_tosv(argv);
         src_data = (void*)sv.data;
         src_size = sv.size;
-    } else if(py_istype(argv, tp_bytes)) {
-        src_data = py_tobytes(argv, &src_size);
     } else {
-        return TypeError("expect bytes or str, got %t", argv->type);
+        py_Buffer buf;
+        if(!py_getbuffer(argv, &buf, false)) return false;
+        src_data = buf.data;
+        src_size = buf.size;
     }
     unsigned char* dst_data = py_newbytes(py_retval(), src_size);
     int size = base64_decode((const char*)src_data, src_size, dst_data);
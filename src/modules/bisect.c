@@ -0,0 +1,138 @@
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/pocketpy.h"
+
+// out = key(a[i]) or a[i], with a fast path for list and tuple
+static bool bisect__item(py_Ref a, int i, py_Ref key, py_OutRef out) {
+    py_TValue* p;
+    int length = pk_arrayview(a, &p);
+    if(length != -1) {
+        if(i >= length) return IndexError("list index out of range");
+        *out = p[i];
+    } else {
+        py_TValue index;
+        py_newint(&index, i);
+        if(!py_getitem(a, &index)) return false;
+        *out = *py_retval();
+    }
+    if(key) {
+        if(!py_call(key, 1, out)) return false;
+        *out = *py_retval();
+    }
+    return true;
+}
+
+// find the insertion point of `x` in `a[lo:hi]`, -1 on error
+static int bisect__impl(py_Ref a, py_Ref x, py_Ref lo_, py_Ref hi_, py_Ref key, bool right) {
+    if(!py_checkint(lo_)) return -1;
+    py_i64 lo = py_toint(lo_);
+    if(lo < 0) {
+        ValueError("lo must be non-negative");
+        return -1;
+    }
+    py_i64 hi;
+    if(py_isnone(hi_)) {
+        py_TValue* p;
+        hi = pk_arrayview(a, &p);
+        if(hi == -1) {
+            if(!py_len(a)) return -1;
+            hi = py_toint(py_retval());
+        }
+    } else {
+        if(!py_checkint(hi_)) return -1;
+        hi = py_toint(hi_);
+    }
+    if(key && py_isnone(key)) key = NULL;
+    py_Ref item = py_pushtmp();
+    while(lo < hi) {
+        py_i64 mid = (lo + hi) / 2;
+        if(!bisect__item(a, (int)mid, key, item)) {
+            py_pop();
+            return -1;
+        }
+        // right: x < a[mid] goes left; left: a[mid] < x goes right
+        int res = right ? pk_less(x, item) : pk_less(item, x);
+        if(res == -1) {
+            py_pop();
+            return -1;
+        }
+        if(res == right) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    py_pop();
+    return (int)lo;
+}
+
+static bool bisect__insort(py_Ref a, py_Ref x, py_Ref lo, py_Ref hi, py_Ref key, bool right) {
+    py_Ref k = py_pushtmp();
+    if(py_isnone(key)) {
+        *k = *x;
+    } else {
+        if(!py_call(key, 1, x)) {
+            py_pop();
+            return false;
+        }
+        *k = *py_retval();
+    }
+    int index = bisect__impl(a, k, lo, hi, key, right);
+    py_pop();
+    if(index == -1) return false;
+    if(py_islist(a)) {
+        py_list_insert(a, index, x);
+    } else {
+        // a.insert(index, x)
+        py_push(a);
+        if(!py_pushmethod(py_name("insert"))) {
+            py_pop();
+            return AttributeError(a, py_name("insert"));
+        }
+        py_newint(py_pushtmp(), index);
+        py_push(x);
+        if(!py_vectorcall(2, 0)) return false;
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+// bisect_left(a, x, lo=0, hi=None, key=None)
+static bool bisect_bisect_left(int argc, py_Ref argv) {
+    int index = bisect__impl(py_arg(0), py_arg(1), py_arg(2), py_arg(3), py_arg(4), false);
+    if(index == -1) return false;
+    py_newint(py_retval(), index);
+    return true;
+}
+
+// bisect_right(a, x, lo=0, hi=None, key=None)
+static bool bisect_bisect_right(int argc, py_Ref argv) {
+    int index = bisect__impl(py_arg(0), py_arg(1), py_arg(2), py_arg(3), py_arg(4), true);
+    if(index == -1) return false;
+    py_newint(py_retval(), index);
+    return true;
+}
+
+// insort_left(a, x, lo=0, hi=None, key=None)
+static bool bisect_insort_left(int argc, py_Ref argv) {
+    return bisect__insort(py_arg(0), py_arg(1), py_arg(2), py_arg(3), py_arg(4), false);
+}
+
+// insort_right(a, x, lo=0, hi=None, key=None)
+static bool bisect_insort_right(int argc, py_Ref argv) {
+    return bisect__insort(py_arg(0), py_arg(1), py_arg(2), py_arg(3), py_arg(4), true);
+}
+
+void pk__add_module_bisect() {
+    py_Ref mod = py_newmodule("bisect");
+
+    py_bind(mod, "bisect_left(a, x, lo=0, hi=None, key=None)", bisect_bisect_left);
+    py_bind(mod, "bisect_right(a, x, lo=0, hi=None, key=None)", bisect_bisect_right);
+    py_bind(mod, "insort_left(a, x, lo=0, hi=None, key=None)", bisect_insort_left);
+    py_bind(mod, "insort_right(a, x, lo=0, hi=None, key=None)", bisect_insort_right);
+
+    // copy before setting, the dict may be resized
+    py_TValue func = *py_getdict(mod, py_name("bisect_right"));
+    py_setdict(mod, py_name("bisect"), &func);
+    func = *py_getdict(mod, py_name("insort_right"));
+    py_setdict(mod, py_name("insort"), &func);
+}
@@ -0,0 +1,1131 @@
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/types.h"
+#include "pocketpy/interpreter/bindings.h"
+#include "pocketpy/common/algorithm.h"
+#include "pocketpy/common/sstream.h"
+#include "pocketpy/pocketpy.h"
+
+/* deque */
+#define PK_DEQUE_BLOCK 64
+#define PK_DEQUE_CENTER ((PK_DEQUE_BLOCK - 1) / 2)
+
+typedef struct c11_deque_block {
+    struct c11_deque_block* prev;
+    struct c11_deque_block* next;
+    py_TValue data[PK_DEQUE_BLOCK];
+} c11_deque_block;
+
+typedef struct c11_deque {
+    c11_deque_block* left;
+    c11_deque_block* right;
+    c11_deque_block* spare;  // a cached free block, avoids malloc churn of steady-state queues
+    int left_index;          // index of the leftmost item in `left`
+    int right_index;         // index of the rightmost item in `right`
+    int length;
+    int maxlen;   // -1 if unbounded
+    int version;  // bumped by every mutation which changes the length or order
+} c11_deque;
+
+typedef struct c11_deque_iterator {
+    c11_deque* deque;
+    c11_deque_block* block;
+    int index;
+    int remaining;
+    int version;
+} c11_deque_iterator;
+
+static c11_deque_block* c11_deque__newblock(c11_deque* self) {
+    c11_deque_block* b = self->spare;
+    if(b) {
+        self->spare = NULL;
+    } else {
+        b = PK_MALLOC(sizeof(c11_deque_block));
+    }
+    b->prev = NULL;
+    b->next = NULL;
+    return b;
+}
+
+static void c11_deque__freeblock(c11_deque* self, c11_deque_block* b) {
+    if(self->spare == NULL) {
+        self->spare = b;
+    } else {
+        PK_FREE(b);
+    }
+}
+
+static void c11_deque__ctor(c11_deque* self, int maxlen) {
+    self->spare = NULL;
+    self->left = self->right = c11_deque__newblock(self);
+    self->left_index = PK_DEQUE_CENTER + 1;
+    self->right_index = PK_DEQUE_CENTER;
+    self->length = 0;
+    self->maxlen = maxlen;
+    self->version = 0;
+}
+
+void c11_deque__dtor(void* ud) {
+    c11_deque* self = ud;
+    c11_deque_block* b = self->left;
+    while(b) {
+        c11_deque_block* next = b->next;
+        PK_FREE(b);
+        b = next;
+    }
+    if(self->spare) PK_FREE(self->spare);
+}
+
+void c11_deque__mark(void* ud, c11_vector* p_stack) {
+    c11_deque* self = ud;
+    c11_deque_block* b = self->left;
+    int index = self->left_index;
+    for(int i = 0; i < self->length; i++) {
+        pk__mark_value(&b->data[index]);
+        if(++index == PK_DEQUE_BLOCK) {
+            b = b->next;
+            index = 0;
+        }
+    }
+}
+
+static void c11_deque__clear(c11_deque* self) {
+    c11_deque_block* b = self->left->next;
+    while(b) {
+        c11_deque_block* next = b->next;
+        c11_deque__freeblock(self, b);
+        b = next;
+    }
+    self->left->next = NULL;
+    self->right = self->left;
+    self->left_index = PK_DEQUE_CENTER + 1;
+    self->right_index = PK_DEQUE_CENTER;
+    self->length = 0;
+    self->version++;
+}
+
+static void c11_deque__push_right(c11_deque* self, py_TValue val) {
+    if(self->right_index == PK_DEQUE_BLOCK - 1) {
+        c11_deque_block* b = c11_deque__newblock(self);
+        b->prev = self->right;
+        self->right->next = b;
+        self->right = b;
+        self->right_index = -1;
+    }
+    self->right->data[++self->right_index] = val;
+    self->length++;
+    self->version++;
+}
+
+static void c11_deque__push_left(c11_deque* self, py_TValue val) {
+    if(self->left_index == 0) {
+        c11_deque_block* b = c11_deque__newblock(self);
+        b->next = self->left;
+        self->left->prev = b;
+        self->left = b;
+        self->left_index = PK_DEQUE_BLOCK;
+    }
+    self->left->data[--self->left_index] = val;
+    self->length++;
+    self->version++;
+}
+
+// the deque must not be empty
+static py_TValue c11_deque__pop_right(c11_deque* self) {
+    py_TValue val = self->right->data[self->right_index--];
+    self->length--;
+    self->version++;
+    if(self->length == 0) {
+        // recenter an empty deque so that both ends have room
+        self->left_index = PK_DEQUE_CENTER + 1;
+        self->right_index = PK_DEQUE_CENTER;
+    } else if(self->right_index < 0) {
+        c11_deque_block* prev = self->right->prev;
+        c11_deque__freeblock(self, self->right);
+        prev->next = NULL;
+        self->right = prev;
+        self->right_index = PK_DEQUE_BLOCK - 1;
+    }
+    return val;
+}
+
+// the deque must not be empty
+static py_TValue c11_deque__pop_left(c11_deque* self) {
+    py_TValue val = self->left->data[self->left_index++];
+    self->length--;
+    self->version++;
+    if(self->length == 0) {
+        self->left_index = PK_DEQUE_CENTER + 1;
+        self->right_index = PK_DEQUE_CENTER;
+    } else if(self->left_index == PK_DEQUE_BLOCK) {
+        c11_deque_block* next = self->left->next;
+        c11_deque__freeblock(self, self->left);
+        next->prev = NULL;
+        self->left = next;
+        self->left_index = 0;
+    }
+    return val;
+}
+
+static void c11_deque__append(c11_deque* self, py_TValue val) {
+    if(self->maxlen == 0) return;
+    c11_deque__push_right(self, val);
+    if(self->length > self->maxlen && self->maxlen > 0) c11_deque__pop_left(self);
+}
+
+static void c11_deque__appendleft(c11_deque* self, py_TValue val) {
+    if(self->maxlen == 0) return;
+    c11_deque__push_left(self, val);
+    if(self->length > self->maxlen && self->maxlen > 0) c11_deque__pop_right(self);
+}
+
+typedef struct c11_deque_cursor {
+    c11_deque_block* block;
+    int index;
+} c11_deque_cursor;
+
+// `i` must be in range, walks from the nearer end
+static c11_deque_cursor c11_deque__seek(c11_deque* self, int i) {
+    c11_deque_cursor cur;
+    if(i < self->length / 2) {
+        cur.block = self->left;
+        i += self->left_index;
+        while(i >= PK_DEQUE_BLOCK) {
+            cur.block = cur.block->next;
+            i -= PK_DEQUE_BLOCK;
+        }
+        cur.index = i;
+        return cur;
+    }
+    cur.block = self->right;
+    // distance from the last slot of `right`
+    int j = (self->length - 1 - i) + (PK_DEQUE_BLOCK - 1 - self->right_index);
+    while(j >= PK_DEQUE_BLOCK) {
+        cur.block = cur.block->prev;
+        j -= PK_DEQUE_BLOCK;
+    }
+    cur.index = PK_DEQUE_BLOCK - 1 - j;
+    return cur;
+}
+
+// returns the item under the cursor and moves to the next one
+static py_TValue* c11_deque_cursor__next(c11_deque_cursor* self) {
+    py_TValue* p = &self->block->data[self->index];
+    if(++self->index == PK_DEQUE_BLOCK) {
+        self->block = self->block->next;
+        self->index = 0;
+    }
+    return p;
+}
+
+static py_TValue* c11_deque__at(c11_deque* self, int i) {
+    c11_deque_cursor cur = c11_deque__seek(self, i);
+    return &cur.block->data[cur.index];
+}
+
+static void c11_deque__rotate(c11_deque* self, py_i64 n) {
+    if(self->length <= 1) return;
+    n %= self->length;
+    if(n < 0) n += self->length;
+    // rotate towards whichever side moves fewer items
+    if(n > self->length / 2) n -= self->length;
+    for(; n > 0; n--) {
+        c11_deque__push_left(self, c11_deque__pop_right(self));
+    }
+    for(; n < 0; n++) {
+        c11_deque__push_right(self, c11_deque__pop_left(self));
+    }
+}
+
+static bool c11_deque__normalize_index(c11_deque* self, py_Ref arg, int* out) {
+    if(!py_checkint(arg)) return false;
+    py_i64 i = py_toint(arg);
+    if(i < 0) i += self->length;
+    if(i < 0 || i >= self->length) return IndexError("deque index out of range");
+    *out = (int)i;
+    return true;
+}
+
+// find the first index of `value` in [start, stop), -1 if not found, -2 on error
+static int c11_deque__find(c11_deque* self, py_Ref value, int start, int stop) {
+    if(start >= stop) return -1;
+    int version = self->version;
+    c11_deque_cursor cur = c11_deque__seek(self, start);
+    for(int i = start; i < stop; i++) {
+        py_TValue item = *c11_deque_cursor__next(&cur);
+        int res = py_equal(&item, value);
+        if(res == -1) return -2;
+        if(version != self->version) {
+            RuntimeError("deque mutated during iteration");
+            return -2;
+        }
+        if(res) return i;
+    }
+    return -1;
+}
+
+static bool c11_deque__extend(c11_deque* self, py_Ref self_obj, py_Ref iterable, bool left) {
+    void (*f_push)(c11_deque*, py_TValue) = left ? c11_deque__appendleft : c11_deque__append;
+    if(py_isidentical(self_obj, iterable)) {
+        // snapshot first, `d.extend(d)` must not see its own appends
+        if(!py_call(py_tpobject(tp_list), 1, iterable)) return false;
+        iterable = py_pushtmp();
+        *iterable = *py_retval();
+        bool ok = c11_deque__extend(self, self_obj, iterable, left);
+        py_pop();
+        return ok;
+    }
+    py_TValue* p;
+    int length = pk_arrayview(iterable, &p);
+    if(length != -1) {
+        for(int i = 0; i < length; i++) {
+            f_push(self, p[i]);
+        }
+        return true;
+    }
+    if(!py_iter(iterable)) return false;
+    py_push(py_retval());
+    while(true) {
+        int res = py_next(py_peek(-1));
+        if(res == -1) {
+            py_pop();
+            return false;
+        }
+        if(res == 0) break;
+        f_push(self, *py_retval());
+    }
+    py_pop();
+    return true;
+}
+
+static bool deque__new__(int argc, py_Ref argv) {
+    // __new__(cls, iterable=None, maxlen=None)
+    py_Type cls = py_totype(argv);
+    int maxlen = -1;
+    if(!py_isnone(py_arg(2))) {
+        if(!py_checkint(py_arg(2))) return false;
+        py_i64 val = py_toint(py_arg(2));
+        if(val < 0) return ValueError("maxlen must be non-negative");
+        maxlen = (int)val;
+    }
+    py_Ref out = py_pushtmp();
+    c11_deque* ud = py_newobject(out, cls, cls == tp_deque ? 0 : -1, sizeof(c11_deque));
+    c11_deque__ctor(ud, maxlen);
+    if(!py_isnone(py_arg(1))) {
+        if(!c11_deque__extend(ud, out, py_arg(1), false)) {
+            py_pop();
+            return false;
+        }
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+static bool deque_append(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque__append(py_touserdata(argv), *py_arg(1));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_appendleft(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque__appendleft(py_touserdata(argv), *py_arg(1));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_pop(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    if(self->length == 0) return IndexError("pop from an empty deque");
+    *py_retval() = c11_deque__pop_right(self);
+    return true;
+}
+
+static bool deque_popleft(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    if(self->length == 0) return IndexError("pop from an empty deque");
+    *py_retval() = c11_deque__pop_left(self);
+    return true;
+}
+
+static bool deque_extend(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!c11_deque__extend(py_touserdata(argv), argv, py_arg(1), false)) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_extendleft(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!c11_deque__extend(py_touserdata(argv), argv, py_arg(1), true)) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_clear(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque__clear(py_touserdata(argv));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_copy(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    py_Ref out = py_pushtmp();
+    c11_deque* ud = py_newobject(out, tp_deque, 0, sizeof(c11_deque));
+    c11_deque__ctor(ud, self->maxlen);
+    c11_deque_block* b = self->left;
+    int index = self->left_index;
+    for(int i = 0; i < self->length; i++) {
+        c11_deque__push_right(ud, b->data[index]);
+        if(++index == PK_DEQUE_BLOCK) {
+            b = b->next;
+            index = 0;
+        }
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+static bool deque_count(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque* self = py_touserdata(argv);
+    int version = self->version;
+    py_i64 count = 0;
+    c11_deque_cursor cur = {self->left, self->left_index};
+    for(int i = 0; i < self->length; i++) {
+        py_TValue item = *c11_deque_cursor__next(&cur);
+        int res = py_equal(&item, py_arg(1));
+        if(res == -1) return false;
+        if(version != self->version) return RuntimeError("deque mutated during iteration");
+        count += res;
+    }
+    py_newint(py_retval(), count);
+    return true;
+}
+
+static bool deque_index(int argc, py_Ref argv) {
+    // index(self, value, start=0, stop=None)
+    c11_deque* self = py_touserdata(argv);
+    int start = 0;
+    int stop = self->length;
+    if(!py_isnone(py_arg(2))) {
+        if(!py_checkint(py_arg(2))) return false;
+        py_i64 val = py_toint(py_arg(2));
+        if(val < 0) val += self->length;
+        start = (int)c11__min(c11__max(val, 0), self->length);
+    }
+    if(!py_isnone(py_arg(3))) {
+        if(!py_checkint(py_arg(3))) return false;
+        py_i64 val = py_toint(py_arg(3));
+        if(val < 0) val += self->length;
+        stop = (int)c11__min(c11__max(val, 0), self->length);
+    }
+    int index = c11_deque__find(self, py_arg(1), start, stop);
+    if(index == -2) return false;
+    if(index == -1) return ValueError("deque.index(x): x not in deque");
+    py_newint(py_retval(), index);
+    return true;
+}
+
+static bool deque_remove(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque* self = py_touserdata(argv);
+    int index = c11_deque__find(self, py_arg(1), 0, self->length);
+    if(index == -2) return false;
+    if(index == -1) return ValueError("deque.remove(x): x not in deque");
+    c11_deque__rotate(self, -index);
+    c11_deque__pop_left(self);
+    c11_deque__rotate(self, index);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_insert(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    c11_deque* self = py_touserdata(argv);
+    if(self->maxlen >= 0 && self->length >= self->maxlen) {
+        return IndexError("deque already at its maximum size");
+    }
+    py_i64 index = py_toint(py_arg(1));
+    if(index < 0) index += self->length;
+    index = c11__min(c11__max(index, 0), self->length);
+    c11_deque__rotate(self, -index);
+    c11_deque__push_left(self, *py_arg(2));
+    c11_deque__rotate(self, index);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_rotate(int argc, py_Ref argv) {
+    // rotate(self, n=1)
+    if(!py_checkint(py_arg(1))) return false;
+    c11_deque__rotate(py_touserdata(argv), py_toint(py_arg(1)));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque_reverse(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    c11_deque_block *lb = self->left, *rb = self->right;
+    int li = self->left_index, ri = self->right_index;
+    for(int n = self->length / 2; n > 0; n--) {
+        py_TValue tmp = lb->data[li];
+        lb->data[li] = rb->data[ri];
+        rb->data[ri] = tmp;
+        if(++li == PK_DEQUE_BLOCK) {
+            lb = lb->next;
+            li = 0;
+        }
+        if(--ri < 0) {
+            rb = rb->prev;
+            ri = PK_DEQUE_BLOCK - 1;
+        }
+    }
+    self->version++;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    py_newint(py_retval(), self->length);
+    return true;
+}
+
+static bool deque__getitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque* self = py_touserdata(argv);
+    int index = 0;
+    if(!c11_deque__normalize_index(self, py_arg(1), &index)) return false;
+    *py_retval() = *c11_deque__at(self, index);
+    return true;
+}
+
+static bool deque__setitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_deque* self = py_touserdata(argv);
+    int index = 0;
+    if(!c11_deque__normalize_index(self, py_arg(1), &index)) return false;
+    *c11_deque__at(self, index) = *py_arg(2);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque__delitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque* self = py_touserdata(argv);
+    int index = 0;
+    if(!c11_deque__normalize_index(self, py_arg(1), &index)) return false;
+    c11_deque__rotate(self, -index);
+    c11_deque__pop_left(self);
+    c11_deque__rotate(self, index);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool deque__contains__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_deque* self = py_touserdata(argv);
+    int index = c11_deque__find(self, py_arg(1), 0, self->length);
+    if(index == -2) return false;
+    py_newbool(py_retval(), index != -1);
+    return true;
+}
+
+static bool deque__eq__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!py_isinstance(py_arg(1), tp_deque)) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    c11_deque* self = py_touserdata(py_arg(0));
+    c11_deque* other = py_touserdata(py_arg(1));
+    if(self->length != other->length) {
+        py_newbool(py_retval(), false);
+        return true;
+    }
+    int self_version = self->version;
+    int other_version = other->version;
+    c11_deque_cursor lhs_cur = {self->left, self->left_index};
+    c11_deque_cursor rhs_cur = {other->left, other->left_index};
+    for(int i = 0; i < self->length; i++) {
+        py_TValue lhs = *c11_deque_cursor__next(&lhs_cur);
+        py_TValue rhs = *c11_deque_cursor__next(&rhs_cur);
+        int res = py_equal(&lhs, &rhs);
+        if(res == -1) return false;
+        if(self_version != self->version || other_version != other->version) {
+            return RuntimeError("deque mutated during iteration");
+        }
+        if(!res) {
+            py_newbool(py_retval(), false);
+            return true;
+        }
+    }
+    py_newbool(py_retval(), true);
+    return true;
+}
+
+static bool deque__ne__(int argc, py_Ref argv) {
+    if(!deque__eq__(argc, argv)) return false;
+    if(py_isbool(py_retval())) py_newbool(py_retval(), !py_tobool(py_retval()));
+    return true;
+}
+
+static bool deque__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "deque([");
+    int version = self->version;
+    c11_deque_cursor cur = {self->left, self->left_index};
+    for(int i = 0; i < self->length; i++) {
+        if(i > 0) c11_sbuf__write_cstr(&buf, ", ");
+        py_TValue item = *c11_deque_cursor__next(&cur);
+        if(!py_repr(&item)) {
+            c11_sbuf__dtor(&buf);
+            return false;
+        }
+        if(version != self->version) {
+            c11_sbuf__dtor(&buf);
+            return RuntimeError("deque mutated during iteration");
+        }
+        c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+    }
+    c11_sbuf__write_char(&buf, ']');
+    if(self->maxlen >= 0) {
+        c11_sbuf__write_cstr(&buf, ", maxlen=");
+        c11_sbuf__write_int(&buf, self->maxlen);
+    }
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool deque__iter__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    c11_deque_iterator* ud =
+        py_newobject(py_retval(), tp_deque_iterator, 1, sizeof(c11_deque_iterator));
+    ud->deque = self;
+    ud->block = self->left;
+    ud->index = self->left_index;
+    ud->remaining = self->length;
+    ud->version = self->version;
+    py_setslot(py_retval(), 0, argv);  // keep a reference to the deque
+    return true;
+}
+
+static bool deque_maxlen(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque* self = py_touserdata(argv);
+    if(self->maxlen < 0) {
+        py_newnone(py_retval());
+    } else {
+        py_newint(py_retval(), self->maxlen);
+    }
+    return true;
+}
+
+bool deque_iterator__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_deque_iterator* self = py_touserdata(argv);
+    if(self->version != self->deque->version) {
+        return RuntimeError("deque mutated during iteration");
+    }
+    if(self->remaining == 0) return StopIteration();
+    *py_retval() = self->block->data[self->index];
+    self->remaining--;
+    if(++self->index == PK_DEQUE_BLOCK) {
+        self->block = self->block->next;
+        self->index = 0;
+    }
+    return true;
+}
+
+static void register_deque(py_Ref mod) {
+    py_Type type = py_newtype("deque", tp_object, mod, c11_deque__dtor);
+    assert(type == tp_deque);
+
+    py_bind(py_tpobject(type), "__new__(cls, iterable=None, maxlen=None)", deque__new__);
+    py_bindmagic(type, __len__, deque__len__);
+    py_bindmagic(type, __getitem__, deque__getitem__);
+    py_bindmagic(type, __setitem__, deque__setitem__);
+    py_bindmagic(type, __delitem__, deque__delitem__);
+    py_bindmagic(type, __contains__, deque__contains__);
+    py_bindmagic(type, __eq__, deque__eq__);
+    py_bindmagic(type, __ne__, deque__ne__);
+    py_bindmagic(type, __repr__, deque__repr__);
+    py_bindmagic(type, __iter__, deque__iter__);
+
+    py_bindmethod(type, "append", deque_append);
+    py_bindmethod(type, "appendleft", deque_appendleft);
+    py_bindmethod(type, "pop", deque_pop);
+    py_bindmethod(type, "popleft", deque_popleft);
+    py_bindmethod(type, "extend", deque_extend);
+    py_bindmethod(type, "extendleft", deque_extendleft);
+    py_bindmethod(type, "clear", deque_clear);
+    py_bindmethod(type, "copy", deque_copy);
+    py_bindmethod(type, "count", deque_count);
+    py_bind(py_tpobject(type), "index(self, value, start=None, stop=None)", deque_index);
+    py_bindmethod(type, "remove", deque_remove);
+    py_bindmethod(type, "insert", deque_insert);
+    py_bind(py_tpobject(type), "rotate(self, n=1)", deque_rotate);
+    py_bindmethod(type, "reverse", deque_reverse);
+    py_bindproperty(type, "maxlen", deque_maxlen, NULL);
+
+    py_setdict(py_tpobject(type), __hash__, py_None());
+
+    type = py_newtype("deque_iterator", tp_object, mod, NULL);
+    assert(type == tp_deque_iterator);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, deque_iterator__next__);
+}
+
+/* defaultdict */
+// returns a new value from a builtin type without calling it, false if `factory` is not one
+static bool defaultdict__fast_factory(py_Ref factory, py_OutRef out) {
+    if(!py_istype(factory, tp_type)) return false;
+    switch(py_totype(factory)) {
+        case tp_int: py_newint(out, 0); return true;
+        case tp_float: py_newfloat(out, 0.0); return true;
+        case tp_bool: py_newbool(out, false); return true;
+        case tp_str: py_newstr(out, ""); return true;
+        case tp_list: py_newlist(out); return true;
+        case tp_dict: py_newdict(out); return true;
+        case tp_tuple: py_newtuple(out, 0); return true;
+        default: return false;
+    }
+}
+
+static bool defaultdict__init__(int argc, py_Ref argv) {
+    // __init__(self, default_factory=None, iterable=None)
+    if(argc > 3) return TypeError("defaultdict() takes at most 2 arguments (%d given)", argc - 1);
+    py_Ref factory = argc >= 2 ? py_arg(1) : py_None();
+    if(!py_isnone(factory) && !py_callable(factory)) {
+        return TypeError("first argument must be callable or None");
+    }
+    py_setdict(argv, py_name("default_factory"), factory);
+    if(argc == 3) {
+        Dict* self = py_touserdata(argv);
+        py_Ref src = py_arg(2);
+        if(py_isinstance(src, tp_dict)) {
+            Dict* other = py_touserdata(src);
+            for(int i = 0; i < other->entries.length; i++) {
+                DictEntry* entry = c11__at(DictEntry, &other->entries, i);
+                if(py_isnil(&entry->key)) continue;
+                if(!Dict__set(self, &entry->key, &entry->val)) return false;
+            }
+        } else {
+            py_TValue* p;
+            int length = pk_arrayview(src, &p);
+            if(length == -1) return TypeError("defaultdict() expects a dict, list or tuple");
+            for(int i = 0; i < length; i++) {
+                if(!py_istuple(&p[i]) || py_tuple_len(&p[i]) != 2) {
+                    return ValueError("defaultdict() argument must be a list of tuple-2");
+                }
+                if(!Dict__set(self, py_tuple_getitem(&p[i], 0), py_tuple_getitem(&p[i], 1))) {
+                    return false;
+                }
+            }
+        }
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool defaultdict__missing__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    py_Ref factory = py_getdict(argv, py_name("default_factory"));
+    if(factory == NULL || py_isnone(factory)) return KeyError(py_arg(1));
+    py_Ref val = py_pushtmp();
+    if(!defaultdict__fast_factory(factory, val)) {
+        if(!py_call(factory, 0, NULL)) {
+            py_pop();
+            return false;
+        }
+        *val = *py_retval();
+    }
+    if(!Dict__set(py_touserdata(argv), py_arg(1), val)) {
+        py_pop();
+        return false;
+    }
+    *py_retval() = *val;
+    py_pop();
+    return true;
+}
+
+static bool defaultdict__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_Ref factory = py_getdict(argv, py_name("default_factory"));
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "defaultdict(");
+    if(!py_repr(factory ? factory : py_None())) {
+        c11_sbuf__dtor(&buf);
+        return false;
+    }
+    c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+    c11_sbuf__write_cstr(&buf, ", ");
+    py_Ref dict_repr = py_tpfindmagic(tp_dict, __repr__);
+    if(!py_call(dict_repr, 1, argv)) {
+        c11_sbuf__dtor(&buf);
+        return false;
+    }
+    c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool defaultdict_copy(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_Ref out = py_pushtmp();
+    Dict* ud = py_newobject(out, argv->type, -1, sizeof(Dict));
+    Dict__copy(ud, py_touserdata(argv));
+    py_Ref factory = py_getdict(argv, py_name("default_factory"));
+    py_setdict(out, py_name("default_factory"), factory ? factory : py_None());
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+/* Counter */
+typedef struct {
+    int index;  // insertion order, breaks ties
+    py_TValue key;
+    py_TValue count;
+} Counter_item;
+
+// self[key] += delta (or -= delta), with a fast path for int counts
+static bool Counter__add(Dict* self, py_Ref key, py_Ref delta, bool negate) {
+    DictEntry* entry;
+    if(!Dict__try_get(self, key, &entry)) return false;
+    if(delta->type == tp_int) {
+        py_i64 d = negate ? -delta->_i64 : delta->_i64;
+        if(entry == NULL) {
+            py_TValue val;
+            py_newint(&val, d);
+            return Dict__set(self, key, &val);
+        }
+        if(entry->val.type == tp_int) {
+            entry->val._i64 += d;
+            return true;
+        }
+    }
+    py_Ref val = py_pushtmp();
+    if(entry == NULL) {
+        py_newint(val, 0);
+    } else {
+        *val = entry->val;
+    }
+    bool ok = negate ? py_binarysub(val, delta) : py_binaryadd(val, delta);
+    if(ok) {
+        *val = *py_retval();
+        ok = Dict__set(self, key, val);
+    }
+    py_pop();
+    return ok;
+}
+
+static bool Counter__update(py_Ref self, py_Ref iterable, bool negate) {
+    Dict* ud = py_touserdata(self);
+    if(py_isinstance(iterable, tp_dict)) {
+        Dict* other = py_touserdata(iterable);
+        // `other` may be `self`, so each entry is copied out before updating
+        int length = other->entries.length;
+        for(int i = 0; i < length; i++) {
+            DictEntry entry = c11__getitem(DictEntry, &other->entries, i);
+            if(py_isnil(&entry.key)) continue;
+            if(!Counter__add(ud, &entry.key, &entry.val, negate)) return false;
+        }
+        return true;
+    }
+    py_TValue one;
+    py_newint(&one, 1);
+    py_TValue* p;
+    if(pk_arrayview(iterable, &p) != -1) {
+        // the length is re-read each time since `__hash__` or `__eq__` may mutate the list
+        for(int i = 0; i < pk_arrayview(iterable, &p); i++) {
+            if(!Counter__add(ud, &p[i], &one, negate)) return false;
+        }
+        return true;
+    }
+    if(!py_iter(iterable)) return false;
+    py_push(py_retval());
+    py_Ref item = py_pushtmp();
+    while(true) {
+        int res = py_next(py_peek(-2));
+        if(res == 0) break;
+        if(res == -1) {
+            py_shrink(2);
+            return false;
+        }
+        *item = *py_retval();
+        if(!Counter__add(ud, item, &one, negate)) {
+            py_shrink(2);
+            return false;
+        }
+    }
+    py_shrink(2);
+    return true;
+}
+
+// 1 if `a` ranks before `b` (larger count, or an equal count inserted earlier), -1 on error
+static int Counter_item__ranks_before(const void* a_, const void* b_, void* extra) {
+    const Counter_item* a = a_;
+    const Counter_item* b = b_;
+    py_Ref x = (py_Ref)&a->count;
+    py_Ref y = (py_Ref)&b->count;
+    if(x->type == tp_int && y->type == tp_int) {
+        if(x->_i64 != y->_i64) return x->_i64 > y->_i64;
+    } else if((x->type == tp_int || x->type == tp_float) &&
+              (y->type == tp_int || y->type == tp_float)) {
+        double xf = x->type == tp_int ? (double)x->_i64 : x->_f64;
+        double yf = y->type == tp_int ? (double)y->_i64 : y->_f64;
+        if(xf != yf) return xf > yf;
+    } else {
+        int res = py_less(y, x);
+        if(res != 0) return res;
+        res = py_less(x, y);
+        if(res == -1) return -1;
+        if(res == 1) return 0;
+    }
+    return a->index < b->index;
+}
+
+// the root of the heap is the item ranking last
+static int Counter__sift_down(Counter_item* heap, int n, int i) {
+    while(true) {
+        int child = 2 * i + 1;
+        if(child >= n) return 1;
+        if(child + 1 < n) {
+            int res = Counter_item__ranks_before(&heap[child], &heap[child + 1], NULL);
+            if(res == -1) return -1;
+            if(res) child++;
+        }
+        int res = Counter_item__ranks_before(&heap[i], &heap[child], NULL);
+        if(res == -1) return -1;
+        if(!res) return 1;
+        Counter_item tmp = heap[i];
+        heap[i] = heap[child];
+        heap[child] = tmp;
+        i = child;
+    }
+}
+
+// collect the `n` most common items in ranking order, `n < 0` means all
+static Counter_item* Counter__most_common(Dict* self, int n, int* out_length) {
+    if(n < 0 || n > self->length) n = self->length;
+    Counter_item* items = PK_MALLOC(sizeof(Counter_item) * c11__max(n, 1));
+    int length = 0;
+    bool partial = n < self->length;
+    for(int i = 0; i < self->entries.length && n > 0; i++) {
+        DictEntry* entry = c11__at(DictEntry, &self->entries, i);
+        if(py_isnil(&entry->key)) continue;
+        Counter_item item = {i, entry->key, entry->val};
+        if(length < n) {
+            items[length++] = item;
+            if(partial && length == n) {
+                // heapify once the heap is full
+                for(int j = n / 2 - 1; j >= 0; j--) {
+                    if(Counter__sift_down(items, n, j) == -1) goto __ERROR;
+                }
+            }
+            continue;
+        }
+        // replace the last ranking item if the new one ranks before it
+        int res = Counter_item__ranks_before(&item, &items[0], NULL);
+        if(res == -1) goto __ERROR;
+        if(res) {
+            items[0] = item;
+            if(Counter__sift_down(items, n, 0) == -1) goto __ERROR;
+        }
+    }
+    if(!c11__stable_sort(items, length, sizeof(Counter_item), Counter_item__ranks_before, NULL)) {
+        goto __ERROR;
+    }
+    *out_length = length;
+    return items;
+__ERROR:
+    PK_FREE(items);
+    return NULL;
+}
+
+static bool Counter__init__(int argc, py_Ref argv) {
+    if(argc > 2) return TypeError("Counter() takes at most 1 argument (%d given)", argc - 1);
+    if(argc == 2 && !py_isnone(py_arg(1))) {
+        if(!Counter__update(argv, py_arg(1), false)) return false;
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Counter__missing__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    py_newint(py_retval(), 0);
+    return true;
+}
+
+static bool Counter__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Dict* self = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "Counter(");
+    if(self->length > 0) {
+        int length;
+        Counter_item* items = Counter__most_common(self, -1, &length);
+        if(items == NULL) {
+            c11_sbuf__dtor(&buf);
+            return false;
+        }
+        c11_sbuf__write_char(&buf, '{');
+        for(int i = 0; i < length; i++) {
+            if(i > 0) c11_sbuf__write_cstr(&buf, ", ");
+            bool ok = py_repr(&items[i].key);
+            if(ok) {
+                c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+                c11_sbuf__write_cstr(&buf, ": ");
+                ok = py_repr(&items[i].count);
+            }
+            if(!ok) {
+                PK_FREE(items);
+                c11_sbuf__dtor(&buf);
+                return false;
+            }
+            c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+        }
+        c11_sbuf__write_char(&buf, '}');
+        PK_FREE(items);
+    }
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool Counter_update(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!Counter__update(argv, py_arg(1), false)) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Counter_subtract(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!Counter__update(argv, py_arg(1), true)) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Counter_most_common(int argc, py_Ref argv) {
+    // most_common(self, n=None)
+    Dict* self = py_touserdata(argv);
+    int n = -1;
+    if(!py_isnone(py_arg(1))) {
+        if(!py_checkint(py_arg(1))) return false;
+        n = (int)c11__max(py_toint(py_arg(1)), 0);
+    }
+    int length;
+    Counter_item* items = Counter__most_common(self, n, &length);
+    if(items == NULL) return false;
+    py_Ref out = py_pushtmp();
+    py_Ref tuple = py_pushtmp();
+    py_newlist(out);
+    for(int i = 0; i < length; i++) {
+        py_Ref p = py_newtuple(tuple, 2);
+        p[0] = items[i].key;
+        p[1] = items[i].count;
+        py_list_append(out, tuple);
+    }
+    PK_FREE(items);
+    *py_retval() = *out;
+    py_shrink(2);
+    return true;
+}
+
+static bool Counter_elements(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Dict* self = py_touserdata(argv);
+    py_Ref out = py_pushtmp();
+    py_newlist(out);
+    for(int i = 0; i < self->entries.length; i++) {
+        DictEntry* entry = c11__at(DictEntry, &self->entries, i);
+        if(py_isnil(&entry->key)) continue;
+        if(!py_checkint(&entry->val)) {
+            py_pop();
+            return false;
+        }
+        for(py_i64 j = 0; j < entry->val._i64; j++) {
+            py_list_append(out, &entry->key);
+        }
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+static bool Counter_total(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Dict* self = py_touserdata(argv);
+    py_Ref acc = py_pushtmp();
+    py_newint(acc, 0);
+    for(int i = 0; i < self->entries.length; i++) {
+        DictEntry entry = c11__getitem(DictEntry, &self->entries, i);
+        if(py_isnil(&entry.key)) continue;
+        if(acc->type == tp_int && entry.val.type == tp_int) {
+            acc->_i64 += entry.val._i64;
+            continue;
+        }
+        if(!py_binaryadd(acc, &entry.val)) {
+            py_pop();
+            return false;
+        }
+        *acc = *py_retval();
+    }
+    *py_retval() = *acc;
+    py_pop();
+    return true;
+}
+
+static bool Counter_copy(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Dict* ud = py_newobject(py_retval(), argv->type, -1, sizeof(Dict));
+    Dict__copy(ud, py_touserdata(argv));
+    return true;
+}
+
+void pk__add_module_collections() {
+    py_Ref mod = py_newmodule("collections");
+
+    register_deque(mod);
+
+    py_Type type = py_newtype("defaultdict", tp_dict, mod, NULL);
+    py_bindmagic(type, __init__, defaultdict__init__);
+    py_bindmagic(type, __missing__, defaultdict__missing__);
+    py_bindmagic(type, __repr__, defaultdict__repr__);
+    py_bindmethod(type, "copy", defaultdict_copy);
+
+    type = py_newtype("Counter", tp_dict, mod, NULL);
+    py_bindmagic(type, __init__, Counter__init__);
+    py_bindmagic(type, __missing__, Counter__missing__);
+    py_bindmagic(type, __repr__, Counter__repr__);
+    py_bindmethod(type, "update", Counter_update);
+    py_bindmethod(type, "subtract", Counter_subtract);
+    py_bind(py_tpobject(type), "most_common(self, n=None)", Counter_most_common);
+    py_bindmethod(type, "elements", Counter_elements);
+    py_bindmethod(type, "total", Counter_total);
+    py_bindmethod(type, "copy", Counter_copy);
+}
+
+#undef PK_DEQUE_BLOCK
+#undef PK_DEQUE_CENTER
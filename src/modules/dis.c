@@ -6,10 +6,11 @@
 static bool disassemble(CodeObject* co) {
     c11_vector /*T=int*/ jumpTargets;
     c11_vector__ctor(&jumpTargets, sizeof(int));
-    for(int i = 0; i < co->codes.length; i++) {
-        Bytecode* bc = c11__at(Bytecode, &co->codes, i);
-        if(Bytecode__is_forward_jump(bc)) {
-            int target = (int16_t)bc->arg + i;
+    for(int i = 0; i < co->units.length; i++) {
+        Bytecode bc;
+        i = CodeObject__decode(co, i, &bc);
+        if(Bytecode__is_forward_jump(&bc)) {
+            int target = (int16_t)bc.arg + i;
             c11_vector__push(int, &jumpTargets, target);
         }
     }
@@ -18,29 +19,32 @@ static bool disassemble(CodeObject* co) {
     c11_sbuf__ctor(&ss);
 
     int prev_line = -1;
-    for(int i = 0; i < co->codes.length; i++) {
-        Bytecode byte = c11__getitem(Bytecode, &co->codes, i);
-        BytecodeEx ex = c11__getitem(BytecodeEx, &co->codes_ex, i);
+    for(int i = 0; i < co->units.length; i++) {
+        // `start` is the first unit of this instruction, `i` is its opcode unit
+        int start = i;
+        Bytecode byte;
+        i = CodeObject__decode(co, i, &byte);
+        int lineno = CodeObject__lineno(co, i);
 
         char line[8] = "";
-        if(ex.lineno == prev_line) {
+        if(lineno == prev_line) {
             // do nothing
         } else {
-            snprintf(line, sizeof(line), "%d", ex.lineno);
+            snprintf(line, sizeof(line), "%d", lineno);
             if(prev_line != -1) c11_sbuf__write_char(&ss, '\n');
-            prev_line = ex.lineno;
+            prev_line = lineno;
         }
 
         char pointer[4] = "";
         c11__foreach(int, &jumpTargets, it) {
-            if(*it == i) {
+            if(*it == start) {
                 snprintf(pointer, sizeof(pointer), "->");
                 break;
             }
         }
 
         char buf[32];
-        snprintf(buf, sizeof(buf), "%-8s%-3s%-3d ", line, pointer, i);
+        snprintf(buf, sizeof(buf), "%-8s%-3s%-3d ", line, pointer, start);
         c11_sbuf__write_cstr(&ss, buf);
 
         c11_sbuf__write_cstr(&ss, pk_opname(byte.op));
@@ -67,7 +71,11 @@ static bool disassemble(CodeObject* co) {
                     }
                     break;
                 }
-                case OP_FORMAT_STRING:
+                case OP_BUILD_FSTRING: {
+                    FStringLayout* layout = c11__at(FStringLayout, &co->fstrings, byte.arg);
+                    pk_sprintf(&ss, " (%d values)", layout->count);
+                    break;
+                }
                 case OP_IMPORT_PATH: {
                     py_Ref path = c11__at(py_TValue, &co->consts, byte.arg);
                     pk_sprintf(&ss, " (%q)", py_tosv(path));
@@ -95,6 +103,23 @@ static bool disassemble(CodeObject* co) {
                     pk_sprintf(&ss, " (%n)", name);
                     break;
                 }
+                case OP_LOAD_FAST_LOAD_FAST: {
+                    py_Name a = c11__getitem(py_Name, &co->varnames, byte.arg & 0xFF);
+                    py_Name b = c11__getitem(py_Name, &co->varnames, byte.arg >> 8);
+                    pk_sprintf(&ss, " (%n, %n)", a, b);
+                    break;
+                }
+                case OP_LOAD_FAST_LOAD_ATTR: {
+                    py_Name a = c11__getitem(py_Name, &co->varnames, byte.arg & 0xFF);
+                    py_Name b = c11__getitem(py_Name, &co->names, byte.arg >> 8);
+                    pk_sprintf(&ss, " (%n.%n)", a, b);
+                    break;
+                }
+                case OP_INC_FAST: {
+                    py_Name a = c11__getitem(py_Name, &co->varnames, byte.arg & 0xFF);
+                    pk_sprintf(&ss, " (%n += %d)", a, (int)(int8_t)(byte.arg >> 8));
+                    break;
+                }
                 case OP_LOAD_FUNCTION: {
                     const FuncDecl* decl = c11__getitem(FuncDecl*, &co->func_decls, byte.arg);
                     pk_sprintf(&ss, " (%s)", decl->code.name->data);
@@ -128,7 +153,19 @@ static bool disassemble(CodeObject* co) {
             }
         } while(0);
 
-        if(i != co->codes.length - 1) c11_sbuf__write_char(&ss, '\n');
+        if(i != co->units.length - 1) c11_sbuf__write_char(&ss, '\n');
+    }
+
+    if(co->exc_table.length > 0) {
+        c11_sbuf__write_cstr(&ss, "\nExceptionTable:");
+        c11__foreach(CodeExceptionEntry, &co->exc_table, entry) {
+            pk_sprintf(&ss,
+                       "\n  %d to %d -> %d [%d]",
+                       entry->start,
+                       entry->end - 1,
+                       entry->handler,
+                       entry->depth);
+        }
     }
 
     c11_string* output = c11_sbuf__submit(&ss);
@@ -139,25 +176,44 @@ static bool disassemble(CodeObject* co) {
     return true;
 }
 
+static CodeObject* dis__getcode(py_Ref obj) {
+    if(py_istype(obj, tp_function)) {
+        Function* ud = py_touserdata(obj);
+        return &ud->decl->code;
+    } else if(py_istype(obj, tp_code)) {
+        return py_touserdata(obj);
+    }
+    return NULL;
+}
+
 static bool dis_dis(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-
-    CodeObject* code = NULL;
-    if(py_istype(argv, tp_function)) {
-        Function* ud = py_touserdata(argv);
-        code = &ud->decl->code;
-    } else if(py_istype(argv, tp_code)) {
-        code = py_touserdata(argv);
-    } else {
-        return TypeError("dis() expected a code object");
-    }
+    CodeObject* code = dis__getcode(argv);
+    if(!code) return TypeError("dis() expected a code object");
     if(!disassemble(code)) return false;
     py_newnone(py_retval());
     return true;
 }
 
+static bool dis_get_instructions(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    CodeObject* code = dis__getcode(argv);
+    if(!code) return TypeError("get_instructions() expected a code object");
+    py_newlist(py_retval());
+    for(int i = 0; i < code->units.length; i++) {
+        Bytecode byte;
+        i = CodeObject__decode(code, i, &byte);
+        py_ItemRef item = py_list_emplace(py_retval());
+        py_newtuple(item, 2);
+        py_newstr(py_tuple_getitem(item, 0), pk_opname(byte.op));
+        py_newint(py_tuple_getitem(item, 1), byte.arg);
+    }
+    return true;
+}
+
 void pk__add_module_dis() {
     py_Ref mod = py_newmodule("dis");
 
     py_bindfunc(mod, "dis", dis_dis);
+    py_bindfunc(mod, "get_instructions", dis_get_instructions);
 }
\ No newline at end of file
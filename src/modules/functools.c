@@ -0,0 +1,422 @@
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/types.h"
+#include "pocketpy/pocketpy.h"
+
+/* Native memoization for `functools.cache` and `functools.lru_cache`.
+ * The cache owns an open-addressing table of node indices. A lookup hashes the call
+ * arguments in place, so a hit never allocates; a tuple key is only built on insertion. */
+
+typedef struct lru_node {
+    py_TValue key;  // the only argument, or a tuple of all arguments
+    py_TValue value;
+    py_i64 hash;
+    int nargs;
+    int prev;  // towards the most recently used, -1 at the head
+    int next;  // towards the least recently used, -1 at the tail
+} lru_node;
+
+typedef struct lru_cache {
+    py_TValue func;
+    int maxsize;  // -1 if unbounded
+    py_i64 hits;
+    py_i64 misses;
+    c11_vector /*T=lru_node*/ nodes;
+    int* table;    // node indices, -1 if empty
+    int capacity;  // length of `table`, 0 or a power of 2
+    int head;      // the most recently used node
+    int tail;      // the least recently used node
+    int version;   // bumped whenever a node is added, evicted or cleared
+} lru_cache;
+
+typedef struct lru_cache_info {
+    py_i64 hits;
+    py_i64 misses;
+    py_i64 maxsize;  // -1 if unbounded
+    py_i64 currsize;
+} lru_cache_info;
+
+static uint32_t lru__slot(lru_cache* self, py_i64 hash) {
+    // small ints hash to themselves, mix the bits before masking
+    uint64_t h = (uint64_t)hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (uint32_t)h & (self->capacity - 1);
+}
+
+static void lru_cache__clear(lru_cache* self) {
+    c11_vector__clear(&self->nodes);
+    PK_FREE(self->table);
+    self->table = NULL;
+    self->capacity = 0;
+    self->head = -1;
+    self->tail = -1;
+    self->version++;
+}
+
+void lru_cache__dtor(void* ud) {
+    lru_cache* self = ud;
+    c11_vector__dtor(&self->nodes);
+    PK_FREE(self->table);
+}
+
+void lru_cache__gc_mark(void* ud, c11_vector* p_stack) {
+    lru_cache* self = ud;
+    pk__mark_value(&self->func);
+    for(int i = 0; i < self->nodes.length; i++) {
+        lru_node* node = c11__at(lru_node, &self->nodes, i);
+        pk__mark_value(&node->key);
+        pk__mark_value(&node->value);
+    }
+}
+
+static bool lru__hash_args(int argc, py_Ref argv, py_i64* out) {
+    if(argc == 1) return py_hash(argv, out);
+    uint64_t h = 0x345678 + (uint64_t)argc;
+    for(int i = 0; i < argc; i++) {
+        py_i64 x;
+        if(!py_hash(&argv[i], &x)) return false;
+        h = (h ^ (uint64_t)x) * 1000003;
+    }
+    *out = (py_i64)h;
+    return true;
+}
+
+// 1 if `node` was built from the same arguments, 0 if not, -1 on error
+static int lru__match(lru_cache* self, int index, int argc, py_Ref argv) {
+    lru_node node = c11__getitem(lru_node, &self->nodes, index);
+    if(node.nargs != argc) return 0;
+    if(argc == 1) return py_equal(&node.key, argv);
+    int version = self->version;
+    py_TValue* p = py_tuple_data(&node.key);
+    for(int i = 0; i < argc; i++) {
+        int res = py_equal(&p[i], &argv[i]);
+        if(res != 1) return res;
+        // the key may be gone, let the caller restart
+        if(self->version != version) return 0;
+    }
+    return 1;
+}
+
+// the node index of the arguments, -1 if not found, -2 on error
+static int lru__find(lru_cache* self, py_i64 hash, int argc, py_Ref argv) {
+__RESTART:
+    if(self->capacity == 0) return -1;
+    int version = self->version;
+    uint32_t i = lru__slot(self, hash);
+    while(true) {
+        int index = self->table[i];
+        if(index == -1) return -1;
+        if(c11__getitem(lru_node, &self->nodes, index).hash == hash) {
+            int res = lru__match(self, index, argc, argv);
+            if(res == -1) return -2;
+            // `__eq__` may have called back into the cache, the probe is stale then
+            if(self->version != version) goto __RESTART;
+            if(res == 1) return index;
+        }
+        i = (i + 1) & (self->capacity - 1);
+    }
+}
+
+static void lru__table_insert(lru_cache* self, int index) {
+    uint32_t i = lru__slot(self, c11__getitem(lru_node, &self->nodes, index).hash);
+    while(self->table[i] != -1) {
+        i = (i + 1) & (self->capacity - 1);
+    }
+    self->table[i] = index;
+}
+
+// backward-shift deletion keeps probe sequences intact without tombstones
+static void lru__table_remove(lru_cache* self, int index) {
+    uint32_t mask = self->capacity - 1;
+    uint32_t i = lru__slot(self, c11__getitem(lru_node, &self->nodes, index).hash);
+    while(self->table[i] != index) {
+        i = (i + 1) & mask;
+    }
+    self->table[i] = -1;
+    uint32_t j = i;
+    while(true) {
+        j = (j + 1) & mask;
+        int k = self->table[j];
+        if(k == -1) break;
+        uint32_t home = lru__slot(self, c11__getitem(lru_node, &self->nodes, k).hash);
+        // `k` stays if its home slot lies cyclically in (i, j]
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if(stays) continue;
+        self->table[i] = k;
+        self->table[j] = -1;
+        i = j;
+    }
+}
+
+static void lru__rehash(lru_cache* self, int capacity) {
+    PK_FREE(self->table);
+    self->capacity = capacity;
+    self->table = PK_MALLOC(sizeof(int) * capacity);
+    memset(self->table, -1, sizeof(int) * capacity);
+    for(int i = 0; i < self->nodes.length; i++) {
+        lru__table_insert(self, i);
+    }
+}
+
+static void lru__unlink(lru_cache* self, int index) {
+    lru_node* node = c11__at(lru_node, &self->nodes, index);
+    if(node->prev != -1) {
+        c11__at(lru_node, &self->nodes, node->prev)->next = node->next;
+    } else {
+        self->head = node->next;
+    }
+    if(node->next != -1) {
+        c11__at(lru_node, &self->nodes, node->next)->prev = node->prev;
+    } else {
+        self->tail = node->prev;
+    }
+}
+
+static void lru__push_front(lru_cache* self, int index) {
+    lru_node* node = c11__at(lru_node, &self->nodes, index);
+    node->prev = -1;
+    node->next = self->head;
+    if(self->head != -1) c11__at(lru_node, &self->nodes, self->head)->prev = index;
+    self->head = index;
+    if(self->tail == -1) self->tail = index;
+}
+
+static void lru__insert(lru_cache* self, py_i64 hash, int argc, py_Ref argv, py_Ref value) {
+    // build the key first, allocating a tuple may trigger a gc
+    py_TValue key;
+    if(argc == 1) {
+        key = argv[0];
+    } else {
+        py_Ref p = py_newtuple(&key, argc);
+        for(int i = 0; i < argc; i++) {
+            p[i] = argv[i];
+        }
+    }
+    int index;
+    if(self->maxsize > 0 && self->nodes.length >= self->maxsize) {
+        // reuse the least recently used node
+        index = self->tail;
+        lru__table_remove(self, index);
+        lru__unlink(self, index);
+    } else {
+        if((self->nodes.length + 1) * 2 > self->capacity) {
+            lru__rehash(self, self->capacity == 0 ? 8 : self->capacity * 2);
+        }
+        index = self->nodes.length;
+        c11_vector__emplace(&self->nodes);
+    }
+    lru_node* node = c11__at(lru_node, &self->nodes, index);
+    node->key = key;
+    node->value = *value;
+    node->hash = hash;
+    node->nargs = argc;
+    self->version++;
+    lru__table_insert(self, index);
+    if(self->maxsize > 0) lru__push_front(self, index);
+}
+
+static bool lru_cache__call__(int argc, py_Ref argv) {
+    lru_cache* self = py_touserdata(argv);
+    int nargs = argc - 1;
+    py_Ref args = argv + 1;
+    if(self->maxsize == 0) {
+        self->misses++;
+        return py_call(&self->func, nargs, args);
+    }
+    py_i64 hash;
+    if(!lru__hash_args(nargs, args, &hash)) return false;
+    int index = lru__find(self, hash, nargs, args);
+    if(index == -2) return false;
+    if(index >= 0) {
+        self->hits++;
+        if(self->maxsize > 0 && self->head != index) {
+            lru__unlink(self, index);
+            lru__push_front(self, index);
+        }
+        *py_retval() = c11__getitem(lru_node, &self->nodes, index).value;
+        return true;
+    }
+    self->misses++;
+    if(!py_call(&self->func, nargs, args)) return false;
+    py_Ref value = py_pushtmp();
+    *value = *py_retval();
+    // the call may have cached the same arguments already, e.g. by recursion
+    index = lru__find(self, hash, nargs, args);
+    if(index == -2) {
+        py_pop();
+        return false;
+    }
+    if(index == -1) lru__insert(self, hash, nargs, args, value);
+    *py_retval() = *value;
+    py_pop();
+    return true;
+}
+
+static bool lru_cache_cache_info(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache* self = py_touserdata(argv);
+    py_Type type = py_gettype("_functools", py_name("CacheInfo"));
+    assert(type);
+    lru_cache_info* ud = py_newobject(py_retval(), type, 0, sizeof(lru_cache_info));
+    ud->hits = self->hits;
+    ud->misses = self->misses;
+    ud->maxsize = self->maxsize;
+    ud->currsize = self->nodes.length;
+    return true;
+}
+
+static bool lru_cache_cache_clear(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache* self = py_touserdata(argv);
+    lru_cache__clear(self);
+    self->hits = 0;
+    self->misses = 0;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool lru_cache__wrapped__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache* self = py_touserdata(argv);
+    *py_retval() = self->func;
+    return true;
+}
+
+static bool lru_cache__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache* self = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "<functools._lru_cache_wrapper of ");
+    if(!py_repr(&self->func)) {
+        c11_sbuf__dtor(&buf);
+        return false;
+    }
+    c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+    c11_sbuf__write_char(&buf, '>');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool lru_cache__new(py_OutRef out, py_Ref func, int maxsize) {
+    if(!py_callable(func)) return TypeError("the first argument must be callable");
+    py_Type type = py_gettype("_functools", py_name("_lru_cache_wrapper"));
+    assert(type);
+    lru_cache* self = py_newobject(out, type, 0, sizeof(lru_cache));
+    self->func = *func;
+    self->maxsize = maxsize;
+    self->hits = 0;
+    self->misses = 0;
+    c11_vector__ctor(&self->nodes, sizeof(lru_node));
+    self->table = NULL;
+    self->capacity = 0;
+    self->head = -1;
+    self->tail = -1;
+    self->version = 0;
+    return true;
+}
+
+static bool functools_cache(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    return lru_cache__new(py_retval(), argv, -1);
+}
+
+// called as a bound method of `maxsize`
+static bool functools__lru_cache_decorate(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    int maxsize = py_isnone(py_arg(0)) ? -1 : (int)py_toint(py_arg(0));
+    return lru_cache__new(py_retval(), py_arg(1), maxsize);
+}
+
+static bool functools_lru_cache(int argc, py_Ref argv) {
+    // lru_cache(maxsize=128)
+    py_Ref maxsize = py_arg(0);
+    // `@lru_cache` without parentheses
+    if(py_callable(maxsize)) return lru_cache__new(py_retval(), maxsize, 128);
+    if(!py_isnone(maxsize)) {
+        if(!py_checkint(maxsize)) return false;
+        if(py_toint(maxsize) < 0) py_newint(maxsize, 0);
+    }
+    py_TValue decorate;
+    py_newnativefunc(&decorate, functools__lru_cache_decorate);
+    py_newboundmethod(py_retval(), maxsize, &decorate);
+    return true;
+}
+
+#define DEF_CACHE_INFO_GETTER(name)                                                                \
+    static bool CacheInfo__##name(int argc, py_Ref argv) {                                         \
+        PY_CHECK_ARGC(1);                                                                          \
+        lru_cache_info* ud = py_touserdata(argv);                                                  \
+        py_newint(py_retval(), ud->name);                                                          \
+        return true;                                                                               \
+    }
+
+DEF_CACHE_INFO_GETTER(hits)
+DEF_CACHE_INFO_GETTER(misses)
+DEF_CACHE_INFO_GETTER(currsize)
+
+#undef DEF_CACHE_INFO_GETTER
+
+static bool CacheInfo__maxsize(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache_info* ud = py_touserdata(argv);
+    if(ud->maxsize < 0) {
+        py_newnone(py_retval());
+    } else {
+        py_newint(py_retval(), ud->maxsize);
+    }
+    return true;
+}
+
+static bool CacheInfo__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lru_cache_info* ud = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    pk_sprintf(&buf, "CacheInfo(hits=%i, misses=%i, maxsize=", ud->hits, ud->misses);
+    if(ud->maxsize < 0) {
+        c11_sbuf__write_cstr(&buf, "None");
+    } else {
+        c11_sbuf__write_i64(&buf, ud->maxsize);
+    }
+    pk_sprintf(&buf, ", currsize=%i)", ud->currsize);
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool CacheInfo__eq__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!py_istype(py_arg(1), argv->type)) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    lru_cache_info* lhs = py_touserdata(py_arg(0));
+    lru_cache_info* rhs = py_touserdata(py_arg(1));
+    py_newbool(py_retval(), memcmp(lhs, rhs, sizeof(lru_cache_info)) == 0);
+    return true;
+}
+
+void pk__add_module_functools() {
+    py_Ref mod = py_newmodule("_functools");
+
+    py_Type type = py_newtype("_lru_cache_wrapper", tp_object, mod, lru_cache__dtor);
+    // a decorated method receives `self` like the function it wraps
+    pk_typeinfo(type)->is_method_like = true;
+    py_bindmagic(type, __call__, lru_cache__call__);
+    py_bindmagic(type, __repr__, lru_cache__repr__);
+    py_bindmethod(type, "cache_info", lru_cache_cache_info);
+    py_bindmethod(type, "cache_clear", lru_cache_cache_clear);
+    py_bindproperty(type, "__wrapped__", lru_cache__wrapped__, NULL);
+
+    type = py_newtype("CacheInfo", tp_object, mod, NULL);
+    py_bindproperty(type, "hits", CacheInfo__hits, NULL);
+    py_bindproperty(type, "misses", CacheInfo__misses, NULL);
+    py_bindproperty(type, "maxsize", CacheInfo__maxsize, NULL);
+    py_bindproperty(type, "currsize", CacheInfo__currsize, NULL);
+    py_bindmagic(type, __repr__, CacheInfo__repr__);
+    py_bindmagic(type, __eq__, CacheInfo__eq__);
+
+    py_bindfunc(mod, "cache", functools_cache);
+    py_bind(mod, "lru_cache(maxsize=128)", functools_lru_cache);
+}
@@ -0,0 +1,163 @@
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/types.h"
+#include "pocketpy/pocketpy.h"
+
+/* Ported from CPython's `heapq.py`, operating on the list storage directly.
+ * Comparisons may run python code, so `list->data` is re-read after each one
+ * and the list is checked for resizing. */
+
+static bool heapq__changed(List* list, int length) {
+    if(list->length == length) return false;
+    RuntimeError("list changed size during iteration");
+    return true;
+}
+
+// `heap` is a heap at all indices >= startpos, except possibly for pos
+static bool heapq__siftdown(py_Ref heap, int startpos, int pos) {
+    List* list = py_touserdata(heap);
+    int length = list->length;
+    // keep `newitem` alive while it is out of the list
+    py_Ref newitem = py_pushtmp();
+    *newitem = c11__getitem(py_TValue, list, pos);
+    while(pos > startpos) {
+        int parentpos = (pos - 1) >> 1;
+        py_TValue parent = c11__getitem(py_TValue, list, parentpos);
+        int res = pk_less(newitem, &parent);
+        if(res == -1 || heapq__changed(list, length)) {
+            py_pop();
+            return false;
+        }
+        if(!res) break;
+        c11__setitem(py_TValue, list, pos, parent);
+        pos = parentpos;
+    }
+    c11__setitem(py_TValue, list, pos, *newitem);
+    py_pop();
+    return true;
+}
+
+// bubble up the smaller child until hitting a leaf, then sift `newitem` into place
+static bool heapq__siftup(py_Ref heap, int pos) {
+    List* list = py_touserdata(heap);
+    int endpos = list->length;
+    int startpos = pos;
+    py_Ref newitem = py_pushtmp();
+    *newitem = c11__getitem(py_TValue, list, pos);
+    int childpos = 2 * pos + 1;
+    while(childpos < endpos) {
+        int rightpos = childpos + 1;
+        if(rightpos < endpos) {
+            py_TValue lhs = c11__getitem(py_TValue, list, childpos);
+            py_TValue rhs = c11__getitem(py_TValue, list, rightpos);
+            int res = pk_less(&lhs, &rhs);
+            if(res == -1 || heapq__changed(list, endpos)) {
+                py_pop();
+                return false;
+            }
+            if(!res) childpos = rightpos;
+        }
+        c11__setitem(py_TValue, list, pos, c11__getitem(py_TValue, list, childpos));
+        pos = childpos;
+        childpos = 2 * pos + 1;
+    }
+    c11__setitem(py_TValue, list, pos, *newitem);
+    py_pop();
+    return heapq__siftdown(heap, startpos, pos);
+}
+
+static bool heapq_heappush(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+    py_list_append(py_arg(0), py_arg(1));
+    if(!heapq__siftdown(py_arg(0), 0, py_list_len(py_arg(0)) - 1)) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool heapq_heappop(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+    List* list = py_touserdata(py_arg(0));
+    if(list->length == 0) return IndexError("pop from empty list");
+    py_TValue lastelt = c11_vector__back(py_TValue, list);
+    c11_vector__pop(list);
+    if(list->length == 0) {
+        *py_retval() = lastelt;
+        return true;
+    }
+    py_Ref returnitem = py_pushtmp();
+    *returnitem = c11__getitem(py_TValue, list, 0);
+    c11__setitem(py_TValue, list, 0, lastelt);
+    if(!heapq__siftup(py_arg(0), 0)) {
+        py_pop();
+        return false;
+    }
+    *py_retval() = *returnitem;
+    py_pop();
+    return true;
+}
+
+static bool heapq_heapreplace(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+    List* list = py_touserdata(py_arg(0));
+    if(list->length == 0) return IndexError("index out of range");
+    py_Ref returnitem = py_pushtmp();
+    *returnitem = c11__getitem(py_TValue, list, 0);
+    c11__setitem(py_TValue, list, 0, *py_arg(1));
+    if(!heapq__siftup(py_arg(0), 0)) {
+        py_pop();
+        return false;
+    }
+    *py_retval() = *returnitem;
+    py_pop();
+    return true;
+}
+
+static bool heapq_heappushpop(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+    List* list = py_touserdata(py_arg(0));
+    if(list->length == 0) {
+        *py_retval() = *py_arg(1);
+        return true;
+    }
+    py_TValue top = c11__getitem(py_TValue, list, 0);
+    int res = pk_less(&top, py_arg(1));
+    if(res == -1) return false;
+    if(!res || list->length == 0) {
+        *py_retval() = *py_arg(1);
+        return true;
+    }
+    py_Ref returnitem = py_pushtmp();
+    *returnitem = c11__getitem(py_TValue, list, 0);
+    c11__setitem(py_TValue, list, 0, *py_arg(1));
+    if(!heapq__siftup(py_arg(0), 0)) {
+        py_pop();
+        return false;
+    }
+    *py_retval() = *returnitem;
+    py_pop();
+    return true;
+}
+
+static bool heapq_heapify(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+    int n = py_list_len(py_arg(0));
+    for(int i = n / 2 - 1; i >= 0; i--) {
+        if(!heapq__siftup(py_arg(0), i)) return false;
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+void pk__add_module_heapq() {
+    py_Ref mod = py_newmodule("heapq");
+
+    py_bindfunc(mod, "heappush", heapq_heappush);
+    py_bindfunc(mod, "heappop", heapq_heappop);
+    py_bindfunc(mod, "heapreplace", heapq_heapreplace);
+    py_bindfunc(mod, "heappushpop", heapq_heappushpop);
+    py_bindfunc(mod, "heapify", heapq_heapify);
+}
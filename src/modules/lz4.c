@@ -3,13 +3,21 @@
 #include <string.h>
 #include <assert.h>
 #include "pocketpy/pocketpy.h"
+#include "pocketpy/common/vector.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/objects/base.h"
 #include "lz4/lib/lz4.h"
+#ifndef LZ4F_STATIC_LINKING_ONLY
+#define LZ4F_STATIC_LINKING_ONLY  // dictionaries
+#endif
+#include "lz4/lib/lz4frame.h"
 
 static bool lz4_compress(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    PY_CHECK_ARG_TYPE(0, tp_bytes);
-    int src_size;
-    const void* src = py_tobytes(argv, &src_size);
+    py_Buffer buf;
+    if(!py_getbuffer(argv, &buf, false)) return false;
+    const void* src = buf.data;
+    int src_size = buf.size;
     int dst_capacity = LZ4_compressBound(src_size);
     char* p = (char*)py_newbytes(py_retval(), sizeof(int) + dst_capacity);
     memcpy(p, &src_size, sizeof(int));
@@ -20,28 +28,386 @@ static bool lz4_compress(int argc, py_Ref argv) {
     return true;
 }
 
+// parse the size header of a block made by `compress`
+static bool
+    lz4__parse_block(py_Ref data, const char** src, int* src_size, int* uncompressed_size) {
+    py_Buffer buf;
+    if(!py_getbuffer(data, &buf, false)) return false;
+    if(buf.size < (int)sizeof(int)) return ValueError("invalid LZ4 data");
+    memcpy(uncompressed_size, buf.data, sizeof(int));
+    if(*uncompressed_size < 0) return ValueError("invalid LZ4 data");
+    *src = (const char*)buf.data + sizeof(int);
+    *src_size = buf.size - sizeof(int);
+    return true;
+}
+
 static bool lz4_decompress(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    PY_CHECK_ARG_TYPE(0, tp_bytes);
-    int total_size;
-    const int* p = (int*)py_tobytes(argv, &total_size);
-    const char* src = (const char*)(p + 1);
-    if(total_size < sizeof(int)) return ValueError("invalid LZ4 data");
-    int uncompressed_size = *p;
-    if(uncompressed_size < 0) return ValueError("invalid LZ4 data");
+    const char* src;
+    int src_size, uncompressed_size;
+    if(!lz4__parse_block(argv, &src, &src_size, &uncompressed_size)) return false;
     char* dst = (char*)py_newbytes(py_retval(), uncompressed_size);
-    int dst_size = LZ4_decompress_safe(src, dst, total_size - sizeof(int), uncompressed_size);
+    int dst_size = LZ4_decompress_safe(src, dst, src_size, uncompressed_size);
     if(dst_size < 0) return ValueError("LZ4 decompression failed");
     assert(dst_size == uncompressed_size);
     return true;
 }
 
+static bool lz4_decompress_into(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    const char* src;
+    int src_size, uncompressed_size;
+    if(!lz4__parse_block(py_arg(0), &src, &src_size, &uncompressed_size)) return false;
+    py_Buffer dst;
+    if(!py_getbuffer(py_arg(1), &dst, true)) return false;
+    if(dst.size < uncompressed_size) {
+        return ValueError("buffer is too small: %d < %d bytes", dst.size, uncompressed_size);
+    }
+    int dst_size = LZ4_decompress_safe(src, dst.data, src_size, uncompressed_size);
+    if(dst_size != uncompressed_size) return ValueError("LZ4 decompression failed");
+    py_newint(py_retval(), dst_size);
+    return true;
+}
+
+/* frame streaming */
+// input is fed to the frame API in slices of this size, so output buffers stay bounded
+#define LZ4_STREAM_CHUNK (64 * 1024)
+#define LZ4_MAX_LEVEL 12
+
+static bool lz4__check(size_t code) {
+    if(!LZ4F_isError(code)) return true;
+    return ValueError("LZ4 frame error: %s", LZ4F_getErrorName(code));
+}
+
+// room for `extra` more bytes, growing geometrically
+static char* lz4__reserve(c11_vector* buf, size_t extra) {
+    int required = buf->length + (int)extra;
+    if(required > buf->capacity) {
+        c11_vector__reserve(buf, c11__max(buf->capacity * 2, required));
+    }
+    return (char*)buf->data + buf->length;
+}
+
+static bool lz4__submit(c11_vector* buf, py_OutRef out) {
+    unsigned char* p = py_newbytes(out, buf->length);
+    if(buf->length > 0) memcpy(p, buf->data, buf->length);
+    c11_vector__dtor(buf);
+    return true;
+}
+
+typedef struct lz4_Compressor {
+    LZ4F_cctx* cctx;
+    LZ4F_CDict* cdict;
+    LZ4F_preferences_t prefs;
+    bool started;  // the frame header is written
+} lz4_Compressor;
+
+static void lz4_Compressor__dtor(void* ud) {
+    lz4_Compressor* self = ud;
+    LZ4F_freeCompressionContext(self->cctx);
+    LZ4F_freeCDict(self->cdict);
+}
+
+static bool lz4_Compressor__begin(lz4_Compressor* self, c11_vector* out) {
+    if(self->started) return true;
+    char* dst = lz4__reserve(out, LZ4F_HEADER_SIZE_MAX);
+    size_t size;
+    if(self->cdict) {
+        size = LZ4F_compressBegin_usingCDict(self->cctx,
+                                             dst,
+                                             LZ4F_HEADER_SIZE_MAX,
+                                             self->cdict,
+                                             &self->prefs);
+    } else {
+        size = LZ4F_compressBegin(self->cctx, dst, LZ4F_HEADER_SIZE_MAX, &self->prefs);
+    }
+    if(!lz4__check(size)) return false;
+    out->length += size;
+    self->started = true;
+    return true;
+}
+
+static bool
+    lz4_Compressor__update(lz4_Compressor* self, const char* src, int size, c11_vector* out) {
+    if(!lz4_Compressor__begin(self, out)) return false;
+    while(size > 0) {
+        int n = size < LZ4_STREAM_CHUNK ? size : LZ4_STREAM_CHUNK;
+        size_t capacity = LZ4F_compressBound(n, &self->prefs);
+        size_t written = LZ4F_compressUpdate(self->cctx,
+                                             lz4__reserve(out, capacity),
+                                             capacity,
+                                             src,
+                                             n,
+                                             NULL);
+        if(!lz4__check(written)) return false;
+        out->length += written;
+        src += n;
+        size -= n;
+    }
+    return true;
+}
+
+// emit the buffered input, and close the frame if `end` is true
+static bool lz4_Compressor__flush(lz4_Compressor* self, bool end, c11_vector* out) {
+    if(!lz4_Compressor__begin(self, out)) return false;
+    size_t capacity = LZ4F_compressBound(0, &self->prefs);
+    char* dst = lz4__reserve(out, capacity);
+    size_t written = end ? LZ4F_compressEnd(self->cctx, dst, capacity, NULL)
+                         : LZ4F_flush(self->cctx, dst, capacity, NULL);
+    if(!lz4__check(written)) return false;
+    out->length += written;
+    // the next update begins a new frame
+    if(end) self->started = false;
+    return true;
+}
+
+static bool lz4__parse_dict(py_Ref dict, const void** data, int* size) {
+    *data = NULL;
+    *size = 0;
+    if(py_isnone(dict)) return true;
+    py_Buffer buf;
+    if(!py_getbuffer(dict, &buf, false)) return false;
+    *data = buf.data;
+    *size = buf.size;
+    return true;
+}
+
+static bool lz4_Compressor__init(lz4_Compressor* self, py_Ref level, py_Ref dict) {
+    if(!py_checkint(level)) return false;
+    py_i64 value = py_toint(level);
+    if(value > LZ4_MAX_LEVEL) return ValueError("level must be at most %d", LZ4_MAX_LEVEL);
+    if(value < -65536) return ValueError("level must be at least -65536");
+    const void* dict_data;
+    int dict_size;
+    if(!lz4__parse_dict(dict, &dict_data, &dict_size)) return false;
+    memset(&self->prefs, 0, sizeof(LZ4F_preferences_t));
+    self->prefs.compressionLevel = (int)value;
+    self->prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+    self->prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    if(LZ4F_isError(LZ4F_createCompressionContext(&self->cctx, LZ4F_VERSION))) {
+        return ValueError("failed to create a LZ4 compression context");
+    }
+    if(dict_data) self->cdict = LZ4F_createCDict(dict_data, dict_size);
+    return true;
+}
+
+static bool lz4_Compressor__new__(int argc, py_Ref argv) {
+    // __new__(cls, level=0, dict=None)
+    lz4_Compressor* self =
+        py_newobject(py_retval(), py_totype(argv), 0, sizeof(lz4_Compressor));
+    memset(self, 0, sizeof(lz4_Compressor));
+    return lz4_Compressor__init(self, py_arg(1), py_arg(2));
+}
+
+static bool lz4_Compressor_update(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    lz4_Compressor* self = py_touserdata(argv);
+    py_Buffer src;
+    if(!py_getbuffer(py_arg(1), &src, false)) return false;
+    c11_vector out;
+    c11_vector__ctor(&out, sizeof(char));
+    if(!lz4_Compressor__update(self, src.data, src.size, &out)) {
+        c11_vector__dtor(&out);
+        return false;
+    }
+    return lz4__submit(&out, py_retval());
+}
+
+static bool lz4_Compressor_flush(int argc, py_Ref argv) {
+    // flush(self, end=True)
+    PY_CHECK_ARG_TYPE(1, tp_bool);
+    lz4_Compressor* self = py_touserdata(argv);
+    c11_vector out;
+    c11_vector__ctor(&out, sizeof(char));
+    if(!lz4_Compressor__flush(self, py_tobool(py_arg(1)), &out)) {
+        c11_vector__dtor(&out);
+        return false;
+    }
+    return lz4__submit(&out, py_retval());
+}
+
+typedef struct lz4_Decompressor {
+    LZ4F_dctx* dctx;
+    char* dict;  // owned copy, the frame API reads it during every call
+    int dict_size;
+    bool eof;  // the last frame is complete
+} lz4_Decompressor;
+
+static void lz4_Decompressor__dtor(void* ud) {
+    lz4_Decompressor* self = ud;
+    LZ4F_freeDecompressionContext(self->dctx);
+    PK_FREE(self->dict);
+}
+
+static bool lz4_Decompressor__init(lz4_Decompressor* self, py_Ref dict) {
+    const void* dict_data;
+    int dict_size;
+    if(!lz4__parse_dict(dict, &dict_data, &dict_size)) return false;
+    if(LZ4F_isError(LZ4F_createDecompressionContext(&self->dctx, LZ4F_VERSION))) {
+        return ValueError("failed to create a LZ4 decompression context");
+    }
+    if(dict_data) {
+        self->dict = PK_MALLOC(dict_size > 0 ? dict_size : 1);
+        memcpy(self->dict, dict_data, dict_size);
+        self->dict_size = dict_size;
+    }
+    return true;
+}
+
+// concatenated frames are decoded one after another
+static bool
+    lz4_Decompressor__update(lz4_Decompressor* self, const char* src, int size, c11_vector* out) {
+    const char* end = src + size;
+    while(true) {
+        size_t dst_size = LZ4_STREAM_CHUNK;
+        size_t src_size = end - src;
+        size_t hint = LZ4F_decompress_usingDict(self->dctx,
+                                                lz4__reserve(out, LZ4_STREAM_CHUNK),
+                                                &dst_size,
+                                                src,
+                                                &src_size,
+                                                self->dict,
+                                                self->dict_size,
+                                                NULL);
+        if(LZ4F_isError(hint)) {
+            LZ4F_resetDecompressionContext(self->dctx);
+            return lz4__check(hint);
+        }
+        src += src_size;
+        out->length += dst_size;
+        if(src_size > 0 || dst_size > 0) self->eof = hint == 0;
+        // stop once the input is used up and no decoded data is left behind
+        if(src == end && dst_size < LZ4_STREAM_CHUNK) break;
+        if(src_size == 0 && dst_size == 0) break;
+    }
+    return true;
+}
+
+static bool lz4_Decompressor__new__(int argc, py_Ref argv) {
+    // __new__(cls, dict=None)
+    lz4_Decompressor* self =
+        py_newobject(py_retval(), py_totype(argv), 0, sizeof(lz4_Decompressor));
+    memset(self, 0, sizeof(lz4_Decompressor));
+    return lz4_Decompressor__init(self, py_arg(1));
+}
+
+static bool lz4_Decompressor_update(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    lz4_Decompressor* self = py_touserdata(argv);
+    py_Buffer src;
+    if(!py_getbuffer(py_arg(1), &src, false)) return false;
+    c11_vector out;
+    c11_vector__ctor(&out, sizeof(char));
+    if(!lz4_Decompressor__update(self, src.data, src.size, &out)) {
+        c11_vector__dtor(&out);
+        return false;
+    }
+    return lz4__submit(&out, py_retval());
+}
+
+static bool lz4_Decompressor_eof(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    lz4_Decompressor* self = py_touserdata(argv);
+    py_newbool(py_retval(), self->eof);
+    return true;
+}
+
+// retval = src.read(LZ4_STREAM_CHUNK), which must export a buffer
+static bool lz4__read(py_Ref src, py_Buffer* out) {
+    py_push(src);
+    if(!py_pushmethod(py_name("read"))) {
+        py_pop();
+        return AttributeError(src, py_name("read"));
+    }
+    py_newint(py_pushtmp(), LZ4_STREAM_CHUNK);
+    if(!py_vectorcall(1, 0)) return false;
+    return py_getbuffer(py_retval(), out, false);
+}
+
+// dst.write(buf), then clear `buf`
+static bool lz4__write(py_Ref dst, c11_vector* buf) {
+    if(buf->length == 0) return true;
+    py_push(dst);
+    if(!py_pushmethod(py_name("write"))) {
+        py_pop();
+        return AttributeError(dst, py_name("write"));
+    }
+    unsigned char* p = py_newbytes(py_pushtmp(), buf->length);
+    memcpy(p, buf->data, buf->length);
+    c11_vector__clear(buf);
+    return py_vectorcall(1, 0);
+}
+
+static bool lz4__pump(py_Ref src, py_Ref dst, void* ctx, bool compress) {
+    c11_vector out;
+    c11_vector__ctor(&out, sizeof(char));
+    bool ok = true;
+    while(ok) {
+        py_Buffer buf;
+        ok = lz4__read(src, &buf);
+        if(!ok) break;
+        const char* data = buf.data;
+        int size = buf.size;
+        if(size == 0) {
+            if(compress) ok = lz4_Compressor__flush(ctx, true, &out) && lz4__write(dst, &out);
+            if(!compress && !((lz4_Decompressor*)ctx)->eof) {
+                ok = ValueError("LZ4 frame is truncated");
+            }
+            break;
+        }
+        ok = compress ? lz4_Compressor__update(ctx, data, size, &out)
+                      : lz4_Decompressor__update(ctx, data, size, &out);
+        if(ok) ok = lz4__write(dst, &out);
+    }
+    c11_vector__dtor(&out);
+    return ok;
+}
+
+static bool lz4_compress_stream(int argc, py_Ref argv) {
+    // compress_stream(src, dst, level=0, dict=None)
+    lz4_Compressor self;
+    memset(&self, 0, sizeof(lz4_Compressor));
+    bool ok = lz4_Compressor__init(&self, py_arg(2), py_arg(3)) &&
+              lz4__pump(py_arg(0), py_arg(1), &self, true);
+    lz4_Compressor__dtor(&self);
+    if(ok) py_newnone(py_retval());
+    return ok;
+}
+
+static bool lz4_decompress_stream(int argc, py_Ref argv) {
+    // decompress_stream(src, dst, dict=None)
+    lz4_Decompressor self;
+    memset(&self, 0, sizeof(lz4_Decompressor));
+    bool ok = lz4_Decompressor__init(&self, py_arg(2)) &&
+              lz4__pump(py_arg(0), py_arg(1), &self, false);
+    lz4_Decompressor__dtor(&self);
+    if(ok) py_newnone(py_retval());
+    return ok;
+}
+
 void pk__add_module_lz4() {
     py_Ref mod = py_newmodule("lz4");
     py_bindfunc(mod, "compress", lz4_compress);
     py_bindfunc(mod, "decompress", lz4_decompress);
+    py_bindfunc(mod, "decompress_into", lz4_decompress_into);
+
+    py_Type type = py_newtype("Compressor", tp_object, mod, lz4_Compressor__dtor);
+    py_bind(py_tpobject(type), "__new__(cls, level=0, dict=None)", lz4_Compressor__new__);
+    py_bindmethod(type, "update", lz4_Compressor_update);
+    py_bind(py_tpobject(type), "flush(self, end=True)", lz4_Compressor_flush);
+
+    type = py_newtype("Decompressor", tp_object, mod, lz4_Decompressor__dtor);
+    py_bind(py_tpobject(type), "__new__(cls, dict=None)", lz4_Decompressor__new__);
+    py_bindmethod(type, "update", lz4_Decompressor_update);
+    py_bindproperty(type, "eof", lz4_Decompressor_eof, NULL);
+
+    py_bind(mod, "compress_stream(src, dst, level=0, dict=None)", lz4_compress_stream);
+    py_bind(mod, "decompress_stream(src, dst, dict=None)", lz4_decompress_stream);
 }
 
+#undef LZ4_STREAM_CHUNK
+#undef LZ4_MAX_LEVEL
+
 #else
 
 void pk__add_module_lz4() {}
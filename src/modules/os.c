@@ -102,9 +102,8 @@ void pk__add_module_os() {
 }
 
 typedef struct {
-    const char* path;
-    const char* mode;
     FILE* file;
+    bool is_binary;  // the mode string is not kept, it may be collected
 } io_FileIO;
 
 static bool io_FileIO__new__(int argc, py_Ref argv) {
@@ -114,12 +113,13 @@ static bool io_FileIO__new__(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(2, tp_str);
     py_Type cls = py_totype(argv);
     io_FileIO* ud = py_newobject(py_retval(), cls, 0, sizeof(io_FileIO));
-    ud->path = py_tostr(py_arg(1));
-    ud->mode = py_tostr(py_arg(2));
-    ud->file = fopen(ud->path, ud->mode);
+    const char* path = py_tostr(py_arg(1));
+    const char* mode = py_tostr(py_arg(2));
+    ud->file = fopen(path, mode);
+    ud->is_binary = strchr(mode, 'b') != NULL;
     if(ud->file == NULL) {
         const char* msg = strerror(errno);
-        return OSError("[Errno %d] %s: '%s'", errno, msg, ud->path);
+        return OSError("[Errno %d] %s: '%s'", errno, msg, path);
     }
     return true;
 }
@@ -141,7 +141,7 @@ static bool io_FileIO__exit__(int argc, py_Ref argv) {
 
 static bool io_FileIO_read(int argc, py_Ref argv) {
     io_FileIO* ud = py_touserdata(py_arg(0));
-    bool is_binary = ud->mode[strlen(ud->mode) - 1] == 'b';
+    bool is_binary = ud->is_binary;
     int size;
     if(argc == 1) {
         long current = ftell(ud->file);
@@ -167,6 +167,16 @@ static bool io_FileIO_read(int argc, py_Ref argv) {
     return true;
 }
 
+static bool io_FileIO_readinto(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    io_FileIO* ud = py_touserdata(py_arg(0));
+    if(!ud->is_binary) return TypeError("readinto() requires a file opened in binary mode");
+    py_Buffer buf;
+    if(!py_getbuffer(py_arg(1), &buf, true)) return false;
+    py_newint(py_retval(), fread(buf.data, 1, buf.size, ud->file));
+    return true;
+}
+
 static bool io_FileIO_tell(int argc, py_Ref argv) {
     io_FileIO* ud = py_touserdata(py_arg(0));
     py_newint(py_retval(), ftell(ud->file));
@@ -199,11 +209,10 @@ static bool io_FileIO_write(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     io_FileIO* ud = py_touserdata(py_arg(0));
     size_t written_size;
-    if(ud->mode[strlen(ud->mode) - 1] == 'b') {
-        PY_CHECK_ARG_TYPE(1, tp_bytes);
-        int filesize;
-        unsigned char* data = py_tobytes(py_arg(1), &filesize);
-        written_size = fwrite(data, 1, filesize, ud->file);
+    if(ud->is_binary) {
+        py_Buffer buf;
+        if(!py_getbuffer(py_arg(1), &buf, false)) return false;
+        written_size = fwrite(buf.data, 1, buf.size, ud->file);
     } else {
         PY_CHECK_ARG_TYPE(1, tp_str);
         c11_sv sv = py_tosv(py_arg(1));
@@ -222,6 +231,7 @@ void pk__add_module_io() {
     py_bindmagic(FileIO, __enter__, io_FileIO__enter__);
     py_bindmagic(FileIO, __exit__, io_FileIO__exit__);
     py_bindmethod(FileIO, "read", io_FileIO_read);
+    py_bindmethod(FileIO, "readinto", io_FileIO_readinto);
     py_bindmethod(FileIO, "write", io_FileIO_write);
     py_bindmethod(FileIO, "close", io_FileIO_close);
     py_bindmethod(FileIO, "tell", io_FileIO_tell);
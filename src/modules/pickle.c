@@ -6,6 +6,7 @@
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/interpreter/vm.h"
 #include "pocketpy/interpreter/array2d.h"
+#include "pocketpy/interpreter/vmath.h"
 #include <stdint.h>
 
 typedef enum {
@@ -26,6 +27,8 @@ typedef enum {
     PKL_VEC2I, PKL_VEC3I,
     PKL_TYPE,
     PKL_ARRAY2D,
+    PKL_ARRAY2D_TYPED,
+    PKL_VEC_ARRAY,
     PKL_TVALUE,
     PKL_CALL,
     PKL_OBJECT,
@@ -325,20 +328,43 @@ static bool pkl__write_object(PickleObject* buf, py_TValue* obj) {
                 return true;
             else {
                 c11_array2d* arr = py_touserdata(obj);
-                for(int i = 0; i < arr->header.numel; i++) {
-                    if(arr->data[i].is_ptr)
-                        return TypeError(
-                            "'array2d' object is not picklable because it contains heap-allocated objects");
-                    buf->used_types[arr->data[i].type] = true;
+                if(arr->dtype != c11_array2d_dtype_object) {
+                    // packed cells hold no references
+                    int size = arr->header.numel * c11_array2d_dtype__itemsize(arr->dtype);
+                    pkl__emit_op(buf, PKL_ARRAY2D_TYPED);
+                    pkl__emit_int(buf, arr->header.n_cols);
+                    pkl__emit_int(buf, arr->header.n_rows);
+                    pkl__emit_int(buf, arr->dtype);
+                    PickleObject__write_bytes(buf, arr->buffer, size);
+                } else {
+                    for(int i = 0; i < arr->header.numel; i++) {
+                        if(arr->data[i].is_ptr)
+                            return TypeError(
+                                "'array2d' object is not picklable because it contains heap-allocated objects");
+                        buf->used_types[arr->data[i].type] = true;
+                    }
+                    pkl__emit_op(buf, PKL_ARRAY2D);
+                    pkl__emit_int(buf, arr->header.n_cols);
+                    pkl__emit_int(buf, arr->header.n_rows);
+                    PickleObject__write_bytes(buf,
+                                              arr->data,
+                                              arr->header.numel * sizeof(py_TValue));
                 }
-                pkl__emit_op(buf, PKL_ARRAY2D);
-                pkl__emit_int(buf, arr->header.n_cols);
-                pkl__emit_int(buf, arr->header.n_rows);
-                PickleObject__write_bytes(buf, arr->data, arr->header.numel * sizeof(py_TValue));
             }
             pkl__store_memo(buf, obj->_obj);
             return true;
         }
+        case tp_vec2_array:
+        case tp_vec3_array: {
+            if(pkl__try_memo(buf, obj->_obj)) return true;
+            c11_vec_array* arr = py_touserdata(obj);
+            pkl__emit_op(buf, PKL_VEC_ARRAY);
+            pkl__emit_int(buf, arr->dim);
+            pkl__emit_int(buf, arr->length);
+            PickleObject__write_bytes(buf, arr->data, arr->length * arr->dim * sizeof(float));
+            pkl__store_memo(buf, obj->_obj);
+            return true;
+        }
         default: {
             if(!obj->is_ptr) {
                 pkl__emit_op(buf, PKL_TVALUE);
@@ -665,6 +691,25 @@ bool py_pickle_loads_body(const unsigned char* p, int memo_length, c11_smallmap_
                 p += total_size;
                 break;
             }
+            case PKL_ARRAY2D_TYPED: {
+                int n_cols = pkl__read_int(&p);
+                int n_rows = pkl__read_int(&p);
+                c11_array2d_dtype dtype = (c11_array2d_dtype)pkl__read_int(&p);
+                c11_array2d* arr = c11_newarray2d_typed(py_pushtmp(), n_cols, n_rows, dtype);
+                int total_size = arr->header.numel * c11_array2d_dtype__itemsize(dtype);
+                memcpy(arr->buffer, p, total_size);
+                p += total_size;
+                break;
+            }
+            case PKL_VEC_ARRAY: {
+                int dim = pkl__read_int(&p);
+                int length = pkl__read_int(&p);
+                c11_vec_array* arr = c11_newvec_array(py_pushtmp(), dim, length);
+                int total_size = length * dim * sizeof(float);
+                memcpy(arr->data, p, total_size);
+                p += total_size;
+                break;
+            }
             case PKL_TVALUE: {
                 py_TValue* tmp = py_pushtmp();
                 memcpy(tmp, p, sizeof(py_TValue));
@@ -5,6 +5,7 @@
 #include "pocketpy/common/utils.h"
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/table.h"
 
 #include "pocketpy/common/threads.h"
 #include <time.h>
@@ -79,6 +80,32 @@ static bool pkpy_currentvm(int argc, py_Ref argv) {
     return true;
 }
 
+static bool pkpy_freeze(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    return py_freeze(argv);
+}
+
+static bool pkpy_isfrozen(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_newbool(py_retval(), py_isfrozen(argv));
+    return true;
+}
+
+static bool pkpy_setfrozen(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    return py_setfrozen(py_tostr(argv), py_arg(1));
+}
+
+static bool pkpy_getfrozen(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    py_GlobalRef res = py_getfrozen(py_tostr(argv));
+    if(res == NULL) return KeyError(argv);
+    py_assign(py_retval(), res);
+    return true;
+}
+
 #if PK_ENABLE_WATCHDOG
 void py_watchdog_begin(py_i64 timeout) {
     WatchdogInfo* info = &pk_current_vm->watchdog_info;
@@ -161,6 +188,63 @@ static void
 
 static bool _pk_compute_thread_flags[16];
 
+// broadcast whenever any ComputeThread finishes a job, so one waiter can select over many threads
+static struct {
+    c11_mtx_t mtx;
+    c11_cnd_t cnd;
+    bool initialized;
+} _pk_compute_thread_sync;
+
+static void c11_ComputeThread__set_done(c11_ComputeThread* self) {
+    c11_mtx_lock(&_pk_compute_thread_sync.mtx);
+    atomic_store(&self->is_done, true);
+    c11_cnd_broadcast(&_pk_compute_thread_sync.cnd);
+    c11_mtx_unlock(&_pk_compute_thread_sync.mtx);
+}
+
+static int64_t c11_ComputeThread__now_ms() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/// Block until one of `threads` is done or `timeout_ms` elapsed (negative means forever).
+/// Return the index of the done thread or -1 on timeout.
+static int c11_ComputeThread__wait_any(c11_ComputeThread** threads, int count, int64_t timeout_ms) {
+    int64_t deadline = timeout_ms < 0 ? -1 : c11_ComputeThread__now_ms() + timeout_ms;
+    int index = -1;
+    c11_mtx_lock(&_pk_compute_thread_sync.mtx);
+    while(true) {
+        for(int i = 0; i < count; i++) {
+            if(atomic_load(&threads[i]->is_done)) {
+                index = i;
+                break;
+            }
+        }
+        if(index != -1) break;
+        int64_t remaining = -1;
+        if(deadline >= 0) {
+            remaining = deadline - c11_ComputeThread__now_ms();
+            if(remaining <= 0) break;
+        }
+        c11_cnd_timedwait(&_pk_compute_thread_sync.cnd, &_pk_compute_thread_sync.mtx, remaining);
+    }
+    c11_mtx_unlock(&_pk_compute_thread_sync.mtx);
+    return index;
+}
+
+static bool c11_ComputeThread__parse_timeout(py_Ref timeout, int64_t* out) {
+    if(py_isnone(timeout)) {
+        *out = -1;
+        return true;
+    }
+    py_f64 seconds;
+    if(!py_castfloat(timeout, &seconds)) return false;
+    if(seconds < 0) return ValueError("timeout must be non-negative");
+    *out = (int64_t)(seconds * 1000);
+    return true;
+}
+
 static void c11_ComputeThread__dtor(c11_ComputeThread* self) {
     if(!atomic_load(&self->is_done)) {
         c11__abort("ComputeThread(%d) is not done yet!! But the object was deleted.",
@@ -225,12 +309,39 @@ static bool ComputeThread_is_done(int argc, py_Ref argv) {
 }
 
 static bool ComputeThread_wait_for_done(int argc, py_Ref argv) {
-    PY_CHECK_ARGC(1);
+    PY_CHECK_ARGC(2);
     c11_ComputeThread* self = py_touserdata(argv);
-    while(!atomic_load(&self->is_done)) {
-        c11_thrd_yield();
+    int64_t timeout_ms = -1;
+    if(!c11_ComputeThread__parse_timeout(py_arg(1), &timeout_ms)) return false;
+    int index = c11_ComputeThread__wait_any(&self, 1, timeout_ms);
+    py_newbool(py_retval(), index == 0);
+    return true;
+}
+
+static bool ComputeThread_wait_any(int argc, py_Ref argv) {
+    if(argc < 1 || argc > 2) return TypeError("wait_any() takes 1 or 2 arguments");
+    py_TValue* p;
+    int count = pk_arrayview(py_arg(0), &p);
+    if(count == -1) return TypeError("wait_any() expects a list or tuple of ComputeThread");
+    if(count == 0) return ValueError("wait_any() arg is an empty sequence");
+    int64_t timeout_ms = -1;
+    if(argc == 2 && !c11_ComputeThread__parse_timeout(py_arg(1), &timeout_ms)) return false;
+    py_Type type = py_gettype("pkpy", py_name("ComputeThread"));
+    c11_ComputeThread** threads = PK_MALLOC(sizeof(c11_ComputeThread*) * count);
+    for(int i = 0; i < count; i++) {
+        if(!py_checktype(&p[i], type)) {
+            PK_FREE(threads);
+            return false;
+        }
+        threads[i] = py_touserdata(&p[i]);
+    }
+    int index = c11_ComputeThread__wait_any(threads, count, timeout_ms);
+    PK_FREE(threads);
+    if(index == -1) {
+        py_newnone(py_retval());
+    } else {
+        py_assign(py_retval(), &p[index]);
     }
-    py_newnone(py_retval());
     return true;
 }
 
@@ -277,14 +388,14 @@ static c11_thrd_retval_t ComputeThreadJob_call(void* arg) {
     unsigned char* retval_data = py_tobytes(py_retval(), &retval_size);
     self->last_retval_data = c11_memdup(retval_data, retval_size);
     self->last_retval_size = retval_size;
-    atomic_store(&self->is_done, true);
+    c11_ComputeThread__set_done(self);
     return (c11_thrd_retval_t)0;
 
 __ERROR:
     self->last_error = py_formatexc();
-    atomic_store(&self->is_done, true);
     py_clearexc(p0);
     py_newnone(py_retval());
+    c11_ComputeThread__set_done(self);
     return (c11_thrd_retval_t)0;
 }
 
@@ -300,13 +411,13 @@ static c11_thrd_retval_t ComputeThreadJob_exec(void* arg) {
     unsigned char* retval_data = py_tobytes(py_retval(), &retval_size);
     self->last_retval_data = c11_memdup(retval_data, retval_size);
     self->last_retval_size = retval_size;
-    atomic_store(&self->is_done, true);
+    c11_ComputeThread__set_done(self);
     return (c11_thrd_retval_t)0;
 
 __ERROR:
     self->last_error = py_formatexc();
-    atomic_store(&self->is_done, true);
     py_clearexc(p0);
+    c11_ComputeThread__set_done(self);
     return (c11_thrd_retval_t)0;
 }
 
@@ -409,14 +520,14 @@ static bool c11_ComputeThread__exec_blocked(c11_ComputeThread* self,
     unsigned char* retval_data = py_tobytes(py_retval(), &retval_size);
     py_switchvm(old_vm_index);
     bool ok = py_pickle_loads(retval_data, retval_size);
-    atomic_store(&self->is_done, true);
+    c11_ComputeThread__set_done(self);
     return ok;
 
 __ERROR:
     err = py_formatexc();
     py_clearexc(p0);
     py_switchvm(old_vm_index);
-    atomic_store(&self->is_done, true);
+    c11_ComputeThread__set_done(self);
     RuntimeError("c11_ComputeThread__exec_blocked() failed:\n%s", err);
     PK_FREE(err);
     return false;
@@ -439,12 +550,20 @@ static bool ComputeThread_eval(int argc, py_Ref argv) {
 }
 
 static void pk_ComputeThread__register(py_Ref mod) {
+    // VM 0 registers this before any ComputeThread can start
+    if(!_pk_compute_thread_sync.initialized) {
+        c11_mtx_init(&_pk_compute_thread_sync.mtx);
+        c11_cnd_init(&_pk_compute_thread_sync.cnd);
+        _pk_compute_thread_sync.initialized = true;
+    }
+
     py_Type type = py_newtype("ComputeThread", tp_object, mod, (py_Dtor)c11_ComputeThread__dtor);
 
     py_bindmagic(type, __new__, ComputeThread__new__);
     py_bindmagic(type, __init__, ComputeThread__init__);
     py_bindproperty(type, "is_done", ComputeThread_is_done, NULL);
-    py_bindmethod(type, "wait_for_done", ComputeThread_wait_for_done);
+    py_bind(py_tpobject(type), "wait_for_done(self, timeout=None)", ComputeThread_wait_for_done);
+    py_bindstaticmethod(type, "wait_any", ComputeThread_wait_any);
     py_bindmethod(type, "last_error", ComputeThread_last_error);
     py_bindmethod(type, "last_retval", ComputeThread_last_retval);
 
@@ -493,6 +612,78 @@ static bool pkpy_profiler_reset(int argc, py_Ref argv) {
     return true;
 }
 
+#if PK_ENABLE_OPCODE_PROFILER
+static bool pkpy_opcodeprofiler_begin(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    py_opcodeprofiler_begin();
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool pkpy_opcodeprofiler_end(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    py_opcodeprofiler_end();
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool pkpy_opcodeprofiler_reset(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    py_opcodeprofiler_reset();
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool pkpy_opcodeprofiler_report(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    c11_vector records;
+    c11_vector__ctor(&records, sizeof(OpcodePairRecord));
+    OpcodeProfiler__get_records(&pk_current_vm->opcode_profiler, &records);
+    py_newlistn(py_retval(), records.length);
+    for(int i = 0; i < records.length; i++) {
+        OpcodePairRecord* it = c11__at(OpcodePairRecord, &records, i);
+        py_Ref p = py_newtuple(py_list_getitem(py_retval(), i), 3);
+        py_newstr(&p[0], pk_opname(it->first));
+        py_newstr(&p[1], pk_opname(it->second));
+        py_newint(&p[2], it->hits);
+    }
+    c11_vector__dtor(&records);
+    return true;
+}
+#endif
+
+static bool pkpy_compilecache_setcapacity(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    py_compilecache_setcapacity(py_toint(argv));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool pkpy_compilecache_stats(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    py_i64 hits, misses;
+    py_compilecache_stats(&hits, &misses);
+    py_Ref p = py_newtuple(py_retval(), 2);
+    py_newint(&p[0], hits);
+    py_newint(&p[1], misses);
+    return true;
+}
+
+static bool pkpy_setoptimizelevel(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    py_setoptimizelevel(py_toint(argv));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool pkpy_getoptimizelevel(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(0);
+    py_newint(py_retval(), py_getoptimizelevel());
+    return true;
+}
+
 static bool pkpy_profiler_report(int argc, py_Ref argv) {
     PY_CHECK_ARGC(0);
     LineProfiler* lp = &pk_current_vm->line_profiler;
@@ -543,6 +734,21 @@ void pk__add_module_pkpy() {
 
     py_bindfunc(mod, "currentvm", pkpy_currentvm);
 
+    py_setdict(mod, py_name("frozendict"), py_tpobject(tp_frozendict));
+    py_bindfunc(mod, "freeze", pkpy_freeze);
+    py_bindfunc(mod, "isfrozen", pkpy_isfrozen);
+    py_bindfunc(mod, "setfrozen", pkpy_setfrozen);
+    py_bindfunc(mod, "getfrozen", pkpy_getfrozen);
+
+    pk_Table__register(mod);
+
+#if PK_ENABLE_OPCODE_PROFILER
+    py_bindfunc(mod, "opcodeprofiler_begin", pkpy_opcodeprofiler_begin);
+    py_bindfunc(mod, "opcodeprofiler_end", pkpy_opcodeprofiler_end);
+    py_bindfunc(mod, "opcodeprofiler_reset", pkpy_opcodeprofiler_reset);
+    py_bindfunc(mod, "opcodeprofiler_report", pkpy_opcodeprofiler_report);
+#endif
+
 #if PK_ENABLE_WATCHDOG
     py_bindfunc(mod, "watchdog_begin", pkpy_watchdog_begin);
     py_bindfunc(mod, "watchdog_end", pkpy_watchdog_end);
@@ -557,12 +763,19 @@ void pk__add_module_pkpy() {
     py_bindfunc(mod, "profiler_reset", pkpy_profiler_reset);
     py_bindfunc(mod, "profiler_report", pkpy_profiler_report);
 
+    py_bindfunc(mod, "compilecache_setcapacity", pkpy_compilecache_setcapacity);
+    py_bindfunc(mod, "compilecache_stats", pkpy_compilecache_stats);
+    py_bindfunc(mod, "setoptimizelevel", pkpy_setoptimizelevel);
+    py_bindfunc(mod, "getoptimizelevel", pkpy_getoptimizelevel);
+
     py_Ref configmacros = py_emplacedict(mod, py_name("configmacros"));
     py_newdict(configmacros);
     pkpy_configmacros_add(configmacros, "PK_ENABLE_OS", PK_ENABLE_OS);
     pkpy_configmacros_add(configmacros, "PK_ENABLE_THREADS", PK_ENABLE_THREADS);
     pkpy_configmacros_add(configmacros, "PK_ENABLE_DETERMINISM", PK_ENABLE_DETERMINISM);
     pkpy_configmacros_add(configmacros, "PK_ENABLE_WATCHDOG", PK_ENABLE_WATCHDOG);
+    pkpy_configmacros_add(configmacros, "PK_ENABLE_OPCODE_PROFILER", PK_ENABLE_OPCODE_PROFILER);
+    pkpy_configmacros_add(configmacros, "PK_ENABLE_SIMD", PK_ENABLE_SIMD);
     pkpy_configmacros_add(configmacros, "PK_GC_MIN_THRESHOLD", PK_GC_MIN_THRESHOLD);
     pkpy_configmacros_add(configmacros, "PK_VM_STACK_SIZE", PK_VM_STACK_SIZE);
 }
@@ -1,4 +1,6 @@
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/array2d.h"
+#include "pocketpy/interpreter/vmath.h"
 #include "pocketpy/pocketpy.h"
 #include <time.h>
 
@@ -119,11 +121,6 @@ static double mt19937__random(mt19937* self) {
     return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
 }
 
-static double mt19937__uniform(mt19937* self, double a, double b) {
-    if(a > b) { return b + mt19937__random(self) * (a - b); }
-    return a + mt19937__random(self) * (b - a);
-}
-
 /* generates a random number on [a, b]-interval */
 int64_t mt19937__randint(mt19937* self, int64_t a, int64_t b) {
     uint64_t delta = b - a + 1;
@@ -134,32 +131,155 @@ int64_t mt19937__randint(mt19937* self, int64_t a, int64_t b) {
     }
 }
 
-static bool Random__new__(int argc, py_Ref argv) {
-    mt19937* ud = py_newobject(py_retval(), py_totype(argv), 0, sizeof(mt19937));
-    mt19937__ctor(ud);
-    return true;
+/* https://prng.di.unimi.it/xoshiro256starstar.c */
+static uint64_t xoshiro256ss__rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+static uint64_t xoshiro256ss__next(uint64_t* s) {
+    uint64_t result = xoshiro256ss__rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = xoshiro256ss__rotl(s[3], 45);
+    return result;
+}
+
+// the state is expanded from a 64-bit seed by splitmix64, so it is never all zero
+static void xoshiro256ss__seed(uint64_t* s, uint64_t seed) {
+    for(int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        s[i] = z ^ (z >> 31);
+    }
+}
+
+typedef enum c11_random_engine {
+    c11_random_engine_mt19937,  // default, keeps the sequences of older versions
+    c11_random_engine_xoshiro256ss,
+} c11_random_engine;
+
+typedef struct c11_random {
+    c11_random_engine engine;
+
+    union {
+        mt19937 mt;
+        uint64_t xoshiro[4];
+    };
+} c11_random;
+
+static const char* c11_random_engine__name(c11_random_engine engine) {
+    return engine == c11_random_engine_mt19937 ? "mt19937" : "xoshiro256**";
 }
 
-static bool Random__init__(int argc, py_Ref argv) {
-    if(argc == 1) {
-        // do nothing
-    } else if(argc == 2) {
-        mt19937* ud = py_touserdata(py_arg(0));
-        if(!py_isnone(&argv[1])) {
-            PY_CHECK_ARG_TYPE(1, tp_int);
-            py_i64 seed = py_toint(py_arg(1));
-            mt19937__seed(ud, (uint32_t)seed);
+static bool c11_random_engine__parse(py_Ref name, c11_random_engine* out) {
+    if(!py_checkstr(name)) return false;
+    for(int i = c11_random_engine_mt19937; i <= c11_random_engine_xoshiro256ss; i++) {
+        if(strcmp(py_tostr(name), c11_random_engine__name(i)) == 0) {
+            *out = i;
+            return true;
         }
+    }
+    return ValueError("unknown random engine: '%s'", py_tostr(name));
+}
+
+static void c11_random__ctor(c11_random* self) {
+    self->engine = c11_random_engine_mt19937;
+    mt19937__ctor(&self->mt);
+}
+
+static void c11_random__seed(c11_random* self, py_i64 seed) {
+    switch(self->engine) {
+        case c11_random_engine_mt19937: mt19937__seed(&self->mt, (uint32_t)seed); return;
+        case c11_random_engine_xoshiro256ss: xoshiro256ss__seed(self->xoshiro, seed); return;
+        default: c11__unreachable();
+    }
+}
+
+static void c11_random__set_engine(c11_random* self, c11_random_engine engine) {
+    if(self->engine == engine) return;
+    self->engine = engine;
+    if(engine == c11_random_engine_mt19937) {
+        mt19937__ctor(&self->mt);
     } else {
-        return TypeError("Random(): expected 1 or 2 arguments, got %d");
+        xoshiro256ss__seed(self->xoshiro, time_ns());
     }
-    py_newnone(py_retval());
+}
+
+static uint32_t c11_random__next_uint32(c11_random* self) {
+    if(self->engine == c11_random_engine_mt19937) return mt19937__next_uint32(&self->mt);
+    // the high bits of xoshiro256** are the strongest
+    return (uint32_t)(xoshiro256ss__next(self->xoshiro) >> 32);
+}
+
+static uint64_t c11_random__next_uint64(c11_random* self) {
+    if(self->engine == c11_random_engine_mt19937) return mt19937__next_uint64(&self->mt);
+    return xoshiro256ss__next(self->xoshiro);
+}
+
+static double c11_random__random(c11_random* self) {
+    if(self->engine == c11_random_engine_mt19937) return mt19937__random(&self->mt);
+    return (xoshiro256ss__next(self->xoshiro) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double c11_random__uniform(c11_random* self, double a, double b) {
+    if(a > b) { return b + c11_random__random(self) * (a - b); }
+    return a + c11_random__random(self) * (b - a);
+}
+
+/* generates a random number on [a, b]-interval */
+static int64_t c11_random__randint(c11_random* self, int64_t a, int64_t b) {
+    if(self->engine == c11_random_engine_mt19937) return mt19937__randint(&self->mt, a, b);
+    uint64_t range = (uint64_t)b - (uint64_t)a;
+    if(range < UINT32_MAX) {
+        // Lemire's multiply-shift, rejecting the few low products that would bias the result
+        uint32_t s = (uint32_t)range + 1;
+        uint64_t m = (uint64_t)c11_random__next_uint32(self) * s;
+        if((uint32_t)m < s) {
+            uint32_t threshold = (uint32_t)(-s) % s;
+            while((uint32_t)m < threshold) {
+                m = (uint64_t)c11_random__next_uint32(self) * s;
+            }
+        }
+        return (int64_t)((uint64_t)a + (m >> 32));
+    }
+    // bitmask rejection, less than 2 draws on average
+    uint64_t mask = range;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+    mask |= mask >> 32;
+    uint64_t x;
+    do {
+        x = c11_random__next_uint64(self) & mask;
+    } while(x > range);
+    return (int64_t)((uint64_t)a + x);
+}
+
+static bool Random__new__(int argc, py_Ref argv) {
+    // __new__(cls, x=None, engine='mt19937')
+    c11_random_engine engine = c11_random_engine_mt19937;
+    if(!c11_random_engine__parse(py_arg(2), &engine)) return false;
+    if(!py_isnone(py_arg(1))) PY_CHECK_ARG_TYPE(1, tp_int);
+    c11_random* ud = py_newobject(py_retval(), py_totype(argv), 0, sizeof(c11_random));
+    c11_random__ctor(ud);
+    c11_random__set_engine(ud, engine);
+    if(!py_isnone(py_arg(1))) c11_random__seed(ud, py_toint(py_arg(1)));
     return true;
 }
 
 static bool Random_seed(int argc, py_Ref argv) {
-    PY_CHECK_ARGC(2);
-    mt19937* ud = py_touserdata(py_arg(0));
+    // seed(self, a=None, engine=None)
+    c11_random* ud = py_touserdata(py_arg(0));
+    if(!py_isnone(py_arg(2))) {
+        c11_random_engine engine = c11_random_engine_mt19937;
+        if(!c11_random_engine__parse(py_arg(2), &engine)) return false;
+        c11_random__set_engine(ud, engine);
+    }
     py_i64 seed;
     if(py_isnone(&argv[1])) {
         seed = time_ns();
@@ -167,26 +287,33 @@ static bool Random_seed(int argc, py_Ref argv) {
         PY_CHECK_ARG_TYPE(1, tp_int);
         seed = py_toint(py_arg(1));
     }
-    mt19937__seed(ud, (uint32_t)seed);
+    c11_random__seed(ud, seed);
     py_newnone(py_retval());
     return true;
 }
 
+static bool Random_engine(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_random* ud = py_touserdata(py_arg(0));
+    py_newstr(py_retval(), c11_random_engine__name(ud->engine));
+    return true;
+}
+
 static bool Random_random(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    mt19937* ud = py_touserdata(py_arg(0));
-    py_f64 res = mt19937__random(ud);
+    c11_random* ud = py_touserdata(py_arg(0));
+    py_f64 res = c11_random__random(ud);
     py_newfloat(py_retval(), res);
     return true;
 }
 
 static bool Random_uniform(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
-    mt19937* ud = py_touserdata(py_arg(0));
+    c11_random* ud = py_touserdata(py_arg(0));
     py_f64 a, b;
     if(!py_castfloat(py_arg(1), &a)) return false;
     if(!py_castfloat(py_arg(2), &b)) return false;
-    py_f64 res = mt19937__uniform(ud, a, b);
+    py_f64 res = c11_random__uniform(ud, a, b);
     py_newfloat(py_retval(), res);
     return true;
 }
@@ -194,11 +321,11 @@ static bool Random_uniform(int argc, py_Ref argv) {
 static bool Random_shuffle(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     PY_CHECK_ARG_TYPE(1, tp_list);
-    mt19937* ud = py_touserdata(py_arg(0));
+    c11_random* ud = py_touserdata(py_arg(0));
     py_Ref L = py_arg(1);
     int length = py_list_len(L);
     for(int i = length - 1; i > 0; i--) {
-        int j = mt19937__randint(ud, 0, i);
+        int j = c11_random__randint(ud, 0, i);
         py_list_swap(L, i, j);
     }
     py_newnone(py_retval());
@@ -209,29 +336,50 @@ static bool Random_randint(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
     PY_CHECK_ARG_TYPE(1, tp_int);
     PY_CHECK_ARG_TYPE(2, tp_int);
-    mt19937* ud = py_touserdata(py_arg(0));
+    c11_random* ud = py_touserdata(py_arg(0));
     py_i64 a = py_toint(py_arg(1));
     py_i64 b = py_toint(py_arg(2));
     if(a > b) return ValueError("randint(a, b): a must be less than or equal to b");
-    py_i64 res = mt19937__randint(ud, a, b);
+    py_i64 res = c11_random__randint(ud, a, b);
     py_newint(py_retval(), res);
     return true;
 }
 
 static bool Random_choice(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
-    mt19937* ud = py_touserdata(py_arg(0));
+    c11_random* ud = py_touserdata(py_arg(0));
     py_TValue* p;
     int length = pk_arrayview(py_arg(1), &p);
     if(length == -1) return TypeError("choice(): argument must be a list or tuple");
     if(length == 0) return IndexError("cannot choose from an empty sequence");
-    int index = mt19937__randint(ud, 0, length - 1);
+    int index = c11_random__randint(ud, 0, length - 1);
     py_assign(py_retval(), p + index);
     return true;
 }
 
+// cum_weights[i] = weights[0] + ... + weights[i], or the running total of `cum_weights`
+static bool Random__cum_weights(py_Ref weights, bool cumulative, int length, py_f64* out) {
+    py_TValue* w;
+    int wlen = pk_arrayview(weights, &w);
+    if(wlen == -1) return TypeError("choices(): weights must be a list or tuple");
+    if(wlen != length) return ValueError("len(weights) != len(population)");
+    py_f64 total = 0;
+    for(int i = 0; i < length; i++) {
+        py_f64 tmp;
+        if(!py_castfloat(&w[i], &tmp)) return false;
+        if(cumulative) {
+            if(i > 0 && tmp < out[i - 1]) return ValueError("cum_weights must be non-decreasing");
+            out[i] = tmp;
+        } else {
+            out[i] = total += tmp;
+        }
+    }
+    return true;
+}
+
 static bool Random_choices(int argc, py_Ref argv) {
-    mt19937* ud = py_touserdata(py_arg(0));
+    // choices(self, population, weights=None, k=1, cum_weights=None)
+    c11_random* ud = py_touserdata(py_arg(0));
     py_TValue* p;
     int length = pk_arrayview(py_arg(1), &p);
     if(length == -1) return TypeError("choices(): argument must be a list or tuple");
@@ -239,34 +387,25 @@ static bool Random_choices(int argc, py_Ref argv) {
     py_Ref weights = py_arg(2);
     if(!py_checktype(py_arg(3), tp_int)) return false;
     py_i64 k = py_toint(py_arg(3));
+    if(k < 0) return ValueError("choices(): k must be non-negative");
+    py_Ref cum_weights_arg = py_arg(4);
+    if(!py_isnone(weights) && !py_isnone(cum_weights_arg)) {
+        return TypeError("choices(): cannot specify both weights and cum_weights");
+    }
 
     py_f64* cum_weights = PK_MALLOC(sizeof(py_f64) * length);
-    if(py_isnone(weights)) {
-        for(int i = 0; i < length; i++)
-            cum_weights[i] = i + 1;
-    } else {
-        py_TValue* w;
-        int wlen = pk_arrayview(weights, &w);
-        if(wlen == -1) {
-            PK_FREE(cum_weights);
-            return TypeError("choices(): weights must be a list or tuple");
-        }
-        if(wlen != length) {
-            PK_FREE(cum_weights);
-            return ValueError("len(weights) != len(population)");
-        }
-        if(!py_castfloat(&w[0], &cum_weights[0])) {
+    if(!py_isnone(weights) || !py_isnone(cum_weights_arg)) {
+        bool cumulative = py_isnone(weights);
+        if(!Random__cum_weights(cumulative ? cum_weights_arg : weights,
+                                cumulative,
+                                length,
+                                cum_weights)) {
             PK_FREE(cum_weights);
             return false;
         }
-        for(int i = 1; i < length; i++) {
-            py_f64 tmp;
-            if(!py_castfloat(&w[i], &tmp)) {
-                PK_FREE(cum_weights);
-                return false;
-            }
-            cum_weights[i] = cum_weights[i - 1] + tmp;
-        }
+    } else {
+        for(int i = 0; i < length; i++)
+            cum_weights[i] = i + 1;
     }
 
     py_f64 total = cum_weights[length - 1];
@@ -277,30 +416,154 @@ static bool Random_choices(int argc, py_Ref argv) {
 
     py_newlistn(py_retval(), k);
     for(int i = 0; i < k; i++) {
-        py_f64 key = mt19937__random(ud) * total;
-        int index;
-        c11__lower_bound(py_f64, cum_weights, length, key, c11__less, &index);
-        assert(index != length);
-        py_list_setitem(py_retval(), i, p + index);
+        py_f64 key = c11_random__random(ud) * total;
+        // the first item whose cumulative weight is above `key`, so zero weights are never chosen
+        int lo = 0, hi = length - 1;
+        while(lo < hi) {
+            int mid = (lo + hi) / 2;
+            if(cum_weights[mid] <= key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        py_list_setitem(py_retval(), i, p + lo);
     }
 
     PK_FREE(cum_weights);
     return true;
 }
 
+static bool Random_floats(int argc, py_Ref argv) {
+    // floats(self, n, a=0.0, b=1.0)
+    c11_random* ud = py_touserdata(py_arg(0));
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    py_i64 n = py_toint(py_arg(1));
+    if(n < 0 || n > INT32_MAX) return ValueError("floats(): invalid n: %i", n);
+    py_f64 a, b;
+    if(!py_castfloat(py_arg(2), &a)) return false;
+    if(!py_castfloat(py_arg(3), &b)) return false;
+    py_newlistn(py_retval(), n);
+    for(int i = 0; i < n; i++) {
+        py_newfloat(py_list_getitem(py_retval(), i), c11_random__uniform(ud, a, b));
+    }
+    return true;
+}
+
+static bool Random_randints(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_int);
+    c11_random* ud = py_touserdata(py_arg(0));
+    py_i64 a = py_toint(py_arg(1));
+    py_i64 b = py_toint(py_arg(2));
+    py_i64 n = py_toint(py_arg(3));
+    if(a > b) return ValueError("randints(a, b, n): a must be less than or equal to b");
+    if(n < 0 || n > INT32_MAX) return ValueError("randints(): invalid n: %i", n);
+    py_newlistn(py_retval(), n);
+    for(int i = 0; i < n; i++) {
+        py_newint(py_list_getitem(py_retval(), i), c11_random__randint(ud, a, b));
+    }
+    return true;
+}
+
+static bool Random_fill(int argc, py_Ref argv) {
+    // fill(self, dst, a=0.0, b=1.0)
+    c11_random* ud = py_touserdata(py_arg(0));
+    py_Ref dst = py_arg(1);
+    // integers in [a, b] if both bounds are int, floats in [a, b) otherwise
+    bool is_int = py_isint(py_arg(2)) && py_isint(py_arg(3));
+    py_f64 fa, fb;
+    py_i64 ia = 0, ib = 0;
+    if(!py_castfloat(py_arg(2), &fa)) return false;
+    if(!py_castfloat(py_arg(3), &fb)) return false;
+    if(is_int) {
+        ia = py_toint(py_arg(2));
+        ib = py_toint(py_arg(3));
+        if(ia > ib) return ValueError("fill(dst, a, b): a must be less than or equal to b");
+    }
+    if(py_istype(dst, tp_vec2_array) || py_istype(dst, tp_vec3_array)) {
+        c11_vec_array* arr = py_touserdata(dst);
+        int n = arr->length * arr->dim;
+        for(int i = 0; i < n; i++) {
+            arr->data[i] = is_int ? (float)c11_random__randint(ud, ia, ib)
+                                  : (float)c11_random__uniform(ud, fa, fb);
+        }
+    } else if(py_istype(dst, tp_array2d)) {
+        c11_array2d* arr = py_touserdata(dst);
+        int n = arr->header.numel;
+        switch(arr->dtype) {
+            case c11_array2d_dtype_float32: {
+                float* p = arr->buffer;
+                for(int i = 0; i < n; i++) {
+                    p[i] = is_int ? (float)c11_random__randint(ud, ia, ib)
+                                  : (float)c11_random__uniform(ud, fa, fb);
+                }
+                break;
+            }
+            case c11_array2d_dtype_float64: {
+                double* p = arr->buffer;
+                for(int i = 0; i < n; i++) {
+                    p[i] = is_int ? (double)c11_random__randint(ud, ia, ib)
+                                  : c11_random__uniform(ud, fa, fb);
+                }
+                break;
+            }
+            default: {
+                // bool, integer and object cells go through the checked conversion
+                py_TValue value;
+                for(int i = 0; i < n; i++) {
+                    if(is_int) {
+                        py_newint(&value, c11_random__randint(ud, ia, ib));
+                    } else {
+                        py_newfloat(&value, c11_random__uniform(ud, fa, fb));
+                    }
+                    if(arr->dtype == c11_array2d_dtype_object) {
+                        arr->data[i] = value;
+                    } else if(!c11_array2d__unbox(arr->dtype, arr->buffer, i, &value)) {
+                        return false;
+                    }
+                }
+                break;
+            }
+        }
+    } else if(py_islist(dst)) {
+        int n = py_list_len(dst);
+        for(int i = 0; i < n; i++) {
+            py_Ref item = py_list_getitem(dst, i);
+            if(is_int) {
+                py_newint(item, c11_random__randint(ud, ia, ib));
+            } else {
+                py_newfloat(item, c11_random__uniform(ud, fa, fb));
+            }
+        }
+    } else {
+        return TypeError("fill(): expected list, array2d, vec2_array or vec3_array, got '%t'",
+                         dst->type);
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
 void pk__add_module_random() {
     py_Ref mod = py_newmodule("random");
     py_Type type = py_newtype("Random", tp_object, mod, NULL);
 
-    py_bindmagic(type, __new__, Random__new__);
-    py_bindmagic(type, __init__, Random__init__);
-    py_bindmethod(type, "seed", Random_seed);
+    py_bind(py_tpobject(type), "__new__(cls, x=None, engine='mt19937')", Random__new__);
+    py_bind(py_tpobject(type), "seed(self, a=None, engine=None)", Random_seed);
+    py_bindproperty(type, "engine", Random_engine, NULL);
     py_bindmethod(type, "random", Random_random);
     py_bindmethod(type, "uniform", Random_uniform);
     py_bindmethod(type, "randint", Random_randint);
     py_bindmethod(type, "shuffle", Random_shuffle);
     py_bindmethod(type, "choice", Random_choice);
-    py_bind(py_tpobject(type), "choices(self, population, weights=None, k=1)", Random_choices);
+    py_bind(py_tpobject(type),
+            "choices(self, population, weights=None, k=1, cum_weights=None)",
+            Random_choices);
+    py_bind(py_tpobject(type), "floats(self, n, a=0.0, b=1.0)", Random_floats);
+    py_bindmethod(type, "randints", Random_randints);
+    py_bind(py_tpobject(type), "fill(self, dst, a=0.0, b=1.0)", Random_fill);
 
     py_Ref inst = py_pushtmp();
     if(!py_tpcall(type, 0, NULL)) goto __ERROR;
@@ -317,6 +580,9 @@ void pk__add_module_random() {
     ADD_INST_BOUNDMETHOD("shuffle");
     ADD_INST_BOUNDMETHOD("choice");
     ADD_INST_BOUNDMETHOD("choices");
+    ADD_INST_BOUNDMETHOD("floats");
+    ADD_INST_BOUNDMETHOD("randints");
+    ADD_INST_BOUNDMETHOD("fill");
 
 #undef ADD_INST_BOUNDMETHOD
 
@@ -338,27 +604,27 @@ __ERROR:
 void py_newRandom(py_OutRef out) {
     py_Type type = py_gettype("random", py_name("Random"));
     assert(type != 0);
-    mt19937* ud = py_newobject(out, type, 0, sizeof(mt19937));
-    mt19937__ctor(ud);
+    c11_random* ud = py_newobject(out, type, 0, sizeof(c11_random));
+    c11_random__ctor(ud);
 }
 
 void py_Random_seed(py_Ref self, py_i64 seed) {
-    mt19937* ud = py_touserdata(self);
-    mt19937__seed(ud, (uint32_t)seed);
+    c11_random* ud = py_touserdata(self);
+    c11_random__seed(ud, seed);
 }
 
 py_f64 py_Random_random(py_Ref self) {
-    mt19937* ud = py_touserdata(self);
-    return mt19937__random(ud);
+    c11_random* ud = py_touserdata(self);
+    return c11_random__random(ud);
 }
 
 py_f64 py_Random_uniform(py_Ref self, py_f64 a, py_f64 b) {
-    mt19937* ud = py_touserdata(self);
-    return mt19937__uniform(ud, a, b);
+    c11_random* ud = py_touserdata(self);
+    return c11_random__uniform(ud, a, b);
 }
 
 py_i64 py_Random_randint(py_Ref self, py_i64 a, py_i64 b) {
-    mt19937* ud = py_touserdata(self);
+    c11_random* ud = py_touserdata(self);
     if(a > b) { c11__abort("randint(a, b): a must be less than or equal to b"); }
-    return mt19937__randint(ud, a, b);
+    return c11_random__randint(ud, a, b);
 }
\ No newline at end of file
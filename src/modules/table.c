@@ -0,0 +1,643 @@
+#include "pocketpy/interpreter/table.h"
+#include "pocketpy/interpreter/types.h"
+#include "pocketpy/interpreter/vmath.h"
+#include "pocketpy/interpreter/vm.h"
+#include "pocketpy/common/sstream.h"
+#include "pocketpy/pocketpy.h"
+
+/* c11_table */
+static int c11_table_column__rowsize(const c11_table_column* col) {
+    return c11_array2d_dtype__itemsize(col->dtype) * col->width;
+}
+
+static const char* c11_table_column__dtype_name(const c11_table_column* col) {
+    return col->width == 2 ? "vec2" : c11_array2d_dtype__name(col->dtype);
+}
+
+// out = data[row]
+static void c11_table_column__box(const c11_table_column* col,
+                                  const void* data,
+                                  int row,
+                                  py_OutRef out) {
+    if(col->width == 2) {
+        const float* p = (const float*)data + row * 2;
+        py_newvec2(out, (c11_vec2){{p[0], p[1]}});
+    } else if(col->dtype == c11_array2d_dtype_object) {
+        *out = ((const py_TValue*)data)[row];
+    } else {
+        c11_array2d__box(col->dtype, data, row, out);
+    }
+}
+
+// data[row] = value, raises if `value` does not fit the column
+static bool
+    c11_table_column__unbox(const c11_table_column* col, void* data, int row, py_Ref value) {
+    if(col->width == 2) {
+        if(!py_checktype(value, tp_vec2)) return false;
+        c11_vec2 v = py_tovec2(value);
+        float* p = (float*)data + row * 2;
+        p[0] = v.x;
+        p[1] = v.y;
+        return true;
+    }
+    if(col->dtype == c11_array2d_dtype_object) {
+        ((py_TValue*)data)[row] = *value;
+        return true;
+    }
+    return c11_array2d__unbox(col->dtype, data, row, value);
+}
+
+static c11_table_column* c11_table__find(c11_table* self, py_Name name) {
+    for(int i = 0; i < self->n_columns; i++) {
+        if(self->columns[i].name == name) return &self->columns[i];
+    }
+    return NULL;
+}
+
+// the column named by the str `name`, raises `KeyError` if not found
+static c11_table_column* c11_table__column(c11_table* self, py_Ref name) {
+    if(!py_checkstr(name)) return NULL;
+    c11_table_column* col = c11_table__find(self, py_namev(py_tosv(name)));
+    if(col == NULL) KeyError(name);
+    return col;
+}
+
+static void c11_table__reserve(c11_table* self, int capacity) {
+    if(capacity <= self->capacity) return;
+    if(capacity < self->capacity * 2) capacity = self->capacity * 2;
+    if(capacity < 8) capacity = 8;
+    for(int i = 0; i < self->n_columns; i++) {
+        c11_table_column* col = &self->columns[i];
+        col->data = PK_REALLOC(col->data, (size_t)capacity * c11_table_column__rowsize(col));
+    }
+    self->capacity = capacity;
+}
+
+// new rows are zero, `False` or `None`
+static void c11_table__resize(c11_table* self, int length) {
+    c11_table__reserve(self, length);
+    for(int i = 0; i < self->n_columns && length > self->length; i++) {
+        c11_table_column* col = &self->columns[i];
+        if(col->dtype == c11_array2d_dtype_object) {
+            py_TValue* p = col->data;
+            for(int j = self->length; j < length; j++) {
+                py_newnone(&p[j]);
+            }
+        } else {
+            int rowsize = c11_table_column__rowsize(col);
+            memset((char*)col->data + (size_t)self->length * rowsize,
+                   0,
+                   (size_t)(length - self->length) * rowsize);
+        }
+    }
+    self->length = length;
+}
+
+void c11_table__dtor(void* ud) {
+    c11_table* self = ud;
+    for(int i = 0; i < self->n_columns; i++) {
+        PK_FREE(self->columns[i].data);
+    }
+    PK_FREE(self->columns);
+}
+
+void c11_table__mark(void* ud, c11_vector* p_stack) {
+    c11_table* self = ud;
+    for(int i = 0; i < self->n_columns; i++) {
+        c11_table_column* col = &self->columns[i];
+        if(col->dtype != c11_array2d_dtype_object) continue;
+        py_TValue* p = col->data;
+        for(int j = 0; j < self->length; j++) {
+            pk__mark_value(&p[j]);
+        }
+    }
+}
+
+// repeat each cell of a width 1 buffer twice, in place
+static void c11_table__widen(void* data, int itemsize, int length) {
+    char* p = data;
+    for(int i = length - 1; i >= 0; i--) {
+        memmove(p + (size_t)(2 * i + 1) * itemsize, p + (size_t)i * itemsize, itemsize);
+        memmove(p + (size_t)(2 * i) * itemsize, p + (size_t)i * itemsize, itemsize);
+    }
+}
+
+// `src` as the cells of the typed column `dst`, a number is broadcasted into `scalar`
+// other operands are converted into `*buffer`, which the caller frees
+static bool c11_table__operand(c11_table* self,
+                               const c11_table_column* dst,
+                               py_Ref src,
+                               c11_array2d_scalar* scalar,
+                               void** buffer) {
+    int n = self->length;
+    int itemsize = c11_array2d_dtype__itemsize(dst->dtype);
+    *buffer = NULL;
+    if(py_isint(src) || py_isfloat(src) || py_isbool(src)) {
+        return c11_array2d__unbox(dst->dtype, scalar, 0, src);
+    }
+    // at least one cell, so that an empty table needs no special case
+    void* p = PK_MALLOC((size_t)(n > 0 ? n : 1) * dst->width * itemsize);
+    *buffer = p;
+    int width = 1;  // cells per row written into `p`
+    if(py_isstr(src)) {
+        c11_table_column* col = c11_table__column(self, src);
+        if(col == NULL) return false;
+        if(col->dtype == c11_array2d_dtype_object) {
+            return TypeError("column '%n' holds objects", col->name);
+        }
+        if(col->width > dst->width) {
+            return TypeError("cannot use a vec2 column for column '%n'", dst->name);
+        }
+        c11_array2d__cast(p, dst->dtype, col->data, col->dtype, n * col->width);
+        width = col->width;
+    } else if(py_istype(src, tp_vec2)) {
+        if(dst->width != 2) return TypeError("expected a number for column '%n'", dst->name);
+        for(int i = 0; i < n; i++) {
+            if(!c11_table_column__unbox(dst, p, i, src)) return false;
+        }
+        width = 2;
+    } else if(py_istype(src, tp_vec2_array)) {
+        c11_vec_array* arr = py_touserdata(src);
+        if(dst->width != 2) return TypeError("expected a number for column '%n'", dst->name);
+        if(arr->length != n) return ValueError("expected %d vectors, got %d", n, arr->length);
+        if(n > 0) memcpy(p, arr->data, sizeof(float) * 2 * n);
+        width = 2;
+    } else if(py_istype(src, tp_array2d)) {
+        c11_array2d* arr = py_touserdata(src);
+        if(arr->header.numel != n) {
+            return ValueError("expected %d cells, got %d", n, arr->header.numel);
+        }
+        if(arr->dtype != c11_array2d_dtype_object) {
+            c11_array2d__cast(p, dst->dtype, arr->buffer, arr->dtype, n);
+        } else {
+            for(int i = 0; i < n; i++) {
+                if(!c11_array2d__unbox(dst->dtype, p, i, &arr->data[i])) return false;
+            }
+        }
+    } else if(py_islist(src) || py_istuple(src)) {
+        int length = py_islist(src) ? py_list_len(src) : py_tuple_len(src);
+        if(length != n) return ValueError("expected %d items, got %d", n, length);
+        for(int i = 0; i < n; i++) {
+            py_Ref item = py_islist(src) ? py_list_getitem(src, i) : py_tuple_getitem(src, i);
+            if(!c11_table_column__unbox(dst, p, i, item)) return false;
+        }
+        width = dst->width;
+    } else {
+        return TypeError("unsupported operand for column '%n': '%t'", dst->name, src->type);
+    }
+    if(width < dst->width) c11_table__widen(p, itemsize, n);
+    return true;
+}
+
+// dst = dst op src * k, `k` may be NULL
+static bool
+    c11_table__apply(c11_table* self, py_Ref name, c11_array2d_op op, py_Ref src, py_Ref k) {
+    c11_table_column* dst = c11_table__column(self, name);
+    if(dst == NULL) return false;
+    if(dst->dtype == c11_array2d_dtype_object ||
+       !c11_array2d__binary(op, dst->dtype, NULL, NULL, NULL, false, 0)) {
+        return TypeError("unsupported operation for column '%n' of '%s'",
+                         dst->name,
+                         c11_table_column__dtype_name(dst));
+    }
+    c11_array2d_scalar factor;
+    if(k != NULL && !c11_array2d__unbox(dst->dtype, &factor, 0, k)) return false;
+    c11_array2d_scalar scalar;
+    void* buffer;
+    if(!c11_table__operand(self, dst, src, &scalar, &buffer)) {
+        PK_FREE(buffer);
+        return false;
+    }
+    int n = self->length * dst->width;
+    if(n == 0) {
+        PK_FREE(buffer);
+        return true;
+    }
+    // the kernels do not allow `out` to alias their inputs
+    void* out = PK_MALLOC((size_t)n * c11_array2d_dtype__itemsize(dst->dtype));
+    if(k != NULL) {
+        if(buffer == NULL) {
+            c11_array2d_scalar scaled;
+            c11_array2d__binary(c11_array2d_op_mul, dst->dtype, &scaled, &scalar, &factor, true, 1);
+            scalar = scaled;
+        } else {
+            c11_array2d__binary(c11_array2d_op_mul, dst->dtype, out, buffer, &factor, true, n);
+            void* tmp = out;
+            out = buffer;
+            buffer = tmp;
+        }
+    }
+    const void* b = buffer ? buffer : (const void*)&scalar;
+    c11_array2d__binary(op, dst->dtype, out, dst->data, b, buffer == NULL, n);
+    memcpy(dst->data, out, (size_t)n * c11_array2d_dtype__itemsize(dst->dtype));
+    PK_FREE(out);
+    PK_FREE(buffer);
+    return true;
+}
+
+static void c11_table__newrow(c11_table* self, py_Ref table, int index, py_OutRef out) {
+    int* ud = py_newobject(out, self->row_type, 1, sizeof(int));
+    *ud = index;
+    py_setslot(out, 0, table);
+}
+
+/* Table */
+static bool Table__add_column(py_Ref key, py_Ref val, void* ctx) {
+    c11_table* self = ctx;
+    if(!py_checkstr(key)) return false;
+    if(!py_checkstr(val)) return false;
+    py_Name name = py_namev(py_tosv(key));
+    if(c11_table__find(self, name)) return ValueError("duplicate column: '%n'", name);
+    c11_table_column col = {.name = name, .width = 1, .data = NULL};
+    const char* dtype = py_tostr(val);
+    if(strcmp(dtype, "vec2") == 0) {
+        col.dtype = c11_array2d_dtype_float32;
+        col.width = 2;
+    } else if(strcmp(dtype, "int") == 0) {
+        col.dtype = c11_array2d_dtype_int32;
+    } else if(strcmp(dtype, "float") == 0) {
+        col.dtype = c11_array2d_dtype_float64;
+    } else if(!c11_array2d_dtype__parse(val, &col.dtype)) {
+        return false;
+    }
+    self->columns[self->n_columns++] = col;
+    return true;
+}
+
+static bool Table__new__(int argc, py_Ref argv) {
+    // __new__(cls, columns, length=0)
+    PY_CHECK_ARG_TYPE(1, tp_dict);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    py_i64 length = py_toint(py_arg(2));
+    if(length < 0 || length > INT32_MAX) return ValueError("invalid length: %i", length);
+    c11_table* self = py_newobject(py_retval(), py_totype(argv), 0, sizeof(c11_table));
+    self->columns = PK_MALLOC(sizeof(c11_table_column) * py_dict_len(py_arg(1)));
+    self->n_columns = 0;
+    self->length = 0;
+    self->capacity = 0;
+    self->row_type = py_gettype("pkpy", py_name("TableRow"));
+    if(!py_dict_apply(py_arg(1), Table__add_column, self)) return false;
+    c11_table__resize(self, (int)length);
+    return true;
+}
+
+static bool Table__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_table* self = py_touserdata(argv);
+    py_newint(py_retval(), self->length);
+    return true;
+}
+
+static bool Table__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_table* self = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "Table({");
+    for(int i = 0; i < self->n_columns; i++) {
+        c11_table_column* col = &self->columns[i];
+        if(i > 0) c11_sbuf__write_cstr(&buf, ", ");
+        pk_sprintf(&buf, "'%n': '%s'", col->name, c11_table_column__dtype_name(col));
+    }
+    pk_sprintf(&buf, "}, length=%d)", self->length);
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool Table_columns(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_table* self = py_touserdata(argv);
+    py_Ref res = py_pushtmp();
+    py_Ref dtype = py_pushtmp();
+    py_newdict(res);
+    for(int i = 0; i < self->n_columns; i++) {
+        c11_table_column* col = &self->columns[i];
+        py_newstr(dtype, c11_table_column__dtype_name(col));
+        if(!py_dict_setitem(res, py_name2ref(col->name), dtype)) return false;
+    }
+    py_assign(py_retval(), res);
+    py_shrink(2);
+    return true;
+}
+
+static bool Table_column(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_table* self = py_touserdata(argv);
+    c11_table_column* col = c11_table__column(self, py_arg(1));
+    if(col == NULL) return false;
+    int n = self->length;
+    if(col->width == 2) {
+        c11_vec_array* res = c11_newvec_array(py_retval(), 2, n);
+        if(n > 0) memcpy(res->data, col->data, sizeof(float) * 2 * n);
+    } else if(col->dtype == c11_array2d_dtype_object) {
+        py_newlistn(py_retval(), n);
+        for(int i = 0; i < n; i++) {
+            py_list_setitem(py_retval(), i, &((py_TValue*)col->data)[i]);
+        }
+    } else {
+        c11_array2d* res = c11_newarray2d_typed(py_retval(), 1, n, col->dtype);
+        if(n > 0) memcpy(res->buffer, col->data, (size_t)n * c11_table_column__rowsize(col));
+    }
+    return true;
+}
+
+static bool Table_set_column(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_table* self = py_touserdata(argv);
+    c11_table_column* col = c11_table__column(self, py_arg(1));
+    if(col == NULL) return false;
+    int n = self->length;
+    py_Ref src = py_arg(2);
+    if(col->dtype == c11_array2d_dtype_object) {
+        py_TValue* p = col->data;
+        if(py_islist(src) || py_istuple(src)) {
+            int length = py_islist(src) ? py_list_len(src) : py_tuple_len(src);
+            if(length != n) return ValueError("expected %d items, got %d", n, length);
+            for(int i = 0; i < n; i++) {
+                p[i] = *(py_islist(src) ? py_list_getitem(src, i) : py_tuple_getitem(src, i));
+            }
+        } else {
+            for(int i = 0; i < n; i++) {
+                p[i] = *src;
+            }
+        }
+        py_newnone(py_retval());
+        return true;
+    }
+    c11_array2d_scalar scalar;
+    void* buffer;
+    if(!c11_table__operand(self, col, src, &scalar, &buffer)) {
+        PK_FREE(buffer);
+        return false;
+    }
+    int itemsize = c11_array2d_dtype__itemsize(col->dtype);
+    if(buffer != NULL) {
+        if(n > 0) memcpy(col->data, buffer, (size_t)n * col->width * itemsize);
+        PK_FREE(buffer);
+    } else {
+        for(int i = 0; i < n * col->width; i++) {
+            memcpy((char*)col->data + (size_t)i * itemsize, &scalar, itemsize);
+        }
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Table__getitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_table* self = py_touserdata(argv);
+    if(py_isint(py_arg(1))) {
+        int index = py_toint(py_arg(1));
+        if(!pk__normalize_index(&index, self->length)) return false;
+        c11_table__newrow(self, argv, index, py_retval());
+        return true;
+    }
+    if(py_isstr(py_arg(1))) return Table_column(argc, argv);
+    if(py_istuple(py_arg(1)) && py_tuple_len(py_arg(1)) == 2) {
+        py_Ref key = py_tuple_getitem(py_arg(1), 0);
+        if(!py_checkint(key)) return false;
+        int index = py_toint(key);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        c11_table_column* col = c11_table__column(self, py_tuple_getitem(py_arg(1), 1));
+        if(col == NULL) return false;
+        c11_table_column__box(col, col->data, index, py_retval());
+        return true;
+    }
+    return TypeError("Table indices must be int, str or (int, str)");
+}
+
+static bool Table__setitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_table* self = py_touserdata(argv);
+    if(py_isstr(py_arg(1))) return Table_set_column(argc, argv);
+    if(py_istuple(py_arg(1)) && py_tuple_len(py_arg(1)) == 2) {
+        py_Ref key = py_tuple_getitem(py_arg(1), 0);
+        if(!py_checkint(key)) return false;
+        int index = py_toint(key);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        c11_table_column* col = c11_table__column(self, py_tuple_getitem(py_arg(1), 1));
+        if(col == NULL) return false;
+        if(!c11_table_column__unbox(col, col->data, index, py_arg(2))) return false;
+        py_newnone(py_retval());
+        return true;
+    }
+    return TypeError("Table indices must be str or (int, str)");
+}
+
+static bool Table__iter__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_Type type = py_gettype("pkpy", py_name("table_iterator"));
+    int* ud = py_newobject(py_retval(), type, 1, sizeof(int));
+    *ud = 0;
+    py_setslot(py_retval(), 0, argv);
+    return true;
+}
+
+static bool table_iterator__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    int* ud = py_touserdata(argv);
+    py_Ref table = py_getslot(argv, 0);
+    c11_table* self = py_touserdata(table);
+    if(*ud >= self->length) return StopIteration();
+    c11_table__newrow(self, table, (*ud)++, py_retval());
+    return true;
+}
+
+static bool Table__set_row(py_Ref key, py_Ref val, void* ctx) {
+    c11_table* self = ((void**)ctx)[0];
+    int index = *(int*)((void**)ctx)[1];
+    c11_table_column* col = c11_table__column(self, key);
+    if(col == NULL) return false;
+    return c11_table_column__unbox(col, col->data, index, val);
+}
+
+static bool Table_append(int argc, py_Ref argv) {
+    // append(self, **fields)
+    c11_table* self = py_touserdata(argv);
+    if(self->length == INT32_MAX) return ValueError("Table is full");
+    int index = self->length;
+    c11_table__resize(self, index + 1);
+    void* ctx[2] = {self, &index};
+    if(!py_dict_apply(py_arg(1), Table__set_row, ctx)) {
+        self->length = index;
+        return false;
+    }
+    py_newint(py_retval(), index);
+    return true;
+}
+
+static bool Table_resize(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    c11_table* self = py_touserdata(argv);
+    py_i64 length = py_toint(py_arg(1));
+    if(length < 0 || length > INT32_MAX) return ValueError("invalid length: %i", length);
+    c11_table__resize(self, (int)length);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Table_clear(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_table* self = py_touserdata(argv);
+    self->length = 0;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Table_swap_remove(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    c11_table* self = py_touserdata(argv);
+    int index = py_toint(py_arg(1));
+    if(!pk__normalize_index(&index, self->length)) return false;
+    int last = self->length - 1;
+    for(int i = 0; i < self->n_columns && index != last; i++) {
+        c11_table_column* col = &self->columns[i];
+        int rowsize = c11_table_column__rowsize(col);
+        memcpy((char*)col->data + (size_t)index * rowsize,
+               (char*)col->data + (size_t)last * rowsize,
+               rowsize);
+    }
+    self->length = last;
+    py_newnone(py_retval());
+    return true;
+}
+
+#define DEF_TABLE_BINARY(name, op)                                                                 \
+    static bool Table_##name(int argc, py_Ref argv) {                                              \
+        PY_CHECK_ARGC(3);                                                                          \
+        c11_table* self = py_touserdata(argv);                                                     \
+        if(!c11_table__apply(self, py_arg(1), op, py_arg(2), NULL)) return false;                  \
+        py_newnone(py_retval());                                                                   \
+        return true;                                                                               \
+    }
+
+DEF_TABLE_BINARY(add_, c11_array2d_op_add)
+DEF_TABLE_BINARY(sub_, c11_array2d_op_sub)
+DEF_TABLE_BINARY(mul_, c11_array2d_op_mul)
+DEF_TABLE_BINARY(truediv_, c11_array2d_op_truediv)
+
+#undef DEF_TABLE_BINARY
+
+static bool Table_add_scaled_(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(4);
+    c11_table* self = py_touserdata(argv);
+    if(!c11_table__apply(self, py_arg(1), c11_array2d_op_add, py_arg(2), py_arg(3))) {
+        return false;
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+/* TableRow */
+// the column named `name` and the row index, NULL if there is no such column
+static c11_table_column* TableRow__resolve(py_Ref self, py_Name name, int* index) {
+    c11_table* table = py_touserdata(py_getslot(self, 0));
+    *index = *(int*)py_touserdata(self);
+    return c11_table__find(table, name);
+}
+
+static bool TableRow__check(py_Ref self, int index) {
+    c11_table* table = py_touserdata(py_getslot(self, 0));
+    if(index < table->length) return true;
+    return IndexError("row %d is out of range, the table has %d rows", index, table->length);
+}
+
+static bool TableRow__getattribute(py_Ref self, py_Name name) {
+    int index;
+    c11_table_column* col = TableRow__resolve(self, name, &index);
+    if(col != NULL) {
+        if(!TableRow__check(self, index)) return false;
+        c11_table_column__box(col, col->data, index, py_retval());
+        return true;
+    }
+    py_Ref cls_var = py_tpfindname(self->type, name);
+    if(cls_var == NULL) return AttributeError(self, name);
+    if(py_istype(cls_var, tp_property)) return py_call(py_getslot(cls_var, 0), 1, self);
+    if(py_istype(cls_var, tp_nativefunc) || py_istype(cls_var, tp_function)) {
+        py_newboundmethod(py_retval(), self, cls_var);
+        return true;
+    }
+    py_assign(py_retval(), cls_var);
+    return true;
+}
+
+static bool TableRow__setattribute(py_Ref self, py_Name name, py_Ref val) {
+    int index;
+    c11_table_column* col = TableRow__resolve(self, name, &index);
+    if(col == NULL) return AttributeError(self, name);
+    if(!TableRow__check(self, index)) return false;
+    return c11_table_column__unbox(col, col->data, index, val);
+}
+
+static bool TableRow_index(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_newint(py_retval(), *(int*)py_touserdata(argv));
+    return true;
+}
+
+static bool TableRow_table(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_assign(py_retval(), py_getslot(argv, 0));
+    return true;
+}
+
+static bool TableRow__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_table* table = py_touserdata(py_getslot(argv, 0));
+    int index = *(int*)py_touserdata(argv);
+    if(!TableRow__check(argv, index)) return false;
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "TableRow(");
+    for(int i = 0; i < table->n_columns; i++) {
+        c11_table_column* col = &table->columns[i];
+        py_TValue value;
+        c11_table_column__box(col, col->data, index, &value);
+        if(!py_repr(&value)) {
+            c11_sbuf__dtor(&buf);
+            return false;
+        }
+        if(i > 0) c11_sbuf__write_cstr(&buf, ", ");
+        pk_sprintf(&buf, "%n=%v", col->name, py_tosv(py_retval()));
+    }
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+void pk_Table__register(py_Ref mod) {
+    py_Type type = py_newtype("Table", tp_object, mod, c11_table__dtor);
+    py_tpsetfinal(type);
+    py_bind(py_tpobject(type), "__new__(cls, columns, length=0)", Table__new__);
+    py_bindmagic(type, __len__, Table__len__);
+    py_bindmagic(type, __repr__, Table__repr__);
+    py_bindmagic(type, __getitem__, Table__getitem__);
+    py_bindmagic(type, __setitem__, Table__setitem__);
+    py_bindmagic(type, __iter__, Table__iter__);
+    py_bindproperty(type, "columns", Table_columns, NULL);
+    py_bind(py_tpobject(type), "append(self, **fields)", Table_append);
+    py_bindmethod(type, "resize", Table_resize);
+    py_bindmethod(type, "clear", Table_clear);
+    py_bindmethod(type, "swap_remove", Table_swap_remove);
+    py_bindmethod(type, "column", Table_column);
+    py_bindmethod(type, "set_column", Table_set_column);
+    py_bindmethod(type, "add_", Table_add_);
+    py_bindmethod(type, "sub_", Table_sub_);
+    py_bindmethod(type, "mul_", Table_mul_);
+    py_bindmethod(type, "truediv_", Table_truediv_);
+    py_bindmethod(type, "add_scaled_", Table_add_scaled_);
+    py_setdict(py_tpobject(type), __hash__, py_None());
+
+    type = py_newtype("TableRow", tp_object, mod, NULL);
+    py_tpsetfinal(type);
+    py_tphookattributes(type, TableRow__getattribute, TableRow__setattribute, NULL, NULL);
+    py_bindmagic(type, __repr__, TableRow__repr__);
+    py_bindproperty(type, "index", TableRow_index, NULL);
+    py_bindproperty(type, "table", TableRow_table, NULL);
+
+    type = py_newtype("table_iterator", tp_object, mod, NULL);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, table_iterator__next__);
+}
@@ -4,6 +4,8 @@
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/common/utils.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/vmath.h"
+#include "pocketpy/interpreter/array2d.h"
 #include <math.h>
 
 static bool isclose(float a, float b) { return fabs(a - b) < 1e-4; }
@@ -364,22 +366,12 @@ static bool vec2_angle_STATIC(int argc, py_Ref argv) {
     return true;
 }
 
-static bool vec2_smoothdamp_STATIC(int argc, py_Ref argv) {
-    PY_CHECK_ARGC(6);
-    PY_CHECK_ARG_TYPE(0, tp_vec2);  // current: vec2
-    PY_CHECK_ARG_TYPE(1, tp_vec2);  // target: vec2
-    PY_CHECK_ARG_TYPE(2, tp_vec2);  // current_velocity: vec2
-
-    float smoothTime;
-    if(!py_castfloat32(&argv[3], &smoothTime)) return false;
-    float maxSpeed;
-    if(!py_castfloat32(&argv[4], &maxSpeed)) return false;
-    float deltaTime;
-    if(!py_castfloat32(&argv[5], &deltaTime)) return false;
-    c11_vec2 current = argv[0]._vec2;
-    c11_vec2 target = argv[1]._vec2;
-    c11_vec2 currentVelocity = argv[2]._vec2;
-
+static c11_vec2 c11_vec2__smooth_damp(c11_vec2 current,
+                                      c11_vec2 target,
+                                      c11_vec2* currentVelocity,
+                                      float smoothTime,
+                                      float maxSpeed,
+                                      float deltaTime) {
     // https://github.com/Unity-Technologies/UnityCsReference/blob/master/Runtime/Export/Math/Vector2.cs#L289
     // Based on Game Programming Gems 4 Chapter 1.10
     smoothTime = c11__max(0.0001F, smoothTime);
@@ -406,11 +398,11 @@ static bool vec2_smoothdamp_STATIC(int argc, py_Ref argv) {
     target.x = current.x - change_x;
     target.y = current.y - change_y;
 
-    float temp_x = (currentVelocity.x + omega * change_x) * deltaTime;
-    float temp_y = (currentVelocity.y + omega * change_y) * deltaTime;
+    float temp_x = (currentVelocity->x + omega * change_x) * deltaTime;
+    float temp_y = (currentVelocity->y + omega * change_y) * deltaTime;
 
-    currentVelocity.x = (currentVelocity.x - omega * temp_x) * exp;
-    currentVelocity.y = (currentVelocity.y - omega * temp_y) * exp;
+    currentVelocity->x = (currentVelocity->x - omega * temp_x) * exp;
+    currentVelocity->y = (currentVelocity->y - omega * temp_y) * exp;
 
     float output_x = target.x + (change_x + temp_x) * exp;
     float output_y = target.y + (change_y + temp_y) * exp;
@@ -425,16 +417,37 @@ static bool vec2_smoothdamp_STATIC(int argc, py_Ref argv) {
         output_x = originalTo.x;
         output_y = originalTo.y;
 
-        currentVelocity.x = (output_x - originalTo.x) / deltaTime;
-        currentVelocity.y = (output_y - originalTo.y) / deltaTime;
+        currentVelocity->x = (output_x - originalTo.x) / deltaTime;
+        currentVelocity->y = (output_y - originalTo.y) / deltaTime;
     }
+    return (c11_vec2){
+        {output_x, output_y}
+    };
+}
+
+static bool vec2_smoothdamp_STATIC(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(6);
+    PY_CHECK_ARG_TYPE(0, tp_vec2);  // current: vec2
+    PY_CHECK_ARG_TYPE(1, tp_vec2);  // target: vec2
+    PY_CHECK_ARG_TYPE(2, tp_vec2);  // current_velocity: vec2
+
+    float smoothTime;
+    if(!py_castfloat32(&argv[3], &smoothTime)) return false;
+    float maxSpeed;
+    if(!py_castfloat32(&argv[4], &maxSpeed)) return false;
+    float deltaTime;
+    if(!py_castfloat32(&argv[5], &deltaTime)) return false;
+    c11_vec2 currentVelocity = argv[2]._vec2;
+    c11_vec2 output = c11_vec2__smooth_damp(argv[0]._vec2,
+                                            argv[1]._vec2,
+                                            &currentVelocity,
+                                            smoothTime,
+                                            maxSpeed,
+                                            deltaTime);
 
     py_Ref ret = py_retval();
     py_Ref p = py_newtuple(ret, 2);
-    py_newvec2(&p[0],
-               (c11_vec2){
-                   {output_x, output_y}
-    });
+    py_newvec2(&p[0], output);
     py_newvec2(&p[1], currentVelocity);
     return true;
 }
@@ -1094,6 +1107,572 @@ static bool color32_alpha_blend_STATIC(int argc, py_Ref argv) {
     return true;
 }
 
+/* vec2_array, vec3_array */
+c11_vec_array* c11_newvec_array(py_OutRef out, int dim, int length) {
+    assert(dim == 2 || dim == 3);
+    int size = length * dim * (int)sizeof(float);
+    py_Type type = dim == 2 ? tp_vec2_array : tp_vec3_array;
+    c11_vec_array* ud = py_newobject(out, type, 0, sizeof(c11_vec_array) + size);
+    ud->dim = dim;
+    ud->length = length;
+    // packed right after the userdata
+    ud->data = (float*)(ud + 1);
+    memset(ud->data, 0, size);
+    return ud;
+}
+
+static bool c11_vec_array__check_length(py_i64 length, int dim) {
+    if(length < 0) return ValueError("length must be non-negative");
+    if(length > INT32_MAX / (dim * (int)sizeof(float))) return ValueError("length is too large");
+    return true;
+}
+
+static py_Type c11_vec_array__type(int dim) { return dim == 2 ? tp_vec2_array : tp_vec3_array; }
+
+static py_Type c11_vec_array__item_type(int dim) { return dim == 2 ? tp_vec2 : tp_vec3; }
+
+static void c11_vec_array__box(py_OutRef out, int dim, const float* p) {
+    if(dim == 2) {
+        py_newvec2(out, (c11_vec2){{p[0], p[1]}});
+    } else {
+        py_newvec3(out, (c11_vec3){{p[0], p[1], p[2]}});
+    }
+}
+
+// the floats of a `vec2` or `vec3` matching `dim`, or NULL
+static const float* c11_vec_array__unbox(py_Ref value, int dim) {
+    if(dim == 2 && value->type == tp_vec2) return value->_vec2.data;
+    if(dim == 3 && value->type == tp_vec3) return value->_vec3.data;
+    return NULL;
+}
+
+// `other` as vectors to combine with `self`, `*step` is 0 if a single vector is broadcast
+// returns 1 on success, 0 if `other` is not a vector operand and -1 if an error was raised
+static int c11_vec_array__operand(c11_vec_array* self, py_Ref other, const float** p, int* step) {
+    const float* v = c11_vec_array__unbox(other, self->dim);
+    if(v != NULL) {
+        *p = v;
+        *step = 0;
+        return 1;
+    }
+    if(other->type != c11_vec_array__type(self->dim)) return 0;
+    c11_vec_array* rhs = py_touserdata(other);
+    if(rhs->length != self->length) {
+        ValueError("length mismatch: %d != %d", self->length, rhs->length);
+        return -1;
+    }
+    *p = rhs->data;
+    *step = self->dim;
+    return 1;
+}
+
+typedef enum c11_vec_array_op {
+    c11_vec_array_op_add,
+    c11_vec_array_op_sub,
+    c11_vec_array_op_mul,
+    c11_vec_array_op_div,
+} c11_vec_array_op;
+
+// out = a op b over `n` floats, `b` repeats every `b_size` floats
+// `out` may alias `a`, the flat loops are left to the compiler to vectorize
+static void c11_vec_array__binary(c11_vec_array_op op,
+                                  float* out,
+                                  const float* a,
+                                  const float* b,
+                                  int b_size,
+                                  int n) {
+#define LOOP(expr)                                                                                 \
+    if(b_size == n) {                                                                              \
+        for(int i = 0; i < n; i++) {                                                               \
+            float x = a[i], y = b[i];                                                              \
+            out[i] = expr;                                                                         \
+        }                                                                                          \
+    } else if(b_size == 1) {                                                                       \
+        float y = b[0];                                                                            \
+        for(int i = 0; i < n; i++) {                                                               \
+            float x = a[i];                                                                        \
+            out[i] = expr;                                                                         \
+        }                                                                                          \
+    } else {                                                                                       \
+        for(int i = 0; i < n; i += b_size) {                                                       \
+            for(int k = 0; k < b_size; k++) {                                                      \
+                float x = a[i + k], y = b[k];                                                      \
+                out[i + k] = expr;                                                                 \
+            }                                                                                      \
+        }                                                                                          \
+    }
+    switch(op) {
+        case c11_vec_array_op_add: LOOP(x + y); break;
+        case c11_vec_array_op_sub: LOOP(x - y); break;
+        case c11_vec_array_op_mul: LOOP(x * y); break;
+        case c11_vec_array_op_div: LOOP(x / y); break;
+    }
+#undef LOOP
+}
+
+// self op other into `out`, vectors are combined componentwise and numbers scale every vector
+// returns 1 on success, 0 if `other` is not supported and -1 if an error was raised
+static int c11_vec_array__apply(c11_vec_array_op op, py_Ref self, py_Ref other, py_OutRef out) {
+    c11_vec_array* lhs = py_touserdata(self);
+    int n = lhs->length * lhs->dim;
+    const float* b;
+    int b_size;
+    float scalar;
+    bool is_number = other->type == tp_int || other->type == tp_float;
+    if(is_number && (op == c11_vec_array_op_mul || op == c11_vec_array_op_div)) {
+        py_castfloat32(other, &scalar);
+        b = &scalar;
+        b_size = 1;
+    } else {
+        int step;
+        int code = c11_vec_array__operand(lhs, other, &b, &step);
+        if(code <= 0) return code;
+        b_size = step == 0 ? lhs->dim : n;
+    }
+    float* dst = lhs->data;
+    if(out != NULL) {
+        // `self` and `other` are still reachable from the arguments
+        dst = c11_newvec_array(out, lhs->dim, lhs->length)->data;
+    }
+    if(n > 0) c11_vec_array__binary(op, dst, lhs->data, b, b_size, n);
+    return 1;
+}
+
+#define DEF_VEC_ARRAY_BINARY(name, op)                                                             \
+    static bool vec_array__##name##__(int argc, py_Ref argv) {                                     \
+        PY_CHECK_ARGC(2);                                                                          \
+        int code = c11_vec_array__apply(op, &argv[0], &argv[1], py_retval());                      \
+        if(code < 0) return false;                                                                 \
+        if(code == 0) py_newnotimplemented(py_retval());                                           \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec_array_##name##_(int argc, py_Ref argv) {                                       \
+        PY_CHECK_ARGC(2);                                                                          \
+        int code = c11_vec_array__apply(op, &argv[0], &argv[1], NULL);                             \
+        if(code < 0) return false;                                                                 \
+        if(code == 0) return TypeError("unsupported operand type '%t'", argv[1].type);             \
+        py_newnone(py_retval());                                                                   \
+        return true;                                                                               \
+    }
+
+DEF_VEC_ARRAY_BINARY(add, c11_vec_array_op_add)
+DEF_VEC_ARRAY_BINARY(sub, c11_vec_array_op_sub)
+DEF_VEC_ARRAY_BINARY(mul, c11_vec_array_op_mul)
+DEF_VEC_ARRAY_BINARY(truediv, c11_vec_array_op_div)
+
+#undef DEF_VEC_ARRAY_BINARY
+
+static bool vec_array__new__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    py_Type cls = py_totype(&argv[0]);
+    int dim = cls == tp_vec2_array ? 2 : 3;
+    py_Ref data = &argv[1];
+    if(py_isint(data)) {
+        py_i64 length = py_toint(data);
+        if(!c11_vec_array__check_length(length, dim)) return false;
+        c11_newvec_array(py_retval(), dim, (int)length);
+        return true;
+    }
+    int length;
+    py_Ref items;
+    if(py_islist(data)) {
+        length = py_list_len(data);
+        items = py_list_data(data);
+    } else if(py_istuple(data)) {
+        length = py_tuple_len(data);
+        items = py_tuple_data(data);
+    } else {
+        return TypeError("expected int, list or tuple, got '%t'", data->type);
+    }
+    if(!c11_vec_array__check_length(length, dim)) return false;
+    c11_vec_array* self = c11_newvec_array(py_retval(), dim, length);
+    for(int i = 0; i < length; i++) {
+        const float* v = c11_vec_array__unbox(&items[i], dim);
+        if(v == NULL) {
+            py_Type expected = c11_vec_array__item_type(dim);
+            return TypeError("expected '%t', got '%t'", expected, items[i].type);
+        }
+        memcpy(self->data + i * dim, v, dim * sizeof(float));
+    }
+    return true;
+}
+
+static bool vec_array__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    py_newint(py_retval(), self->length);
+    return true;
+}
+
+static bool vec_array__getbuffer(py_Ref self, py_Buffer* out) {
+    c11_vec_array* ud = py_touserdata(self);
+    out->data = ud->data;
+    out->size = ud->length * ud->dim * (int)sizeof(float);
+    out->itemsize = sizeof(float);
+    out->format = 'f';
+    out->readonly = false;
+    return true;
+}
+
+static bool vec_array__index(c11_vec_array* self, py_Ref index, int* out) {
+    if(!py_checkint(index)) return false;
+    py_i64 i = py_toint(index);
+    if(i < 0) i += self->length;
+    if(i < 0 || i >= self->length) return IndexError("vector index out of range");
+    *out = (int)i;
+    return true;
+}
+
+static bool vec_array__getitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vec_array* self = py_touserdata(argv);
+    int i = 0;
+    if(!vec_array__index(self, &argv[1], &i)) return false;
+    c11_vec_array__box(py_retval(), self->dim, self->data + i * self->dim);
+    return true;
+}
+
+static bool vec_array__setitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_vec_array* self = py_touserdata(argv);
+    int i = 0;
+    if(!vec_array__index(self, &argv[1], &i)) return false;
+    const float* v = c11_vec_array__unbox(&argv[2], self->dim);
+    if(v == NULL) {
+        py_Type expected = c11_vec_array__item_type(self->dim);
+        return TypeError("expected '%t', got '%t'", expected, argv[2].type);
+    }
+    memcpy(self->data + i * self->dim, v, self->dim * sizeof(float));
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool vec_array_tolist(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    py_newlistn(py_retval(), self->length);
+    for(int i = 0; i < self->length; i++) {
+        c11_vec_array__box(py_list_getitem(py_retval(), i), self->dim, self->data + i * self->dim);
+    }
+    return true;
+}
+
+static bool vec_array__iter__(int argc, py_Ref argv) {
+    if(!vec_array_tolist(argc, argv)) return false;
+    py_push(py_retval());
+    bool ok = py_iter(py_peek(-1));
+    if(!ok) return false;
+    py_pop();
+    return true;
+}
+
+static bool vec_array__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    pk_sprintf(&buf, "%t([", argv->type);
+    for(int i = 0; i < self->length; i++) {
+        if(i > 0) c11_sbuf__write_cstr(&buf, ", ");
+        const float* p = self->data + i * self->dim;
+        char item[128];
+        int size;
+        if(self->dim == 2) {
+            size = snprintf(item, 128, "vec2(%.4f, %.4f)", p[0], p[1]);
+        } else {
+            size = snprintf(item, 128, "vec3(%.4f, %.4f, %.4f)", p[0], p[1], p[2]);
+        }
+        c11_sbuf__write_cstrn(&buf, item, size);
+    }
+    c11_sbuf__write_cstr(&buf, "])");
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool vec_array__eq__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(argv[1].type != argv[0].type) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    c11_vec_array* lhs = py_touserdata(&argv[0]);
+    c11_vec_array* rhs = py_touserdata(&argv[1]);
+    bool ok = lhs->length == rhs->length;
+    for(int i = 0; ok && i < lhs->length * lhs->dim; i++) {
+        if(!isclose(lhs->data[i], rhs->data[i])) ok = false;
+    }
+    py_newbool(py_retval(), ok);
+    return true;
+}
+
+DEFINE_BOOL_NE(vec_array, vec_array__eq__)
+
+static bool vec_array_copy(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    c11_vec_array* res = c11_newvec_array(py_retval(), self->dim, self->length);
+    memcpy(res->data, self->data, self->length * self->dim * sizeof(float));
+    return true;
+}
+
+// a column of one float per vector
+static float* c11_vec_array__newcolumn(py_OutRef out, int length) {
+    c11_array2d* res = c11_newarray2d_typed(out, 1, length, c11_array2d_dtype_float32);
+    return res->buffer;
+}
+
+static bool vec_array_dot(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vec_array* self = py_touserdata(argv);
+    const float* b;
+    int step;
+    int code = c11_vec_array__operand(self, &argv[1], &b, &step);
+    if(code < 0) return false;
+    if(code == 0) return TypeError("unsupported operand type '%t'", argv[1].type);
+    int dim = self->dim;
+    const float* a = self->data;
+    float* out = c11_vec_array__newcolumn(py_retval(), self->length);
+    if(dim == 2) {
+        for(int i = 0; i < self->length; i++) {
+            const float* v = b + i * step;
+            out[i] = a[i * 2] * v[0] + a[i * 2 + 1] * v[1];
+        }
+    } else {
+        for(int i = 0; i < self->length; i++) {
+            const float* v = b + i * step;
+            out[i] = a[i * 3] * v[0] + a[i * 3 + 1] * v[1] + a[i * 3 + 2] * v[2];
+        }
+    }
+    return true;
+}
+
+static void c11_vec_array__length_squared(const c11_vec_array* self, float* out) {
+    const float* a = self->data;
+    if(self->dim == 2) {
+        for(int i = 0; i < self->length; i++) {
+            out[i] = a[i * 2] * a[i * 2] + a[i * 2 + 1] * a[i * 2 + 1];
+        }
+    } else {
+        for(int i = 0; i < self->length; i++) {
+            const float* v = a + i * 3;
+            out[i] = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+        }
+    }
+}
+
+static bool vec_array_length_squared(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    float* out = c11_vec_array__newcolumn(py_retval(), self->length);
+    c11_vec_array__length_squared(self, out);
+    return true;
+}
+
+static bool vec_array_length(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    float* out = c11_vec_array__newcolumn(py_retval(), self->length);
+    c11_vec_array__length_squared(self, out);
+    for(int i = 0; i < self->length; i++) {
+        out[i] = sqrtf(out[i]);
+    }
+    return true;
+}
+
+// zero vectors, where `vec2.normalize` raises, are left as they are
+static void c11_vec_array__normalize(const c11_vec_array* self, float* out) {
+    int dim = self->dim;
+    for(int i = 0; i < self->length; i++) {
+        const float* v = self->data + i * dim;
+        float len = 0;
+        for(int k = 0; k < dim; k++) {
+            len += v[k] * v[k];
+        }
+        float inv = isclose(len, 0) ? 1.0f : 1.0f / sqrtf(len);
+        for(int k = 0; k < dim; k++) {
+            out[i * dim + k] = v[k] * inv;
+        }
+    }
+}
+
+static bool vec_array_normalize(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    c11_vec_array* res = c11_newvec_array(py_retval(), self->dim, self->length);
+    c11_vec_array__normalize(self, res->data);
+    return true;
+}
+
+static bool vec_array_normalize_(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    c11_vec_array__normalize(self, self->data);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool vec_array_lerp(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_vec_array* self = py_touserdata(argv);
+    const float* b;
+    int step;
+    int code = c11_vec_array__operand(self, &argv[1], &b, &step);
+    if(code < 0) return false;
+    if(code == 0) return TypeError("unsupported operand type '%t'", argv[1].type);
+    float t;
+    if(!py_castfloat32(&argv[2], &t)) return false;
+    int dim = self->dim;
+    c11_vec_array* res = c11_newvec_array(py_retval(), dim, self->length);
+    for(int i = 0; i < self->length; i++) {
+        const float* v = b + i * step;
+        for(int k = 0; k < dim; k++) {
+            float x = self->data[i * dim + k];
+            res->data[i * dim + k] = x + (v[k] - x) * t;
+        }
+    }
+    return true;
+}
+
+static bool vec_array_to_array2d(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vec_array* self = py_touserdata(argv);
+    c11_array2d* res =
+        c11_newarray2d_typed(py_retval(), self->dim, self->length, c11_array2d_dtype_float32);
+    memcpy(res->buffer, self->data, self->length * self->dim * sizeof(float));
+    return true;
+}
+
+static bool c11_vec_array__from_array2d(int argc, py_Ref argv, int dim) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_array2d);
+    c11_array2d* a = py_touserdata(argv);
+    if(a->header.n_cols != dim) {
+        return ValueError("expected an array2d of width %d, got %d", dim, a->header.n_cols);
+    }
+    if(!c11_vec_array__check_length(a->header.n_rows, dim)) return false;
+    c11_vec_array* res = c11_newvec_array(py_retval(), dim, a->header.n_rows);
+    if(a->dtype != c11_array2d_dtype_object) {
+        c11_array2d__cast(res->data,
+                          c11_array2d_dtype_float32,
+                          a->buffer,
+                          a->dtype,
+                          a->header.numel);
+        return true;
+    }
+    for(int i = 0; i < a->header.numel; i++) {
+        if(!py_castfloat32(&a->data[i], &res->data[i])) return false;
+    }
+    return true;
+}
+
+static bool vec2_array_from_array2d_STATIC(int argc, py_Ref argv) {
+    return c11_vec_array__from_array2d(argc, argv, 2);
+}
+
+static bool vec3_array_from_array2d_STATIC(int argc, py_Ref argv) {
+    return c11_vec_array__from_array2d(argc, argv, 3);
+}
+
+// smooth_damp(current, target, current_velocity, smooth_time, max_speed, delta_time)
+static bool vec2_array_smoothdamp_STATIC(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(6);
+    PY_CHECK_ARG_TYPE(0, tp_vec2_array);  // current: vec2_array
+    PY_CHECK_ARG_TYPE(2, tp_vec2_array);  // current_velocity: vec2_array
+    c11_vec_array* current = py_touserdata(&argv[0]);
+    c11_vec_array* velocity = py_touserdata(&argv[2]);
+    const float* target;
+    int step;
+    int code = c11_vec_array__operand(current, &argv[1], &target, &step);
+    if(code < 0) return false;
+    if(code == 0) return TypeError("expected 'vec2' or 'vec2_array', got '%t'", argv[1].type);
+    if(velocity->length != current->length) {
+        return ValueError("length mismatch: %d != %d", current->length, velocity->length);
+    }
+    float smoothTime;
+    if(!py_castfloat32(&argv[3], &smoothTime)) return false;
+    float maxSpeed;
+    if(!py_castfloat32(&argv[4], &maxSpeed)) return false;
+    float deltaTime;
+    if(!py_castfloat32(&argv[5], &deltaTime)) return false;
+
+    int n = current->length;
+    py_Ref p = py_newtuple(py_pushtmp(), 2);
+    c11_vec_array* output = c11_newvec_array(&p[0], 2, n);
+    c11_vec_array* new_velocity = c11_newvec_array(&p[1], 2, n);
+    for(int i = 0; i < n; i++) {
+        c11_vec2 cur = {{current->data[i * 2], current->data[i * 2 + 1]}};
+        c11_vec2 dst = {{target[i * step], target[i * step + 1]}};
+        c11_vec2 vel = {{velocity->data[i * 2], velocity->data[i * 2 + 1]}};
+        c11_vec2 res = c11_vec2__smooth_damp(cur,
+                                             dst,
+                                             &vel,
+                                             smoothTime,
+                                             maxSpeed,
+                                             deltaTime);
+        output->data[i * 2] = res.x;
+        output->data[i * 2 + 1] = res.y;
+        new_velocity->data[i * 2] = vel.x;
+        new_velocity->data[i * 2 + 1] = vel.y;
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+static bool mat3x3__transform(int argc, py_Ref argv, float w) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_vec2_array);
+    c11_mat3x3 m = *py_tomat3x3(&argv[0]);
+    c11_vec_array* points = py_touserdata(&argv[1]);
+    c11_vec_array* res = c11_newvec_array(py_retval(), 2, points->length);
+    const float* src = points->data;
+    float* dst = res->data;
+    float tx = m._13 * w, ty = m._23 * w;
+    for(int i = 0; i < points->length; i++) {
+        float x = src[i * 2], y = src[i * 2 + 1];
+        dst[i * 2] = m._11 * x + m._12 * y + tx;
+        dst[i * 2 + 1] = m._21 * x + m._22 * y + ty;
+    }
+    return true;
+}
+
+static bool mat3x3_transform_points(int argc, py_Ref argv) {
+    return mat3x3__transform(argc, argv, 1.0f);
+}
+
+static bool mat3x3_transform_vectors(int argc, py_Ref argv) {
+    return mat3x3__transform(argc, argv, 0.0f);
+}
+
+static void register_vec_array(py_Type type) {
+    py_bindmagic(type, __new__, vec_array__new__);
+    py_bindmagic(type, __len__, vec_array__len__);
+    py_bindmagic(type, __getitem__, vec_array__getitem__);
+    py_bindmagic(type, __setitem__, vec_array__setitem__);
+    py_bindmagic(type, __iter__, vec_array__iter__);
+    py_bindmagic(type, __repr__, vec_array__repr__);
+    py_bindmagic(type, __eq__, vec_array__eq__);
+    py_bindmagic(type, __ne__, vec_array__ne__);
+    py_bindmagic(type, __add__, vec_array__add__);
+    py_bindmagic(type, __sub__, vec_array__sub__);
+    py_bindmagic(type, __mul__, vec_array__mul__);
+    py_bindmagic(type, __truediv__, vec_array__truediv__);
+    py_bindmethod(type, "add_", vec_array_add_);
+    py_bindmethod(type, "sub_", vec_array_sub_);
+    py_bindmethod(type, "mul_", vec_array_mul_);
+    py_bindmethod(type, "truediv_", vec_array_truediv_);
+    py_bindmethod(type, "dot", vec_array_dot);
+    py_bindmethod(type, "length", vec_array_length);
+    py_bindmethod(type, "length_squared", vec_array_length_squared);
+    py_bindmethod(type, "normalize", vec_array_normalize);
+    py_bindmethod(type, "normalize_", vec_array_normalize_);
+    py_bindmethod(type, "lerp", vec_array_lerp);
+    py_bindmethod(type, "copy", vec_array_copy);
+    py_bindmethod(type, "tolist", vec_array_tolist);
+    py_bindmethod(type, "to_array2d", vec_array_to_array2d);
+    py_tphookbuffer(type, vec_array__getbuffer);
+}
+
 void pk__add_module_vmath() {
     py_Ref mod = py_newmodule("vmath");
 
@@ -1103,6 +1682,8 @@ void pk__add_module_vmath() {
     py_Type vec3i = pk_newtype("vec3i", tp_object, mod, NULL, false, true);
     py_Type mat3x3 = pk_newtype("mat3x3", tp_object, mod, NULL, false, true);
     py_Type color32 = pk_newtype("color32", tp_object, mod, NULL, false, true);
+    py_Type vec2_array = pk_newtype("vec2_array", tp_object, mod, NULL, false, true);
+    py_Type vec3_array = pk_newtype("vec3_array", tp_object, mod, NULL, false, true);
 
     py_setdict(mod, py_name("vec2"), py_tpobject(vec2));
     py_setdict(mod, py_name("vec3"), py_tpobject(vec3));
@@ -1110,6 +1691,8 @@ void pk__add_module_vmath() {
     py_setdict(mod, py_name("vec3i"), py_tpobject(vec3i));
     py_setdict(mod, py_name("mat3x3"), py_tpobject(mat3x3));
     py_setdict(mod, py_name("color32"), py_tpobject(color32));
+    py_setdict(mod, py_name("vec2_array"), py_tpobject(vec2_array));
+    py_setdict(mod, py_name("vec3_array"), py_tpobject(vec3_array));
 
     assert(vec2 == tp_vec2);
     assert(vec3 == tp_vec3);
@@ -1117,6 +1700,8 @@ void pk__add_module_vmath() {
     assert(vec3i == tp_vec3i);
     assert(mat3x3 == tp_mat3x3);
     assert(color32 == tp_color32);
+    assert(vec2_array == tp_vec2_array);
+    assert(vec3_array == tp_vec3_array);
 
     /* vec2 */
     py_bindmagic(vec2, __new__, vec2__new__);
@@ -1175,6 +1760,8 @@ void pk__add_module_vmath() {
     py_bindmethod(mat3x3, "s", mat3x3_s);
     py_bindmethod(mat3x3, "transform_point", mat3x3_transform_point);
     py_bindmethod(mat3x3, "transform_vector", mat3x3_transform_vector);
+    py_bindmethod(mat3x3, "transform_points", mat3x3_transform_points);
+    py_bindmethod(mat3x3, "transform_vectors", mat3x3_transform_vectors);
 
     /* vec2i */
     py_bindmagic(vec2i, __new__, vec2i__new__);
@@ -1284,6 +1871,13 @@ void pk__add_module_vmath() {
     py_bindfunc(mod, "rgb", vmath_rgb);
     py_bindfunc(mod, "rgba", vmath_rgba);
     py_bindstaticmethod(color32, "alpha_blend", color32_alpha_blend_STATIC);
+
+    /* vec2_array, vec3_array */
+    register_vec_array(vec2_array);
+    register_vec_array(vec3_array);
+    py_bindstaticmethod(vec2_array, "from_array2d", vec2_array_from_array2d_STATIC);
+    py_bindstaticmethod(vec3_array, "from_array2d", vec3_array_from_array2d_STATIC);
+    py_bindstaticmethod(vec2_array, "smooth_damp", vec2_array_smoothdamp_STATIC);
 }
 
 #undef DEFINE_VEC_FIELD
@@ -2,6 +2,7 @@
 #include "pocketpy/common/utils.h"
 #include "pocketpy/pocketpy.h"
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
 void Bytecode__set_signed_arg(Bytecode* self, int arg) {
@@ -14,7 +15,8 @@ void Bytecode__set_signed_arg(Bytecode* self, int arg) {
 bool Bytecode__is_forward_jump(const Bytecode* self) {
     Opcode op = self->op;
     return (op >= OP_JUMP_FORWARD && op <= OP_LOOP_BREAK) ||
-           (op == OP_FOR_ITER || op == OP_FOR_ITER_YIELD_VALUE);
+           (op == OP_FOR_ITER || op == OP_FOR_ITER_YIELD_VALUE) ||
+           (op >= OP_COMPARE_LT_JUMP_IF_FALSE && op <= OP_COMPARE_GE_JUMP_IF_FALSE);
 }
 
 static void FuncDecl__dtor(FuncDecl* self) {
@@ -123,6 +125,12 @@ void CodeObject__ctor(CodeObject* self, SourceData_ src, c11_sv name) {
     c11_vector__ctor(&self->codes, sizeof(Bytecode));
     c11_vector__ctor(&self->codes_ex, sizeof(BytecodeEx));
 
+    c11_vector__ctor(&self->units, sizeof(CodeUnit));
+    c11_vector__ctor(&self->linetable, sizeof(uint8_t));
+    c11_vector__ctor(&self->block_ranges, sizeof(CodeBlockRange));
+    c11_vector__ctor(&self->exc_table, sizeof(CodeExceptionEntry));
+    memset(&self->line_cursor, 0, sizeof(CodeLineCursor));
+
     c11_vector__ctor(&self->consts, sizeof(py_TValue));
     c11_vector__ctor(&self->varnames, sizeof(py_Name));
     c11_vector__ctor(&self->names, sizeof(py_Name));
@@ -133,11 +141,12 @@ void CodeObject__ctor(CodeObject* self, SourceData_ src, c11_sv name) {
 
     c11_vector__ctor(&self->blocks, sizeof(CodeBlock));
     c11_vector__ctor(&self->func_decls, sizeof(FuncDecl_));
+    c11_vector__ctor(&self->fstrings, sizeof(FStringLayout));
 
     self->start_line = -1;
     self->end_line = -1;
 
-    CodeBlock root_block = {CodeBlockType_NO_BLOCK, -1, 0, -1, -1};
+    CodeBlock root_block = {CodeBlockType_NO_BLOCK, -1, 0, -1, -1, 0};
     c11_vector__push(CodeBlock, &self->blocks, root_block);
 }
 
@@ -148,6 +157,11 @@ void CodeObject__dtor(CodeObject* self) {
     c11_vector__dtor(&self->codes);
     c11_vector__dtor(&self->codes_ex);
 
+    c11_vector__dtor(&self->units);
+    c11_vector__dtor(&self->linetable);
+    c11_vector__dtor(&self->block_ranges);
+    c11_vector__dtor(&self->exc_table);
+
     c11_vector__dtor(&self->consts);
     c11_vector__dtor(&self->varnames);
     c11_vector__dtor(&self->names);
@@ -162,6 +176,199 @@ void CodeObject__dtor(CodeObject* self) {
         PK_DECREF(decl);
     }
     c11_vector__dtor(&self->func_decls);
+
+    c11__foreach(FStringLayout, &self->fstrings, layout) PK_FREE(layout->specs);
+    c11_vector__dtor(&self->fstrings);
+}
+
+static void c11_vector__push_varint(c11_vector* self, uint32_t value) {
+    while(value >= 0x80) {
+        c11_vector__push(uint8_t, self, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    c11_vector__push(uint8_t, self, (uint8_t)value);
+}
+
+static uint32_t CodeObject__read_varint(const CodeObject* self, int* offset) {
+    const uint8_t* p = self->linetable.data;
+    uint32_t value = 0;
+    int shift = 0;
+    while(true) {
+        uint8_t byte = p[(*offset)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if(byte < 0x80) return value;
+        shift += 7;
+    }
+}
+
+static void CodeObject__build_exc_table(CodeObject* self) {
+    const CodeBlockRange* ranges = self->block_ranges.data;
+    for(int i = 0; i < self->block_ranges.length; i++) {
+        // find the innermost try block
+        int itry = ranges[i].iblock;
+        while(itry >= 0) {
+            CodeBlock* block = c11__at(CodeBlock, &self->blocks, itry);
+            if(block->type == CodeBlockType_TRY) break;
+            itry = block->parent;
+        }
+        if(itry < 0) continue;
+        CodeBlock* try_block = c11__at(CodeBlock, &self->blocks, itry);
+        int depth = try_block->depth;
+        int start = ranges[i].start;
+        int end = i + 1 < self->block_ranges.length ? ranges[i + 1].start : self->units.length;
+        if(start == end) continue;
+        c11_vector* table = &self->exc_table;
+        if(table->length > 0) {
+            CodeExceptionEntry* last = &c11_vector__back(CodeExceptionEntry, table);
+            if(last->end == start && last->handler == try_block->end && last->depth == depth) {
+                last->end = end;
+                continue;
+            }
+        }
+        CodeExceptionEntry entry = {start, end, try_block->end, depth};
+        c11_vector__push(CodeExceptionEntry, table, entry);
+    }
+}
+
+void CodeObject__finalize(CodeObject* self) {
+    int n = self->codes.length;
+    Bytecode* codes = self->codes.data;
+    BytecodeEx* codes_ex = self->codes_ex.data;
+    // `sizes[i]` is the number of units of `codes[i]`
+    // `starts[i]` is the first unit of `codes[i]`, `starts[n]` is the total number of units
+    int* sizes = PK_MALLOC(sizeof(int) * n);
+    int* starts = PK_MALLOC(sizeof(int) * (n + 1));
+    for(int i = 0; i < n; i++) {
+        bool is_jump = Bytecode__is_forward_jump(&codes[i]);
+        sizes[i] = !is_jump && codes[i].arg > 0xFF ? 2 : 1;
+    }
+    // jump offsets depend on the sizes, which only grow, so this converges
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        starts[0] = 0;
+        for(int i = 0; i < n; i++) {
+            starts[i + 1] = starts[i] + sizes[i];
+        }
+        for(int i = 0; i < n; i++) {
+            if(sizes[i] == 2 || !Bytecode__is_forward_jump(&codes[i])) continue;
+            int target = i + (int16_t)codes[i].arg;
+            int offset = starts[target] - (starts[i + 1] - 1);
+            if(offset < 0 || offset > 0xFF) {
+                sizes[i] = 2;
+                changed = true;
+            }
+        }
+    }
+    // emit units
+    c11_vector__reserve(&self->units, starts[n]);
+    for(int i = 0; i < n; i++) {
+        uint16_t arg = codes[i].arg;
+        if(Bytecode__is_forward_jump(&codes[i])) {
+            int target = i + (int16_t)codes[i].arg;
+            Bytecode tmp = codes[i];
+            Bytecode__set_signed_arg(&tmp, starts[target] - (starts[i + 1] - 1));
+            arg = tmp.arg;
+        }
+        if(sizes[i] == 2) {
+            CodeUnit ext = {OP_EXTENDED_ARG, (uint8_t)(arg >> 8)};
+            c11_vector__push(CodeUnit, &self->units, ext);
+        }
+        CodeUnit unit = {codes[i].op, (uint8_t)arg};
+        c11_vector__push(CodeUnit, &self->units, unit);
+    }
+    // line table and block ranges
+    int prev_unit = 0;
+    int prev_lineno = 0;
+    for(int i = 0; i < n; i++) {
+        int lineno = codes_ex[i].lineno;
+        if(i == 0 || lineno != prev_lineno) {
+            int delta = lineno - prev_lineno;
+            c11_vector__push_varint(&self->linetable, starts[i] - prev_unit);
+            c11_vector__push_varint(&self->linetable, ((uint32_t)delta << 1) ^ (delta >> 31));
+            prev_unit = starts[i];
+            prev_lineno = lineno;
+        }
+        int iblock = codes_ex[i].iblock;
+        c11_vector* ranges = &self->block_ranges;
+        if(ranges->length == 0 || c11_vector__back(CodeBlockRange, ranges).iblock != iblock) {
+            CodeBlockRange range = {starts[i], iblock};
+            c11_vector__push(CodeBlockRange, &self->block_ranges, range);
+        }
+    }
+    c11__foreach(CodeBlock, &self->blocks, block) {
+        if(block->start != -1) block->start = starts[block->start];
+        if(block->end != -1) block->end = starts[block->end];
+        if(block->end2 != -1) block->end2 = starts[block->end2];
+    }
+    CodeObject__build_exc_table(self);
+    PK_FREE(sizes);
+    PK_FREE(starts);
+    c11_vector__dtor(&self->codes);
+    c11_vector__dtor(&self->codes_ex);
+}
+
+int CodeObject__decode(const CodeObject* self, int ip, Bytecode* out) {
+    const CodeUnit* units = self->units.data;
+    uint16_t arg = 0;
+    while(units[ip].op == OP_EXTENDED_ARG) {
+        arg = (arg << 8) | units[ip].arg;
+        ip++;
+    }
+    out->op = units[ip].op;
+    out->arg = (arg << 8) | units[ip].arg;
+    return ip;
+}
+
+int CodeObject__lineno(const CodeObject* self, int ip) {
+    // the cursor is a cache and does not change the observable state
+    CodeLineCursor* cursor = (CodeLineCursor*)&self->line_cursor;
+    if(cursor->offset == 0 || ip < cursor->unit) {
+        cursor->offset = 0;
+        cursor->unit = 0;
+        cursor->lineno = 0;
+    }
+    while(cursor->offset < self->linetable.length) {
+        int offset = cursor->offset;
+        int unit = cursor->unit + CodeObject__read_varint(self, &offset);
+        if(unit > ip) break;
+        uint32_t zigzag = CodeObject__read_varint(self, &offset);
+        cursor->lineno += (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+        cursor->unit = unit;
+        cursor->offset = offset;
+    }
+    return cursor->lineno;
+}
+
+int CodeObject__iblock(const CodeObject* self, int ip) {
+    const CodeBlockRange* ranges = self->block_ranges.data;
+    int lo = 0, hi = self->block_ranges.length - 1;
+    // find the last range whose start <= ip
+    while(lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if(ranges[mid].start <= ip) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return ranges[lo].iblock;
+}
+
+const CodeExceptionEntry* CodeObject__exception_entry(const CodeObject* self, int ip) {
+    const CodeExceptionEntry* table = self->exc_table.data;
+    int lo = 0, hi = self->exc_table.length;
+    // find the first entry whose end > ip
+    while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if(table[mid].end <= ip) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if(lo == self->exc_table.length || table[lo].start > ip) return NULL;
+    return &table[lo];
 }
 
 void Function__ctor(Function* self, FuncDecl_ decl, py_GlobalRef module, py_Ref globals) {
@@ -169,6 +376,11 @@ void Function__ctor(Function* self, FuncDecl_ decl, py_GlobalRef module, py_Ref
     self->decl = decl;
     self->module = module;
     self->globals = globals;
+    // a dict passed to `exec()` lives on the stack, so keep the value instead
+    if(globals && globals->type == tp_dict) {
+        self->globals_dict = *globals;
+        self->globals = &self->globals_dict;
+    }
     self->closure = NULL;
     self->clazz = NULL;
     self->cfunc = NULL;
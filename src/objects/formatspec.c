@@ -0,0 +1,75 @@
+#include "pocketpy/objects/formatspec.h"
+
+#include <string.h>
+
+static bool FormatSpec__parse_int(c11_sv text, int* out) {
+    int64_t value;
+    if(c11__parse_uint(text, &value, 10) != IntParsing_SUCCESS) return false;
+    if(value > 0x7fffffff) return false;
+    *out = (int)value;
+    return true;
+}
+
+void FormatSpec__parse(FormatSpec* self, c11_sv spec) {
+    self->error = NULL;
+    self->conversion = 0;
+    self->fill = ' ';
+    self->align = 0;
+    self->type = 0;
+    self->width = -1;
+    self->precision = -1;
+
+    if(spec.size > 0 && spec.data[0] == '!') {
+        if(spec.size >= 2 && spec.data[1] == 'r') {
+            self->conversion = 'r';
+            spec = c11_sv__slice(spec, 2);
+        } else {
+            self->error = "invalid conversion specifier (only !r is supported)";
+            return;
+        }
+    }
+
+    if(spec.size > 0 && spec.data[0] == ':') spec = c11_sv__slice(spec, 1);
+    if(spec.size == 0) return;
+
+    switch(spec.data[spec.size - 1]) {
+        case 'f':
+        case 'd':
+        case 's':
+            self->type = spec.data[spec.size - 1];
+            spec.size--;
+            break;
+        default: break;
+    }
+
+    if(spec.size > 0 && strchr("0-=*#@!~", spec.data[0])) {
+        self->fill = spec.data[0];
+        spec = c11_sv__slice(spec, 1);
+    }
+
+    if(spec.size > 0 && strchr("^><", spec.data[0])) {
+        self->align = spec.data[0];
+        spec = c11_sv__slice(spec, 1);
+    }
+
+    int dot = c11_sv__index(spec, '.');
+    c11_sv width = dot >= 0 ? c11_sv__slice2(spec, 0, dot) : spec;
+    if(width.size > 0 && !FormatSpec__parse_int(width, &self->width)) {
+        self->error = "invalid format specifier";
+        return;
+    }
+    if(dot >= 0) {
+        if(!FormatSpec__parse_int(c11_sv__slice(spec, dot + 1), &self->precision)) {
+            self->error = "invalid format specifier";
+            return;
+        }
+        if(self->type != 'f') {
+            self->error = "precision not allowed in the format specifier";
+            return;
+        }
+    }
+}
+
+bool FormatSpec__is_plain(const FormatSpec* self) {
+    return self->error == NULL && self->conversion == 0 && self->type == 0 && self->width == -1;
+}
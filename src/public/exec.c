@@ -19,10 +19,10 @@ bool _py_compile(CodeObject* out,
                  bool is_dynamic) {
     VM* vm = pk_current_vm;
     SourceData_ src = SourceData__rcnew(source, filename, mode, is_dynamic);
-    Error* err = pk_compile(src, out);
+    Error* err = pk_compile(src, vm->optimize_level, out);
     if(err) {
         py_exception(tp_SyntaxError, err->msg);
-        py_BaseException__stpush(NULL, &vm->curr_exception, err->src, err->lineno, NULL);
+        py_BaseException__stpush(NULL, &vm->curr_exception, err->src, err->lineno);
         PK_DECREF(src);
 
         PK_DECREF(err->src);
@@ -33,45 +33,79 @@ bool _py_compile(CodeObject* out,
     return true;
 }
 
+static bool pk_compile_cached(py_OutRef out,
+                              const char* source,
+                              const char* filename,
+                              enum py_CompileMode mode,
+                              bool is_dynamic) {
+    CompileCache* cache = &pk_current_vm->compile_cache;
+    py_Ref cached = CompileCache__get(cache, source, filename, mode, is_dynamic);
+    if(cached) {
+        *out = *cached;
+        return true;
+    }
+    CodeObject co;
+    if(!_py_compile(&co, source, filename, mode, is_dynamic)) return false;
+    CodeObject* ud = py_newobject(out, tp_code, 0, sizeof(CodeObject));
+    *ud = co;
+    CompileCache__put(cache, source, filename, mode, is_dynamic, out);
+    return true;
+}
+
 bool py_compile(const char* source,
                 const char* filename,
                 enum py_CompileMode mode,
                 bool is_dynamic) {
-    CodeObject co;
-    bool ok = _py_compile(&co, source, filename, mode, is_dynamic);
-    if(ok) {
-        // compile success
-        CodeObject* ud = py_newobject(py_retval(), tp_code, 0, sizeof(CodeObject));
-        *ud = co;
-    }
-    return ok;
+    return pk_compile_cached(py_retval(), source, filename, mode, is_dynamic);
+}
+
+void py_compilecache_setcapacity(int capacity) {
+    CompileCache__set_capacity(&pk_current_vm->compile_cache, capacity);
+}
+
+void py_compilecache_stats(py_i64* hits, py_i64* misses) {
+    CompileCache* cache = &pk_current_vm->compile_cache;
+    if(hits) *hits = cache->hits;
+    if(misses) *misses = cache->misses;
+}
+
+void py_setoptimizelevel(int level) {
+    VM* vm = pk_current_vm;
+    if(level == vm->optimize_level) return;
+    vm->optimize_level = level;
+    CompileCache__clear(&vm->compile_cache);
 }
 
-bool pk_exec(CodeObject* co, py_Ref module) {
+int py_getoptimizelevel() { return pk_current_vm->optimize_level; }
+
+bool pk_exec(py_Ref code, py_Ref module) {
     VM* vm = pk_current_vm;
     if(!module) module = vm->main;
     assert(module->type == tp_module);
 
+    // keep the code object right below the frame, tracebacks refer to it
+    py_push(code);
     py_StackRef sp = vm->stack.sp;
-    py_Frame* frame = Frame__new(co, sp, module, module, py_NIL(), true);
+    py_Frame* frame = Frame__new(py_touserdata(code), sp, module, module, py_NIL(), true);
     VM__push_frame(vm, frame);
     FrameResult res = VM__run_top_frame(vm);
+    py_pop();
     if(res == RES_ERROR) return false;
     assert(res == RES_RETURN);
     return true;
 }
 
-bool pk_execdyn(CodeObject* co, py_Ref module, py_Ref globals, py_Ref locals) {
+bool pk_execdyn(py_Ref code, py_Ref module, py_Ref globals, py_Ref locals) {
     VM* vm = pk_current_vm;
     if(!module) module = vm->main;
     assert(module->type == tp_module);
-
-    py_StackRef sp = vm->stack.sp;
     assert(globals != NULL && locals != NULL);
 
     // check globals
     if(globals->type == tp_namedict) {
-        globals = py_getslot(globals, 0);
+        // refer to the module itself, the proxy may be collected before functions defined here
+        py_ModuleInfo* mi = py_touserdata(py_getslot(globals, 0));
+        globals = mi->self;
         assert(globals->type == tp_module);
     } else {
         if(!py_istype(globals, tp_dict)) { return TypeError("globals must be a dict object"); }
@@ -84,19 +118,27 @@ bool pk_execdyn(CodeObject* co, py_Ref module, py_Ref globals, py_Ref locals) {
         default: return TypeError("locals must be a dict object");
     }
 
-    py_Frame* frame = Frame__new(co, sp, module, globals, locals, true);
+    // keep the code object right below the frame, tracebacks refer to it
+    py_push(code);
+    py_StackRef sp = vm->stack.sp;
+    py_Frame* frame = Frame__new(py_touserdata(code), sp, module, globals, locals, true);
     VM__push_frame(vm, frame);
     FrameResult res = VM__run_top_frame(vm);
+    py_pop();
     if(res == RES_ERROR) return false;
     assert(res == RES_RETURN);
     return true;
 }
 
 bool py_exec(const char* source, const char* filename, enum py_CompileMode mode, py_Ref module) {
-    CodeObject co;
-    if(!_py_compile(&co, source, filename, mode, false)) return false;
-    bool ok = pk_exec(&co, module);
-    CodeObject__dtor(&co);
+    // keep the code object alive on the stack, since it may be evicted from the cache
+    py_Ref code = py_pushtmp();
+    if(!pk_compile_cached(code, source, filename, mode, false)) {
+        py_pop();
+        return false;
+    }
+    bool ok = pk_exec(code, module);
+    py_pop();
     return ok;
 }
 
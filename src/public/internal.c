@@ -4,7 +4,9 @@
 
 #include "pocketpy/common/utils.h"
 #include "pocketpy/common/name.h"
+#include "pocketpy/common/threadpool.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/frozen.h"
 
 _Thread_local VM* pk_current_vm;
 
@@ -24,6 +26,8 @@ void py_initialize() {
     }
 
     pk_names_initialize();
+    pk_frozen_initialize();
+    c11_threadpool__initialize();
 
     // check endianness
     int x = 1;
@@ -74,9 +78,12 @@ void py_finalize() {
         }
     }
     pk_current_vm = &pk_default_vm;
+    // VMs never dereference frozen objects on destruction
+    pk_frozen_finalize();
     VM__dtor(&pk_default_vm);
     pk_current_vm = NULL;
 
+    c11_threadpool__finalize();
     pk_names_finalize();
 }
 
@@ -258,7 +265,14 @@ bool pk_loadmethod(py_StackRef self, py_Name name) {
                 self[0] = *py_getslot(cls_var, 0);
                 self[1] = ti->self;
                 break;
-            default: c11__unreachable();
+            default:
+                if(pk_typeinfo(cls_var->type)->is_method_like) {
+                    self[0] = *cls_var;
+                    self[1] = self_bak;
+                    break;
+                }
+                // e.g. a property, let the caller fall back to getattr
+                return false;
         }
         return true;
     }
@@ -277,8 +291,3 @@ bool pk_callmagic(py_Name name, int argc, py_Ref argv) {
     return py_call(tmp, argc, argv);
 }
 
-bool StopIteration() {
-    bool ok = py_tpcall(tp_StopIteration, 0, NULL);
-    if(!ok) return false;
-    return py_raise(py_retval());
-}
@@ -4,8 +4,10 @@
 #include "pocketpy/pocketpy.h"
 #include "pocketpy/common/utils.h"
 #include "pocketpy/objects/object.h"
+#include "pocketpy/objects/iterator.h"
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/types.h"
 #include "pocketpy/common/_generated.h"
 
 #include <ctype.h>
@@ -284,7 +286,11 @@ static bool builtins_next(int argc, py_Ref argv) {
     if(res == -1) return false;
     if(res) return true;
     if(argc == 1) {
-        // StopIteration stored in py_retval()
+        // StopIteration stored in py_retval(), the cached instance must not reach user code
+        VM* vm = pk_current_vm;
+        if(!py_isnil(&vm->stop_iteration) && py_retval()->_obj == vm->stop_iteration._obj) {
+            return StopIteration();
+        }
         return py_raise(py_retval());
     } else {
         py_assign(py_retval(), py_arg(1));
@@ -596,8 +602,8 @@ static bool _builtins_execdyn(const char* title, int argc, py_Ref argv, enum py_
 
     py_Frame* frame = pk_current_vm->top_frame;
     // [globals, locals, code]
-    CodeObject* code = py_touserdata(py_peek(-1));
-    if(code->src->is_dynamic) {
+    py_StackRef code = py_peek(-1);
+    if(((CodeObject*)py_touserdata(code))->src->is_dynamic) {
         bool ok = pk_execdyn(code, frame ? frame->module : NULL, py_peek(-3), py_peek(-2));
         py_shrink(3);
         return ok;
@@ -634,9 +640,11 @@ static bool
     CodeObject* co = py_touserdata(py_peek(-1));
     py_StackRef locals = py_peek(-2);
     int max_index = -1;
-    c11__foreach(Bytecode, &co->codes, bc) {
-        if(bc->op == OP_LOAD_NAME) {
-            c11_sv name = py_name2sv(c11__getitem(py_Name, &co->names, bc->arg));
+    for(int i = 0; i < co->units.length; i++) {
+        Bytecode bc;
+        i = CodeObject__decode(co, i, &bc);
+        if(bc.op == OP_LOAD_NAME) {
+            c11_sv name = py_name2sv(c11__getitem(py_Name, &co->names, bc.arg));
             if(name.data[0] != '_') continue;
             int index;
             if(name.size == 1) {
@@ -664,7 +672,7 @@ static bool
             py_dict_setitem_by_str(locals, "_", val);
         }
     }
-    ok = pk_execdyn(co, module, py_peek(-3), locals);
+    ok = pk_execdyn(py_peek(-1), module, py_peek(-3), locals);
     if(!ok) return false;
     py_shrink(3);
     return true;
@@ -708,6 +716,421 @@ static bool builtins_compile(int argc, py_Ref argv) {
     return py_compile(source, filename, compile_mode, true);
 }
 
+/* Iterates a list or tuple by index, or any other iterable via `py_next()`.
+ * The list/tuple or the iterator is kept in a temporary stack slot, call `pk_ForEach__dtor()`
+ * to release it. */
+typedef struct {
+    py_Ref obj;
+    int index;  // -1 if `obj` is an iterator
+} pk_ForEach;
+
+static bool pk_ForEach__ctor(pk_ForEach* self, py_Ref iterable) {
+    py_TValue* p;
+    if(pk_arrayview(iterable, &p) != -1) {
+        self->obj = py_pushtmp();
+        *self->obj = *iterable;
+        self->index = 0;
+        return true;
+    }
+    if(!py_iter(iterable)) return false;
+    self->obj = py_pushtmp();
+    *self->obj = *py_retval();
+    self->index = -1;
+    return true;
+}
+
+// returns 1 and stores the item in `py_retval()`, 0 if exhausted, -1 on error
+static int pk_ForEach__next(pk_ForEach* self) {
+    if(self->index < 0) return py_next(self->obj);
+    py_TValue* p;
+    // the length is re-read each time since a list can be mutated during iteration
+    int length = pk_arrayview(self->obj, &p);
+    if(self->index >= length) return 0;
+    *py_retval() = p[self->index++];
+    return 1;
+}
+
+static void pk_ForEach__dtor(pk_ForEach* self) { py_pop(); }
+
+// acc += item, with fast paths for int and float
+static bool builtins_sum__add(py_Ref acc, py_Ref item) {
+    if(acc->type == tp_int) {
+        if(item->type == tp_int) {
+            acc->_i64 += item->_i64;
+            return true;
+        }
+        if(item->type == tp_float) {
+            py_newfloat(acc, acc->_i64 + item->_f64);
+            return true;
+        }
+    } else if(acc->type == tp_float) {
+        if(item->type == tp_float) {
+            acc->_f64 += item->_f64;
+            return true;
+        }
+        if(item->type == tp_int) {
+            acc->_f64 += item->_i64;
+            return true;
+        }
+    }
+    if(!py_binaryadd(acc, item)) return false;
+    *acc = *py_retval();
+    return true;
+}
+
+// sum(iterable, start=0)
+static bool builtins_sum(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    py_Ref acc = py_pushtmp();
+    *acc = *py_arg(1);
+    if(py_istype(py_arg(0), tp_range) && acc->type == tp_int) {
+        Range* ud = py_touserdata(py_arg(0));
+        if(ud->step > 0) {
+            for(py_i64 i = ud->start; i < ud->stop; i += ud->step)
+                acc->_i64 += i;
+        } else {
+            for(py_i64 i = ud->start; i > ud->stop; i += ud->step)
+                acc->_i64 += i;
+        }
+    } else {
+        pk_ForEach it;
+        if(!pk_ForEach__ctor(&it, py_arg(0))) {
+            py_pop();
+            return false;
+        }
+        while(true) {
+            int res = pk_ForEach__next(&it);
+            if(res == 0) break;
+            py_TValue item = *py_retval();
+            if(res == -1 || !builtins_sum__add(acc, &item)) {
+                py_shrink(2);
+                return false;
+            }
+        }
+        pk_ForEach__dtor(&it);
+    }
+    *py_retval() = *acc;
+    py_pop();
+    return true;
+}
+
+static bool builtins_minmax(py_Ref args, py_Ref key, bool is_min) {
+    py_Ref iterable;
+    int length = py_tuple_len(args);
+    if(length == 0) return TypeError("expected 1 arguments, got 0");
+    if(length == 1) {
+        iterable = py_tuple_getitem(args, 0);
+    } else {
+        iterable = args;
+    }
+    if(py_isnone(key)) key = NULL;
+
+    py_Ref res = py_pushtmp();
+    py_Ref res_key = py_pushtmp();
+    py_Ref item = py_pushtmp();
+    pk_ForEach it;
+    if(!pk_ForEach__ctor(&it, iterable)) {
+        py_shrink(3);
+        return false;
+    }
+    bool is_empty = true;
+    while(true) {
+        int next = pk_ForEach__next(&it);
+        if(next == -1) goto __ERROR;
+        if(next == 0) break;
+        *item = *py_retval();
+        py_TValue item_key = *item;
+        if(key) {
+            if(!py_call(key, 1, item)) goto __ERROR;
+            item_key = *py_retval();
+        }
+        if(is_empty) {
+            *res = *item;
+            *res_key = item_key;
+            is_empty = false;
+            continue;
+        }
+        py_Ref lhs = is_min ? &item_key : res_key;
+        py_Ref rhs = is_min ? res_key : &item_key;
+        bool better;
+        if(lhs->type == tp_int && rhs->type == tp_int) {
+            better = lhs->_i64 < rhs->_i64;
+        } else if(lhs->type == tp_float && rhs->type == tp_float) {
+            better = lhs->_f64 < rhs->_f64;
+        } else {
+            bool ok = is_min ? py_lt(&item_key, res_key) : py_gt(&item_key, res_key);
+            if(!ok) goto __ERROR;
+            better = py_tobool(py_retval());
+        }
+        if(better) {
+            *res = *item;
+            *res_key = item_key;
+        }
+    }
+    pk_ForEach__dtor(&it);
+    if(is_empty) {
+        py_shrink(3);
+        return ValueError("args is an empty sequence");
+    }
+    *py_retval() = *res;
+    py_shrink(3);
+    return true;
+
+__ERROR:
+    py_shrink(4);
+    return false;
+}
+
+// min(*args, key=None)
+static bool builtins_min(int argc, py_Ref argv) {
+    return builtins_minmax(py_arg(0), py_arg(1), true);
+}
+
+// max(*args, key=None)
+static bool builtins_max(int argc, py_Ref argv) {
+    return builtins_minmax(py_arg(0), py_arg(1), false);
+}
+
+static bool builtins_allany(py_Ref iterable, bool is_all) {
+    pk_ForEach it;
+    if(!pk_ForEach__ctor(&it, iterable)) return false;
+    while(true) {
+        int res = pk_ForEach__next(&it);
+        if(res == 0) break;
+        int truth = -1;
+        if(res == 1) {
+            py_Ref item = py_retval();
+            truth = item->type == tp_bool ? item->_bool : py_bool(item);
+        }
+        if(truth == -1) {
+            pk_ForEach__dtor(&it);
+            return false;
+        }
+        if(truth != is_all) {
+            pk_ForEach__dtor(&it);
+            py_newbool(py_retval(), !is_all);
+            return true;
+        }
+    }
+    pk_ForEach__dtor(&it);
+    py_newbool(py_retval(), is_all);
+    return true;
+}
+
+static bool builtins_all(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    return builtins_allany(argv, true);
+}
+
+static bool builtins_any(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    return builtins_allany(argv, false);
+}
+
+static bool builtins_reversed(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    // pkpy's reversed() returns a list
+    if(!py_call(py_tpobject(tp_list), 1, argv)) return false;
+    List* list = py_touserdata(py_retval());
+    c11__reverse(py_TValue, list);
+    return true;
+}
+
+/* map, filter, zip and enumerate */
+static bool map__new__(int argc, py_Ref argv) {
+    // map(func, *iterables)
+    if(argc < 3) return TypeError("map() must have at least two arguments");
+    int n = argc - 2;
+    py_Ref out = py_pushtmp();
+    int* ud = py_newobject(out, tp_map, 1 + n, sizeof(int));
+    *ud = n;
+    py_setslot(out, 0, py_arg(1));
+    for(int i = 0; i < n; i++) {
+        if(!py_iter(py_arg(2 + i))) {
+            py_pop();
+            return false;
+        }
+        py_setslot(out, 1 + i, py_retval());
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+bool map__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    int n = *(int*)py_touserdata(argv);
+    py_StackRef args = py_peek(0);
+    for(int i = 0; i < n; i++) {
+        int res = py_next(py_getslot(argv, 1 + i));
+        if(res != 1) {
+            py_shrink(i);
+            return res == 0 ? StopIteration() : false;
+        }
+        py_push(py_retval());
+    }
+    bool ok = py_call(py_getslot(argv, 0), n, args);
+    py_shrink(n);
+    return ok;
+}
+
+static bool filter__new__(int argc, py_Ref argv) {
+    // filter(func, iterable)
+    PY_CHECK_ARGC(3);
+    py_Ref out = py_pushtmp();
+    py_newobject(out, tp_filter, 2, 0);
+    py_setslot(out, 0, py_arg(1));
+    if(!py_iter(py_arg(2))) {
+        py_pop();
+        return false;
+    }
+    py_setslot(out, 1, py_retval());
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+bool filter__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_Ref func = py_getslot(argv, 0);
+    while(true) {
+        int res = py_next(py_getslot(argv, 1));
+        if(res == -1) return false;
+        if(res == 0) return StopIteration();
+        py_push(py_retval());
+        py_Ref item = py_peek(-1);
+        if(!py_isnone(func)) {
+            res = py_call(func, 1, item) ? py_bool(py_retval()) : -1;
+        } else {
+            res = py_bool(item);
+        }
+        if(res == -1) {
+            py_pop();
+            return false;
+        }
+        if(res) {
+            *py_retval() = *item;
+            py_pop();
+            return true;
+        }
+        py_pop();
+    }
+}
+
+static bool zip__new__(int argc, py_Ref argv) {
+    // zip(*iterables)
+    int n = argc - 1;
+    py_Ref out = py_pushtmp();
+    int* ud = py_newobject(out, tp_zip, n, sizeof(int));
+    *ud = n;
+    for(int i = 0; i < n; i++) {
+        if(!py_iter(py_arg(1 + i))) {
+            py_pop();
+            return false;
+        }
+        py_setslot(out, i, py_retval());
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+bool zip__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    int n = *(int*)py_touserdata(argv);
+    if(n == 0) return StopIteration();
+    py_Ref out = py_pushtmp();
+    py_newtuple(out, n);
+    for(int i = 0; i < n; i++) {
+        int res = py_next(py_getslot(argv, i));
+        if(res != 1) {
+            py_pop();
+            return res == 0 ? StopIteration() : false;
+        }
+        py_tuple_setitem(out, i, py_retval());
+    }
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+static bool enumerate__new__(int argc, py_Ref argv) {
+    // __new__(cls, iterable, start=0)
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    py_Ref out = py_pushtmp();
+    py_i64* ud = py_newobject(out, tp_enumerate, 1, sizeof(py_i64));
+    *ud = py_toint(py_arg(2));
+    if(!py_iter(py_arg(1))) {
+        py_pop();
+        return false;
+    }
+    py_setslot(out, 0, py_retval());
+    *py_retval() = *out;
+    py_pop();
+    return true;
+}
+
+bool enumerate__next__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_i64* index = py_touserdata(argv);
+    int res = py_next(py_getslot(argv, 0));
+    if(res == -1) return false;
+    if(res == 0) return StopIteration();
+    py_TValue item = *py_retval();
+    py_Ref p = py_newtuple(py_retval(), 2);
+    py_newint(&p[0], (*index)++);
+    p[1] = item;
+    return true;
+}
+
+py_Type pk_map__register() {
+    py_Type type = pk_newtype("map", tp_object, NULL, NULL, false, true);
+    py_bindmagic(type, __new__, map__new__);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, map__next__);
+    return type;
+}
+
+py_Type pk_filter__register() {
+    py_Type type = pk_newtype("filter", tp_object, NULL, NULL, false, true);
+    py_bindmagic(type, __new__, filter__new__);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, filter__next__);
+    return type;
+}
+
+py_Type pk_zip__register() {
+    py_Type type = pk_newtype("zip", tp_object, NULL, NULL, false, true);
+    py_bindmagic(type, __new__, zip__new__);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, zip__next__);
+    return type;
+}
+
+py_Type pk_enumerate__register() {
+    py_Type type = pk_newtype("enumerate", tp_object, NULL, NULL, false, true);
+    py_bind(py_tpobject(type), "__new__(cls, iterable, start=0)", enumerate__new__);
+    py_bindmagic(type, __iter__, pk_wrapper__self);
+    py_bindmagic(type, __next__, enumerate__next__);
+    return type;
+}
+
+static bool builtins_sorted(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(2, tp_bool);
+    if(!py_call(py_tpobject(tp_list), 1, py_arg(0))) return false;
+    py_Ref list = py_pushtmp();
+    *list = *py_retval();
+    py_Ref key = py_isnone(py_arg(1)) ? NULL : py_arg(1);
+    if(!pk_list__sort(list, key, py_tobool(py_arg(2)))) {
+        py_pop();
+        return false;
+    }
+    *py_retval() = *list;
+    py_pop();
+    return true;
+}
+
 static bool builtins__import__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     PY_CHECK_ARG_TYPE(0, tp_str);
@@ -767,6 +1190,14 @@ py_GlobalRef pk_builtins__register() {
     py_bindfunc(builtins, "eval", builtins_eval);
     py_bindfunc(builtins, "compile", builtins_compile);
 
+    py_bind(builtins, "sorted(iterable, key=None, reverse=False)", builtins_sorted);
+    py_bind(builtins, "sum(iterable, start=0)", builtins_sum);
+    py_bind(builtins, "min(*args, key=None)", builtins_min);
+    py_bind(builtins, "max(*args, key=None)", builtins_max);
+    py_bindfunc(builtins, "all", builtins_all);
+    py_bindfunc(builtins, "any", builtins_any);
+    py_bindfunc(builtins, "reversed", builtins_reversed);
+
     py_bindfunc(builtins, "__import__", builtins__import__);
 
     // some patches
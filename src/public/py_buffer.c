@@ -0,0 +1,708 @@
+#include "pocketpy/pocketpy.h"
+
+#include "pocketpy/common/utils.h"
+#include "pocketpy/common/sstream.h"
+#include "pocketpy/common/vector.h"
+#include "pocketpy/objects/object.h"
+#include "pocketpy/interpreter/vm.h"
+
+#include <string.h>
+
+/* buffer protocol */
+static bool (*pk_buffer__findhook(py_Type type))(py_Ref, py_Buffer*) {
+    py_TypeInfo* ti = pk_typeinfo(type);
+    while(ti) {
+        if(ti->getbuffer) return ti->getbuffer;
+        ti = ti->base_ti;
+    }
+    return NULL;
+}
+
+bool py_getbuffer(py_Ref self, py_Buffer* out, bool writable) {
+    bool (*getbuffer)(py_Ref, py_Buffer*) = pk_buffer__findhook(self->type);
+    if(!getbuffer) return TypeError("a bytes-like object is required, not '%t'", self->type);
+    if(!getbuffer(self, out)) return false;
+    if(writable && out->readonly) {
+        return TypeError("'%t' object is a read-only buffer", self->type);
+    }
+    return true;
+}
+
+static int pk_buffer__itemsize(char format) {
+    switch(format) {
+        case 'B':
+        case '?':
+        case 'b': return 1;
+        case 'h': return 2;
+        case 'i':
+        case 'f': return 4;
+        case 'd': return 8;
+        default: return 0;
+    }
+}
+
+// items of a view may be unaligned, so they are accessed with `memcpy`
+static void pk_buffer__box(char format, const unsigned char* p, py_OutRef out) {
+    switch(format) {
+        case 'B': py_newint(out, *p); break;
+        case '?': py_newbool(out, *p != 0); break;
+        case 'b': py_newint(out, (int8_t)*p); break;
+        case 'h': {
+            int16_t v;
+            memcpy(&v, p, sizeof(v));
+            py_newint(out, v);
+            break;
+        }
+        case 'i': {
+            int32_t v;
+            memcpy(&v, p, sizeof(v));
+            py_newint(out, v);
+            break;
+        }
+        case 'f': {
+            float v;
+            memcpy(&v, p, sizeof(v));
+            py_newfloat(out, v);
+            break;
+        }
+        case 'd': {
+            double v;
+            memcpy(&v, p, sizeof(v));
+            py_newfloat(out, v);
+            break;
+        }
+        default: c11__unreachable();
+    }
+}
+
+static bool pk_buffer__unbox(char format, unsigned char* p, py_Ref val) {
+    switch(format) {
+        case '?': {
+            if(!py_checkbool(val)) return false;
+            *p = py_tobool(val);
+            return true;
+        }
+        case 'f': {
+            float v;
+            if(!py_castfloat32(val, &v)) return false;
+            memcpy(p, &v, sizeof(v));
+            return true;
+        }
+        case 'd': {
+            double v;
+            if(!py_castfloat(val, &v)) return false;
+            memcpy(p, &v, sizeof(v));
+            return true;
+        }
+        default: break;
+    }
+    if(!py_checkint(val)) return false;
+    py_i64 v = py_toint(val);
+    switch(format) {
+        case 'B': {
+            if(v < 0 || v > UINT8_MAX) return ValueError("byte must be in range(0, 256)");
+            *p = (uint8_t)v;
+            return true;
+        }
+        case 'b': {
+            if(v < INT8_MIN || v > INT8_MAX) break;
+            *p = (uint8_t)(int8_t)v;
+            return true;
+        }
+        case 'h': {
+            if(v < INT16_MIN || v > INT16_MAX) break;
+            int16_t x = (int16_t)v;
+            memcpy(p, &x, sizeof(x));
+            return true;
+        }
+        case 'i': {
+            if(v < INT32_MIN || v > INT32_MAX) break;
+            int32_t x = (int32_t)v;
+            memcpy(p, &x, sizeof(x));
+            return true;
+        }
+        default: c11__unreachable();
+    }
+    return ValueError("memoryview: invalid value for format '%c'", format);
+}
+
+/* bytearray */
+unsigned char* py_newbytearray(py_OutRef out, int n) {
+    c11_vector* ud = py_newobject(out, tp_bytearray, 0, sizeof(c11_vector));
+    c11_vector__ctor(ud, sizeof(unsigned char));
+    c11_vector__reserve(ud, n);
+    memset(ud->data, 0, n);
+    ud->length = n;
+    return ud->data;
+}
+
+// read `src` as bytes, the ints of a list or tuple are packed into `tmp` first
+static bool bytearray__source(py_Ref src, c11_vector* tmp, py_Buffer* out) {
+    py_TValue* p;
+    int length = pk_arrayview(src, &p);
+    if(length == -1) return py_getbuffer(src, out, false);
+    for(int i = 0; i < length; i++) {
+        if(!py_checkint(&p[i])) return false;
+        py_i64 v = py_toint(&p[i]);
+        if(v < 0 || v > 255) return ValueError("byte must be in range(0, 256)");
+        c11_vector__push(unsigned char, tmp, (unsigned char)v);
+    }
+    out->data = tmp->data;
+    out->size = tmp->length;
+    out->itemsize = 1;
+    out->format = 'B';
+    out->readonly = true;
+    return true;
+}
+
+// self[start:stop] = p[:n], where `p` may point into `self`
+static void bytearray__replace(c11_vector* self, int start, int stop, const void* p, int n) {
+    unsigned char* copy = NULL;
+    const unsigned char* src = p;
+    const unsigned char* begin = self->data;
+    if(n > 0 && src < begin + self->capacity && src + n > begin) {
+        copy = PK_MALLOC(n);
+        memcpy(copy, src, n);
+        src = copy;
+    }
+    int new_length = self->length - (stop - start) + n;
+    if(new_length > self->capacity) {
+        c11_vector__reserve(self, c11__max(new_length, c11_vector__nextcap(self)));
+    }
+    unsigned char* data = self->data;
+    memmove(data + start + n, data + stop, self->length - stop);
+    if(n > 0) memcpy(data + start, src, n);
+    self->length = new_length;
+    if(copy) PK_FREE(copy);
+}
+
+// self[start:stop] = src
+static bool bytearray__splice(py_Ref self, int start, int stop, py_Ref src) {
+    c11_vector tmp;
+    c11_vector__ctor(&tmp, sizeof(unsigned char));
+    py_Buffer buf;
+    bool ok = bytearray__source(src, &tmp, &buf);
+    if(ok) bytearray__replace(py_touserdata(self), start, stop, buf.data, buf.size);
+    c11_vector__dtor(&tmp);
+    return ok;
+}
+
+static bool bytearray__getbuffer(py_Ref self, py_Buffer* out) {
+    c11_vector* ud = py_touserdata(self);
+    out->data = ud->data;
+    out->size = ud->length;
+    out->itemsize = 1;
+    out->format = 'B';
+    out->readonly = false;
+    return true;
+}
+
+static bool bytearray__new__(int argc, py_Ref argv) {
+    if(argc == 1) {
+        py_newbytearray(py_retval(), 0);
+        return true;
+    }
+    if(argc > 2) return TypeError("bytearray() takes at most 1 argument");
+    if(py_isint(&argv[1])) {
+        py_i64 n = py_toint(&argv[1]);
+        if(n < 0) return ValueError("negative count");
+        if(n > INT32_MAX) return ValueError("bytearray() argument is too large");
+        py_newbytearray(py_retval(), (int)n);
+        return true;
+    }
+    c11_vector tmp;
+    c11_vector__ctor(&tmp, sizeof(unsigned char));
+    py_Buffer buf;
+    bool ok = bytearray__source(&argv[1], &tmp, &buf);
+    if(ok) {
+        unsigned char* p = py_newbytearray(py_retval(), buf.size);
+        if(buf.size > 0) memcpy(p, buf.data, buf.size);
+    }
+    c11_vector__dtor(&tmp);
+    return ok;
+}
+
+static bool bytearray__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vector* self = py_touserdata(&argv[0]);
+    py_newint(py_retval(), self->length);
+    return true;
+}
+
+static bool bytearray__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vector* self = py_touserdata(&argv[0]);
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "bytearray(b");
+    c11_sbuf__write_quoted(&buf, (c11_sv){self->data, self->length}, '\'');
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+static bool bytearray__getitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vector* self = py_touserdata(&argv[0]);
+    unsigned char* data = self->data;
+    py_Ref _1 = py_arg(1);
+    if(_1->type == tp_int) {
+        int index = py_toint(_1);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        py_newint(py_retval(), data[index]);
+        return true;
+    } else if(_1->type == tp_slice) {
+        int start, stop, step;
+        if(!pk__parse_int_slice(_1, self->length, &start, &stop, &step)) return false;
+        int n = 0;
+        for(int i = start; step > 0 ? i < stop : i > stop; i += step) n++;
+        unsigned char* p = py_newbytearray(py_retval(), n);
+        for(int j = 0; j < n; j++) p[j] = data[start + j * step];
+        return true;
+    } else {
+        return TypeError("bytearray indices must be integers");
+    }
+}
+
+static bool bytearray__setitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_vector* self = py_touserdata(&argv[0]);
+    py_Ref _1 = py_arg(1);
+    if(_1->type == tp_int) {
+        int index = py_toint(_1);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        unsigned char* data = self->data;
+        if(!pk_buffer__unbox('B', &data[index], py_arg(2))) return false;
+    } else if(_1->type == tp_slice) {
+        int start, stop, step;
+        if(!pk__parse_int_slice(_1, self->length, &start, &stop, &step)) return false;
+        if(step == 1) {
+            if(!bytearray__splice(&argv[0], start, c11__max(start, stop), py_arg(2))) {
+                return false;
+            }
+        } else {
+            c11_vector tmp;
+            c11_vector__ctor(&tmp, sizeof(unsigned char));
+            py_Buffer buf;
+            if(!bytearray__source(py_arg(2), &tmp, &buf)) {
+                c11_vector__dtor(&tmp);
+                return false;
+            }
+            int n = 0;
+            for(int i = start; step > 0 ? i < stop : i > stop; i += step) n++;
+            if(buf.size != n) {
+                c11_vector__dtor(&tmp);
+                return ValueError("attempt to assign bytes of size %d to extended slice of size %d",
+                                  buf.size,
+                                  n);
+            }
+            // `memmove` semantics when the source is `self`
+            unsigned char* src = PK_MALLOC(n + 1);
+            memcpy(src, buf.data, n);
+            unsigned char* data = self->data;
+            for(int j = 0; j < n; j++) data[start + j * step] = src[j];
+            PK_FREE(src);
+            c11_vector__dtor(&tmp);
+        }
+    } else {
+        return TypeError("bytearray indices must be integers");
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool bytearray__delitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vector* self = py_touserdata(&argv[0]);
+    py_Ref _1 = py_arg(1);
+    if(_1->type == tp_int) {
+        int index = py_toint(_1);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        bytearray__replace(self, index, index + 1, NULL, 0);
+    } else if(_1->type == tp_slice) {
+        int start, stop, step;
+        if(!pk__parse_int_slice(_1, self->length, &start, &stop, &step)) return false;
+        if(step != 1) return ValueError("bytearray deletion requires a slice with step 1");
+        bytearray__replace(self, start, c11__max(start, stop), NULL, 0);
+    } else {
+        return TypeError("bytearray indices must be integers");
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool bytearray__compare(int argc, py_Ref argv, bool eq) {
+    PY_CHECK_ARGC(2);
+    if(!py_istype(&argv[1], tp_bytes) && !py_istype(&argv[1], tp_bytearray)) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    py_Buffer lhs, rhs;
+    if(!py_getbuffer(&argv[0], &lhs, false)) return false;
+    if(!py_getbuffer(&argv[1], &rhs, false)) return false;
+    bool res = lhs.size == rhs.size && memcmp(lhs.data, rhs.data, lhs.size) == 0;
+    py_newbool(py_retval(), res == eq);
+    return true;
+}
+
+static bool bytearray__eq__(int argc, py_Ref argv) { return bytearray__compare(argc, argv, true); }
+
+static bool bytearray__ne__(int argc, py_Ref argv) {
+    return bytearray__compare(argc, argv, false);
+}
+
+static bool bytearray__add__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    if(!pk_buffer__findhook(argv[1].type)) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    py_Buffer rhs;
+    if(!py_getbuffer(&argv[1], &rhs, false)) return false;
+    c11_vector* self = py_touserdata(&argv[0]);
+    unsigned char* p = py_newbytearray(py_retval(), self->length + rhs.size);
+    memcpy(p, self->data, self->length);
+    if(rhs.size > 0) memcpy(p + self->length, rhs.data, rhs.size);
+    return true;
+}
+
+static bool bytearray__reduce__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vector* self = py_touserdata(&argv[0]);
+    py_Ref args = py_pushtmp();
+    py_newtuple(args, 1);
+    unsigned char* p = py_newbytes(py_tuple_getitem(args, 0), self->length);
+    memcpy(p, self->data, self->length);
+    py_newtuple(py_retval(), 2);
+    py_tuple_setitem(py_retval(), 0, py_tpobject(tp_bytearray));
+    py_tuple_setitem(py_retval(), 1, args);
+    py_pop();
+    return true;
+}
+
+static bool bytearray_append(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vector* self = py_touserdata(&argv[0]);
+    unsigned char byte = 0;
+    if(!pk_buffer__unbox('B', &byte, py_arg(1))) return false;
+    c11_vector__push(unsigned char, self, byte);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool bytearray_extend(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_vector* self = py_touserdata(&argv[0]);
+    if(!bytearray__splice(&argv[0], self->length, self->length, py_arg(1))) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool bytearray_clear(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vector* self = py_touserdata(&argv[0]);
+    c11_vector__clear(self);
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool bytearray_decode(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_vector* self = py_touserdata(&argv[0]);
+    py_newstrv(py_retval(), (c11_sv){self->data, self->length});
+    return true;
+}
+
+py_Type pk_bytearray__register() {
+    py_Type type =
+        pk_newtype("bytearray", tp_object, NULL, (void (*)(void*))c11_vector__dtor, false, true);
+
+    py_bindmagic(type, __new__, bytearray__new__);
+    py_bindmagic(type, __len__, bytearray__len__);
+    py_bindmagic(type, __repr__, bytearray__repr__);
+    py_bindmagic(type, __getitem__, bytearray__getitem__);
+    py_bindmagic(type, __setitem__, bytearray__setitem__);
+    py_bindmagic(type, __delitem__, bytearray__delitem__);
+    py_bindmagic(type, __eq__, bytearray__eq__);
+    py_bindmagic(type, __ne__, bytearray__ne__);
+    py_bindmagic(type, __add__, bytearray__add__);
+    py_bindmagic(type, __reduce__, bytearray__reduce__);
+
+    py_bindmethod(type, "append", bytearray_append);
+    py_bindmethod(type, "extend", bytearray_extend);
+    py_bindmethod(type, "clear", bytearray_clear);
+    py_bindmethod(type, "decode", bytearray_decode);
+
+    py_setdict(py_tpobject(type), __hash__, py_None());
+    py_tphookbuffer(type, bytearray__getbuffer);
+    return type;
+}
+
+/* memoryview */
+// a window of items into the buffer of the object in slot 0
+typedef struct c11_memoryview {
+    int offset;  // in bytes
+    int length;  // in items
+    int itemsize;
+    char format;
+    bool readonly;
+} c11_memoryview;
+
+static c11_memoryview* memoryview__new(py_OutRef out, py_Ref obj) {
+    c11_memoryview* ud = py_newobject(out, tp_memoryview, 1, sizeof(c11_memoryview));
+    py_setslot(out, 0, obj);
+    return ud;
+}
+
+// the exporter's memory is looked up on every access, since a `bytearray` may have moved it
+static bool memoryview__resolve(py_Ref self, unsigned char** data) {
+    c11_memoryview* ud = py_touserdata(self);
+    py_Buffer buf;
+    if(!py_getbuffer(py_getslot(self, 0), &buf, false)) return false;
+    if(ud->offset + ud->length * ud->itemsize > buf.size) {
+        return ValueError("memoryview: underlying buffer has shrunk");
+    }
+    *data = (unsigned char*)buf.data + ud->offset;
+    return true;
+}
+
+static bool memoryview__getbuffer(py_Ref self, py_Buffer* out) {
+    c11_memoryview* ud = py_touserdata(self);
+    unsigned char* data = NULL;
+    if(!memoryview__resolve(self, &data)) return false;
+    out->data = data;
+    out->size = ud->length * ud->itemsize;
+    out->itemsize = ud->itemsize;
+    out->format = ud->format;
+    out->readonly = ud->readonly;
+    return true;
+}
+
+static bool memoryview__new__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    py_Ref obj = py_arg(1);
+    py_Buffer buf;
+    if(!py_getbuffer(obj, &buf, false)) return false;
+    if(py_istype(obj, tp_memoryview)) {
+        c11_memoryview* other = py_touserdata(obj);
+        c11_memoryview* ud = memoryview__new(py_retval(), py_getslot(obj, 0));
+        *ud = *other;
+        return true;
+    }
+    c11_memoryview* ud = memoryview__new(py_retval(), obj);
+    ud->offset = 0;
+    ud->length = buf.size / buf.itemsize;
+    ud->itemsize = buf.itemsize;
+    ud->format = buf.format;
+    ud->readonly = buf.readonly;
+    return true;
+}
+
+static bool memoryview__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_newint(py_retval(), self->length);
+    return true;
+}
+
+static bool memoryview__repr__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_newfstr(py_retval(), "<memory at %p>", argv->_obj);
+    return true;
+}
+
+static bool memoryview__getitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_Ref _1 = py_arg(1);
+    if(_1->type == tp_int) {
+        int index = py_toint(_1);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        unsigned char* data = NULL;
+        if(!memoryview__resolve(&argv[0], &data)) return false;
+        pk_buffer__box(self->format, data + index * self->itemsize, py_retval());
+        return true;
+    } else if(_1->type == tp_slice) {
+        int start, stop, step;
+        if(!pk__parse_int_slice(_1, self->length, &start, &stop, &step)) return false;
+        if(step != 1) return ValueError("memoryview: slices must have step 1");
+        c11_memoryview* ud = memoryview__new(py_retval(), py_getslot(&argv[0], 0));
+        *ud = *self;
+        ud->offset = self->offset + start * self->itemsize;
+        ud->length = c11__max(stop - start, 0);
+        return true;
+    } else {
+        return TypeError("memoryview indices must be integers");
+    }
+}
+
+static bool memoryview__setitem__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    if(self->readonly) return TypeError("cannot modify read-only memory");
+    py_Ref _1 = py_arg(1);
+    if(_1->type == tp_int) {
+        int index = py_toint(_1);
+        if(!pk__normalize_index(&index, self->length)) return false;
+        unsigned char* data = NULL;
+        if(!memoryview__resolve(&argv[0], &data)) return false;
+        if(!pk_buffer__unbox(self->format, data + index * self->itemsize, py_arg(2))) {
+            return false;
+        }
+    } else if(_1->type == tp_slice) {
+        int start, stop, step;
+        if(!pk__parse_int_slice(_1, self->length, &start, &stop, &step)) return false;
+        if(step != 1) return ValueError("memoryview: slices must have step 1");
+        int nbytes = c11__max(stop - start, 0) * self->itemsize;
+        py_Buffer src;
+        if(!py_getbuffer(py_arg(2), &src, false)) return false;
+        if(src.size != nbytes || src.format != self->format) {
+            return ValueError("memoryview assignment: lvalue and rvalue have different structures");
+        }
+        unsigned char* data = NULL;
+        if(!memoryview__resolve(&argv[0], &data)) return false;
+        if(nbytes > 0) memmove(data + start * self->itemsize, src.data, nbytes);
+    } else {
+        return TypeError("memoryview indices must be integers");
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool memoryview__compare(int argc, py_Ref argv, bool eq) {
+    PY_CHECK_ARGC(2);
+    if(!pk_buffer__findhook(argv[1].type)) {
+        py_newnotimplemented(py_retval());
+        return true;
+    }
+    py_Buffer lhs, rhs;
+    if(!py_getbuffer(&argv[0], &lhs, false)) return false;
+    if(!py_getbuffer(&argv[1], &rhs, false)) return false;
+    int n = lhs.size / lhs.itemsize;
+    bool res = n == rhs.size / rhs.itemsize;
+    if(res && lhs.format == rhs.format && lhs.format != 'f' && lhs.format != 'd') {
+        res = memcmp(lhs.data, rhs.data, lhs.size) == 0;
+    } else {
+        // compare by value, so that `nan` is unequal and formats may differ
+        py_Ref a = py_pushtmp();
+        py_Ref b = py_pushtmp();
+        for(int i = 0; res && i < n; i++) {
+            pk_buffer__box(lhs.format, (unsigned char*)lhs.data + i * lhs.itemsize, a);
+            pk_buffer__box(rhs.format, (unsigned char*)rhs.data + i * rhs.itemsize, b);
+            py_f64 x, y;
+            py_castfloat(a, &x);
+            py_castfloat(b, &y);
+            res = x == y;
+        }
+        py_shrink(2);
+    }
+    py_newbool(py_retval(), res == eq);
+    return true;
+}
+
+static bool memoryview__eq__(int argc, py_Ref argv) {
+    return memoryview__compare(argc, argv, true);
+}
+
+static bool memoryview__ne__(int argc, py_Ref argv) {
+    return memoryview__compare(argc, argv, false);
+}
+
+static bool memoryview_tobytes(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_Buffer buf;
+    if(!py_getbuffer(&argv[0], &buf, false)) return false;
+    unsigned char* p = py_newbytes(py_retval(), buf.size);
+    if(buf.size > 0) memcpy(p, buf.data, buf.size);
+    return true;
+}
+
+static bool memoryview_tolist(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    unsigned char* data = NULL;
+    if(!memoryview__resolve(&argv[0], &data)) return false;
+    py_newlistn(py_retval(), self->length);
+    for(int i = 0; i < self->length; i++) {
+        pk_buffer__box(self->format, data + i * self->itemsize, py_list_getitem(py_retval(), i));
+    }
+    return true;
+}
+
+static bool memoryview_cast(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_str);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    c11_sv format = py_tosv(py_arg(1));
+    int itemsize = format.size == 1 ? pk_buffer__itemsize(format.data[0]) : 0;
+    if(itemsize == 0) return ValueError("memoryview: unknown format '%v'", format);
+    int nbytes = self->length * self->itemsize;
+    if(nbytes % itemsize != 0) return TypeError("memoryview: length is not a multiple of itemsize");
+    c11_memoryview* ud = memoryview__new(py_retval(), py_getslot(&argv[0], 0));
+    ud->offset = self->offset;
+    ud->length = nbytes / itemsize;
+    ud->itemsize = itemsize;
+    ud->format = format.data[0];
+    ud->readonly = self->readonly;
+    return true;
+}
+
+static bool memoryview_obj(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    py_assign(py_retval(), py_getslot(&argv[0], 0));
+    return true;
+}
+
+static bool memoryview_nbytes(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_newint(py_retval(), self->length * self->itemsize);
+    return true;
+}
+
+static bool memoryview_itemsize(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_newint(py_retval(), self->itemsize);
+    return true;
+}
+
+static bool memoryview_format(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_newstrv(py_retval(), (c11_sv){&self->format, 1});
+    return true;
+}
+
+static bool memoryview_readonly(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_memoryview* self = py_touserdata(&argv[0]);
+    py_newbool(py_retval(), self->readonly);
+    return true;
+}
+
+py_Type pk_memoryview__register() {
+    py_Type type = pk_newtype("memoryview", tp_object, NULL, NULL, false, true);
+
+    py_bindmagic(type, __new__, memoryview__new__);
+    py_bindmagic(type, __len__, memoryview__len__);
+    py_bindmagic(type, __repr__, memoryview__repr__);
+    py_bindmagic(type, __getitem__, memoryview__getitem__);
+    py_bindmagic(type, __setitem__, memoryview__setitem__);
+    py_bindmagic(type, __eq__, memoryview__eq__);
+    py_bindmagic(type, __ne__, memoryview__ne__);
+
+    py_bindmethod(type, "tobytes", memoryview_tobytes);
+    py_bindmethod(type, "tolist", memoryview_tolist);
+    py_bindmethod(type, "cast", memoryview_cast);
+
+    py_bindproperty(type, "obj", memoryview_obj, NULL);
+    py_bindproperty(type, "nbytes", memoryview_nbytes, NULL);
+    py_bindproperty(type, "itemsize", memoryview_itemsize, NULL);
+    py_bindproperty(type, "format", memoryview_format, NULL);
+    py_bindproperty(type, "readonly", memoryview_readonly, NULL);
+
+    py_setdict(py_tpobject(type), __hash__, py_None());
+    py_tphookbuffer(type, memoryview__getbuffer);
+    return type;
+}
@@ -4,6 +4,7 @@
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/interpreter/types.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/frozen.h"
 
 typedef struct {
     Dict* dict;  // weakref for slot 0
@@ -95,13 +96,23 @@ static void Dict__ctor(Dict* self, uint32_t capacity, int entries_capacity) {
     c11_vector__reserve(&self->entries, entries_capacity);
 }
 
-static void Dict__dtor(Dict* self) {
+void Dict__dtor(Dict* self) {
     self->length = 0;
     self->capacity = 0;
     PK_FREE(self->indices);
     c11_vector__dtor(&self->entries);
 }
 
+void dict__gc_mark(void* ud, c11_vector* p_stack) {
+    Dict* self = ud;
+    for(int i = 0; i < self->entries.length; i++) {
+        DictEntry* entry = c11__at(DictEntry, &self->entries, i);
+        if(py_isnil(&entry->key)) continue;
+        pk__mark_value(&entry->key);
+        pk__mark_value(&entry->val);
+    }
+}
+
 static uint32_t Dict__get_index(Dict* self, uint32_t index) {
     if(self->index_is_short) {
         uint16_t* indices = self->indices;
@@ -172,7 +183,7 @@ static bool Dict__probe(Dict* self,
     return true;
 }
 
-static bool Dict__try_get(Dict* self, py_TValue* key, DictEntry** out) {
+bool Dict__try_get(Dict* self, py_TValue* key, DictEntry** out) {
     uint64_t hash;
     uint32_t idx;
     return Dict__probe(self, key, &hash, &idx, out);
@@ -236,7 +247,7 @@ static void Dict__compact_entries(Dict* self) {
     PK_FREE(mappings);
 }
 
-static bool Dict__set(Dict* self, py_TValue* key, py_TValue* val) {
+bool Dict__set(Dict* self, py_TValue* key, py_TValue* val) {
     uint64_t hash;
     uint32_t idx;
     DictEntry* entry;
@@ -449,7 +460,7 @@ static bool dict__repr__(int argc, py_Ref argv) {
 static bool dict__eq__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     Dict* self = py_touserdata(py_arg(0));
-    if(!py_isdict(py_arg(1))) {
+    if(!py_isinstance(py_arg(1), tp_dict) && !py_istype(py_arg(1), tp_frozendict)) {
         py_newnotimplemented(py_retval());
         return true;
     }
@@ -502,21 +513,25 @@ static bool dict_clear(int argc, py_Ref argv) {
     return true;
 }
 
+void Dict__copy(Dict* self, Dict* other) {
+    self->length = other->length;
+    self->capacity = other->capacity;
+    self->null_index_value = other->null_index_value;
+    self->index_is_short = other->index_is_short;
+    // copy entries
+    self->entries = c11_vector__copy(&other->entries);
+    // copy indices
+    size_t indices_size = other->index_is_short ? other->capacity * sizeof(uint16_t)
+                                                : other->capacity * sizeof(uint32_t);
+    self->indices = PK_MALLOC(indices_size);
+    memcpy(self->indices, other->indices, indices_size);
+}
+
 static bool dict_copy(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     Dict* self = py_touserdata(argv);
     Dict* new_dict = py_newobject(py_retval(), tp_dict, 0, sizeof(Dict));
-    new_dict->length = self->length;
-    new_dict->capacity = self->capacity;
-    new_dict->null_index_value = self->null_index_value;
-    new_dict->index_is_short = self->index_is_short;
-    // copy entries
-    new_dict->entries = c11_vector__copy(&self->entries);
-    // copy indices
-    size_t indices_size = self->index_is_short ? self->capacity * sizeof(uint16_t)
-                                               : self->capacity * sizeof(uint32_t);
-    new_dict->indices = PK_MALLOC(indices_size);
-    memcpy(new_dict->indices, self->indices, indices_size);
+    Dict__copy(new_dict, self);
     return true;
 }
 
@@ -609,6 +624,57 @@ py_Type pk_dict__register() {
     return type;
 }
 
+//////////////////////////
+void pk_newfrozendict(py_OutRef out, py_Ref dict) {
+    assert(py_isdict(dict));
+    PyObject* obj = FrozenSpace__new(tp_frozendict, 0, sizeof(Dict));
+    Dict__copy(PyObject__userdata(obj), py_touserdata(dict));
+    out->type = tp_frozendict;
+    out->is_ptr = true;
+    out->_obj = obj;
+}
+
+static bool frozendict__new__(int argc, py_Ref argv) {
+    if(argc != 2) return TypeError("frozendict() takes exactly 1 argument (%d given)", argc - 1);
+    PY_CHECK_ARG_TYPE(1, tp_dict);
+    return py_freeze(py_arg(1));
+}
+
+static bool frozendict__repr__(int argc, py_Ref argv) {
+    if(!dict__repr__(argc, argv)) return false;
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstr(&buf, "frozendict(");
+    c11_sbuf__write_sv(&buf, py_tosv(py_retval()));
+    c11_sbuf__write_char(&buf, ')');
+    c11_sbuf__py_submit(&buf, py_retval());
+    return true;
+}
+
+py_Type pk_frozendict__register() {
+    py_Type type =
+        pk_newtype("frozendict", tp_object, NULL, (void (*)(void*))Dict__dtor, false, true);
+    assert(type == tp_frozendict);
+
+    py_bindmagic(type, __new__, frozendict__new__);
+    py_bindmagic(type, __getitem__, dict__getitem__);
+    py_bindmagic(type, __contains__, dict__contains__);
+    py_bindmagic(type, __len__, dict__len__);
+    py_bindmagic(type, __repr__, frozendict__repr__);
+    py_bindmagic(type, __eq__, dict__eq__);
+    py_bindmagic(type, __ne__, dict__ne__);
+    py_bindmagic(type, __iter__, dict_keys);
+
+    py_bindmethod(type, "copy", dict_copy);
+    py_bindmethod(type, "get", dict_get);
+    py_bindmethod(type, "keys", dict_keys);
+    py_bindmethod(type, "values", dict_values);
+    py_bindmethod(type, "items", dict_items);
+
+    py_setdict(py_tpobject(type), __hash__, py_None());
+    return type;
+}
+
 //////////////////////////
 bool dict_items__next__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
@@ -6,19 +6,28 @@
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/objects/exception.h"
 
-void py_BaseException__stpush(py_Frame* frame,
-                              py_Ref self,
-                              SourceData_ src,
-                              int lineno,
-                              const char* func_name) {
+void py_BaseException__stpush(py_Frame* frame, py_Ref self, SourceData_ src, int lineno) {
     BaseException* ud = py_touserdata(self);
     int max_frame_dumps = py_debugger_isattached() ? 31 : 7;
     if(ud->stacktrace.length >= max_frame_dumps) return;
     BaseExceptionFrame* frame_dump = c11_vector__emplace(&ud->stacktrace);
-    PK_INCREF(src);
-    frame_dump->src = src;
-    frame_dump->lineno = lineno;
-    frame_dump->name = func_name ? c11_string__new(func_name) : NULL;
+    py_newnil(&frame_dump->locals);
+    py_newnil(&frame_dump->globals);
+    if(frame != NULL) {
+        // [callable, <self>, args..., local_vars...] or [code] for module-level code
+        //      ^p0                                          ^p0
+        frame_dump->owner = frame->is_locals_special ? frame->p0[-1] : frame->p0[0];
+        assert(frame_dump->owner.type == (frame->is_locals_special ? tp_code : tp_function));
+        frame_dump->ip = frame->ip;
+        frame_dump->src = NULL;
+        frame_dump->lineno = 0;
+    } else {
+        py_newnil(&frame_dump->owner);
+        frame_dump->ip = -1;
+        PK_INCREF(src);
+        frame_dump->src = src;
+        frame_dump->lineno = lineno;
+    }
 
     if(py_debugger_isattached()) {
         if(frame != NULL) {
@@ -31,15 +40,58 @@ void py_BaseException__stpush(py_Frame* frame,
     }
 }
 
-static void BaseException__dtor(void* ud) {
-    BaseException* self = (BaseException*)ud;
+static const CodeObject* BaseExceptionFrame__code(const BaseExceptionFrame* self) {
+    switch(self->owner.type) {
+        case tp_function: {
+            Function* fn = PyObject__userdata(self->owner._obj);
+            return &fn->decl->code;
+        }
+        case tp_code: return PyObject__userdata(self->owner._obj);
+        default: return NULL;
+    }
+}
+
+SourceData_ BaseExceptionFrame__src(const BaseExceptionFrame* self) {
+    const CodeObject* co = BaseExceptionFrame__code(self);
+    return co ? co->src : self->src;
+}
+
+int BaseExceptionFrame__lineno(const BaseExceptionFrame* self) {
+    const CodeObject* co = BaseExceptionFrame__code(self);
+    if(co == NULL) return self->lineno;
+    if(self->ip >= 0) return CodeObject__lineno(co, self->ip);
+    return self->owner.type == tp_function ? co->start_line : 0;
+}
+
+const char* BaseExceptionFrame__name(const BaseExceptionFrame* self) {
+    if(self->owner.type != tp_function) return NULL;
+    Function* fn = PyObject__userdata(self->owner._obj);
+    return fn->decl->code.name->data;
+}
+
+static void BaseException__clear_stacktrace(BaseException* self) {
     c11__foreach(BaseExceptionFrame, &self->stacktrace, it) {
-        PK_DECREF(it->src);
-        if(it->name) c11_string__delete(it->name);
+        if(it->src) PK_DECREF(it->src);
     }
+    c11_vector__clear(&self->stacktrace);
+}
+
+void BaseException__dtor(void* ud) {
+    BaseException* self = (BaseException*)ud;
+    BaseException__clear_stacktrace(self);
     c11_vector__dtor(&self->stacktrace);
 }
 
+void BaseException__gc_mark(BaseException* self, c11_vector* p_stack) {
+    pk__mark_value(&self->args);
+    pk__mark_value(&self->inner_exc);
+    c11__foreach(BaseExceptionFrame, &self->stacktrace, frame) {
+        pk__mark_value(&frame->owner);
+        pk__mark_value(&frame->locals);
+        pk__mark_value(&frame->globals);
+    }
+}
+
 static bool _py_BaseException__new__(int argc, py_Ref argv) {
     py_Type cls = py_totype(argv);
     BaseException* ud = py_newobject(py_retval(), cls, 0, sizeof(BaseException));
@@ -178,11 +230,11 @@ static void c11_sbuf__write_exc(c11_sbuf* self, py_Ref exc) {
 
     for(int i = ud->stacktrace.length - 1; i >= 0; i--) {
         BaseExceptionFrame* frame = c11__at(BaseExceptionFrame, &ud->stacktrace, i);
-        SourceData__snapshot(frame->src,
+        SourceData__snapshot(BaseExceptionFrame__src(frame),
                              self,
-                             frame->lineno,
+                             BaseExceptionFrame__lineno(frame),
                              NULL,
-                             frame->name ? frame->name->data : NULL);
+                             BaseExceptionFrame__name(frame));
         c11_sbuf__write_char(self, '\n');
     }
 
@@ -281,4 +333,25 @@ bool KeyError(py_Ref key) {
     bool ok = py_tpcall(tp_KeyError, 1, key);
     if(!ok) return false;
     return py_raise(py_retval());
-}
\ No newline at end of file
+}
+
+bool StopIteration() {
+    VM* vm = pk_current_vm;
+    // internal iteration raises and clears this a lot, so reuse a cached instance
+    // when `py_next()` is the direct consumer, user code never sees it then
+    bool is_internal = vm->is_in_next && vm->next_frame == vm->top_frame;
+    if(!is_internal || !py_isnil(&vm->curr_exception)) {
+        bool ok = py_tpcall(tp_StopIteration, 0, NULL);
+        if(!ok) return false;
+        return py_raise(py_retval());
+    }
+    if(py_isnil(&vm->stop_iteration)) {
+        bool ok = py_tpcall(tp_StopIteration, 0, NULL);
+        if(!ok) return false;
+        vm->stop_iteration = *py_retval();
+    }
+    BaseException* ud = py_touserdata(&vm->stop_iteration);
+    BaseException__clear_stacktrace(ud);
+    py_newnil(&ud->inner_exc);
+    return py_raise(&vm->stop_iteration);
+}
@@ -350,45 +350,97 @@ static bool list_insert(int argc, py_Ref argv) {
     return true;
 }
 
-static int lt_with_key(py_TValue* a, py_TValue* b, py_TValue* key) {
-    if(!key) return py_less(a, b);
-    VM* vm = pk_current_vm;
-    // project a
-    py_push(key);
-    py_pushnil();
-    py_push(a);
-    if(!py_vectorcall(1, 0)) return -1;
-    py_push(py_retval());
-    // project b
-    py_push(key);
-    py_pushnil();
-    py_push(b);
-    if(!py_vectorcall(1, 0)) return -1;
-    py_push(py_retval());
-    // binary op
-    bool ok = pk_stack_binaryop(vm, __lt__, __gt__);
-    if(!ok) return -1;
-    py_shrink(2);
-    return py_bool(py_retval());
+static int list__lt_int(const void* a, const void* b, void* extra) {
+    return ((const py_TValue*)a)->_i64 < ((const py_TValue*)b)->_i64;
 }
 
-// sort(self, key=None, reverse=False)
-static bool list_sort(int argc, py_Ref argv) {
-    List* self = py_touserdata(py_arg(0));
+static int list__lt_float(const void* a, const void* b, void* extra) {
+    return ((const py_TValue*)a)->_f64 < ((const py_TValue*)b)->_f64;
+}
 
-    py_Ref key = py_arg(1);
-    if(py_isnone(key)) key = NULL;
+static int list__lt_str(const void* a, const void* b, void* extra) {
+    return c11_sv__cmp(py_tosv((py_Ref)a), py_tosv((py_Ref)b)) < 0;
+}
 
-    bool ok = c11__stable_sort(self->data,
-                               self->length,
-                               sizeof(py_TValue),
-                               (int (*)(const void*, const void*, void*))lt_with_key,
-                               key);
-    if(!ok) return false;
+static int list__lt_object(const void* a, const void* b, void* extra) {
+    return py_less((py_Ref)a, (py_Ref)b);
+}
 
+// choose a native comparison if all keys have the same builtin type
+static int (*list__select_lt(py_TValue* keys, int length, int stride))(const void*,
+                                                                       const void*,
+                                                                       void*) {
+    if(length == 0) return list__lt_object;
+    py_Type type = keys[0].type;
+    if(type != tp_int && type != tp_float && type != tp_str) return list__lt_object;
+    for(int i = 1; i < length; i++) {
+        if(keys[i * stride].type != type) return list__lt_object;
+    }
+    if(type == tp_int) return list__lt_int;
+    if(type == tp_float) return list__lt_float;
+    return list__lt_str;
+}
+
+bool pk_list__sort(py_Ref self, py_Ref key, bool reverse) {
+    List* list = py_touserdata(self);
+    int length = list->length;
+    if(length < 2) return true;
+    py_TValue* data = list->data;
+
+    // homogeneous builtin items can be sorted in place since no python code is involved
+    if(key == NULL) {
+        int (*f_lt)(const void*, const void*, void*) = list__select_lt(data, length, 1);
+        if(f_lt != list__lt_object) {
+            // reverse before and after sorting to keep equal items in their original order
+            if(reverse) c11__reverse(py_TValue, list);
+            c11__stable_sort(data, length, sizeof(py_TValue), f_lt, NULL);
+            if(reverse) c11__reverse(py_TValue, list);
+            return true;
+        }
+    }
+
+    /* Sort a decorated copy of `[key(x), x]` pairs (or just `[x]` without a key) held by a
+     * temporary list, so every key is computed only once and `self` can be safely mutated by
+     * python code during the sort. */
+    int stride = key ? 2 : 1;
+    py_Ref tmp = py_pushtmp();
+    py_newlistn(tmp, length * stride);
+    py_TValue* items = py_list_data(tmp);
+    for(int i = 0; i < length; i++) {
+        int j = reverse ? length - 1 - i : i;
+        items[i * stride] = data[j];
+        items[i * stride + stride - 1] = data[j];
+    }
+    if(key) {
+        for(int i = 0; i < length; i++) {
+            if(!py_call(key, 1, &items[i * 2 + 1])) {
+                py_pop();
+                return false;
+            }
+            items[i * 2] = *py_retval();
+        }
+    }
+
+    int (*f_lt)(const void*, const void*, void*) = list__select_lt(items, length, stride);
+    bool ok = c11__stable_sort(items, length, stride * sizeof(py_TValue), f_lt, NULL);
+    if(ok && list->length != length) ok = ValueError("list modified during sort");
+    if(ok) {
+        data = list->data;
+        for(int i = 0; i < length; i++) {
+            int j = reverse ? length - 1 - i : i;
+            data[j] = items[i * stride + stride - 1];
+        }
+    }
+    py_pop();
+    return ok;
+}
+
+// sort(self, key=None, reverse=False)
+static bool list_sort(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(2, tp_bool);
-    bool reverse = py_tobool(py_arg(2));
-    if(reverse) c11__reverse(py_TValue, self);
+    py_Ref key = py_arg(1);
+    if(py_isnone(key)) key = NULL;
+    if(!pk_list__sort(py_arg(0), key, py_tobool(py_arg(2)))) return false;
     py_newnone(py_retval());
     return true;
 }
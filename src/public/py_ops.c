@@ -2,6 +2,7 @@
 #include "pocketpy/interpreter/bindings.h"
 #include "pocketpy/interpreter/vm.h"
 #include "pocketpy/objects/base.h"
+#include "pocketpy/objects/exception.h"
 #include "pocketpy/pocketpy.h"
 
 bool py_isidentical(py_Ref lhs, py_Ref rhs) {
@@ -76,9 +77,8 @@ bool py_iter(py_Ref val) {
     return py_call(tmp, 1, val);
 }
 
-int py_next(py_Ref val) {
-    VM* vm = pk_current_vm;
-
+// 1 if an item is in `py_retval()`, 0 if an exception is raised, -1 if `val` is not an iterator
+static int pk_next__dispatch(py_Ref val) {
     switch(val->type) {
         case tp_generator:
             if(generator__next__(1, val)) return 1;
@@ -101,6 +101,21 @@ int py_next(py_Ref val) {
         case tp_str_iterator:
             if(str_iterator__next__(1, val)) return 1;
             break;
+        case tp_map:
+            if(map__next__(1, val)) return 1;
+            break;
+        case tp_filter:
+            if(filter__next__(1, val)) return 1;
+            break;
+        case tp_zip:
+            if(zip__next__(1, val)) return 1;
+            break;
+        case tp_enumerate:
+            if(enumerate__next__(1, val)) return 1;
+            break;
+        case tp_deque_iterator:
+            if(deque_iterator__next__(1, val)) return 1;
+            break;
         default: {
             py_Ref tmp = py_tpfindmagic(val->type, __next__);
             if(!tmp) {
@@ -111,9 +126,34 @@ int py_next(py_Ref val) {
             break;
         }
     }
+    return 0;
+}
+
+int py_next(py_Ref val) {
+    VM* vm = pk_current_vm;
+    // `StopIteration()` may raise the cached instance for this frame, since it is consumed below
+    py_Frame* prev_frame = vm->next_frame;
+    bool prev_is_in_next = vm->is_in_next;
+    // an exception being handled by the caller, it is current again once iteration stops
+    py_TValue prev_exc = vm->curr_exception;
+    bool prev_is_exc_handled = vm->is_curr_exc_handled;
+    // `py_raise()` chains onto it, which must not survive a consumed StopIteration
+    py_TValue prev_inner_exc = *py_NIL();
+    if(!py_isnil(&prev_exc)) prev_inner_exc = ((BaseException*)py_touserdata(&prev_exc))->inner_exc;
+    vm->next_frame = vm->top_frame;
+    vm->is_in_next = true;
+    int res = pk_next__dispatch(val);
+    vm->next_frame = prev_frame;
+    vm->is_in_next = prev_is_in_next;
+    if(res != 0) return res;
     if(vm->curr_exception.type == tp_StopIteration) {
         vm->last_retval = vm->curr_exception;
         py_clearexc(NULL);
+        vm->curr_exception = prev_exc;
+        vm->is_curr_exc_handled = prev_is_exc_handled;
+        if(!py_isnil(&prev_exc)) {
+            ((BaseException*)py_touserdata(&prev_exc))->inner_exc = prev_inner_exc;
+        }
         return 0;
     }
     return -1;
@@ -180,6 +220,10 @@ bool py_getattr(py_Ref self, py_Name name) {
                 return true;
             }
             default: {
+                if(name != __new__ && pk_typeinfo(cls_var->type)->is_method_like) {
+                    py_newboundmethod(py_retval(), self, cls_var);
+                    return true;
+                }
             __STATIC_NEW:
                 py_assign(py_retval(), cls_var);
                 return true;
@@ -287,4 +331,49 @@ int py_equal(py_Ref lhs, py_Ref rhs) {
 int py_less(py_Ref lhs, py_Ref rhs) {
     if(!py_lt(lhs, rhs)) return -1;
     return py_bool(py_retval());
+}
+
+// three-way comparison of two int, float or str values, false if not natively comparable
+static bool pk_cmp_native(py_Ref lhs, py_Ref rhs, int* out) {
+    if(lhs->type == tp_int && rhs->type == tp_int) {
+        *out = (lhs->_i64 > rhs->_i64) - (lhs->_i64 < rhs->_i64);
+        return true;
+    }
+    if(lhs->type == tp_str && rhs->type == tp_str) {
+        int res = c11_sv__cmp(py_tosv(lhs), py_tosv(rhs));
+        *out = (res > 0) - (res < 0);
+        return true;
+    }
+    bool lhs_num = lhs->type == tp_int || lhs->type == tp_float;
+    bool rhs_num = rhs->type == tp_int || rhs->type == tp_float;
+    if(!lhs_num || !rhs_num) return false;
+    double a = lhs->type == tp_int ? (double)lhs->_i64 : lhs->_f64;
+    double b = rhs->type == tp_int ? (double)rhs->_i64 : rhs->_f64;
+    if(a != a || b != b) return false;  // nan is not ordered
+    *out = (a > b) - (a < b);
+    return true;
+}
+
+int pk_less(py_Ref lhs, py_Ref rhs) {
+    int cmp;
+    if(pk_cmp_native(lhs, rhs, &cmp)) return cmp < 0;
+    if(lhs->type != tp_tuple || rhs->type != tp_tuple) return py_less(lhs, rhs);
+    // same order of `<` and `==` as `tuple.__lt__`
+    int lhs_length = py_tuple_len(lhs);
+    int rhs_length = py_tuple_len(rhs);
+    py_TValue* p0 = py_tuple_data(lhs);
+    py_TValue* p1 = py_tuple_data(rhs);
+    int length = c11__min(lhs_length, rhs_length);
+    for(int i = 0; i < length; i++) {
+        if(pk_cmp_native(p0 + i, p1 + i, &cmp)) {
+            if(cmp != 0) return cmp < 0;
+            continue;
+        }
+        int res = pk_less(p0 + i, p1 + i);
+        if(res != 0) return res;
+        res = py_equal(p0 + i, p1 + i);
+        if(res == -1) return -1;
+        if(res == 0) return 0;
+    }
+    return lhs_length < rhs_length;
 }
\ No newline at end of file
@@ -2,14 +2,9 @@
 
 #include "pocketpy/common/utils.h"
 #include "pocketpy/objects/object.h"
+#include "pocketpy/objects/iterator.h"
 #include "pocketpy/interpreter/vm.h"
 
-typedef struct Range {
-    py_i64 start;
-    py_i64 stop;
-    py_i64 step;
-} Range;
-
 static bool range__new__(int argc, py_Ref argv) {
     Range* ud = py_newobject(py_retval(), tp_range, 0, sizeof(Range));
     switch(argc - 1) {  // skip cls
@@ -54,11 +49,6 @@ py_Type pk_range__register() {
     return type;
 }
 
-typedef struct RangeIterator {
-    Range range;
-    py_i64 current;
-} RangeIterator;
-
 static bool range_iterator__new__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     PY_CHECK_ARG_TYPE(1, tp_range);
@@ -4,6 +4,7 @@
 #include "pocketpy/common/utils.h"
 #include "pocketpy/objects/object.h"
 #include "pocketpy/interpreter/vm.h"
+#include "pocketpy/interpreter/format.h"
 #include "pocketpy/common/sstream.h"
 
 void py_newstr(py_OutRef out, const char* data) { py_newstrv(out, (c11_sv){data, strlen(data)}); }
@@ -470,6 +471,13 @@ static bool str_encode(int argc, py_Ref argv) {
     return true;
 }
 
+// format(self, *args, **kwargs)
+static bool str_format(int argc, py_Ref argv) {
+    py_Ref args = py_arg(1);
+    py_Ref kwargs = py_dict_len(py_arg(2)) > 0 ? py_arg(2) : NULL;
+    return pk_str_format(py_tosv(argv), py_tuple_len(args), py_tuple_data(args), kwargs);
+}
+
 py_Type pk_str__register() {
     py_Type type = pk_newtype("str", tp_object, NULL, NULL, false, true);
     // no need to dtor because the memory is controlled by the object
@@ -510,6 +518,7 @@ py_Type pk_str__register() {
     py_bindmethod(tp_str, "find", str_find);
     py_bindmethod(tp_str, "index", str_index);
     py_bindmethod(tp_str, "encode", str_encode);
+    py_bind(py_tpobject(tp_str), "format(self, *args, **kwargs)", str_format);
     return type;
 }
 
@@ -542,7 +551,13 @@ static bool bytes__new__(int argc, py_Ref argv) {
     if(argc > 2) return TypeError("bytes() takes at most 1 argument");
     py_TValue* p;
     int length = pk_arrayview(&argv[1], &p);
-    if(length == -1) return TypeError("bytes() argument must be a list or tuple");
+    if(length == -1) {
+        py_Buffer buf;
+        if(!py_getbuffer(&argv[1], &buf, false)) return false;
+        unsigned char* data = py_newbytes(py_retval(), buf.size);
+        if(buf.size > 0) memcpy(data, buf.data, buf.size);
+        return true;
+    }
     unsigned char* data = py_newbytes(py_retval(), length);
     for(int i = 0; i < length; i++) {
         if(!py_checktype(&p[i], tp_int)) return false;
@@ -630,13 +645,19 @@ static bool bytes__hash__(int argc, py_Ref argv) {
 static bool bytes__add__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     c11_bytes* self = py_touserdata(&argv[0]);
-    if(py_arg(1)->type != tp_bytes) {
-        py_newnotimplemented(py_retval());
-    } else {
+    if(py_arg(1)->type == tp_bytes) {
         c11_bytes* other = py_touserdata(&argv[1]);
         unsigned char* p = py_newbytes(py_retval(), self->size + other->size);
         memcpy(p, self->data, self->size);
         memcpy(p + self->size, other->data, other->size);
+    } else if(py_arg(1)->type == tp_bytearray || py_arg(1)->type == tp_memoryview) {
+        py_Buffer other;
+        if(!py_getbuffer(&argv[1], &other, false)) return false;
+        unsigned char* p = py_newbytes(py_retval(), self->size + other.size);
+        memcpy(p, self->data, self->size);
+        if(other.size > 0) memcpy(p + self->size, other.data, other.size);
+    } else {
+        py_newnotimplemented(py_retval());
     }
     return true;
 }
@@ -649,6 +670,16 @@ static bool bytes_decode(int argc, py_Ref argv) {
     return true;
 }
 
+static bool bytes__getbuffer(py_Ref self, py_Buffer* out) {
+    c11_bytes* ud = py_touserdata(self);
+    out->data = ud->data;
+    out->size = ud->size;
+    out->itemsize = 1;
+    out->format = 'B';
+    out->readonly = true;
+    return true;
+}
+
 static bool bytes__len__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_bytes* self = py_touserdata(&argv[0]);
@@ -670,6 +701,8 @@ py_Type pk_bytes__register() {
     py_bindmagic(tp_bytes, __len__, bytes__len__);
 
     py_bindmethod(tp_bytes, "decode", bytes_decode);
+
+    py_tphookbuffer(tp_bytes, bytes__getbuffer);
     return type;
 }
 
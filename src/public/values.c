@@ -128,7 +128,7 @@ py_Name py_newfunction(py_OutRef out,
     // fn(a, b, *c, d=1) -> None
     CodeObject code;
     SourceData_ source = SourceData__rcnew(buffer, "<bind>", EXEC_MODE, false);
-    Error* err = pk_compile(source, &code);
+    Error* err = pk_compile(source, 0, &code);
     if(err || code.func_decls.length != 1) {
         c11__abort("py_newfunction(): invalid signature '%s'", sig);
     }
@@ -0,0 +1,78 @@
+#include "pocketpy.h"
+#include "pocketpy/common/threads.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Multi-threaded stress benchmark for the name table.
+// Build with: bash build_g.sh src2/name_stress.c
+
+#define NUM_THREADS 8
+#define NUM_NAMES 200000
+#define NUM_ROUNDS 10
+
+static py_Name results[NUM_THREADS][NUM_NAMES];
+
+static c11_thrd_retval_t worker(void* arg) {
+    int tid = (int)(intptr_t)arg;
+    char buf[32];
+    for(int round = 0; round < NUM_ROUNDS; round++) {
+        for(int i = 0; i < NUM_NAMES; i++) {
+            // every thread interns the same names in a different order
+            int k = (int)(((long long)i * 7919 + tid * 12345) % NUM_NAMES);
+            snprintf(buf, sizeof(buf), "name_%d", k);
+            results[tid][k] = py_name(buf);
+        }
+    }
+    return (c11_thrd_retval_t)0;
+}
+
+static double now() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+    py_initialize();
+
+    c11_thrd_t threads[NUM_THREADS];
+    double t0 = now();
+    for(int i = 0; i < NUM_THREADS; i++) {
+        if(!c11_thrd_create(&threads[i], worker, (void*)(intptr_t)i)) {
+            printf("failed to create thread %d\n", i);
+            return 1;
+        }
+    }
+    for(int i = 0; i < NUM_THREADS; i++) {
+        c11_thrd_join(threads[i]);
+    }
+    double t1 = now();
+
+    for(int i = 0; i < NUM_NAMES; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "name_%d", i);
+        py_Name expected = py_name(buf);
+        for(int tid = 0; tid < NUM_THREADS; tid++) {
+            if(results[tid][i] != expected) {
+                printf("mismatch: thread %d, %s\n", tid, buf);
+                return 1;
+            }
+        }
+        if(strcmp(py_name2str(expected), buf) != 0) {
+            printf("corrupted: %s\n", buf);
+            return 1;
+        }
+    }
+
+    long long total = (long long)NUM_THREADS * NUM_NAMES * NUM_ROUNDS;
+    printf("%d threads, %lld lookups: %.3fs (%.1f ns/op)\n",
+           NUM_THREADS,
+           total,
+           t1 - t0,
+           (t1 - t0) * 1e9 / total);
+
+    py_finalize();
+    return 0;
+}
@@ -224,6 +224,39 @@ except ValueError:
 assert "{{{}xxx{}x}}".format(1, 2) == "{1xxx2x}"
 assert "{{abc}}".format() == "{abc}"
 
+# format specs and conversions
+assert "{:>8.2f}|{:<5}|{:^7}|{!r}".format(3.14159, 'ab', 12, 'x') == "    3.14|ab   |  12   |'x'"
+assert "{name:*^9}".format(name='mid') == '***mid***'
+assert "{0:d}-{1:s}-{0}".format(5, 's') == '5-s-5'
+assert "{} and {x}".format(1, x=2) == '1 and 2'
+assert "{}{}".format(None, 1.5) == 'None1.5'
+assert "{0}".format(0) == '0'
+
+class FormatMe:
+    def __str__(self):
+        return "<{}>".format(type(self).__name__)
+
+assert "{} {}".format(FormatMe(), FormatMe()) == "<FormatMe> <FormatMe>"
+
+for bad in ["{", "{0}{}", "{}{0}", "{:.2d}", "{!x}"]:
+    try:
+        bad.format(1, 2)
+        exit(1)
+    except ValueError:
+        pass
+
+try:
+    "{3}".format(1)
+    exit(1)
+except IndexError:
+    pass
+
+try:
+    "{k}".format(1)
+    exit(1)
+except KeyError:
+    pass
+
 # test f-string
 assert f"{1+2}" == "3"
 # assert f"{1, 2, 3}" == "(1, 2, 3)"
@@ -160,6 +160,35 @@ b = [(1, 2), (3, 3), (5, 1)]
 b.sort(key=lambda x:x[1])
 assert b == [(5, 1), (1, 2), (3,3)]
 
+# sort is stable, also with reverse=True
+b = [(1, 'a'), (0, 'b'), (1, 'c'), (0, 'd')]
+assert sorted(b, key=lambda x: x[0]) == [(0, 'b'), (0, 'd'), (1, 'a'), (1, 'c')]
+assert sorted(b, key=lambda x: x[0], reverse=True) == [(1, 'a'), (1, 'c'), (0, 'b'), (0, 'd')]
+
+# key is called once per item
+calls = []
+def key(x):
+    calls.append(x)
+    return -x
+assert sorted(range(100), key=key) == list(range(99, -1, -1))
+assert len(calls) == 100
+
+# runs, floats, strings and mixed types
+a = list(range(500)) + list(range(500, 0, -1))
+assert sorted(a) == sorted(a, key=lambda x: x)
+assert sorted([2.5, -1.0, 3.25]) == [-1.0, 2.5, 3.25]
+assert sorted(['b', 'ab', 'a', '']) == ['', 'a', 'ab', 'b']
+assert sorted([2, 1.5, 0, -0.5]) == [-0.5, 0, 1.5, 2]
+
+# errors leave the list unchanged
+a = [3, 'a', 1]
+try:
+    a.sort()
+    exit(1)
+except TypeError:
+    pass
+assert a == [3, 'a', 1]
+
 # test cyclic reference
 # a = []
 # a.append(0)
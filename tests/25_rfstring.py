@@ -130,4 +130,24 @@ assert f'{A():10}' == 'A         '
 assert f'{A():10}' == 'A         '
 
 a = ['1', '2', '3']
-assert f'a = {'\n'.join(a)}' == 'a = 1\n2\n3'
\ No newline at end of file
+assert f'a = {'\n'.join(a)}' == 'a = 1\n2\n3'
+# specs are parsed at compile time, errors are raised when formatting
+b = 5
+assert f'{b:d}' == '5'
+assert f'{b:d}|{b}|{b!r:>3}|{1.5}|{True}' == '5|5|  5|1.5|True'
+assert f'{"测试":>4}|' == '  测试|'
+assert f'{None!r:>6}' == '  None'
+for i in range(3):
+    assert f'{i:>2}{i:.1f}' == f' {i}{i}.0'
+
+try:
+    f'{b:.2d}'
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    f'{"abc":d}'
+    exit(1)
+except TypeError:
+    pass
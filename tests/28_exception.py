@@ -226,3 +226,49 @@ def finally_return():
 assert finally_return() == 1
 
 
+
+# handlers restore the stack depth of their try block
+class Ctx:
+    def __enter__(self): return self
+    def __exit__(self, *args): pass
+
+def gen_in_blocks():
+    for i in range(3):
+        with Ctx():
+            for j in range(2):
+                try:
+                    yield i * j
+                    if j: raise ValueError
+                except ValueError:
+                    pass
+
+assert list(gen_in_blocks()) == [0, 0, 0, 1, 0, 2]
+
+for a in [1]:
+    for b in [2]:
+        try:
+            try:
+                {}[0]
+            finally:
+                pass
+        except KeyError:
+            res = (a, b)
+assert res == (1, 2)
+
+for q in range(2):
+    class ClassBody:
+        try:
+            try:
+                for z in [1]:
+                    with Ctx():
+                        try:
+                            raise KeyError
+                        except KeyError:
+                            pass
+                raise KeyError
+            except KeyError:
+                pass
+            raise IndexError
+        except IndexError:
+            w = q
+    assert ClassBody.w == q
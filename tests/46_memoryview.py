@@ -0,0 +1,219 @@
+# bytearray
+a = bytearray()
+assert len(a) == 0
+assert a == b''
+assert bytearray(3) == b'\x00\x00\x00'
+assert bytearray([1, 2, 3]) == bytes([1, 2, 3])
+assert bytearray(b'abc') == b'abc'
+assert b'abc' == bytearray(b'abc')
+assert bytearray(b'abc') != b'abd'
+assert repr(bytearray(b'ab')) == "bytearray(b'ab')"
+
+a = bytearray(b'hello')
+a[0] = ord('j')
+assert a == b'jello'
+assert a[1] == ord('e')
+assert a[-1] == ord('o')
+assert a[1:3] == b'el'
+assert isinstance(a[1:3], bytearray)
+assert a[::-1] == b'ollej'
+a[1:3] = b'EEEE'
+assert a == b'jEEEElo'
+a[1:5] = [101]
+assert a == b'jelo'
+a[::2] = b'JL'
+assert a == b'JeLo'
+del a[0]
+assert a == b'eLo'
+del a[1:]
+assert a == b'e'
+a.append(33)
+a.extend(b'xy')
+a.extend([1, 2])
+assert a == b'e!xy\x01\x02'
+a.extend(a)
+assert a == b'e!xy\x01\x02e!xy\x01\x02'
+a[0:0] = a
+assert len(a) == 24
+a.clear()
+assert len(a) == 0
+assert bytearray('测试'.encode()).decode() == '测试'
+assert bytearray(b'ab') + b'cd' == b'abcd'
+assert isinstance(bytearray(b'ab') + b'cd', bytearray)
+assert b'ab' + bytearray(b'cd') == b'abcd'
+assert isinstance(b'ab' + bytearray(b'cd'), bytes)
+assert bytes(bytearray(b'xyz')) == b'xyz'
+
+try:
+    a.append(256)
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    bytearray(2)[0] = -1
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    bytearray(4)[::2] = b'abc'
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    hash(bytearray())
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    bytearray('abc')
+    exit(1)
+except TypeError:
+    pass
+
+# memoryview of bytes is readonly
+m = memoryview(b'abcdef')
+assert len(m) == 6
+assert m.readonly
+assert m.format == 'B'
+assert m.itemsize == 1
+assert m.nbytes == 6
+assert m.obj == b'abcdef'
+assert m[0] == ord('a')
+assert m[-1] == ord('f')
+assert m[1:4].tobytes() == b'bcd'
+assert m[1:4] == b'bcd'
+assert m[4:2].tobytes() == b''
+assert m.tolist() == [97, 98, 99, 100, 101, 102]
+assert bytes(m[2:]) == b'cdef'
+assert b'xy' + m[:2] == b'xyab'
+
+try:
+    m[0] = 1
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    m[::2]
+    exit(1)
+except ValueError:
+    pass
+
+# memoryview of bytearray writes through
+a = bytearray(b'abcdef')
+m = memoryview(a)
+assert not m.readonly
+m[0] = ord('A')
+assert a == b'Abcdef'
+sub = m[2:5]
+sub[0] = ord('C')
+assert a == b'AbCdef'
+sub[:] = b'xyz'
+assert a == b'Abxyzf'
+m[1:3] = m[0:2]
+assert a == b'AAbyzf'
+assert memoryview(sub).obj is a
+
+try:
+    sub[:] = b'xy'
+    exit(1)
+except ValueError:
+    pass
+
+# views see a resized bytearray, and fail once it has shrunk
+a.extend(('0123456789' * 10).encode())
+assert sub.tobytes() == b'byz'
+a.clear()
+try:
+    sub.tobytes()
+    exit(1)
+except ValueError:
+    pass
+
+# cast
+a = bytearray(8)
+m = memoryview(a).cast('i')
+assert len(m) == 2
+assert m.itemsize == 4
+assert m.format == 'i'
+m[1] = -2
+assert m.tolist() == [0, -2]
+assert memoryview(a).cast('B')[4] == 254
+assert m.cast('B').nbytes == 8
+m = memoryview(a).cast('h')
+m[0] = 32767
+assert m[0] == 32767
+try:
+    m[0] = 32768
+    exit(1)
+except ValueError:
+    pass
+try:
+    memoryview(bytearray(3)).cast('i')
+    exit(1)
+except TypeError:
+    pass
+try:
+    memoryview(a).cast('q')
+    exit(1)
+except ValueError:
+    pass
+m = memoryview(bytearray(8)).cast('d')
+m[0] = 1.5
+assert m[0] == 1.5
+assert m == memoryview(bytearray(m)).cast('d')
+assert m != memoryview(bytearray(m))
+assert memoryview(bytearray([1, 2])) == memoryview(bytearray([1, 0, 2, 0])).cast('h')
+
+try:
+    memoryview(123)
+    exit(1)
+except TypeError:
+    pass
+
+# typed array2d and vec arrays export their cells
+from array2d import array2d
+a = array2d(3, 2, default=0, dtype='int32')
+m = memoryview(a)
+assert m.format == 'i'
+assert len(m) == 6
+m[4] = 7
+assert a[1, 1] == 7
+a[2, 1] = 9
+assert m[5] == 9
+assert memoryview(array2d(2, 2, default=True, dtype='bool')).tolist() == [True] * 4
+f = array2d(2, 1, default=0.5, dtype='float32')
+assert memoryview(f).tolist() == [0.5, 0.5]
+assert len(bytes(f)) == 8
+
+try:
+    memoryview(array2d(2, 2))
+    exit(1)
+except TypeError:
+    pass
+
+from vmath import vec2, vec2_array, vec3_array
+v = vec2_array(3)
+m = memoryview(v)
+assert m.format == 'f'
+assert len(m) == 6
+m[2] = 1.0
+m[3] = 2.0
+assert v[1] == vec2(1, 2)
+assert memoryview(vec3_array(2)).nbytes == 24
+
+# pickle copies a bytearray
+import pickle
+a = pickle.loads(pickle.dumps(bytearray(b'pkl')))
+assert isinstance(a, bytearray)
+assert a == b'pkl'
+
+# base64 reads any buffer
+import base64
+assert base64.b64encode(bytearray(b'hello')) == b'aGVsbG8='
+assert base64.b64encode(memoryview(b'xhello')[1:]) == b'aGVsbG8='
+assert base64.b64decode(bytearray(b'aGVsbG8=')) == b'hello'
@@ -41,4 +41,28 @@ insort_right(a, 5)
 assert a == [0, 0, 1, 1, 1, 2, 5, 5, 6, 7, 8, 16, 22, 23, 23]
 
 insort_right(a, 1)
-assert a == [0, 0, 1, 1, 1, 1, 2, 5, 5, 6, 7, 8, 16, 22, 23, 23]
\ No newline at end of file
+assert a == [0, 0, 1, 1, 1, 1, 2, 5, 5, 6, 7, 8, 16, 22, 23, 23]
+from bisect import bisect, insort
+
+# lo, hi and tuples
+a = [1, 2, 2, 2, 3]
+assert bisect_left(a, 2, 2) == 2
+assert bisect_right(a, 2, 0, 2) == 2
+assert bisect(a, 2) == 4
+assert bisect_left((1.5, 2.5, 3.5), 3) == 2
+assert bisect_right(['a', 'c', 'e'], 'c') == 2
+try:
+    bisect_left(a, 1, -1)
+    exit(1)
+except ValueError:
+    pass
+
+# key
+records = [('a', 1), ('b', 3), ('c', 5)]
+key = lambda r: r[1]
+assert bisect_left(records, 3, key=key) == 1
+assert bisect_right(records, 3, key=key) == 2
+insort(records, ('d', 4), key=key)
+assert records == [('a', 1), ('b', 3), ('d', 4), ('c', 5)]
+insort_left(records, ('e', 3), key=key)
+assert records[1] == ('e', 3)
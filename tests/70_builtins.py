@@ -49,4 +49,58 @@ assert not all([True, False])
 assert not all([False, False])
 
 assert list(enumerate([1,2,3])) == [(0,1), (1,2), (2,3)]
-assert list(enumerate([1,2,3], 1)) == [(1,1), (2,2), (3,3)]
\ No newline at end of file
+assert list(enumerate([1,2,3], 1)) == [(1,1), (2,2), (3,3)]
+# sum
+assert sum([]) == 0
+assert sum([1, 2, 3]) == 6
+assert sum((1, 2.5)) == 3.5
+assert sum(range(101)) == 5050
+assert sum(range(10, 0, -3)) == 22
+assert sum(range(5), 10) == 20
+assert sum([[1], [2]], []) == [1, 2]
+assert sum(iter([x * x for x in range(4)])) == 14
+
+# min / max
+assert min(3, 1, 2) == 1
+assert max(3, 1, 2) == 3
+assert min([2.5, -1, 7]) == -1
+assert max((2.5, -1, 7)) == 7
+assert min('bca') == 'a'
+assert max(iter([1, 5, 3])) == 5
+assert min([3, -4, 2], key=abs) == 2
+assert max([3, -4, 2], key=abs) == -4
+assert max([1, 3, 3], key=lambda x: 0) == 1
+try:
+    min([])
+    exit(1)
+except ValueError:
+    pass
+try:
+    max()
+    exit(1)
+except TypeError:
+    pass
+
+# map / filter / zip / enumerate
+assert list(map(lambda x: x * 2, [1, 2, 3])) == [2, 4, 6]
+assert list(map(lambda x, y: x + y, [1, 2, 3], (10, 20))) == [11, 22]
+assert list(filter(lambda x: x % 2, range(6))) == [1, 3, 5]
+assert list(filter(None, [0, 1, '', 'a', None])) == [1, 'a']
+assert list(zip([1, 2, 3], 'ab')) == [(1, 'a'), (2, 'b')]
+assert list(zip([1, 2], [3, 4], [5, 6])) == [(1, 3, 5), (2, 4, 6)]
+assert list(zip()) == []
+assert list(enumerate('ab', 5)) == [(5, 'a'), (6, 'b')]
+assert isinstance(map(int, []), map)
+z = zip(range(3), range(3))
+assert iter(z) is z
+assert next(z) == (0, 0)
+assert list(z) == [(1, 1), (2, 2)]
+
+# any / all stop early
+def gen():
+    yield 1
+    yield 0
+    exit(1)
+assert not all(gen())
+assert any(iter([0, 2]))
+assert list(enumerate('ab', start=5)) == [(5, 'a'), (6, 'b')]
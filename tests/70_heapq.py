@@ -6,4 +6,44 @@ b = sorted(a)
 
 heapify(a)
 for x in b:
-    assert heappop(a) == x
\ No newline at end of file
+    assert heappop(a) == x
+from heapq import heapreplace, heappushpop
+
+# tuples, floats and strings
+h = []
+for i, x in enumerate([5.5, 1, 3.25, 8, 2, 7.0]):
+    heappush(h, (x, str(i)))
+assert [heappop(h)[0] for _ in range(6)] == [1, 2, 3.25, 5.5, 7.0, 8]
+h = ['d', 'b', 'a', 'c']
+heapify(h)
+assert heapreplace(h, 'e') == 'a'
+assert heappushpop(h, 'a') == 'a'
+assert heappushpop(h, 'z') == 'b'
+assert sorted(h) == ['c', 'd', 'e', 'z']
+assert heappushpop([], 1) == 1
+try:
+    heappop([])
+    exit(1)
+except IndexError:
+    pass
+
+# fallback to __lt__
+class Task:
+    def __init__(self, p):
+        self.p = p
+    def __lt__(self, other):
+        return self.p < other.p
+
+h = []
+for p in [3, 1, 2]:
+    heappush(h, (p, Task(p)))
+assert [heappop(h)[1].p for _ in range(3)] == [1, 2, 3]
+h = [Task(p) for p in [5, 3, 9, 1]]
+heapify(h)
+assert [heappop(h).p for _ in range(4)] == [1, 3, 5, 9]
+
+try:
+    heappush([1, 2], 'a')
+    exit(1)
+except TypeError:
+    pass
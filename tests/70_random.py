@@ -70,3 +70,59 @@ assert c == randint(50, 100)
 
 import random
 assert random.Random(7).randint(1, 100) == a
+
+# engines
+assert random.Random().engine == 'mt19937'
+x = random.Random(7, engine='xoshiro256**')
+assert x.engine == 'xoshiro256**'
+assert x.random() == random.Random(7, 'xoshiro256**').random()
+x.seed(1)
+assert x.random() == 0.7029218331588505
+
+try:
+    random.Random(7, 'pcg')
+    exit(1)
+except ValueError:
+    pass
+
+counts = [0] * 6
+for i in x.randints(1, 6, 6000):
+    counts[i - 1] += 1
+for c in counts:
+    assert 850 < c < 1150, counts
+assert type(x.randint(-9223372036854775807 - 1, 9223372036854775807)) is int
+
+random.seed(3, engine='xoshiro256**')
+a = random.random()
+random.seed(3)
+assert random.random() == a
+random.seed(7, engine='mt19937')
+assert randint(1, 100) == 16
+
+# bulk generation
+f = x.floats(100, -1.0, 1.0)
+assert len(f) == 100 and all([-1.0 <= v < 1.0 for v in f])
+assert x.randints(5, 5, 3) == [5, 5, 5]
+
+from array2d import array2d
+from vmath import vec2_array
+
+a = array2d(4, 4, dtype='int8')
+x.fill(a, -3, 3)
+assert a.min() >= -3 and a.max() <= 3
+a = array2d(4, 4, dtype='float32')
+x.fill(a)
+assert a.min() >= 0.0 and a.max() <= 1.0
+v = vec2_array(8)
+x.fill(v, 2.0, 3.0)
+assert all([2.0 <= p.x <= 3.0 and 2.0 <= p.y <= 3.0 for p in v])
+
+try:
+    x.fill(array2d(2, 2, dtype='int8'), 0, 1000)
+    exit(1)
+except ValueError:
+    pass
+
+# zero weights are never chosen
+assert x.choices([1, 2, 3], [1, 0, 0], k=20) == [1] * 20
+assert x.choices([1, 2, 3], cum_weights=[0, 0, 1], k=20) == [3] * 20
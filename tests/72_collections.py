@@ -516,3 +516,123 @@ d = deque()
 for i in range(100):
     d.append(1)
     gc.collect()
+
+# test maxlen
+d = deque(range(10), maxlen=3)
+assert list(d) == [7, 8, 9]
+assert d.maxlen == 3
+d.appendleft(6)
+assert list(d) == [6, 7, 8]
+d.extend([1, 2])
+assert list(d) == [8, 1, 2]
+assert repr(d) == 'deque([8, 1, 2], maxlen=3)'
+assert deque().maxlen is None
+assert len(deque([1, 2], maxlen=0)) == 0
+try:
+    d.insert(0, 1)
+    exit(1)
+except IndexError:
+    pass
+
+# test indexing, insert, remove, reverse
+d = deque(range(300))
+assert d[0] == 0 and d[-1] == 299 and d[150] == 150
+d[150] = 'x'
+assert d[150] == 'x'
+del d[150]
+assert d[150] == 151 and len(d) == 299
+d.insert(150, 150)
+assert list(d) == list(range(300))
+d.remove(299)
+assert d.index(200) == 200
+assert d.index(5, 3, 10) == 5
+try:
+    d.index(299)
+    exit(1)
+except ValueError:
+    pass
+d.reverse()
+assert list(d) == list(reversed(range(299)))
+
+# test mutation during iteration
+d = deque([1, 2, 3])
+try:
+    for x in d:
+        d.append(x)
+    exit(1)
+except RuntimeError:
+    pass
+
+class ClearOnRepr:
+    def __repr__(self):
+        d.clear()
+        return 'x'
+
+d = deque([ClearOnRepr(), 1, 2])
+try:
+    repr(d)
+    exit(1)
+except RuntimeError:
+    pass
+
+# scans walk the blocks in order across block boundaries
+d = deque(range(1000))
+d.appendleft(-1)
+assert d.count(999) == 1 and 500 in d and -2 not in d
+assert d.index(700, 600) == 701
+assert d == deque([-1] + list(range(1000)))
+assert repr(d).endswith('998, 999])')
+
+# test deque subclass and gc
+class MyDeque(deque):
+    pass
+
+d = MyDeque()
+for i in range(100):
+    d.append([i])
+    gc.collect()
+assert d[50] == [50]
+
+# test defaultdict
+a = defaultdict(lambda: 'x', [(1, 2)])
+assert a[1] == 2 and a[2] == 'x'
+assert a.default_factory() == 'x'
+b = a.copy()
+assert type(b) is defaultdict and b[3] == 'x'
+assert repr(defaultdict(None, {1: 2})) == 'defaultdict(None, {1: 2})'
+assert repr(defaultdict(int)) == "defaultdict(<class 'int'>, {})"
+try:
+    defaultdict(None)[1]
+    exit(1)
+except KeyError:
+    pass
+a = defaultdict(list)
+for i in range(100):
+    a[i % 7].append([i])
+    gc.collect()
+assert a[3][0] == [3]
+
+# test Counter
+c = Counter('abracadabra')
+assert isinstance(c, dict)
+assert c['a'] == 5 and c['z'] == 0
+assert 'z' not in c
+assert c.most_common(2) == [('a', 5), ('b', 2)]
+assert c.most_common() == [('a', 5), ('b', 2), ('r', 2), ('c', 1), ('d', 1)]
+assert c.most_common(0) == []
+assert c.total() == 11
+assert repr(c) == "Counter({'a': 5, 'b': 2, 'r': 2, 'c': 1, 'd': 1})"
+assert repr(Counter()) == 'Counter()'
+c.update(['a', 'z'])
+c.update({'b': 3})
+assert c['a'] == 6 and c['z'] == 1 and c['b'] == 5
+c.subtract('aab')
+assert c['a'] == 4 and c['b'] == 4
+assert sorted(Counter('aab').elements()) == ['a', 'a', 'b']
+assert type(c.copy()) is Counter and c.copy() == c
+c = Counter([random.randint(0, 50) for _ in range(1000)])
+mc = c.most_common()
+assert sum([n for _, n in mc]) == 1000
+for i in range(len(mc) - 1):
+    assert mc[i][1] >= mc[i+1][1]
+assert c.most_common(5) == mc[:5]
@@ -28,6 +28,108 @@ for i in range(100):
     ratio = test(gen_data())
     # print(f'compression ratio: {ratio:.2f}')
 
+# frame streaming
+def test_frame(data: bytes, level=0, dict=None, step=1000):
+    c = lz4.Compressor(level, dict)
+    compressed = b''
+    for i in range(0, len(data), step):
+        compressed += c.update(data[i:i+step])
+    compressed += c.flush()
+    assert compressed[:4] == b'\x04"M\x18'
+    d = lz4.Decompressor(dict)
+    res = b''
+    for i in range(0, len(compressed), 333):
+        res += d.update(compressed[i:i+333])
+    assert res == data and d.eof
+    return compressed
+
+test_frame(b'')
+test_frame(gen_data())
+for level in [-1, 0, 3, 12]:
+    test_frame(gen_data(), level)
+test_frame(('{"x": 1, "y": 2}' * 10).encode(), dict=b'{"x": 0, "y": 0}')
+
+# dictionaries
+zdict = ''.join([f'key{i}=value{i * 7};' for i in range(40)]).encode()
+data = zdict[100:400] + zdict[:200]
+with_dict = test_frame(data, dict=zdict)
+test_frame(data, level=9, dict=bytearray(zdict))
+assert len(with_dict) < len(test_frame(data)) // 2
+try:
+    lz4.Decompressor().update(with_dict)
+    exit(1)
+except ValueError:
+    pass
+test_frame(data, dict=b'')
+
+# flush without ending the frame
+c = lz4.Compressor()
+d = lz4.Decompressor()
+assert d.update(c.update(b'abc') + c.flush(False)) == b'abc'
+assert not d.eof
+assert d.update(c.update(b'def') + c.flush()) == b'def'
+assert d.eof
+
+try:
+    lz4.Decompressor().update(b'not a frame')
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    lz4.Compressor(13)
+    exit(1)
+except ValueError:
+    pass
+
+# buffers
+data = bytes([i % 7 for i in range(1000)])
+compressed = lz4.compress(bytearray(data))
+assert lz4.decompress(memoryview(compressed)) == data
+out = bytearray(1000)
+assert lz4.decompress_into(compressed, out) == 1000
+assert out == data
+out = bytearray(999)
+try:
+    lz4.decompress_into(compressed, out)
+    exit(1)
+except ValueError:
+    pass
+try:
+    lz4.decompress_into(compressed, bytes(1000))
+    exit(1)
+except TypeError:
+    pass
+c = lz4.Compressor()
+frame = c.update(memoryview(data)[:500]) + c.update(bytearray(data[500:])) + c.flush()
+assert lz4.Decompressor().update(bytearray(frame)) == data
+
+# files
+data = bytes([i % 251 for i in range(200000)])
+with open('72_lz4.tmp', 'wb') as f:
+    f.write(data)
+with open('72_lz4.tmp', 'rb') as src:
+    with open('72_lz4.tmp.lz4', 'wb') as dst:
+        lz4.compress_stream(src, dst, level=9)
+with open('72_lz4.tmp.lz4', 'rb') as src:
+    with open('72_lz4.tmp', 'wb') as dst:
+        lz4.decompress_stream(src, dst)
+with open('72_lz4.tmp', 'rb') as f:
+    assert f.read() == data
+zdict = data[:4096]
+with open('72_lz4.tmp', 'rb') as src:
+    with open('72_lz4.tmp.lz4', 'wb') as dst:
+        lz4.compress_stream(src, dst, dict=zdict)
+with open('72_lz4.tmp.lz4', 'rb') as src:
+    with open('72_lz4.tmp', 'wb') as dst:
+        lz4.decompress_stream(src, dst, dict=zdict)
+with open('72_lz4.tmp', 'rb') as f:
+    assert f.read() == data
+
+import os
+os.remove('72_lz4.tmp')
+os.remove('72_lz4.tmp.lz4')
+
 # test 64MB random data (require 1GB list[int] buffer)
 rnd = [random.randint(0, 255) for _ in range(1024*1024*1024//16)]
 test(bytes(rnd))
@@ -54,3 +54,159 @@ assert test_f(3) == 3 and miss_keys == [1, 2, 3, 4, 3, 5]
 # [2, 5, 3]
 assert test_f(1) == 1 and miss_keys == [1, 2, 3, 4, 3, 5, 1]
 # [5, 3, 1]
+
+# test cache_info / cache_clear
+from functools import cache
+
+assert test_f.cache_info().hits == 4
+assert test_f.cache_info().misses == 7
+assert test_f.cache_info().maxsize == 3
+assert test_f.cache_info().currsize == 3
+test_f.cache_clear()
+assert test_f.cache_info().currsize == 0
+assert test_f.cache_info().hits == 0
+assert test_f(1) == 1 and miss_keys[-1] == 1
+
+# `__eq__` calling back into the cache never returns a stale entry
+class ClearOnEq:
+    def __init__(self, n):
+        self.n = n
+    def __hash__(self):
+        return 1
+    def __eq__(self, other):
+        double.cache_clear()
+        return True
+    def __ne__(self, other):
+        return not self.__eq__(other)
+
+@lru_cache(maxsize=4)
+def double(x):
+    return x.n * 2
+
+assert double(ClearOnEq(1)) == 2
+assert [double(ClearOnEq(n)) for n in (2, 3, 4)] == [4, 6, 8]
+assert double.cache_info().hits == 0
+
+class EvictOnEq:
+    def __init__(self, n):
+        self.n = n
+    def __hash__(self):
+        return 1
+    def __eq__(self, other):
+        if isinstance(other, EvictOnEq) and self.n != other.n:
+            return False
+        # evicts every node and reuses the matched one for another key
+        for i in range(4):
+            triple(i + 100)
+        return True
+    def __ne__(self, other):
+        return not self.__eq__(other)
+
+@lru_cache(maxsize=4)
+def triple(x):
+    return x * 3 if isinstance(x, int) else x.n * 3
+
+assert triple(EvictOnEq(1)) == 3
+assert triple(EvictOnEq(1)) == 3
+assert triple(100) == 300
+
+# test lru_cache without parentheses
+@lru_cache
+def fib(n):
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+assert fib(90) == 2880067194370816120
+info = fib.cache_info()
+assert info.misses == 91 and info.currsize == 91 and info.maxsize == 128
+assert repr(info) == 'CacheInfo(hits=88, misses=91, maxsize=128, currsize=91)'
+
+# test multiple arguments
+calls = []
+
+@cache
+def mul(a, b):
+    calls.append((a, b))
+    return a * b
+
+assert mul(2, 3) == 6
+assert mul(2, 3) == 6
+assert mul(3, 2) == 6
+assert mul('a', 2) == 'aa'
+assert calls == [(2, 3), (3, 2), ('a', 2)]
+assert mul.cache_info().maxsize is None
+assert mul.__wrapped__(4, 5) == 20
+
+try:
+    mul([1], 2)
+    exit(1)
+except TypeError:
+    pass
+
+# test maxsize=None and maxsize=0
+@lru_cache(maxsize=None)
+def square(x):
+    return x * x
+
+for i in range(1000):
+    assert square(i) == i * i
+for i in range(1000):
+    assert square(i) == i * i
+assert square.cache_info().hits == 1000 and square.cache_info().currsize == 1000
+
+@lru_cache(maxsize=0)
+def ident(x):
+    return x
+
+assert ident(1) == 1 and ident(1) == 1
+assert ident.cache_info().misses == 2 and ident.cache_info().currsize == 0
+
+# test eviction over many keys
+@lru_cache(maxsize=16)
+def mod7(x):
+    return x % 7
+
+for i in range(1000):
+    assert mod7(i % 40) == i % 40 % 7
+assert mod7.cache_info().currsize == 16
+
+# cached values survive gc
+import gc
+
+@cache
+def make(n):
+    return [n] * 3
+
+a = make(5)
+del a
+gc.collect()
+assert make(5) == [5, 5, 5]
+assert make.cache_info().hits == 1
+
+# cached methods receive `self`
+class A:
+    def __init__(self, k):
+        self.k = k
+        self.calls = 0
+
+    @lru_cache(maxsize=16)
+    def f(self, x):
+        self.calls += 1
+        return x * self.k
+
+    @cache
+    def g(self, x):
+        return x + self.k
+
+a = A(2)
+assert a.f(10) == 20
+assert a.f(10) == 20
+assert a.calls == 1
+assert A(3).f(10) == 30
+assert a.g(1) == 3
+bound = a.f
+assert bound(4) == 8
+assert A.f(a, 4) == 8
+assert A.f.cache_info().hits == 2
+assert A.f.cache_info().currsize == 3
@@ -0,0 +1,62 @@
+import traceback
+
+# args larger than 255 need EXTENDED_ARG
+lines = []
+for i in range(300):
+    lines.append(f'v{i} = {i * 1000}')
+lines.append('res = v0 + v299 + 1')
+g = {}
+exec('\n'.join(lines), g)
+assert g['res'] == 299001
+
+lines = ['def h(x):', '    s = 0']
+for i in range(300):
+    lines.append(f'    s += g.attr{i} if x else {i}')
+lines.append('    return s')
+exec('\n'.join(lines))
+assert globals()['h'](0) == sum(range(300))
+
+# long forward and backward jumps
+lines = ['def k(n):', '    i = 0', '    t = 0', '    while i < n:', '        i += 1', '        if i % 2 == 0:']
+for j in range(200):
+    lines.append(f'            t = t + {j}')
+lines.append('        else:')
+lines.append('            t = t - 1')
+lines.append('    return t')
+exec('\n'.join(lines))
+assert globals()['k'](4) == 2 * sum(range(200)) - 2
+
+# line numbers survive the compact line table
+def raise_at_line():
+    a = 1
+
+    b = 2
+
+
+    raise ValueError(a + b)
+
+try:
+    raise_at_line()
+    exit(1)
+except ValueError:
+    s = traceback.format_exc()
+    assert 'line 36' in s, s
+    assert 'raise ValueError(a + b)' in s
+
+# exceptions inside deep blocks still find their handlers
+def nested(x):
+    for i in range(3):
+        try:
+            with open_ctx():
+                if x:
+                    raise KeyError(i)
+        except KeyError as e:
+            x = False
+            continue
+    return x
+
+class open_ctx:
+    def __enter__(self): pass
+    def __exit__(self, *args): pass
+
+assert nested(True) == False
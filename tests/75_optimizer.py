@@ -0,0 +1,245 @@
+from pkpy import setoptimizelevel, getoptimizelevel
+
+assert getoptimizelevel() == 2
+
+# constant folding
+assert 1 + 2 == 3
+assert 1 + 2 * 3 - 4 == 3
+assert 2 ** 10 == 1024
+assert 2 ** 40 == 1099511627776
+assert 7 // 2 == 3 and 7 % 2 == 1
+assert -7 // 2 == -4
+assert 7 / 2 == 3.5
+assert 1 << 10 == 1024 and 1024 >> 3 == 128
+assert (6 & 3, 6 | 3, 6 ^ 3) == (2, 7, 5)
+assert "a" + "b" == "ab"
+assert "ab" * 3 == "ababab"
+assert (not True) == False
+assert (not 0) == True
+assert (not "") == True
+assert -(1 + 2) == -3
+assert 1.5 + 2 == 3.5
+assert (1 < 2, 2 <= 1, "a" < "b") == (True, False, True)
+
+# errors are raised at runtime, not at compile time
+try:
+    1 // 0
+    exit(1)
+except ZeroDivisionError:
+    pass
+
+try:
+    "a" + 1
+    exit(1)
+except TypeError:
+    pass
+
+def f():
+    return 1 / 0
+
+try:
+    f()
+    exit(1)
+except ZeroDivisionError:
+    pass
+
+# constant conditions and dead code
+def g(x):
+    if False:
+        return 'dead'
+    while True:
+        if x > 3:
+            break
+        x += 1
+    if 1:
+        return x
+    return 'dead'
+
+assert g(0) == 4
+assert g(10) == 10
+
+# dead `yield` still makes a generator
+def gen():
+    return
+    yield 1
+
+assert list(gen()) == []
+
+# jump threading through nested if/elif/else
+def h(x):
+    if x == 0:
+        if x < 1:
+            r = 'a'
+        else:
+            r = 'b'
+    elif x == 1:
+        r = 'c'
+    else:
+        r = 'd'
+    return r
+
+assert [h(0), h(1), h(2)] == ['a', 'c', 'd']
+
+# try/except handlers are kept reachable
+def k():
+    try:
+        raise ValueError
+    except ValueError:
+        return 1
+    return 2
+
+assert k() == 1
+
+# results are the same for all levels
+src = '''
+def fn(n):
+    s = 0
+    for i in range(n):
+        if i % 2 == 0 and True:
+            s += i * (2 + 3)
+        elif not False:
+            continue
+        else:
+            s -= 1
+    return s + (10 - 2 ** 3)
+res = fn(100)
+'''
+
+results = []
+for level in [0, 1, 2]:
+    setoptimizelevel(level)
+    assert getoptimizelevel() == level
+    g_ = {}
+    exec(src, g_)
+    results.append(g_['res'])
+setoptimizelevel(2)
+assert results[0] == results[1] == results[2] == 12252, results
+
+# the optimizer really folds constants and removes dead code
+from dis import get_instructions
+
+src = '''
+def fold(x):
+    return x + (1 + 2 * 3) - (10 - 2 ** 3)
+
+def dead(x):
+    if False:
+        x = x * 100
+    while 0:
+        x = x - 1
+    if 1:
+        return x
+    return 'unreachable'
+'''
+
+def compile_at(level):
+    setoptimizelevel(level)
+    g_ = {}
+    exec(src, g_)
+    return g_['fold'], g_['dead']
+
+fold0, dead0 = compile_at(0)
+fold2, dead2 = compile_at(2)
+setoptimizelevel(2)
+
+def opnames(f):
+    return [op for op, _ in get_instructions(f)]
+
+assert fold0(1) == fold2(1) == 6
+assert dead0(5) == dead2(5) == 5
+# `1 + 2 * 3` and `10 - 2 ** 3` are computed at runtime without the optimizer
+assert opnames(fold0).count('BINARY_MUL') == 1 and opnames(fold0).count('BINARY_POW') == 1
+assert 'BINARY_MUL' not in opnames(fold2) and 'BINARY_POW' not in opnames(fold2)
+assert ('LOAD_SMALL_INT', 7) in get_instructions(fold2)
+assert ('LOAD_SMALL_INT', 2) in get_instructions(fold2)
+assert len(get_instructions(fold2)) < len(get_instructions(fold0))
+# dead branches and the code after the constant `if 1:` return are gone
+assert 'BINARY_MUL' in opnames(dead0) and 'BINARY_MUL' not in opnames(dead2)
+assert 'BINARY_SUB' in opnames(dead0) and 'BINARY_SUB' not in opnames(dead2)
+assert 'POP_JUMP_IF_FALSE' in opnames(dead0) and 'POP_JUMP_IF_FALSE' not in opnames(dead2)
+assert opnames(dead2) == ['LOAD_FAST', 'RETURN_VALUE']
+
+# superinstructions
+class Num:
+    def __init__(self, x):
+        self.x = x
+    def __add__(self, other):
+        return Num(self.x + other)
+    def __lt__(self, other):
+        return self.x < other
+
+def inc(x):
+    x += 1
+    x = x + 2
+    return x
+
+assert inc(1) == 4
+assert inc(1.5) == 4.5
+assert inc(Num(1)).x == 4
+try:
+    inc('a')
+    exit(1)
+except TypeError:
+    pass
+
+def unbound():
+    if False:
+        i = 0
+    i += 1
+
+try:
+    unbound()
+    exit(1)
+except UnboundLocalError:
+    pass
+
+def count(lo, hi):
+    res = []
+    while lo < hi:
+        res.append(lo)
+        lo += 1
+    return res
+
+assert count(0, 3) == [0, 1, 2]
+assert count(0.5, 3) == [0.5, 1.5, 2.5]
+assert [n.x for n in count(Num(0), 2)] == [0, 1]
+assert count(3, 0) == []
+
+def cmp_all(a, b):
+    res = []
+    if a < b: res.append('<')
+    if a <= b: res.append('<=')
+    if a == b: res.append('==')
+    if a != b: res.append('!=')
+    if a > b: res.append('>')
+    if a >= b: res.append('>=')
+    return res
+
+assert cmp_all(1, 2) == ['<', '<=', '!=']
+assert cmp_all(2, 2) == ['<=', '==', '>=']
+assert cmp_all(2.5, 2) == ['!=', '>', '>=']
+assert cmp_all('b', 'a') == ['!=', '>', '>=']
+
+def attr(a, b):
+    return a.x + b
+
+assert attr(Num(1), 2) == 3
+try:
+    attr(1, 2)
+    exit(1)
+except AttributeError:
+    pass
+
+from pkpy import configmacros
+if configmacros['PK_ENABLE_OPCODE_PROFILER']:
+    from pkpy import opcodeprofiler_begin, opcodeprofiler_end, opcodeprofiler_report
+    opcodeprofiler_begin()
+    count(0, 100)
+    opcodeprofiler_end()
+    report = opcodeprofiler_report()
+    assert len(report) > 0
+    first, second, hits = report[0]
+    assert type(first) is str and type(second) is str
+    assert hits >= 100
+    for i in range(1, len(report)):
+        assert report[i-1][2] >= report[i][2]
@@ -66,4 +66,26 @@ f_()
 
 assert os.path.exists('123.bin')
 os.remove('123.bin')
-assert not os.path.exists('123.bin')
\ No newline at end of file
+assert not os.path.exists('123.bin')
+
+# write any buffer, and read into an existing one
+with open('123.bin', 'wb') as f:
+    f.write(bytearray(b'abc'))
+    f.write(memoryview(b'xdefx')[1:4])
+
+buf = bytearray(4)
+with open('123.bin', 'rb') as f:
+    assert f.readinto(buf) == 4
+    assert buf == b'abcd'
+    assert f.readinto(memoryview(buf)[1:]) == 2
+    assert buf == b'aefd'
+    assert f.readinto(buf) == 0
+
+try:
+    with open('123.bin', 'rb') as f:
+        f.readinto(b'1234')
+    exit(1)
+except TypeError:
+    pass
+
+os.remove('123.bin')
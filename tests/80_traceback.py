@@ -16,4 +16,106 @@ if actual != expected:
     print(actual)
     print('--- EXPECTED RESULT ---')
     print(expected)
-    exit(1)
\ No newline at end of file
+    exit(1)
+# tracebacks are resolved lazily and keep their code alive
+import gc
+
+saved = None
+try:
+    exec("def h():\n  1/0\nh()")
+except ZeroDivisionError as e:
+    saved = e
+for i in range(300):
+    exec(f"x{i} = {i}")
+gc.collect()
+junk = [[i] for i in range(10000)]
+gc.collect()
+try:
+    raise saved
+except ZeroDivisionError:
+    s = traceback.format_exc()
+assert 'line 2, in h' in s, s
+assert '1/0' in s
+
+# exception args are kept alive by subclasses too
+e = KeyError([1, 2, 3] * 2)
+gc.collect()
+junk = [[i] for i in range(10000)]
+gc.collect()
+assert e.args == ([1, 2, 3, 1, 2, 3],)
+
+# functions defined by exec() keep their globals alive
+g = {'y': 7}
+exec('def get_y():\n  return y', g)
+exec('def get_x0():\n  return x0')
+gc.collect()
+junk = [[i] for i in range(10000)]
+gc.collect()
+assert g['get_y']() == 7
+assert get_x0() == 0
+
+# internal StopIteration
+def gen():
+    yield 1
+
+for _ in range(3):
+    assert list(gen()) == [1]
+it = gen()
+next(it)
+try:
+    next(it)
+    exit(1)
+except StopIteration as e:
+    assert e.value is None
+
+def gen_ret():
+    yield 1
+    return 2
+
+it = gen_ret()
+next(it)
+try:
+    next(it)
+    exit(1)
+except StopIteration as e:
+    assert e.value == 2
+
+# user code gets a fresh StopIteration every time
+it = iter([])
+errors = []
+for _ in range(2):
+    try:
+        next(it)
+    except StopIteration as e:
+        errors.append(e)
+try:
+    it.__next__()
+except StopIteration as e:
+    errors.append(e)
+assert errors[0] is not errors[1] and errors[1] is not errors[2]
+
+# internal iteration inside a handler keeps the handled traceback
+try:
+    next(it)
+except StopIteration:
+    for _ in [1, 2]:
+        pass
+    assert traceback.format_exc().count('StopIteration') == 1
+
+# exhausting an iterator inside a handler does not chain StopIteration to itself
+handled = []
+
+def next_in_handler():
+    try:
+        it.__next__()
+    except StopIteration as e:
+        handled.append(e)
+        it.__next__()
+
+try:
+    next_in_handler()
+    exit(1)
+except StopIteration as e:
+    assert e is not handled[0]
+    msg = traceback.format_exc()
+    assert msg.count('StopIteration') == 1 and 'During handling' not in msg
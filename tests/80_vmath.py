@@ -425,3 +425,79 @@ for i in range(-1000, 10000):
     e[vec2i(i, 12)] = i
     e[vec2i(i, 11)] = i
     e[vec2i(i, 13)] = i
+
+# test vec2_array, vec3_array
+import array2d
+from vmath import vec2_array, vec3_array
+
+def isclose(a, b):
+    return abs(a - b) < 1e-4
+
+pts = [vec2(i * 0.5 - 3, 2 - i * 0.25) for i in range(20)]
+a = vec2_array(pts)
+b = vec2_array([vec2(1, 2)] * 20)
+assert len(a) == 20
+assert a[3] == pts[3] and a[-1] == pts[-1]
+assert a.tolist() == pts and list(a) == pts
+assert vec2_array(3).tolist() == [vec2(0, 0)] * 3
+a2 = a.copy()
+a2[0] = vec2(9, 9)
+assert a2[0] == vec2(9, 9) and a[0] == pts[0]
+
+assert (a + b).tolist() == [p + vec2(1, 2) for p in pts]
+assert (a - vec2(1, 2)).tolist() == [p - vec2(1, 2) for p in pts]
+assert (a * 2).tolist() == [p * 2 for p in pts]
+assert (a * vec2(2, 3)).tolist() == [p * vec2(2, 3) for p in pts]
+assert (a / 4).tolist() == [p / 4 for p in pts]
+assert a.lerp(b, 0.25).tolist() == [p + (vec2(1, 2) - p) * 0.25 for p in pts]
+
+d = a.dot(b)
+assert d.dtype == 'float32' and d.width == 1 and d.height == 20
+lengths = a.length()
+for i in range(20):
+    assert isclose(d[0, i], pts[i].dot(vec2(1, 2)))
+    assert isclose(lengths[0, i], pts[i].length())
+assert a.normalize().tolist() == [p.normalize() for p in pts]
+assert vec2_array([vec2(0, 0)]).normalize()[0] == vec2(0, 0)
+
+m = mat3x3.trs(vec2(1, 2), 0.3, vec2(2, 2))
+assert m.transform_points(a).tolist() == [m.transform_point(p) for p in pts]
+assert m.transform_vectors(a).tolist() == [m.transform_vector(p) for p in pts]
+
+pos, vel = vec2_array.smooth_damp(a, vec2(3, 3), vec2_array(20), 0.3, 10, 0.016)
+for i in range(20):
+    p, v = vec2.smooth_damp(pts[i], vec2(3, 3), vec2(0, 0), 0.3, 10, 0.016)
+    assert pos[i] == p and vel[i] == v
+
+c = a.copy()
+c.add_(b)
+assert c == a + b
+c.mul_(0)
+assert c == vec2_array(20)
+
+t = a.to_array2d()
+assert t.width == 2 and t.height == 20 and t.dtype == 'float32'
+assert vec2_array.from_array2d(t) == a
+assert vec2_array.from_array2d(array2d.array2d.fromlist([[1, 2], [3, 4]])).tolist() == [vec2(1, 2), vec2(3, 4)]
+
+v3 = vec3_array([vec3(1, 2, 3), vec3(0, 0, 1)])
+assert v3.dot(vec3(1, 1, 1)).tolist() == [[6.0], [1.0]]
+assert v3.normalize()[0] == vec3(1, 2, 3).normalize()
+
+try:
+    a + vec2_array(3)
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    a + v3
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    a[20]
+    exit(1)
+except IndexError:
+    pass
@@ -244,6 +244,40 @@ vis, cnt = a.get_connected_components(2, 'von Neumann')
 assert cnt == 1
 vis, cnt = a.get_connected_components(0, 'Moore')
 assert cnt == 2
+labels, cnt = a.astype('int8').connected_components(1, 'Moore')
+assert cnt == 2 and labels.dtype == 'int32'
+assert labels.tolist() == a.get_connected_components(1, 'Moore')[0].tolist()
+assert a.connected_components(2)[0].tolist() == [[0, 0, 0, 0], [0, 1, 1, 0], [0, 0, 0, 0], [0, 0, 0, 0]]
+
+# test flood_fill, distance_transform and find_path
+b = a.copy()
+assert b.flood_fill(vec2i(3, 0), 9) == 5
+assert b.tolist() == [[1, 1, 0, 9], [0, 2, 2, 9], [0, 9, 9, 9], [1, 0, 0, 0]]
+t = a.astype('int16')
+assert t.flood_fill(vec2i(0, 0), 5, 'Moore') == 2 and t[1, 0] == 5 and t[3, 0] == 1
+try:
+    t.flood_fill(vec2i(4, 0), 5)
+    exit(1)
+except IndexError:
+    pass
+assert a.distance_transform(2).tolist() == [[2, 1, 1, 2], [1, 0, 0, 1], [2, 1, 1, 2], [3, 2, 2, 3]]
+moore = a.astype('int32').distance_transform(2, 'Moore')
+assert moore.tolist() == [[1, 1, 1, 1], [1, 0, 0, 1], [1, 1, 1, 1], [2, 2, 2, 2]]
+assert a.distance_transform(7).tolist() == [[-1] * 4] * 4
+walls = array2d.fromlist([
+    [1, 1, 1, 1],
+    [0, 0, 0, 1],
+    [1, 9, 1, 1],
+    [1, 0, 0, 0],
+], dtype='int8')
+assert walls.find_path(vec2i(0, 0), vec2i(0, 3)) == [
+    vec2i(0, 0), vec2i(1, 0), vec2i(2, 0), vec2i(3, 0), vec2i(3, 1),
+    vec2i(3, 2), vec2i(2, 2), vec2i(1, 2), vec2i(0, 2), vec2i(0, 3),
+]
+assert len(walls.find_path(vec2i(0, 0), vec2i(0, 3), 'Moore')) == 7
+assert walls.find_path(vec2i(0, 0), vec2i(3, 3)) is None
+assert (walls > 0).find_path(vec2i(1, 2), vec2i(1, 2)) == [vec2i(1, 2)]
+assert walls.astype(None).find_path(vec2i(0, 0), vec2i(2, 2)) == walls.find_path(vec2i(0, 0), vec2i(2, 2))
 
 # test zip_with
 a = array2d[int].fromlist([[1, 2], [3, 4]])
@@ -279,6 +313,147 @@ assert (a ^ b).tolist() == [[False, True], [False, True]]
 assert (~a).tolist() == [[False, True], [True, False]]
 assert (~b).tolist() == [[False, False], [True, True]]
 
+# test typed storage
+a = array2d(3, 2, default=7, dtype='int8')
+assert a.dtype == 'int8' and array2d(1, 1).dtype == 'object'
+assert a.tolist() == [[7, 7, 7], [7, 7, 7]]
+assert array2d(2, 2, dtype='float32').tolist() == [[0.0, 0.0], [0.0, 0.0]]
+a[1, 1] = -3
+assert a[1, 1] == -3 and a.count(7) == 5 and a.count(7.0) == 5 and a.count(7.5) == 0
+try:
+    a[0, 0] = 128
+    exit(1)
+except ValueError:
+    pass
+try:
+    a[0, 0] = 1.5
+    exit(1)
+except TypeError:
+    pass
+assert (a + 1).dtype == 'int8' and (a + 1)[1, 1] == -2
+assert (a * 20)[0, 0] == -116    # wraps around
+assert (a + 1000).dtype == 'int16' and (a + 1000)[0, 0] == 1007
+assert (a + 0.5).dtype == 'float64' and (a + 0.5)[0, 0] == 7.5
+assert (a / 2).dtype == 'float64' and (a / 2)[1, 1] == -1.5
+assert (a // 2)[1, 1] == -2 and (a % 2)[1, 1] == 1
+assert (a > 0).dtype == 'bool' and (a > 0).count(False) == 1
+assert (~a)[0, 0] == -8 and (a ** 2)[1, 1] == 9
+try:
+    a // array2d(3, 2, dtype='int8')
+    exit(1)
+except ZeroDivisionError:
+    pass
+
+b = array2d.fromlist([[1, 2], [3, 4]], dtype='int16')
+c = array2d.fromlist([[0.5, 0.5], [1.5, 1.5]], dtype='float32')
+assert (b + c).dtype == 'float32' and (b + c).tolist() == [[1.5, 2.5], [4.5, 5.5]]
+assert (b == b.astype('int32')).all()
+assert (b - b).tolist() == [[0, 0], [0, 0]]
+assert (b[0:2, 1:2] + b[0:2, 0:1]).tolist() == [[4, 6]]
+assert b.map(abs).dtype == 'int16' and (b - 3).map(abs).tolist() == [[2, 1], [0, 1]]
+assert b.map(float).dtype == 'float64' and b.map(str).tolist() == [['1', '2'], ['3', '4']]
+assert c.astype('int8').tolist() == [[0, 0], [1, 1]]
+
+# float `%` follows the scalar operator, the sign of the left operand is kept
+for dtype in ['float32', 'float64', None]:
+    f = array2d.fromlist([[-1.25, 1.25]], dtype=dtype)
+    assert (f % 2.5).tolist() == [[-1.25 % 2.5, 1.25 % 2.5]]
+    assert (f % -2.5).tolist() == [[-1.25 % -2.5, 1.25 % -2.5]]
+assert (array2d.fromlist([[-7, 7]], dtype='int32') % 3).tolist() == [[-7 % 3, 7 % 3]]
+assert array2d.fromlist([[True, False]], dtype='bool').astype('int8').tolist() == [[1, 0]]
+assert b.copy().dtype == 'int16' and b.astype(None).dtype == 'object'
+
+m = array2d.fromlist([[True, False], [False, True]], dtype='bool')
+assert (~m).tolist() == [[False, True], [True, False]]
+assert (m & ~m).any() == False and (m | ~m).all() == True
+assert b[m] == [1, 4]
+
+g = array2d.fromlist([[1, 0, 1], [0, 1, 0], [1, 1, 1]])
+for dtype in ['int8', 'int32', 'float64']:
+    t = g.astype(dtype)
+    assert t.count_neighbors(1, 'Moore').tolist() == g.count_neighbors(1, 'Moore').tolist()
+    assert t.count_neighbors(1, 'von Neumann').tolist() == g.count_neighbors(1, 'von Neumann').tolist()
+    kernel = array2d.fromlist([[1, 2, 1], [0, 1, 0], [-1, 0, 3]])
+    if dtype == 'float64':
+        # float cells are rejected, like in an object array
+        try:
+            t.convolve(kernel, 2)
+            exit(1)
+        except TypeError:
+            pass
+    else:
+        assert t.convolve(kernel, 2).tolist() == g.convolve(kernel, 2).tolist()
+
+import pickle
+assert pickle.loads(pickle.dumps(c)).dtype == 'float32'
+assert pickle.loads(pickle.dumps(c)).tolist() == c.tolist()
+
+# test sum, min and max
+assert g.sum() == 6 and g.min() == 0 and g.max() == 1
+life = array2d(37, 29, default=False, dtype='bool')
+for i in range(37):
+    life[i, (i * 7) % 29] = True
+    life[i, (i * 3) % 29] = True
+life_obj = life.astype(None)
+assert life.sum() == life.count(True) == life_obj.count(True)
+assert life.min() == False and life.max() == True
+n = life.count_neighbors(True, 'Moore')
+assert n.tolist() == life_obj.count_neighbors(True, 'Moore').tolist()
+assert n.sum() == n.astype(None).sum() and n.max() == n.astype(None).max()
+assert ((n == 3) | (life & (n == 2))).tolist() == ((n == 3) | (life_obj & (n == 2))).tolist()
+f = n.astype('float32') - 2.5
+assert f.sum() == f.astype(None).sum() and f.min() == -2.5 and f.max() == f.astype(None).max()
+f[36, 28] = float('nan')
+assert str(f.min()) == 'nan' and str(f.max()) == 'nan'
+# separable kernels take two passes
+box = array2d(3, 3, default=1)
+assert n.convolve(box, 1).tolist() == n.astype(None).convolve(box, 1).tolist()
+k121 = array2d.fromlist([[1, 2, 1], [2, 4, 2], [1, 2, 1]])
+assert n.convolve(k121, 0).tolist() == n.astype(None).convolve(k121, 0).tolist()
+
+# typed arrays accept the same operands as object arrays
+def raises_type_error(f):
+    try:
+        f()
+    except TypeError:
+        return True
+    return False
+
+gauss = array2d.fromlist([[0.25, 0.5, 0.25], [0.5, 1.0, 0.5], [0.25, 0.5, 0.25]])
+for dtype in [None, 'int32', 'float64']:
+    t = n.astype(dtype)
+    assert raises_type_error(lambda: t // 2.0)
+    assert raises_type_error(lambda: t // array2d(n.n_cols, n.n_rows, default=2.0))
+    assert raises_type_error(lambda: t.convolve(gauss, 0))
+    assert raises_type_error(lambda: t.astype('float32').convolve(k121, 0))
+    assert raises_type_error(lambda: t.astype('float32') // 2)
+assert (n // 2).tolist() == (n.astype(None) // 2).tolist()
+assert raises_type_error(lambda: array2d(2, 2, default=True, dtype='bool') / True)
+
+# test parallel kernels
+from array2d import set_parallel, get_parallel
+assert get_parallel() == (1, 65536)
+def run_kernels():
+    return [
+        n.count_neighbors(3, 'Moore').tolist(), life.count_neighbors(True, 'von Neumann').tolist(),
+        n.convolve(box, 1).tolist(), n.convolve(kernel, -2).tolist(),
+        n.convolve(k121, 1).tolist(), (n * 3 - 1).tolist(),
+        (n >= 2).tolist(), (~life).tolist(), (n - 4).map(abs).tolist(), n.astype('int8').tolist(),
+        n.count(3), n.sum(), n.min(), n.max(), str(f.sum()), str(f.max()), life.min(), life.sum(),
+    ]
+serial = run_kernels()
+set_parallel(4, 16)
+assert get_parallel() == (4, 16)
+for _ in range(3):
+    assert run_kernels() == serial
+set_parallel(1)
+assert get_parallel() == (1, 65536)
+try:
+    set_parallel(0)
+    exit(1)
+except ValueError:
+    pass
+
 # stackoverflow bug due to recursive mark-and-sweep
 # class Cell:
 #     neighbors: list['Cell']
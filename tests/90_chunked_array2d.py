@@ -65,3 +65,89 @@ assert (a.view() == b.view()).all()
 
 for pos, ctx in a:
     assert b.get_context(pos) == ctx
+
+# test many chunks
+a = array2d.chunked_array2d(2, default=0)
+for i in range(-50, 50):
+    for j in range(-50, 50):
+        a[vec2i(i, j)] = i * 100 + j
+assert len(a) == 50 * 50
+for i in range(-50, 50, 7):
+    for j in range(-50, 50, 3):
+        assert a[vec2i(i, j)] == i * 100 + j
+for x in range(-25, 25, 2):
+    assert a.remove_chunk(vec2i(x, 0))
+assert len(a) == 50 * 50 - 25
+assert a[vec2i(-50, 0)] == 0
+assert a[vec2i(-50, 2)] == -5000 + 2
+assert a[vec2i(-48, -1)] == -4800 - 1
+assert a.move_chunk(vec2i(-24, 0), vec2i(-25, 0))
+assert a[vec2i(-50, 0)] == -4800
+
+# test save_chunks/load_chunks
+a = array2d.chunked_array2d(4, default=0, context_builder=lambda pos: [pos])
+a[vec2i(0, 0)] = 1
+a[vec2i(1, 0)] = -2**40
+a[vec2i(2, 0)] = 3.5
+a[vec2i(3, 0)] = 'hello'
+a[vec2i(0, 1)] = None
+a[vec2i(1, 1)] = True
+a[vec2i(2, 1)] = False
+a[vec2i(-1, -1)] = 'x'
+a[vec2i(100, 100)] = 7
+data = a.save_chunks(vec2i(-1, -1), 2, 2)
+assert type(data) is bytes
+assert a.save_chunks(vec2i(-1, -1)) != data
+
+b = array2d.chunked_array2d(4, default=0, context_builder=lambda pos: [pos, 'b'])
+b[vec2i(0, 0)] = 'old'
+b[vec2i(3, 3)] = 'old'
+loaded = b.load_chunks(data)
+assert sorted(loaded, key=lambda p: (p.y, p.x)) == [vec2i(-1, -1), vec2i(0, 0)]
+assert len(b) == 2
+assert (b.view_chunk(vec2i(0, 0)) == a.view_chunk(vec2i(0, 0))).all()
+assert b[vec2i(3, 3)] == 0
+assert b[vec2i(-1, -1)] == 'x'
+assert b[vec2i(100, 100)] == 0
+assert b.get_context(vec2i(0, 0)) == [vec2i(0, 0), 'b']
+assert b.get_context(vec2i(-1, -1)) == [vec2i(-1, -1), 'b']
+
+assert b.load_chunks(a.save_chunks(vec2i(50, 50))) == []
+
+try:
+    array2d.chunked_array2d(8).load_chunks(data)
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    b.load_chunks(data[:-1])
+    exit(1)
+except ValueError:
+    pass
+
+a[vec2i(0, 0)] = [1]
+try:
+    a.save_chunks(vec2i(0, 0))
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    import lz4
+    has_lz4 = True
+except ImportError:
+    has_lz4 = False
+
+a[vec2i(0, 0)] = 1
+if has_lz4:
+    data = a.save_chunks(vec2i(-1, -1), 2, 2, compress=True)
+    c = array2d.chunked_array2d(4, default=0)
+    assert len(c.load_chunks(data)) == 2
+    assert (c.view_chunk(vec2i(0, 0)) == a.view_chunk(vec2i(0, 0))).all()
+else:
+    try:
+        a.save_chunks(vec2i(0, 0), compress=True)
+        exit(1)
+    except ValueError:
+        pass
@@ -210,4 +210,10 @@ a = deque([1, 2, 3])
 test(a)
 
 a = [int, float, Foo]
-test(a)
\ No newline at end of file
+test(a)
+from vmath import vec2_array, vec3_array
+test(vec2_array([vec2(1, 2), vec2(3.5, -4)]))
+test(vec3_array([vec3(1, 2, 3)]))
+a = vec2_array(2)
+c = loads(dumps([a, a]))
+assert c[0] is c[1]
@@ -0,0 +1,89 @@
+from pkpy import freeze, isfrozen, setfrozen, getfrozen, frozendict, configmacros
+import gc
+
+a = freeze((1, 2.5, 'a very long string that is not inlined', b'abc', None, True))
+assert isfrozen(a)
+assert a == (1, 2.5, 'a very long string that is not inlined', b'abc', None, True)
+assert isfrozen(a[2])
+assert isfrozen(a[3])
+assert not isfrozen([1, 2])
+
+# freezing a frozen object is a no-op
+assert freeze(a) is a
+
+# list is frozen as tuple
+b = freeze([1, [2, 3], 'x'])
+assert type(b) is tuple
+assert b == (1, (2, 3), 'x')
+
+# dict is frozen as frozendict
+d = freeze({'level': 1, 'tiles': [0, 1, 2], 'nested': {'x': 'y'}})
+assert type(d) is frozendict
+assert d['level'] == 1
+assert d['tiles'] == (0, 1, 2)
+assert d['nested']['x'] == 'y'
+assert 'level' in d
+assert 'missing' not in d
+assert len(d) == 3
+assert d.get('missing', 5) == 5
+assert list(d.keys()) == ['level', 'tiles', 'nested']
+assert d == {'level': 1, 'tiles': (0, 1, 2), 'nested': {'x': 'y'}}
+assert repr(frozendict({1: 2})) == 'frozendict({1: 2})'
+
+c = d.copy()
+assert type(c) is dict
+c['level'] = 2
+assert d['level'] == 1
+
+try:
+    d['level'] = 2
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    hash(d)
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    freeze([object()])
+    exit(1)
+except TypeError:
+    pass
+
+# frozen objects survive gc
+gc.collect()
+assert d['nested']['x'] == 'y'
+
+setfrozen('config', {'name': 'pocketpy', 'values': list(range(100))})
+assert getfrozen('config')['name'] == 'pocketpy'
+assert getfrozen('config') is getfrozen('config')
+
+try:
+    setfrozen('config', 1)
+    exit(1)
+except ValueError:
+    pass
+
+try:
+    getfrozen('unknown')
+    exit(1)
+except KeyError:
+    pass
+
+if configmacros['PK_ENABLE_THREADS'] == 1:
+    from pkpy import ComputeThread
+    t = ComputeThread(3)
+    t.exec('from pkpy import getfrozen, isfrozen')
+    assert t.eval('isfrozen(getfrozen("config"))')
+    assert t.eval('sum(getfrozen("config")["values"])') == sum(range(100))
+
+    # published entries stay valid while another VM keeps publishing
+    t.exec('from pkpy import setfrozen')
+    t.submit_exec('for i in range(2000): setfrozen("thread_key_" + str(i), [i, str(i)])')
+    while not t.is_done:
+        assert getfrozen('config')['name'] == 'pocketpy'
+    assert t.wait_for_done()
+    assert getfrozen('thread_key_1999') == (1999, '1999')
@@ -5,4 +5,37 @@ class A:
 
 assert is_user_defined_type(A)
 assert not is_user_defined_type(int)
-assert not is_user_defined_type(dict)
\ No newline at end of file
+assert not is_user_defined_type(dict)
+# compile cache
+from pkpy import compilecache_stats, compilecache_setcapacity
+
+hits_0, misses_0 = compilecache_stats()
+x = 0
+for i in range(10):
+    x = eval('x + 1')
+assert x == 10
+hits_1, misses_1 = compilecache_stats()
+assert misses_1 - misses_0 == 1
+assert hits_1 - hits_0 == 9
+
+# cached code objects are shared and can be executed again
+exec('y = 1')
+exec('y = 1')
+assert y == 1
+assert compile('1 + 2', '<a>', 'eval') is compile('1 + 2', '<a>', 'eval')
+assert compile('1 + 2', '<a>', 'eval') is not compile('1 + 2', '<b>', 'eval')
+
+# syntax errors are not cached
+for i in range(2):
+    try:
+        eval('1 +')
+        exit(1)
+    except SyntaxError:
+        pass
+
+compilecache_setcapacity(0)
+hits_0, misses_0 = compilecache_stats()
+eval('1')
+eval('1')
+assert compilecache_stats() == (hits_0, misses_0)
+compilecache_setcapacity(64)
@@ -0,0 +1,105 @@
+from pkpy import Table, TableRow
+from vmath import vec2, vec2_array
+import gc
+
+t = Table({'x': 'float', 'hp': 'int', 'pos': 'vec2', 'alive': 'bool', 'tag': 'object'})
+assert len(t) == 0
+assert t.columns == {'x': 'float64', 'hp': 'int32', 'pos': 'vec2', 'alive': 'bool', 'tag': 'object'}
+
+for i in range(5):
+    assert t.append(x=i * 1.5, hp=i, pos=vec2(i, -i), tag=[i]) == i
+assert len(t) == 5
+assert t[2, 'x'] == 3.0
+assert t[-1].tag == [4]
+assert t[0].alive == False
+
+# rows are views of the table
+r = t[1]
+assert isinstance(r, TableRow)
+assert r.index == 1 and r.table is t
+r.x += 10
+r.pos = vec2(3, 4)
+assert t[1, 'x'] == 11.5
+assert t[1].pos == vec2(3, 4)
+assert repr(t[0]) == 'TableRow(x=0.0, hp=0, pos=vec2(0.0000, 0.0000), alive=False, tag=[0])'
+assert [row.hp for row in t] == [0, 1, 2, 3, 4]
+
+try:
+    r.foo
+    exit(1)
+except AttributeError:
+    pass
+
+try:
+    r.hp = 1.5
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    t[5]
+    exit(1)
+except IndexError:
+    pass
+
+# bulk arithmetic
+t.add_('hp', 5)
+assert t['hp'].tolist() == [[5], [6], [7], [8], [9]]
+t.mul_('x', 'hp')
+assert t.column('x').tolist() == [[0.0], [69.0], [21.0], [36.0], [54.0]]
+t.add_scaled_('pos', vec2(1, 1), 0.5)
+t.add_scaled_('pos', 'x', 2)
+assert t[1].pos == vec2(141.5, 142.5)
+assert t[0].pos == vec2(0.5, 0.5)
+
+try:
+    t.truediv_('hp', 2)
+    exit(1)
+except TypeError:
+    pass
+
+try:
+    t.add_('tag', 1)
+    exit(1)
+except TypeError:
+    pass
+
+# columns
+t.set_column('alive', True)
+assert t.column('alive').all()
+t['tag'] = None
+assert t.column('tag') == [None] * 5
+t.set_column('tag', [1, 2, 3, 4, 5])
+assert t.column('tag') == [1, 2, 3, 4, 5]
+t.set_column('pos', vec2_array(5))
+assert t.column('pos') == vec2_array(5)
+
+t.swap_remove(0)
+assert len(t) == 4
+assert t[0].hp == 9 and t[0].tag == 5
+
+t.resize(6)
+assert t[5].hp == 0 and t[5].tag is None
+t.clear()
+assert len(t) == 0
+
+try:
+    t.append(mana=1)
+    exit(1)
+except KeyError:
+    pass
+assert len(t) == 0
+
+try:
+    Table({'a': 'int64'})
+    exit(1)
+except ValueError:
+    pass
+
+# object columns are kept alive by the table
+s = Table({'o': 'object'})
+for i in range(1000):
+    s.append(o=[i] * 3)
+gc.collect()
+assert s[999].o == [999, 999, 999]
+assert sum([len(row.o) for row in s]) == 3000
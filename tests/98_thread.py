@@ -38,3 +38,22 @@ while not thread_1.is_done or not thread_2.is_done:
 print("Thread 1 last return value:", thread_1.last_retval())
 print("Thread 2 last return value:", thread_2.last_retval())
 
+# blocking waits
+thread_1.submit_call('func', [1, 2, 3])
+thread_2.submit_call('func', [4, 5, 6])
+
+done = ComputeThread.wait_any([thread_1, thread_2])
+assert done is thread_1 or done is thread_2
+assert done.is_done
+
+assert thread_1.wait_for_done()
+assert thread_2.wait_for_done(5.0)
+assert thread_1.is_done and thread_2.is_done
+
+
+# timeout
+thread_1.submit_exec('import time; time.sleep(0.5)')
+assert not thread_1.wait_for_done(0.01)
+assert ComputeThread.wait_any([thread_1], 0.01) is None
+assert thread_1.wait_for_done()
+assert ComputeThread.wait_any([thread_1, thread_2], 0) is thread_1